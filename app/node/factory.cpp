@@ -45,6 +45,7 @@
 #include "filter/dropshadow/dropshadowfilter.h"
 #include "filter/mosaic/mosaicfilternode.h"
 #include "filter/stroke/stroke.h"
+#include "generator/formationoverlay/formationoverlay.h"
 #include "generator/matrix/matrix.h"
 #include "generator/noise/noise.h"
 #include "generator/polygon/polygon.h"
@@ -309,6 +310,8 @@ Node *NodeFactory::CreateFromFactoryIndex(const NodeFactory::InternalID &id)
     return new RippleDistortNode();
   case kMulticamNode:
     return new MultiCamNode();
+  case kFormationOverlayGenerator:
+    return new FormationOverlayGenerator();
 
   case kInternalNodeCount:
     break;
@@ -81,6 +81,7 @@ public:
     kTileDistort,
     kSwirlDistort,
     kMulticamNode,
+    kFormationOverlayGenerator,
 
     // Count value
     kInternalNodeCount
@@ -0,0 +1,355 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#include "formationoverlay.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QPainter>
+
+#include <algorithm>
+
+#include "node/project.h"
+
+namespace olive {
+
+#define super GeneratorWithMerge
+
+const QString FormationOverlayGenerator::kFormationsInput = QStringLiteral("formations_in");
+const QString FormationOverlayGenerator::kFieldSizeInput = QStringLiteral("field_size_in");
+const QString FormationOverlayGenerator::kHoldInput = QStringLiteral("hold_in");
+const QString FormationOverlayGenerator::kShowConnectionsInput = QStringLiteral("connections_in");
+const QString FormationOverlayGenerator::kShowLabelsInput = QStringLiteral("labels_in");
+const QString FormationOverlayGenerator::kShowCallsInput = QStringLiteral("calls_in");
+const QString FormationOverlayGenerator::kLineWidthInput = QStringLiteral("line_width_in");
+
+namespace {
+
+// Same palette as the live viewer overlay
+QColor FormationColor(const QString &type)
+{
+  static const QMap<QString, QColor> colors = {
+    {QStringLiteral("larry"), QColor(50, 150, 255)},
+    {QStringLiteral("linda"), QColor(255, 100, 150)},
+    {QStringLiteral("rita"), QColor(150, 255, 100)},
+    {QStringLiteral("ricky"), QColor(255, 150, 50)},
+    {QStringLiteral("randy"), QColor(200, 100, 255)},
+    {QStringLiteral("pat"), QColor(150, 150, 150)},
+  };
+  return colors.value(type.toLower(), QColor(100, 100, 100));
+}
+
+QColor CallColor(const QString &call)
+{
+  static const QMap<QString, QColor> colors = {
+    {QStringLiteral("strong side"), QColor(255, 50, 50)},
+    {QStringLiteral("weak side"), QColor(50, 255, 50)},
+    {QStringLiteral("middle hash"), QColor(255, 255, 50)},
+    {QStringLiteral("left hash"), QColor(50, 50, 255)},
+    {QStringLiteral("right hash"), QColor(255, 50, 255)},
+    {QStringLiteral("red zone"), QColor(255, 100, 0)},
+    {QStringLiteral("goal line"), QColor(150, 0, 0)},
+  };
+  return colors.value(call.toLower(), QColor(128, 128, 128));
+}
+
+QPolygonF ConvexHull(QVector<QPointF> points)
+{
+  if (points.size() < 3) {
+    return QPolygonF(points);
+  }
+
+  std::sort(points.begin(), points.end(), [](const QPointF &a, const QPointF &b){
+    return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+  });
+
+  auto cross = [](const QPointF &o, const QPointF &a, const QPointF &b){
+    return (a.x() - o.x()) * (b.y() - o.y()) - (a.y() - o.y()) * (b.x() - o.x());
+  };
+
+  // Andrew's monotone chain
+  QVector<QPointF> hull(points.size() * 2);
+  int k = 0;
+  for (int i=0; i<points.size(); i++) {
+    while (k >= 2 && cross(hull[k-2], hull[k-1], points[i]) <= 0) k--;
+    hull[k++] = points[i];
+  }
+  for (int i=points.size()-2, t=k+1; i>=0; i--) {
+    while (k >= t && cross(hull[k-2], hull[k-1], points[i]) <= 0) k--;
+    hull[k++] = points[i];
+  }
+  hull.resize(k - 1);
+
+  return QPolygonF(hull);
+}
+
+}
+
+FormationOverlayGenerator::FormationOverlayGenerator()
+{
+  AddInput(kFormationsInput, NodeValue::kFile, QString(), InputFlags(kInputFlagNotConnectable | kInputFlagNotKeyframable));
+
+  AddInput(kFieldSizeInput, NodeValue::kVec2, QVector2D(120.0f, 53.3f), InputFlags(kInputFlagNotKeyframable));
+
+  AddInput(kHoldInput, NodeValue::kInt, 3000, InputFlags(kInputFlagNotKeyframable));
+  SetInputProperty(kHoldInput, QStringLiteral("min"), 0);
+
+  AddInput(kShowConnectionsInput, NodeValue::kBoolean, true);
+
+  AddInput(kShowLabelsInput, NodeValue::kBoolean, true);
+
+  AddInput(kShowCallsInput, NodeValue::kBoolean, true);
+
+  AddInput(kLineWidthInput, NodeValue::kFloat, 4.0);
+  SetInputProperty(kLineWidthInput, QStringLiteral("min"), 0.0);
+}
+
+QString FormationOverlayGenerator::Name() const
+{
+  return tr("Formation Overlay");
+}
+
+QString FormationOverlayGenerator::id() const
+{
+  return QStringLiteral("org.olivevideoeditor.Olive.formationoverlay");
+}
+
+QVector<Node::CategoryID> FormationOverlayGenerator::Category() const
+{
+  return {kCategoryGenerator};
+}
+
+QString FormationOverlayGenerator::Description() const
+{
+  return tr("Draw detected formations, player positions and Triangle Defense calls synced to the timeline.");
+}
+
+void FormationOverlayGenerator::Retranslate()
+{
+  super::Retranslate();
+
+  SetInputName(kFormationsInput, tr("Formation Track"));
+  SetInputName(kFieldSizeInput, tr("Field Size"));
+  SetInputName(kHoldInput, tr("Hold (ms)"));
+  SetInputName(kShowConnectionsInput, tr("Show Connections"));
+  SetInputName(kShowLabelsInput, tr("Show Labels"));
+  SetInputName(kShowCallsInput, tr("Show Calls"));
+  SetInputName(kLineWidthInput, tr("Line Width"));
+}
+
+void FormationOverlayGenerator::Value(const NodeValueRow &value, const NodeGlobals &globals, NodeValueTable *table) const
+{
+  qint64 time_ms = qRound64(globals.time().in().toDouble() * 1000.0);
+  QJsonObject formation = ActiveFormation(value[kFormationsInput].toString(), time_ms, value[kHoldInput].toInt());
+
+  if (!formation.isEmpty()) {
+    TexturePtr base = value[kBaseInput].toTexture();
+
+    VideoParams overlay_params = base ? base->params() : globals.vparams();
+    overlay_params.set_format(PixelFormat::U8);
+    overlay_params.set_colorspace(project()->color_manager()->GetDefaultInputColorSpace());
+
+    // Replace the whole track with just this formation so the job hash
+    // changes only when what is drawn does
+    GenerateJob job(value);
+    job.Insert(kFormationsInput, NodeValue(NodeValue::kText, QString::fromUtf8(QJsonDocument(formation).toJson(QJsonDocument::Compact))));
+
+    PushMergableJob(value, Texture::Job(overlay_params, job), table);
+  } else if (value[kBaseInput].toTexture()) {
+    table->Push(value[kBaseInput]);
+  }
+}
+
+void FormationOverlayGenerator::GenerateFrame(FramePtr frame, const GenerateJob &job) const
+{
+  QImage img(reinterpret_cast<uchar*>(frame->data()), frame->width(), frame->height(), frame->linesize_bytes(), QImage::Format_RGBA8888_Premultiplied);
+  img.fill(Qt::transparent);
+
+  QJsonObject formation = QJsonDocument::fromJson(job.Get(kFormationsInput).toString().toUtf8()).object();
+  QVector2D field_size = job.Get(kFieldSizeInput).toVec2();
+  if (field_size.x() <= 0 || field_size.y() <= 0) {
+    return;
+  }
+
+  const VideoParams &vp = frame->video_params();
+  double sx = vp.width() / field_size.x();
+  double sy = vp.height() / field_size.y();
+  auto to_frame = [sx, sy](double x, double y){
+    return QPointF(x * sx, y * sy);
+  };
+
+  QPainter p(&img);
+  p.setRenderHint(QPainter::Antialiasing);
+  p.scale(1.0 / vp.divider(), 1.0 / vp.divider());
+
+  // Sizes follow frame height so 720p and 4K exports look the same
+  double unit = vp.height() / 1080.0;
+  double line_width = job.Get(kLineWidthInput).toDouble() * unit;
+  double marker_radius = 9.0 * unit;
+  bool show_labels = job.Get(kShowLabelsInput).toBool();
+
+  QFont font = p.font();
+  font.setBold(true);
+  font.setPixelSize(qMax(1, qRound(22.0 * unit)));
+  p.setFont(font);
+
+  QColor color = FormationColor(formation.value(QStringLiteral("formation_type")).toString());
+
+  QVector<QPointF> players;
+  QStringList labels;
+  const QJsonArray player_array = formation.value(QStringLiteral("player_positions")).toObject().value(QStringLiteral("players")).toArray();
+  for (const QJsonValue &v : player_array) {
+    QJsonObject player = v.toObject();
+    players.append(to_frame(player.value(QStringLiteral("x")).toDouble(), player.value(QStringLiteral("y")).toDouble()));
+    labels.append(player.value(QStringLiteral("position")).toString());
+  }
+
+  // Formation shape
+  QPolygonF hull = ConvexHull(players);
+  if (hull.size() >= 3) {
+    QColor fill = color;
+    fill.setAlpha(48);
+    p.setPen(QPen(color, line_width, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin));
+    p.setBrush(fill);
+    p.drawPolygon(hull);
+  }
+
+  // Connect every player to its nearest teammate
+  if (job.Get(kShowConnectionsInput).toBool() && players.size() > 1) {
+    QColor connection = color;
+    connection.setAlpha(160);
+    p.setPen(QPen(connection, line_width * 0.5, Qt::DashLine, Qt::RoundCap));
+    QVector<int> nearest(players.size(), -1);
+    for (int i=0; i<players.size(); i++) {
+      double nearest_dist = 0;
+      for (int j=0; j<players.size(); j++) {
+        if (j != i) {
+          QPointF d = players[j] - players[i];
+          double dist = QPointF::dotProduct(d, d);
+          if (nearest[i] == -1 || dist < nearest_dist) {
+            nearest[i] = j;
+            nearest_dist = dist;
+          }
+        }
+      }
+    }
+
+    // Mutual nearest pairs are drawn once
+    for (int i=0; i<players.size(); i++) {
+      int j = nearest[i];
+      if (j > i || nearest[j] != i) {
+        p.drawLine(players[i], players[j]);
+      }
+    }
+  }
+
+  // Player markers
+  p.setPen(QPen(color.darker(150), qMax(1.0, unit * 2.0)));
+  p.setBrush(color);
+  for (const QPointF &pt : players) {
+    p.drawEllipse(pt, marker_radius, marker_radius);
+  }
+
+  if (show_labels) {
+    p.setPen(Qt::white);
+    for (int i=0; i<players.size(); i++) {
+      if (!labels.at(i).isEmpty()) {
+        p.drawText(players[i] + QPointF(marker_radius * 1.5, marker_radius * 0.5), labels.at(i));
+      }
+    }
+
+    if (hull.size() >= 3) {
+      QString label = QStringLiteral("%1 %2%").arg(formation.value(QStringLiteral("formation_type")).toString(),
+                                                 QString::number(qRound(formation.value(QStringLiteral("confidence")).toDouble() * 100)));
+      QRectF bounds = hull.boundingRect();
+      QRectF text_rect = p.fontMetrics().boundingRect(label);
+      text_rect.moveCenter(QPointF(bounds.center().x(), bounds.top() - text_rect.height()));
+      p.setPen(color);
+      p.drawText(text_rect, Qt::AlignCenter, label);
+    }
+  }
+
+  // Triangle Defense call, as a tagged banner in the top left corner
+  QString call = formation.value(QStringLiteral("recommended_call")).toString();
+  if (job.Get(kShowCallsInput).toBool() && !call.isEmpty() && call.compare(QStringLiteral("No Call"), Qt::CaseInsensitive) != 0) {
+    QColor call_color = CallColor(call);
+    double margin = 24.0 * unit;
+    double glyph = p.fontMetrics().height();
+
+    QRectF text_rect = p.fontMetrics().boundingRect(call);
+    QRectF banner(margin, margin, glyph * 1.5 + text_rect.width() + margin, glyph + margin * 0.5);
+
+    p.setPen(Qt::NoPen);
+    p.setBrush(QColor(0, 0, 0, 160));
+    p.drawRoundedRect(banner, 6.0 * unit, 6.0 * unit);
+
+    QPointF glyph_origin = banner.topLeft() + QPointF(margin * 0.5, margin * 0.25);
+    QPolygonF triangle;
+    triangle << glyph_origin + QPointF(glyph * 0.5, 0)
+             << glyph_origin + QPointF(glyph, glyph)
+             << glyph_origin + QPointF(0, glyph);
+    p.setBrush(call_color);
+    p.drawPolygon(triangle);
+
+    p.setPen(call_color);
+    p.drawText(QRectF(glyph_origin.x() + glyph * 1.5, banner.top(), text_rect.width() + margin, banner.height()),
+               Qt::AlignVCenter | Qt::AlignLeft, call);
+  }
+}
+
+QJsonObject FormationOverlayGenerator::ActiveFormation(const QString &filename, qint64 time_ms, qint64 hold_ms) const
+{
+  QMutexLocker locker(&track_lock_);
+
+  QDateTime modified = QFileInfo(filename).lastModified();
+  if (filename != track_filename_ || modified != track_modified_) {
+    track_filename_ = filename;
+    track_modified_ = modified;
+    track_.clear();
+
+    QFile file(filename);
+    if (!file.open(QFile::ReadOnly)) {
+      return QJsonObject();
+    }
+
+    const QJsonArray array = QJsonDocument::fromJson(file.readAll()).array();
+    for (const QJsonValue &v : array) {
+      QJsonObject formation = v.toObject();
+      track_.insert(formation.value(QStringLiteral("video_timestamp")).toVariant().toLongLong(), formation);
+    }
+  }
+
+  // Latest formation at or before this time
+  auto it = track_.upperBound(time_ms);
+  if (it == track_.constBegin()) {
+    return QJsonObject();
+  }
+  --it;
+
+  if (time_ms - it.key() > hold_ms) {
+    return QJsonObject();
+  }
+
+  return it.value();
+}
+
+}
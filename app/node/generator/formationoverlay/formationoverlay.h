@@ -0,0 +1,86 @@
+/***
+
+  Olive - Non-Linear Video Editor
+  Copyright (C) 2022 Olive Team
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+***/
+
+#ifndef FORMATIONOVERLAYGENERATOR_H
+#define FORMATIONOVERLAYGENERATOR_H
+
+#include <QDateTime>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+
+#include "node/generator/shape/generatorwithmerge.h"
+
+namespace olive {
+
+/**
+ * @brief Burns formation annotations into the frame
+ *
+ * The formations input is a JSON file holding an array of timeline-synced
+ * formations, as TriangleDefenseSync::SaveFormationTrack() writes it (id,
+ * formation_type, recommended_call, confidence, video_timestamp in
+ * milliseconds of node time, and player_positions.players with field
+ * coordinates). Each frame draws the latest formation that is at most
+ * the hold time old. The file is read again when it changes on disk.
+ *
+ * Only the active formation goes into the generate job, so frames that
+ * show the same formation hash the same and share cache entries.
+ */
+class FormationOverlayGenerator : public GeneratorWithMerge
+{
+  Q_OBJECT
+public:
+  FormationOverlayGenerator();
+
+  NODE_DEFAULT_FUNCTIONS(FormationOverlayGenerator)
+
+  virtual QString Name() const override;
+  virtual QString id() const override;
+  virtual QVector<CategoryID> Category() const override;
+  virtual QString Description() const override;
+
+  virtual void Retranslate() override;
+
+  virtual void Value(const NodeValueRow& value, const NodeGlobals &globals, NodeValueTable *table) const override;
+
+  virtual void GenerateFrame(FramePtr frame, const GenerateJob &job) const override;
+
+  static const QString kFormationsInput;
+  static const QString kFieldSizeInput;
+  static const QString kHoldInput;
+  static const QString kShowConnectionsInput;
+  static const QString kShowLabelsInput;
+  static const QString kShowCallsInput;
+  static const QString kLineWidthInput;
+
+private:
+  QJsonObject ActiveFormation(const QString &filename, qint64 time_ms, qint64 hold_ms) const;
+
+  // Parsed form of the formations file, rebuilt when the file changes
+  mutable QMutex track_lock_;
+  mutable QString track_filename_;
+  mutable QDateTime track_modified_;
+  mutable QMap<qint64, QJsonObject> track_;
+
+};
+
+}
+
+#endif // FORMATIONOVERLAYGENERATOR_H
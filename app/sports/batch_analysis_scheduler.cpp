@@ -0,0 +1,588 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Batch Analysis Scheduler Implementation
+***/
+
+#include "batch_analysis_scheduler.h"
+
+#include <QDebug>
+#include <QThread>
+#include <QTimer>
+
+namespace olive {
+
+namespace {
+
+// Long enough for a full game film upload on a slow uplink
+constexpr int kDefaultPendingTimeoutMs = 60 * 60 * 1000;
+
+// Stage graph, in topological order
+const ProcessingStage kStages[BatchAnalysisScheduler::kStageCount] = {
+  ProcessingStage::VideoUpload,
+  ProcessingStage::MetadataExtraction,
+  ProcessingStage::FormationDetection,
+  ProcessingStage::MELProcessing,
+  ProcessingStage::DashboardSync
+};
+
+// Bit i set means the stage needs kStages[i] first
+const quint32 kDependencies[BatchAnalysisScheduler::kStageCount] = {
+  0,                     // VideoUpload
+  0,                     // MetadataExtraction
+  1u << 1,               // FormationDetection <- MetadataExtraction
+  1u << 2,               // MELProcessing <- FormationDetection
+  (1u << 0) | (1u << 3)  // DashboardSync <- VideoUpload, MELProcessing
+};
+
+int StageIndex(ProcessingStage stage)
+{
+  for (int i = 0; i < BatchAnalysisScheduler::kStageCount; i++) {
+    if (kStages[i] == stage) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+} // namespace
+
+BatchAnalysisScheduler::BatchAnalysisScheduler(QObject* parent)
+  : QObject(parent)
+  , pending_timeout_ms_(kDefaultPendingTimeoutMs)
+  , window_start_(0)
+  , videos_completed_(0)
+  , videos_failed_(0)
+{
+  // Inference already spreads each frame batch over several cores, so two
+  // detections at a time keep the compute slots busy without thrashing
+  int cores = qMax(1, QThread::idealThreadCount());
+  stage_caps_[StageIndex(ProcessingStage::VideoUpload)] = 3;
+  stage_caps_[StageIndex(ProcessingStage::MetadataExtraction)] = 2;
+  stage_caps_[StageIndex(ProcessingStage::FormationDetection)] = qMax(1, qMin(2, cores / 2));
+  stage_caps_[StageIndex(ProcessingStage::MELProcessing)] = qMax(1, cores / 2);
+  stage_caps_[StageIndex(ProcessingStage::DashboardSync)] = 4;
+
+  resource_caps_[kDiskResource] = 2;
+  resource_caps_[kComputeResource] = cores;
+  resource_caps_[kNetworkResource] = 6;
+
+  stage_running_.fill(0);
+  stage_busy_ms_.fill(0);
+  resource_running_.fill(0);
+  resource_busy_ms_.fill(0);
+
+  pool_.setObjectName("BatchAnalysisScheduler");
+  UpdatePoolSize();
+
+  clock_.start();
+}
+
+BatchAnalysisScheduler::~BatchAnalysisScheduler()
+{
+  Clear();
+}
+
+void BatchAnalysisScheduler::SetStageRunner(const StageRunner& runner)
+{
+  QMutexLocker locker(&mutex_);
+  runner_ = runner;
+}
+
+void BatchAnalysisScheduler::SetStageConcurrency(ProcessingStage stage, int max_running)
+{
+  int index = StageIndex(stage);
+  if (index < 0) {
+    return;
+  }
+
+  {
+    QMutexLocker locker(&mutex_);
+    stage_caps_[index] = qMax(1, max_running);
+  }
+  Dispatch();
+}
+
+void BatchAnalysisScheduler::SetResourceConcurrency(Resource resource, int max_running)
+{
+  {
+    QMutexLocker locker(&mutex_);
+    resource_caps_[resource] = qMax(1, max_running);
+    UpdatePoolSize();
+  }
+  Dispatch();
+}
+
+void BatchAnalysisScheduler::SetPendingTimeout(int timeout_ms)
+{
+  QMutexLocker locker(&mutex_);
+  pending_timeout_ms_ = qMax(0, timeout_ms);
+}
+
+void BatchAnalysisScheduler::Submit(const QString& video_id)
+{
+  {
+    QMutexLocker locker(&mutex_);
+
+    if (jobs_.contains(video_id)) {
+      return;
+    }
+
+    // A new batch starts a new utilization window
+    if (jobs_.isEmpty()) {
+      window_start_ = clock_.elapsed();
+      stage_busy_ms_.fill(0);
+      resource_busy_ms_.fill(0);
+    }
+
+    VideoJob job;
+    job.state.fill(kTaskWaiting);
+    job.ready_at.fill(-1);
+    job.started_at.fill(-1);
+    job.finished_at.fill(-1);
+    jobs_.insert(video_id, job);
+    job_order_.append(video_id);
+  }
+
+  Dispatch();
+}
+
+void BatchAnalysisScheduler::FinishStage(const QString& video_id, ProcessingStage stage, bool success)
+{
+  int index = StageIndex(stage);
+  if (index < 0) {
+    return;
+  }
+
+  bool report = false;
+  QJsonObject metrics;
+  bool completed = false;
+  bool failed = false;
+
+  {
+    QMutexLocker locker(&mutex_);
+
+    // A timed-out stage's video has already failed, so its late report only
+    // gives the slot back. One that timed out before its video was submitted
+    // again is the older run and is matched first.
+    auto expired = expired_stages_.find(qMakePair(video_id, index));
+    if (expired != expired_stages_.end()) {
+      ReleaseSlot(index, expired.value());
+      expired_stages_.erase(expired);
+      locker.unlock();
+      Dispatch();
+      return;
+    }
+
+    auto it = jobs_.find(video_id);
+    if (it == jobs_.end() || it->state[index] != kTaskRunning) {
+      return;
+    }
+    VideoJob& job = it.value();
+
+    qint64 now = clock_.elapsed();
+    ReleaseSlot(index, job.started_at[index]);
+
+    job.state[index] = success ? kTaskDone : kTaskFailed;
+    job.finished_at[index] = now;
+    report = !job.cancelled;
+    metrics["queued_ms"] = job.started_at[index] - job.ready_at[index];
+    metrics["run_ms"] = now - job.started_at[index];
+
+    if (!success && !job.cancelled) {
+      job.cancelled = true;
+      failed = true;
+      videos_failed_++;
+      for (int i = 0; i < kStageCount; i++) {
+        if (job.state[i] == kTaskWaiting) {
+          job.state[i] = kTaskCancelled;
+        }
+      }
+    }
+
+    if (!job.cancelled) {
+      completed = true;
+      for (int i = 0; i < kStageCount; i++) {
+        if (job.state[i] != kTaskDone) {
+          completed = false;
+          break;
+        }
+      }
+      if (completed) {
+        videos_completed_++;
+      }
+    }
+
+    // Keep a finished or cancelled video until its last running stage returns
+    if (completed || (job.cancelled && RunningStages(job) == 0)) {
+      jobs_.erase(it);
+      job_order_.removeOne(video_id);
+    }
+  }
+
+  if (report) {
+    emit StageFinished(video_id, stage, success, metrics);
+  }
+  if (failed) {
+    qWarning() << "Batch analysis stage failed:" << video_id << StageName(stage);
+    emit VideoFailed(video_id, stage);
+  }
+  if (completed) {
+    emit VideoCompleted(video_id);
+  }
+
+  Dispatch();
+}
+
+void BatchAnalysisScheduler::Cancel(const QString& video_id)
+{
+  QMutexLocker locker(&mutex_);
+
+  auto it = jobs_.find(video_id);
+  if (it == jobs_.end()) {
+    return;
+  }
+
+  it->cancelled = true;
+  for (int i = 0; i < kStageCount; i++) {
+    if (it->state[i] == kTaskWaiting) {
+      it->state[i] = kTaskCancelled;
+    }
+  }
+
+  if (RunningStages(it.value()) == 0) {
+    jobs_.erase(it);
+    job_order_.removeOne(video_id);
+  }
+}
+
+void BatchAnalysisScheduler::Clear()
+{
+  {
+    QMutexLocker locker(&mutex_);
+    for (const QString& video_id : job_order_) {
+      VideoJob& job = jobs_[video_id];
+      job.cancelled = true;
+      for (int i = 0; i < kStageCount; i++) {
+        if (job.state[i] == kTaskWaiting) {
+          job.state[i] = kTaskCancelled;
+        }
+      }
+    }
+  }
+
+  pool_.waitForDone();
+
+  // Pending stages never report back once their video is gone
+  QMutexLocker locker(&mutex_);
+  jobs_.clear();
+  job_order_.clear();
+  expired_stages_.clear();
+  stage_running_.fill(0);
+  resource_running_.fill(0);
+}
+
+bool BatchAnalysisScheduler::Contains(const QString& video_id) const
+{
+  QMutexLocker locker(&mutex_);
+  return jobs_.contains(video_id);
+}
+
+QJsonObject BatchAnalysisScheduler::Utilization() const
+{
+  QMutexLocker locker(&mutex_);
+
+  qint64 now = clock_.elapsed();
+  qint64 window = qMax<qint64>(1, now - window_start_);
+
+  // Count running stages up to now, not just finished ones
+  std::array<qint64, kStageCount> stage_busy = stage_busy_ms_;
+  std::array<qint64, kResourceCount> resource_busy = resource_busy_ms_;
+  std::array<int, kStageCount> stage_ready;
+  stage_ready.fill(0);
+
+  int videos_active = 0;
+  for (auto it = jobs_.constBegin(); it != jobs_.constEnd(); ++it) {
+    const VideoJob& job = it.value();
+    bool active = false;
+    for (int i = 0; i < kStageCount; i++) {
+      if (job.state[i] == kTaskRunning) {
+        qint64 busy = now - qMax(job.started_at[i], window_start_);
+        stage_busy[i] += busy;
+        resource_busy[StageResource(kStages[i])] += busy;
+        active = true;
+      } else if (job.state[i] == kTaskDone) {
+        active = true;
+      } else if (!job.cancelled && IsReady(job, i)) {
+        stage_ready[i]++;
+      }
+    }
+    if (active) {
+      videos_active++;
+    }
+  }
+  for (auto it = expired_stages_.constBegin(); it != expired_stages_.constEnd(); ++it) {
+    qint64 busy = now - qMax(it.value(), window_start_);
+    stage_busy[it.key().second] += busy;
+    resource_busy[StageResource(kStages[it.key().second])] += busy;
+  }
+
+  QJsonObject stages;
+  for (int i = 0; i < kStageCount; i++) {
+    QJsonObject stage;
+    stage["resource"] = ResourceName(StageResource(kStages[i]));
+    stage["running"] = stage_running_[i];
+    stage["max_running"] = stage_caps_[i];
+    stage["ready"] = stage_ready[i];
+    stage["busy_ms"] = stage_busy[i];
+    stage["utilization"] = static_cast<double>(stage_busy[i]) / (static_cast<double>(window) * stage_caps_[i]);
+    stages[StageName(kStages[i])] = stage;
+  }
+
+  QJsonObject resources;
+  for (int i = 0; i < kResourceCount; i++) {
+    QJsonObject resource;
+    resource["running"] = resource_running_[i];
+    resource["max_running"] = resource_caps_[i];
+    resource["busy_ms"] = resource_busy[i];
+    resource["utilization"] = static_cast<double>(resource_busy[i]) / (static_cast<double>(window) * resource_caps_[i]);
+    resources[ResourceName(static_cast<Resource>(i))] = resource;
+  }
+
+  QJsonObject utilization;
+  utilization["window_ms"] = window;
+  utilization["videos_queued"] = jobs_.size() - videos_active;
+  utilization["videos_active"] = videos_active;
+  utilization["videos_completed"] = videos_completed_;
+  utilization["videos_failed"] = videos_failed_;
+  utilization["stages"] = stages;
+  utilization["resources"] = resources;
+  return utilization;
+}
+
+QString BatchAnalysisScheduler::StageName(ProcessingStage stage)
+{
+  switch (stage) {
+    case ProcessingStage::VideoUpload: return "video_upload";
+    case ProcessingStage::MetadataExtraction: return "metadata_extraction";
+    case ProcessingStage::FormationDetection: return "formation_detection";
+    case ProcessingStage::MELProcessing: return "mel_processing";
+    case ProcessingStage::TriangleAnalysis: return "triangle_analysis";
+    case ProcessingStage::FabricatorGeneration: return "fabricator_generation";
+    case ProcessingStage::DashboardSync: return "dashboard_sync";
+    case ProcessingStage::Complete: return "complete";
+  }
+  return "unknown";
+}
+
+QString BatchAnalysisScheduler::ResourceName(Resource resource)
+{
+  switch (resource) {
+    case kDiskResource: return "disk";
+    case kComputeResource: return "compute";
+    case kNetworkResource: return "network";
+    case kResourceCount: break;
+  }
+  return "unknown";
+}
+
+BatchAnalysisScheduler::Resource BatchAnalysisScheduler::StageResource(ProcessingStage stage)
+{
+  switch (stage) {
+    case ProcessingStage::VideoUpload:
+    case ProcessingStage::DashboardSync:
+      return kNetworkResource;
+    case ProcessingStage::MetadataExtraction:
+      return kDiskResource;
+    default:
+      return kComputeResource;
+  }
+}
+
+void BatchAnalysisScheduler::Dispatch()
+{
+  StageRunner runner;
+  QVector<Launch> launches;
+  {
+    QMutexLocker locker(&mutex_);
+    runner = runner_;
+    launches = CollectReadyStages();
+  }
+
+  for (const Launch& launch : launches) {
+    emit StageStarted(launch.video_id, launch.stage);
+
+    QString video_id = launch.video_id;
+    ProcessingStage stage = launch.stage;
+    pool_.start([this, runner, video_id, stage]() {
+      StageResult result = runner ? runner(video_id, stage) : kStageSucceeded;
+      if (result == kStagePending) {
+        WatchPendingStage(video_id, stage);
+      } else {
+        FinishStage(video_id, stage, result == kStageSucceeded);
+      }
+    });
+  }
+}
+
+void BatchAnalysisScheduler::WatchPendingStage(const QString& video_id, ProcessingStage stage)
+{
+  int index = StageIndex(stage);
+  int timeout_ms;
+  qint64 started_at;
+  {
+    QMutexLocker locker(&mutex_);
+    auto it = jobs_.constFind(video_id);
+    if (it == jobs_.constEnd() || it->state[index] != kTaskRunning || pending_timeout_ms_ <= 0) {
+      return;
+    }
+    timeout_ms = pending_timeout_ms_;
+    started_at = it->started_at[index];
+  }
+
+  // Pool threads have no event loop, so the timer lives on the scheduler's
+  // thread. started_at tells a stage apart from a later run of the same one.
+  QMetaObject::invokeMethod(this, [this, video_id, stage, timeout_ms, started_at]() {
+    QTimer::singleShot(timeout_ms, this, [this, video_id, stage, started_at]() {
+      ExpirePendingStage(video_id, stage, started_at);
+    });
+  }, Qt::QueuedConnection);
+}
+
+void BatchAnalysisScheduler::ExpirePendingStage(const QString& video_id, ProcessingStage stage, qint64 started_at)
+{
+  int index = StageIndex(stage);
+  bool report = false;
+  QJsonObject metrics;
+  bool failed = false;
+
+  {
+    QMutexLocker locker(&mutex_);
+    auto it = jobs_.find(video_id);
+    if (it == jobs_.end() || it->state[index] != kTaskRunning || it->started_at[index] != started_at) {
+      return;
+    }
+    VideoJob& job = it.value();
+
+    // Fail the stage now, but the upload behind it is still using the
+    // network, so the slot is only released by the late FinishStage()
+    qint64 now = clock_.elapsed();
+    expired_stages_.insert(qMakePair(video_id, index), started_at);
+
+    job.state[index] = kTaskFailed;
+    job.finished_at[index] = now;
+    report = !job.cancelled;
+    metrics["queued_ms"] = job.started_at[index] - job.ready_at[index];
+    metrics["run_ms"] = now - job.started_at[index];
+
+    if (!job.cancelled) {
+      job.cancelled = true;
+      failed = true;
+      videos_failed_++;
+      for (int i = 0; i < kStageCount; i++) {
+        if (job.state[i] == kTaskWaiting) {
+          job.state[i] = kTaskCancelled;
+        }
+      }
+    }
+
+    if (RunningStages(job) == 0) {
+      jobs_.erase(it);
+      job_order_.removeOne(video_id);
+    }
+  }
+
+  qWarning() << "Batch analysis stage timed out:" << video_id << StageName(stage);
+  if (report) {
+    emit StageFinished(video_id, stage, false, metrics);
+  }
+  if (failed) {
+    emit VideoFailed(video_id, stage);
+  }
+}
+
+QVector<BatchAnalysisScheduler::Launch> BatchAnalysisScheduler::CollectReadyStages()
+{
+  // Requires mutex_
+  QVector<Launch> launches;
+  qint64 now = clock_.elapsed();
+
+  // Oldest video first, so films finish in submission order when contended
+  for (const QString& video_id : job_order_) {
+    VideoJob& job = jobs_[video_id];
+    if (job.cancelled) {
+      continue;
+    }
+
+    for (int i = 0; i < kStageCount; i++) {
+      if (!IsReady(job, i)) {
+        continue;
+      }
+      if (job.ready_at[i] < 0) {
+        job.ready_at[i] = now;
+      }
+
+      Resource resource = StageResource(kStages[i]);
+      if (stage_running_[i] >= stage_caps_[i] || resource_running_[resource] >= resource_caps_[resource]) {
+        continue;
+      }
+
+      job.state[i] = kTaskRunning;
+      job.started_at[i] = now;
+      stage_running_[i]++;
+      resource_running_[resource]++;
+      launches.append({video_id, kStages[i]});
+    }
+  }
+
+  return launches;
+}
+
+bool BatchAnalysisScheduler::IsReady(const VideoJob& job, int stage) const
+{
+  if (job.state[stage] != kTaskWaiting) {
+    return false;
+  }
+  for (int i = 0; i < kStageCount; i++) {
+    if ((kDependencies[stage] & (1u << i)) && job.state[i] != kTaskDone) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int BatchAnalysisScheduler::RunningStages(const VideoJob& job) const
+{
+  int running = 0;
+  for (int i = 0; i < kStageCount; i++) {
+    if (job.state[i] == kTaskRunning) {
+      running++;
+    }
+  }
+  return running;
+}
+
+void BatchAnalysisScheduler::ReleaseSlot(int stage, qint64 started_at)
+{
+  // Requires mutex_
+  qint64 busy = clock_.elapsed() - qMax(started_at, window_start_);
+  Resource resource = StageResource(kStages[stage]);
+  stage_running_[stage]--;
+  resource_running_[resource]--;
+  stage_busy_ms_[stage] += busy;
+  resource_busy_ms_[resource] += busy;
+}
+
+void BatchAnalysisScheduler::UpdatePoolSize()
+{
+  // Requires mutex_. Pending stages hold a slot but not a thread, so this
+  // only ever over-provisions.
+  int threads = 0;
+  for (int cap : resource_caps_) {
+    threads += cap;
+  }
+  pool_.setMaxThreadCount(threads);
+}
+
+} // namespace olive
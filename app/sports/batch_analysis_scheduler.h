@@ -0,0 +1,186 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Batch Analysis Scheduler
+  Interleaves pipeline stages from many queued videos across disk, compute and network
+***/
+
+#ifndef BATCHANALYSISSCHEDULER_H
+#define BATCHANALYSISSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QVector>
+
+#include <array>
+#include <functional>
+
+#include "sports_integration.h"
+
+namespace olive {
+
+/**
+ * @brief Runs the batch analysis stages of many videos as one DAG
+ *
+ * Each submitted video contributes the stage graph
+ *
+ *   VideoUpload ----------------------------------------+
+ *   MetadataExtraction -> FormationDetection -> MELProcessing -> DashboardSync
+ *
+ * and every stage draws on one resource: decoding for metadata is disk
+ * bound, formation detection and M.E.L. are compute bound, upload and
+ * dashboard sync are network bound. Whenever a slot frees up the scheduler
+ * starts the oldest video's ready stage that fits both its stage cap and
+ * its resource cap, so one film's upload overlaps another's inference and
+ * a third's decode instead of each film running start to finish.
+ *
+ * Stages run on the scheduler's own thread pool through the stage runner.
+ * A runner that only kicks off asynchronous work (an upload) returns
+ * kStagePending and reports back through FinishStage(); the stage keeps its
+ * slot until then, and fails if that takes longer than the pending timeout.
+ * The work behind a timed-out stage is still going, so its slot stays taken
+ * until the late FinishStage() arrives. A failed stage cancels the rest of
+ * that video's graph.
+ *
+ * Utilization is busy slot time over capacity since the scheduler last went
+ * from idle to busy. Signals may be emitted from pool threads. All methods
+ * are thread-safe.
+ */
+class BatchAnalysisScheduler : public QObject
+{
+  Q_OBJECT
+
+public:
+  enum Resource {
+    kDiskResource,
+    kComputeResource,
+    kNetworkResource,
+    kResourceCount
+  };
+
+  enum StageResult {
+    kStageSucceeded,
+    kStageFailed,
+    kStagePending
+  };
+
+  using StageRunner = std::function<StageResult(const QString& video_id, ProcessingStage stage)>;
+
+  static constexpr int kStageCount = 5;
+
+  explicit BatchAnalysisScheduler(QObject* parent = nullptr);
+  virtual ~BatchAnalysisScheduler() override;
+
+  void SetStageRunner(const StageRunner& runner);
+
+  void SetStageConcurrency(ProcessingStage stage, int max_running);
+  void SetResourceConcurrency(Resource resource, int max_running);
+
+  /**
+   * @brief Fail pending stages not finished within timeout_ms; 0 waits forever
+   */
+  void SetPendingTimeout(int timeout_ms);
+
+  /**
+   * @brief Queue a video's stage graph; ignored if the video is already queued
+   */
+  void Submit(const QString& video_id);
+
+  /**
+   * @brief Complete a stage whose runner returned kStagePending
+   */
+  void FinishStage(const QString& video_id, ProcessingStage stage, bool success);
+
+  /**
+   * @brief Drop a video's unstarted stages; running stages finish unreported
+   */
+  void Cancel(const QString& video_id);
+
+  /**
+   * @brief Cancel every video and wait for running stages to return
+   */
+  void Clear();
+
+  bool Contains(const QString& video_id) const;
+
+  QJsonObject Utilization() const;
+
+  static QString StageName(ProcessingStage stage);
+  static QString ResourceName(Resource resource);
+  static Resource StageResource(ProcessingStage stage);
+
+signals:
+  void StageStarted(const QString& video_id, ProcessingStage stage);
+  /**
+   * @param metrics Time the stage spent ready but waiting for a slot, and running
+   */
+  void StageFinished(const QString& video_id, ProcessingStage stage, bool success, const QJsonObject& metrics);
+  void VideoCompleted(const QString& video_id);
+  void VideoFailed(const QString& video_id, ProcessingStage stage);
+
+private:
+  enum TaskState {
+    kTaskWaiting,
+    kTaskRunning,
+    kTaskDone,
+    kTaskFailed,
+    kTaskCancelled
+  };
+
+  struct VideoJob {
+    bool cancelled = false;
+    std::array<TaskState, kStageCount> state;
+    std::array<qint64, kStageCount> ready_at;
+    std::array<qint64, kStageCount> started_at;
+    std::array<qint64, kStageCount> finished_at;
+  };
+
+  struct Launch {
+    QString video_id;
+    ProcessingStage stage;
+  };
+
+  void Dispatch();
+  void WatchPendingStage(const QString& video_id, ProcessingStage stage);
+  void ExpirePendingStage(const QString& video_id, ProcessingStage stage, qint64 started_at);
+  QVector<Launch> CollectReadyStages();
+  bool IsReady(const VideoJob& job, int stage) const;
+  int RunningStages(const VideoJob& job) const;
+  void ReleaseSlot(int stage, qint64 started_at);
+  void UpdatePoolSize();
+
+  mutable QMutex mutex_;
+  QThreadPool pool_;
+  StageRunner runner_;
+
+  QHash<QString, VideoJob> jobs_;
+  QStringList job_order_;
+
+  // Timed-out pending stages by video and stage index, to when they started
+  QHash<QPair<QString, int>, qint64> expired_stages_;
+
+  std::array<int, kStageCount> stage_caps_;
+  std::array<int, kStageCount> stage_running_;
+  std::array<qint64, kStageCount> stage_busy_ms_;
+  std::array<int, kResourceCount> resource_caps_;
+  std::array<int, kResourceCount> resource_running_;
+  std::array<qint64, kResourceCount> resource_busy_ms_;
+  int pending_timeout_ms_;
+
+  QElapsedTimer clock_;
+  qint64 window_start_;
+  qint64 videos_completed_;
+  qint64 videos_failed_;
+};
+
+} // namespace olive
+
+#endif // BATCHANALYSISSCHEDULER_H
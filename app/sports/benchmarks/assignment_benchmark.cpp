@@ -0,0 +1,117 @@
+/**
+ * @file assignment_benchmark.cpp
+ * @brief Micro-benchmark for the formation assignment solver
+ *
+ * Times AssignmentSolver on random 8-11 player problems and checks the
+ * result against brute force on small problems. Exits non-zero when the
+ * per-pattern solve time exceeds the budget, so it can gate CI.
+ */
+
+#include "formation_assignment.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace amt::sports;
+
+namespace {
+
+constexpr double kBudgetMicroseconds = 5.0;
+constexpr int kIterations = 200000;
+
+void fillRandomCosts(AssignmentWorkspace& workspace, int rows, int cols, std::mt19937& rng) {
+    std::uniform_real_distribution<double> position(0.0, 1.0);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            workspace.cost[r][c] = position(rng);
+        }
+    }
+}
+
+double bruteForce(const AssignmentWorkspace& workspace, int rows, int cols) {
+    std::vector<int> columns(cols);
+    std::iota(columns.begin(), columns.end(), 0);
+    double best = INFINITY;
+    do {
+        double total = 0.0;
+        for (int r = 0; r < rows; ++r) {
+            total += workspace.cost[r][columns[r]];
+        }
+        best = std::min(best, total);
+    } while (std::next_permutation(columns.begin(), columns.end()));
+    return best;
+}
+
+bool verifyOptimality(std::mt19937& rng) {
+    AssignmentWorkspace workspace;
+    for (int trial = 0; trial < 200; ++trial) {
+        const int rows = 3 + trial % 4;
+        const int cols = rows + trial % 3;
+        fillRandomCosts(workspace, rows, cols, rng);
+        double solved = AssignmentSolver::solve(workspace, rows, cols);
+        double expected = bruteForce(workspace, rows, cols);
+        if (std::abs(solved - expected) > 1e-9) {
+            std::cerr << "[Assignment Benchmark] Non-optimal result for " << rows << "x" << cols
+                      << ": " << solved << " vs " << expected << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+double benchmark(int rows, int cols, std::mt19937& rng) {
+    // Pre-generate problems so only the solve is timed
+    const int problem_count = 64;
+    std::vector<AssignmentWorkspace> problems(problem_count);
+    for (auto& problem : problems) {
+        fillRandomCosts(problem, rows, cols, rng);
+    }
+
+    AssignmentWorkspace& workspace = AssignmentSolver::threadWorkspace();
+    double checksum = 0.0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < kIterations; ++i) {
+        const AssignmentWorkspace& problem = problems[i % problem_count];
+        for (int r = 0; r < rows; ++r) {
+            std::copy(problem.cost[r], problem.cost[r] + cols, workspace.cost[r]);
+        }
+        checksum += AssignmentSolver::solve(workspace, rows, cols);
+    }
+    auto elapsed = std::chrono::duration<double, std::micro>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    if (checksum < 0.0) {
+        std::cerr << "[Assignment Benchmark] Solver rejected " << rows << "x" << cols << std::endl;
+    }
+    return elapsed / kIterations;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(2024);
+
+    if (!verifyOptimality(rng)) {
+        return 1;
+    }
+    std::cout << "[Assignment Benchmark] Optimality verified against brute force" << std::endl;
+
+    bool within_budget = true;
+    const int sizes[][2] = {{8, 8}, {8, 11}, {11, 11}};
+    for (const auto& size : sizes) {
+        double per_solve = benchmark(size[0], size[1], rng);
+        std::cout << "[Assignment Benchmark] " << size[0] << " slots x " << size[1] << " players: "
+                  << per_solve << " us per pattern" << std::endl;
+        within_budget = within_budget && per_solve <= kBudgetMicroseconds;
+    }
+
+    if (!within_budget) {
+        std::cerr << "[Assignment Benchmark] Exceeded " << kBudgetMicroseconds << " us budget" << std::endl;
+        return 1;
+    }
+    return 0;
+}
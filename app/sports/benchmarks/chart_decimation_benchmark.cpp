@@ -0,0 +1,163 @@
+/**
+ * @file chart_decimation_benchmark.cpp
+ * @brief Dashboard chart render time against series length, raw and decimated
+ *
+ * Builds a season-long confidence trend (one sample per tracked frame
+ * segment, with occasional spikes) and renders it through a QChartView the
+ * size of a dashboard widget, first with every point in the series and
+ * then decimated to the plot width with each ChartDecimator method. Exits
+ * non-zero if a decimated min/max series loses a spike, or if a decimated
+ * render of the longest series exceeds the budget.
+ */
+
+#include "chart_decimation.h"
+
+#include <QApplication>
+#include <QChart>
+#include <QChartView>
+#include <QLineSeries>
+#include <QScatterSeries>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+using namespace olive;
+
+namespace {
+
+constexpr double kBudgetMilliseconds = 50.0;
+constexpr int kPlotWidth = 1200;
+constexpr int kPlotHeight = 600;
+
+QVector<QPointF> makeSeason(int count, std::mt19937& rng) {
+    std::normal_distribution<double> noise(0.0, 0.04);
+    QVector<QPointF> points;
+    points.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        double trend = 0.75 + 0.1 * std::sin(i * 0.0005);
+        double spike = (i % 9973 == 0) ? 0.2 : 0.0;
+        points.append(QPointF(i * 33.0, qBound(0.0, trend + noise(rng) + spike, 1.0)));
+    }
+    return points;
+}
+
+double maxY(const QVector<QPointF>& points, double x_min, double x_max) {
+    double result = -1.0;
+    for (const QPointF& point : points) {
+        if (point.x() >= x_min && point.x() <= x_max) {
+            result = std::max(result, point.y());
+        }
+    }
+    return result;
+}
+
+struct Measurement {
+    int rendered_points;
+    double decimate_ms;
+    double render_ms;
+};
+
+Measurement measure(QChartView& view, QXYSeries* series, const QVector<QPointF>& points,
+                    const ChartViewport& viewport, ChartDecimator::Method method, bool decimate) {
+    auto start = std::chrono::high_resolution_clock::now();
+    QVector<QPointF> shown = decimate ? ChartDecimator::Decimate(points, viewport, method) : points;
+    auto decimated = std::chrono::high_resolution_clock::now();
+
+    series->replace(shown);
+    view.grab();
+    auto rendered = std::chrono::high_resolution_clock::now();
+
+    Measurement result;
+    result.rendered_points = shown.size();
+    result.decimate_ms = std::chrono::duration<double, std::milli>(decimated - start).count();
+    result.render_ms = std::chrono::duration<double, std::milli>(rendered - decimated).count();
+    return result;
+}
+
+const char* methodName(ChartDecimator::Method method) {
+    switch (method) {
+        case ChartDecimator::kLargestTriangle: return "lttb";
+        case ChartDecimator::kMinMax: return "minmax";
+        case ChartDecimator::kPixelGrid: return "pixelgrid";
+    }
+    return "unknown";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Renders without a display unless a platform is forced
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    std::mt19937 rng(2024);
+
+    bool passed = true;
+    const int counts[] = {10000, 100000, 500000};
+    const ChartDecimator::Method methods[] = {ChartDecimator::kLargestTriangle, ChartDecimator::kMinMax,
+                                              ChartDecimator::kPixelGrid};
+
+    for (int count : counts) {
+        QVector<QPointF> points = makeSeason(count, rng);
+
+        for (ChartDecimator::Method method : methods) {
+            QChart* chart = new QChart();
+            chart->legend()->hide();
+            QXYSeries* series = nullptr;
+            if (method == ChartDecimator::kPixelGrid) {
+                series = new QScatterSeries();
+            } else {
+                series = new QLineSeries();
+            }
+            chart->addSeries(series);
+            chart->createDefaultAxes();
+            chart->axes(Qt::Horizontal).first()->setRange(points.first().x(), points.last().x());
+            chart->axes(Qt::Vertical).first()->setRange(0.0, 1.0);
+
+            QChartView view(chart);
+            view.setRenderHint(QPainter::Antialiasing);
+            view.resize(kPlotWidth, kPlotHeight);
+            view.grab(); // Lays out the plot area
+
+            ChartViewport viewport;
+            viewport.x_min = points.first().x();
+            viewport.x_max = points.last().x();
+            viewport.y_min = 0.0;
+            viewport.y_max = 1.0;
+            viewport.pixel_width = static_cast<int>(chart->plotArea().width());
+            viewport.pixel_height = static_cast<int>(chart->plotArea().height());
+
+            Measurement raw = measure(view, series, points, viewport, method, false);
+            Measurement decimated = measure(view, series, points, viewport, method, true);
+
+            std::cout << "[Chart Decimation Benchmark] " << std::setw(6) << count << " points, "
+                      << std::setw(9) << methodName(method) << ": raw " << std::fixed << std::setprecision(2)
+                      << raw.render_ms << " ms, decimated " << decimated.rendered_points << " points in "
+                      << decimated.decimate_ms << " ms + " << decimated.render_ms << " ms render" << std::endl;
+
+            if (count == counts[2] && decimated.decimate_ms + decimated.render_ms > kBudgetMilliseconds) {
+                std::cerr << "[Chart Decimation Benchmark] " << methodName(method) << " exceeded "
+                          << kBudgetMilliseconds << " ms budget" << std::endl;
+                passed = false;
+            }
+
+            // Zoomed into a quarter of the season the spikes must still be there
+            if (method == ChartDecimator::kMinMax) {
+                viewport.x_max = viewport.x_min + (viewport.x_max - viewport.x_min) / 4.0;
+                QVector<QPointF> zoomed = ChartDecimator::Decimate(points, viewport, method);
+                if (maxY(zoomed, viewport.x_min, viewport.x_max) != maxY(points, viewport.x_min, viewport.x_max)) {
+                    std::cerr << "[Chart Decimation Benchmark] Min/max decimation dropped a spike at "
+                              << count << " points" << std::endl;
+                    passed = false;
+                }
+            }
+        }
+    }
+
+    return passed ? 0 : 1;
+}
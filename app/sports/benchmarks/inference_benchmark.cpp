@@ -0,0 +1,123 @@
+/**
+ * @file inference_benchmark.cpp
+ * @brief Throughput comparison of the player detection backends
+ *
+ * Runs every compiled-in InferenceBackend over the same frames with a
+ * range of batch sizes, thread counts and FP32/INT8 models, and prints
+ * the fastest CPU configuration for this machine.
+ *
+ * Usage: sports_inference_benchmark <model> [video] [frames] [iterations]
+ */
+
+#include "inference_backend.h"
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace amt::sports;
+
+namespace {
+
+// Synthetic turf with player-sized blobs when no footage is given
+std::vector<cv::Mat> syntheticFrames(int count) {
+    std::mt19937 rng(2024);
+    std::uniform_int_distribution<int> x(0, 1200), y(100, 600);
+    std::vector<cv::Mat> frames;
+    for (int i = 0; i < count; ++i) {
+        cv::Mat frame(720, 1280, CV_8UC3, cv::Scalar(40, 140, 40));
+        for (int p = 0; p < 22; ++p) {
+            cv::Scalar jersey = p < 11 ? cv::Scalar(200, 60, 30) : cv::Scalar(240, 240, 240);
+            cv::rectangle(frame, cv::Rect(x(rng), y(rng), 18, 40), jersey, cv::FILLED);
+        }
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+std::vector<cv::Mat> videoFrames(const std::string& path, int count) {
+    std::vector<cv::Mat> frames;
+    cv::VideoCapture capture(path);
+    cv::Mat frame;
+    while (static_cast<int>(frames.size()) < count && capture.read(frame)) {
+        frames.push_back(frame.clone());
+    }
+    return frames;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string model_path = argc > 1 ? argv[1] : "";
+    int frame_count = argc > 3 ? std::max(1, std::stoi(argv[3])) : 32;
+    int iterations = argc > 4 ? std::max(1, std::stoi(argv[4])) : 5;
+
+    std::vector<cv::Mat> frames = argc > 2 ? videoFrames(argv[2], frame_count) : syntheticFrames(frame_count);
+    if (frames.empty()) {
+        std::cerr << "[Inference Benchmark] No frames to process" << std::endl;
+        return 1;
+    }
+
+    const int hardware_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    const int batch_sizes[] = {1, 4, 8};
+    const bool precisions[] = {false, true};
+
+    InferenceOptions int8_probe;
+    int8_probe.use_int8 = true;
+    const bool has_int8_model = !model_path.empty() &&
+        InferenceBackend::resolveModelPath(model_path, int8_probe) != model_path;
+
+    InferenceBenchmarkResult best;
+    for (InferenceBackendType type : InferenceBackend::availableBackends()) {
+        std::unique_ptr<InferenceBackend> backend = InferenceBackend::create(type);
+        bool needs_model = type != InferenceBackendType::RULE_BASED;
+        if (needs_model && model_path.empty()) {
+            std::cout << "[Inference Benchmark] Skipping " << backend->name() << " - no model given" << std::endl;
+            continue;
+        }
+
+        for (int threads : {1, hardware_threads / 2, hardware_threads}) {
+            for (bool int8 : precisions) {
+                if (int8 && (!needs_model || !has_int8_model)) {
+                    continue;
+                }
+
+                InferenceOptions options;
+                options.num_threads = std::max(1, threads);
+                options.use_int8 = int8;
+                if (!backend->load(model_path, options)) {
+                    continue;
+                }
+
+                for (int batch_size : batch_sizes) {
+                    InferenceBenchmarkResult result = benchmarkInferenceBackend(*backend, frames, batch_size, iterations);
+                    std::cout << "[Inference Benchmark] " << backend->name()
+                              << (int8 ? " INT8" : " FP32")
+                              << " threads=" << options.num_threads
+                              << " batch=" << batch_size << ": "
+                              << result.ms_per_frame << " ms/frame, "
+                              << result.frames_per_second << " FPS, "
+                              << result.detections << " detections" << std::endl;
+                    if (result.frames_per_second > best.frames_per_second) {
+                        best = result;
+                    }
+                }
+            }
+        }
+    }
+
+    if (best.frames_per_second <= 0.0) {
+        std::cerr << "[Inference Benchmark] No backend could be benchmarked" << std::endl;
+        return 1;
+    }
+    std::cout << "[Inference Benchmark] Fastest: " << InferenceBackend::backendName(best.type)
+              << (best.options.use_int8 ? " INT8" : " FP32")
+              << " threads=" << best.options.num_threads
+              << " batch=" << best.batch_size
+              << " (" << best.frames_per_second << " FPS)" << std::endl;
+    return 0;
+}
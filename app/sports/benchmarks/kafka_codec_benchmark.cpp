@@ -0,0 +1,170 @@
+/**
+ * @file kafka_codec_benchmark.cpp
+ * @brief Payload size and encode/decode cost of the Kafka event codec
+ *
+ * Encodes a stream of formation updates and coaching alerts (shaped like
+ * the ones SportsIntegration publishes) as JSON and binary, one message per
+ * event as KafkaProducerWorker sends them, then decodes every message again
+ * the way a consumer would. Compression is left to the producer's
+ * compression.codec and is not measured here. Exits non-zero if any event
+ * fails to round-trip.
+ */
+
+#include "kafka_event_codec.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace olive;
+
+namespace {
+
+constexpr int kEventCount = 20000;
+
+QJsonObject makeMetadata(EventType type, EventPriority priority, qint64 timestamp) {
+    QJsonObject metadata;
+    metadata["event_type"] = KafkaUtils::EventTypeToString(type);
+    metadata["priority"] = KafkaUtils::EventPriorityToString(priority);
+    metadata["source"] = "apache-cleats";
+    metadata["hostname"] = "film-room-01";
+    metadata["version"] = "2.0.0";
+    metadata["timestamp"] = timestamp;
+    return metadata;
+}
+
+KafkaEvent makeEvent(int index, std::mt19937& rng) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const qint64 timestamp = 1700000000000LL + index * 33;
+
+    KafkaEvent event;
+    event.timestamp = timestamp;
+    if (index % 10 == 9) {
+        event.type = EventType::CoachingAlert;
+        event.priority = EventPriority::High;
+        event.topic = "coaching-alerts";
+        event.key = QString("alert_%1").arg(index);
+        event.data["alert_type"] = "formation_tendency";
+        event.data["message"] = "Trips right on 3rd and long - expect the flood concept";
+        event.data["timestamp"] = timestamp;
+        event.data["down"] = 3;
+        event.data["distance"] = 8;
+    } else {
+        event.type = EventType::FormationUpdate;
+        event.topic = "formation-detections";
+        event.key = QString("formation_%1").arg(index);
+        event.data["formation_id"] = event.key;
+        event.data["type"] = index % 7;
+        event.data["confidence"] = unit(rng);
+        event.data["video_timestamp"] = static_cast<qint64>(index) * 33;
+        event.data["hash_position"] = (index % 2) ? "left" : "right";
+        event.data["field_zone"] = "red_zone";
+
+        // Schema-less extras still have to survive the trip
+        QJsonArray players;
+        for (int p = 0; p < 3; ++p) {
+            players.append(QJsonArray{unit(rng) * 120.0, unit(rng) * 53.3});
+        }
+        event.data["player_positions"] = players;
+    }
+    event.data["_metadata"] = makeMetadata(event.type, event.priority, timestamp);
+    return event;
+}
+
+// Binary payloads carry confidence as f32
+QJsonObject expectedAfterRoundTrip(const KafkaEvent& event, KafkaPayloadEncoding encoding) {
+    QJsonObject expected = event.data;
+    if (encoding == KafkaPayloadEncoding::Binary && expected.contains("confidence")) {
+        expected["confidence"] = static_cast<double>(static_cast<float>(expected["confidence"].toDouble()));
+    }
+    return expected;
+}
+
+struct CodecResult {
+    qint64 bytes = 0;
+    double encode_us = 0.0;
+    double decode_us = 0.0;
+    bool round_trip_ok = true;
+};
+
+CodecResult run(const std::vector<KafkaEvent>& events, KafkaPayloadEncoding encoding) {
+    CodecResult result;
+    std::vector<QByteArray> messages;
+    messages.reserve(events.size());
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const KafkaEvent& event : events) {
+        messages.push_back(KafkaEventCodec::Encode(event, encoding));
+    }
+    auto encoded = std::chrono::high_resolution_clock::now();
+
+    // Stand-in consumer
+    std::vector<QJsonObject> decoded;
+    decoded.reserve(events.size());
+    for (const QByteArray& message : messages) {
+        result.bytes += message.size();
+        QJsonObject data;
+        if (KafkaEventCodec::Decode(message, &data)) {
+            decoded.push_back(data);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    result.encode_us = std::chrono::duration<double, std::micro>(encoded - start).count() / events.size();
+    result.decode_us = std::chrono::duration<double, std::micro>(end - encoded).count() / events.size();
+
+    if (decoded.size() != events.size()) {
+        std::cerr << "[Kafka Codec Benchmark] Decoded " << decoded.size() << " of "
+                  << events.size() << " events" << std::endl;
+        result.round_trip_ok = false;
+        return result;
+    }
+    for (size_t i = 0; i < events.size(); ++i) {
+        if (decoded[i] != expectedAfterRoundTrip(events[i], encoding)) {
+            std::cerr << "[Kafka Codec Benchmark] Event " << i << " did not round-trip" << std::endl;
+            result.round_trip_ok = false;
+            break;
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+
+    std::mt19937 rng(7);
+    std::vector<KafkaEvent> events;
+    events.reserve(kEventCount);
+    for (int i = 0; i < kEventCount; ++i) {
+        events.push_back(makeEvent(i, rng));
+    }
+
+    std::cout << "[Kafka Codec Benchmark] " << kEventCount << " events" << std::endl;
+    std::cout << std::left << std::setw(10) << "encoding"
+              << std::right << std::setw(14) << "bytes/event"
+              << std::setw(14) << "encode us" << std::setw(14) << "decode us" << std::endl;
+
+    bool ok = true;
+    for (KafkaPayloadEncoding encoding : {KafkaPayloadEncoding::Json, KafkaPayloadEncoding::Binary}) {
+        CodecResult result = run(events, encoding);
+        ok = ok && result.round_trip_ok;
+
+        std::cout << std::left << std::setw(10)
+                  << (encoding == KafkaPayloadEncoding::Json ? "json" : "binary")
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(14) << static_cast<double>(result.bytes) / kEventCount
+                  << std::setprecision(2)
+                  << std::setw(14) << result.encode_us
+                  << std::setw(14) << result.decode_us
+                  << (result.round_trip_ok ? "" : "  ROUND-TRIP FAILED") << std::endl;
+    }
+
+    return ok ? 0 : 1;
+}
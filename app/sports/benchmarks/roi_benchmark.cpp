@@ -0,0 +1,160 @@
+/**
+ * @file roi_benchmark.cpp
+ * @brief A/B comparison of full-frame and region-of-interest detection
+ *
+ * Runs the same backend over a recorded clip twice: once resizing the
+ * whole frame into the detector input, once with DetectionRegionPlanner
+ * tiles around the previous player extent. Reports throughput, the share
+ * of the frame searched, detections per frame (and how many are small),
+ * and how many full-frame detections the ROI pass also finds.
+ *
+ * Usage: sports_roi_benchmark <clip> [model] [backend: dnn|onnx|rules] [max frames]
+ */
+
+#include "detection_region_planner.h"
+#include "inference_backend.h"
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace amt::sports;
+
+namespace {
+
+constexpr float kSmallPlayerHeight = 0.04f;   // Box height as a fraction of the frame
+constexpr float kMatchIou = 0.5f;
+
+struct RunResult {
+    double seconds = 0.0;
+    size_t detections = 0;
+    size_t small_detections = 0;
+    double coverage = 1.0;
+    std::vector<std::vector<InferenceDetection>> frames;
+};
+
+float iou(const cv::Rect2f& a, const cv::Rect2f& b) {
+    float x1 = std::max(a.x, b.x), y1 = std::max(a.y, b.y);
+    float x2 = std::min(a.x + a.width, b.x + b.width), y2 = std::min(a.y + a.height, b.y + b.height);
+    if (x2 <= x1 || y2 <= y1) {
+        return 0.0f;
+    }
+    float intersection = (x2 - x1) * (y2 - y1);
+    return intersection / (a.width * a.height + b.width * b.height - intersection);
+}
+
+void tally(RunResult& result, const std::vector<InferenceDetection>& detections) {
+    result.detections += detections.size();
+    result.small_detections += std::count_if(detections.begin(), detections.end(), [](const InferenceDetection& d) {
+        return d.box.height < kSmallPlayerHeight;
+    });
+    result.frames.push_back(detections);
+}
+
+RunResult runFullFrame(InferenceBackend& backend, const std::vector<cv::Mat>& clip, float threshold) {
+    RunResult result;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& frame : clip) {
+        tally(result, backend.infer({frame}, threshold).front());
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    return result;
+}
+
+RunResult runRegionOfInterest(InferenceBackend& backend, const std::vector<cv::Mat>& clip, float threshold) {
+    RunResult result;
+    DetectionRegionPlanner planner;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& frame : clip) {
+        std::vector<cv::Rect> tiles = planner.plan(frame.size(), backend.options().input_size);
+        std::vector<cv::Mat> crops;
+        for (const auto& tile : tiles) {
+            crops.push_back(frame(tile));
+        }
+        std::vector<InferenceDetection> detections =
+            planner.mapToFrame(backend.infer(crops, threshold), tiles, frame.size());
+
+        std::vector<cv::Rect> boxes;
+        for (const auto& d : detections) {
+            boxes.emplace_back(static_cast<int>(d.box.x * frame.cols), static_cast<int>(d.box.y * frame.rows),
+                               static_cast<int>(d.box.width * frame.cols), static_cast<int>(d.box.height * frame.rows));
+        }
+        planner.update(boxes);
+        tally(result, detections);
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    result.coverage = planner.getAverageCoverage();
+    return result;
+}
+
+// Fraction of reference detections that the candidate run also produced
+double agreement(const RunResult& reference, const RunResult& candidate) {
+    size_t matched = 0, total = 0;
+    for (size_t f = 0; f < reference.frames.size() && f < candidate.frames.size(); ++f) {
+        for (const auto& ref : reference.frames[f]) {
+            total++;
+            matched += std::any_of(candidate.frames[f].begin(), candidate.frames[f].end(),
+                                   [&](const InferenceDetection& d) {
+                                       return d.class_id == ref.class_id && iou(d.box, ref.box) >= kMatchIou;
+                                   });
+        }
+    }
+    return total > 0 ? static_cast<double>(matched) / total : 1.0;
+}
+
+void report(const char* label, const RunResult& result, size_t frame_count) {
+    std::cout << "[ROI Benchmark] " << label << ": "
+              << frame_count / std::max(result.seconds, 1e-9) << " FPS, "
+              << result.coverage * 100.0 << "% of frame searched, "
+              << static_cast<double>(result.detections) / frame_count << " detections/frame ("
+              << static_cast<double>(result.small_detections) / frame_count << " small)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <clip> [model] [dnn|onnx|rules] [max frames]" << std::endl;
+        return 1;
+    }
+    std::string model_path = argc > 2 ? argv[2] : "";
+    std::string backend_name = argc > 3 ? argv[3] : (model_path.empty() ? "rules" : "dnn");
+    int max_frames = argc > 4 ? std::max(1, std::stoi(argv[4])) : 300;
+
+    InferenceBackendType type = backend_name == "onnx" ? InferenceBackendType::ONNX_RUNTIME :
+                                backend_name == "rules" ? InferenceBackendType::RULE_BASED :
+                                InferenceBackendType::OPENCV_DNN;
+    std::unique_ptr<InferenceBackend> backend = InferenceBackend::create(type);
+    if (!backend || !backend->load(model_path, InferenceOptions())) {
+        std::cerr << "[ROI Benchmark] Could not load " << backend_name << " backend" << std::endl;
+        return 1;
+    }
+
+    // Decode up front so only detection is timed
+    std::vector<cv::Mat> clip;
+    cv::VideoCapture capture(argv[1]);
+    cv::Mat frame;
+    while (static_cast<int>(clip.size()) < max_frames && capture.read(frame)) {
+        clip.push_back(frame.clone());
+    }
+    if (clip.empty()) {
+        std::cerr << "[ROI Benchmark] No frames decoded from " << argv[1] << std::endl;
+        return 1;
+    }
+
+    const float threshold = 0.5f;
+    backend->infer({clip.front()}, threshold);   // Warm-up
+
+    RunResult full = runFullFrame(*backend, clip, threshold);
+    RunResult roi = runRegionOfInterest(*backend, clip, threshold);
+
+    std::cout << "[ROI Benchmark] " << clip.size() << " frames, " << backend->name() << std::endl;
+    report("Full frame", full, clip.size());
+    report("ROI tiles ", roi, clip.size());
+    std::cout << "[ROI Benchmark] ROI finds " << agreement(full, roi) * 100.0
+              << "% of full-frame detections; speedup " << full.seconds / std::max(roi.seconds, 1e-9)
+              << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,215 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Chart Decimation Implementation
+***/
+
+#include "chart_decimation.h"
+
+#include <QBitArray>
+
+#include <algorithm>
+#include <cmath>
+
+namespace olive {
+
+namespace {
+
+QVector<QPointF> Slice(const QVector<QPointF>& points, int begin, int end)
+{
+  return points.mid(begin, end - begin);
+}
+
+// Pixel column of x; points just outside the viewport get columns -1 and width.
+// x_max itself is on the plot, so it lands in the last column.
+int PixelColumn(double x, const ChartViewport& viewport)
+{
+  double column = std::floor((x - viewport.x_min) / (viewport.x_max - viewport.x_min) * viewport.pixel_width);
+  if (x <= viewport.x_max) {
+    column = qMin(column, viewport.pixel_width - 1.0);
+  }
+  return static_cast<int>(qBound(-1.0, column, static_cast<double>(viewport.pixel_width)));
+}
+
+// Pixel row of y over height rows, with y_max in the top row
+int PixelRow(double y, double y_min, double y_max, int height)
+{
+  double row = std::floor((y - y_min) / (y_max - y_min) * height);
+  if (y <= y_max) {
+    row = qMin(row, height - 1.0);
+  }
+  return static_cast<int>(qBound(-1.0, row, static_cast<double>(height)));
+}
+
+} // namespace
+
+QVector<QPointF> ChartDecimator::Decimate(const QVector<QPointF>& points, const ChartViewport& viewport, Method method)
+{
+  if (viewport.pixel_width <= 0 || !(viewport.x_max > viewport.x_min)) {
+    // Nothing to size the output against yet
+    return points;
+  }
+
+  int begin, end;
+  VisibleRange(points, viewport.x_min, viewport.x_max, &begin, &end);
+
+  switch (method) {
+    case kLargestTriangle:
+      return LargestTriangleThreeBuckets(points, begin, end, qMax(3, viewport.pixel_width));
+    case kMinMax:
+      return MinMaxBuckets(points, begin, end, viewport);
+    case kPixelGrid:
+      return PixelGrid(points, begin, end, viewport);
+  }
+
+  return Slice(points, begin, end);
+}
+
+QVector<QPointF> ChartDecimator::LargestTriangleThreeBuckets(const QVector<QPointF>& points, int begin, int end, int threshold)
+{
+  int count = end - begin;
+  if (threshold < 3 || count <= threshold) {
+    return Slice(points, begin, end);
+  }
+
+  QVector<QPointF> sampled;
+  sampled.reserve(threshold);
+
+  // First and last points are always kept; the rest are split into
+  // threshold - 2 buckets and each contributes the point forming the largest
+  // triangle with the previous pick and the average of the next bucket
+  double bucket_size = static_cast<double>(count - 2) / (threshold - 2);
+  int previous = begin;
+  sampled.append(points[previous]);
+
+  for (int bucket = 0; bucket < threshold - 2; bucket++) {
+    int range_begin = begin + static_cast<int>(std::floor(bucket * bucket_size)) + 1;
+    int range_end = begin + static_cast<int>(std::floor((bucket + 1) * bucket_size)) + 1;
+
+    int next_begin = range_end;
+    int next_end = qMin(begin + static_cast<int>(std::floor((bucket + 2) * bucket_size)) + 1, end);
+
+    double average_x = 0.0;
+    double average_y = 0.0;
+    for (int i = next_begin; i < next_end; i++) {
+      average_x += points[i].x();
+      average_y += points[i].y();
+    }
+    int next_count = next_end - next_begin;
+    average_x /= next_count;
+    average_y /= next_count;
+
+    const QPointF& a = points[previous];
+    double max_area = -1.0;
+    int chosen = range_begin;
+    for (int i = range_begin; i < range_end; i++) {
+      // Twice the triangle area; the factor does not change the pick
+      double area = std::abs((a.x() - average_x) * (points[i].y() - a.y())
+                             - (a.x() - points[i].x()) * (average_y - a.y()));
+      if (area > max_area) {
+        max_area = area;
+        chosen = i;
+      }
+    }
+
+    sampled.append(points[chosen]);
+    previous = chosen;
+  }
+
+  sampled.append(points[end - 1]);
+  return sampled;
+}
+
+QVector<QPointF> ChartDecimator::MinMaxBuckets(const QVector<QPointF>& points, int begin, int end, const ChartViewport& viewport)
+{
+  // Each column contributes at most four points, plus the two edge columns
+  if (end - begin <= 4 * (viewport.pixel_width + 2)) {
+    return Slice(points, begin, end);
+  }
+
+  QVector<QPointF> sampled;
+  sampled.reserve(4 * (viewport.pixel_width + 2));
+
+  int column = PixelColumn(points[begin].x(), viewport);
+  int first = begin;
+  int lowest = begin;
+  int highest = begin;
+
+  auto flush = [&](int last) {
+    int picks[] = {first, lowest, highest, last};
+    std::sort(std::begin(picks), std::end(picks));
+    int previous = -1;
+    for (int pick : picks) {
+      if (pick != previous) {
+        sampled.append(points[pick]);
+        previous = pick;
+      }
+    }
+  };
+
+  for (int i = begin + 1; i < end; i++) {
+    int point_column = PixelColumn(points[i].x(), viewport);
+    if (point_column != column) {
+      flush(i - 1);
+      column = point_column;
+      first = lowest = highest = i;
+      continue;
+    }
+
+    if (points[i].y() < points[lowest].y()) {
+      lowest = i;
+    }
+    if (points[i].y() > points[highest].y()) {
+      highest = i;
+    }
+  }
+  flush(end - 1);
+
+  return sampled;
+}
+
+QVector<QPointF> ChartDecimator::PixelGrid(const QVector<QPointF>& points, int begin, int end, const ChartViewport& viewport)
+{
+  int width = viewport.pixel_width;
+  int height = qMax(1, viewport.pixel_height);
+  if (!(viewport.y_max > viewport.y_min)) {
+    // No vertical range yet, fall back to one point per column
+    height = 1;
+  }
+
+  QVector<QPointF> sampled;
+  QBitArray occupied(width * height);
+
+  for (int i = begin; i < end; i++) {
+    const QPointF& point = points[i];
+    int column = PixelColumn(point.x(), viewport);
+    int row = height > 1 ? PixelRow(point.y(), viewport.y_min, viewport.y_max, height) : 0;
+
+    // Scatter points off the plot are not drawn at all
+    if (column < 0 || column >= width || row < 0 || row >= height) {
+      continue;
+    }
+
+    int cell = row * width + column;
+    if (!occupied.testBit(cell)) {
+      occupied.setBit(cell);
+      sampled.append(point);
+    }
+  }
+
+  return sampled;
+}
+
+void ChartDecimator::VisibleRange(const QVector<QPointF>& points, double x_min, double x_max, int* begin, int* end)
+{
+  auto compare_x = [](const QPointF& point, double x) { return point.x() < x; };
+  auto lower = std::lower_bound(points.constBegin(), points.constEnd(), x_min, compare_x);
+  auto upper = std::upper_bound(points.constBegin(), points.constEnd(), x_max,
+                                [](double x, const QPointF& point) { return x < point.x(); });
+
+  *begin = qMax(0, static_cast<int>(lower - points.constBegin()) - 1);
+  *end = qMin(points.size(), static_cast<int>(upper - points.constBegin()) + 1);
+}
+
+} // namespace olive
@@ -0,0 +1,75 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Chart Decimation
+  Reduces long metric series to what a chart can actually draw
+***/
+
+#ifndef CHARTDECIMATION_H
+#define CHARTDECIMATION_H
+
+#include <QPointF>
+#include <QVector>
+
+namespace olive {
+
+/**
+ * @brief Visible data range of a chart and the plot area it maps onto
+ */
+struct ChartViewport {
+  double x_min = 0.0;
+  double x_max = 0.0;
+  double y_min = 0.0;
+  double y_max = 0.0;
+  int pixel_width = 0;
+  int pixel_height = 0;
+};
+
+/**
+ * @brief Downsamples x-sorted series to the chart's pixel resolution
+ *
+ * Only the points inside the viewport's x range are considered, plus one
+ * neighbour on each side so lines still run off the plot edges. The result
+ * size is bounded by the plot size rather than the series length, so a
+ * season of samples draws as fast as a single quarter. Re-run it whenever
+ * the visible range or plot area changes.
+ *
+ *  - kLargestTriangle (LTTB) keeps about one point per pixel column and
+ *    preserves the visual shape of a trend line.
+ *  - kMinMax keeps the first, last, minimum and maximum point of every
+ *    pixel column, so spikes are never lost; the line is pixel-exact.
+ *  - kPixelGrid keeps the first point landing in each pixel, for scatter
+ *    plots where every point is drawn on its own.
+ *
+ * Input points must be sorted by x.
+ */
+class ChartDecimator
+{
+public:
+  enum Method {
+    kLargestTriangle,
+    kMinMax,
+    kPixelGrid
+  };
+
+  static QVector<QPointF> Decimate(const QVector<QPointF>& points, const ChartViewport& viewport, Method method);
+
+  /**
+   * @brief Largest-Triangle-Three-Buckets over points[begin, end)
+   */
+  static QVector<QPointF> LargestTriangleThreeBuckets(const QVector<QPointF>& points, int begin, int end, int threshold);
+
+  static QVector<QPointF> MinMaxBuckets(const QVector<QPointF>& points, int begin, int end, const ChartViewport& viewport);
+
+  static QVector<QPointF> PixelGrid(const QVector<QPointF>& points, int begin, int end, const ChartViewport& viewport);
+
+  /**
+   * @brief Index range [*begin, *end) covering [x_min, x_max] plus one point either side
+   */
+  static void VisibleRange(const QVector<QPointF>& points, double x_min, double x_max, int* begin, int* end);
+};
+
+} // namespace olive
+
+#endif // CHARTDECIMATION_H
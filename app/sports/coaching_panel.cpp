@@ -504,22 +504,55 @@ void CoachingPanel::stopRealTimeAnalysis() {
     qDebug() << "[Coaching Panel] Real-time analysis stopped";
 }
 
+void CoachingPanel::setCurrentFrame(const QImage& frame) {
+    m_current_frame = frame;
+    m_current_view = FrameMatView();
+}
+
+void CoachingPanel::setCurrentFrame(olive::FramePtr frame) {
+    // Holding the view keeps the decoder's buffer alive until the next frame
+    m_current_view = FrameMatAdapter::wrap(frame);
+    m_current_frame = QImage();
+}
+
+void CoachingPanel::onFrameChanged(const QImage& frame) {
+    setCurrentFrame(frame);
+}
+
+void CoachingPanel::onFrameChanged(olive::FramePtr frame) {
+    setCurrentFrame(frame);
+}
+
 void CoachingPanel::processCurrentFrame() {
-    if (!m_current_frame.isNull() && m_formation_detector) {
-        // Convert QImage to cv::Mat for processing
-        #ifdef ENABLE_OPENCV_INTEGRATION
-        cv::Mat frame(m_current_frame.height(), m_current_frame.width(), 
-                     CV_8UC4, (void*)m_current_frame.constBits(), 
-                     m_current_frame.bytesPerLine());
-        cv::cvtColor(frame, frame, cv::COLOR_BGRA2BGR);
-        
+    if (!m_formation_detector) {
+        return;
+    }
+    
+    #ifdef ENABLE_OPENCV_INTEGRATION
+    cv::Mat frame;
+    FrameColorOrder order = FrameColorOrder::BGR;
+    QImage converted;
+    
+    if (m_current_view.isValid()) {
+        frame = m_current_view.mat;
+        order = m_current_view.color_order;
+    } else if (!m_current_frame.isNull()) {
+        // Wrap the QImage pixels directly; only exotic formats need converting
+        frame = FrameMatAdapter::wrap(m_current_frame, &order);
+        if (frame.empty()) {
+            converted = m_current_frame.convertToFormat(QImage::Format_RGBA8888);
+            frame = FrameMatAdapter::wrap(converted, &order);
+        }
+    }
+    
+    if (!frame.empty()) {
         // Detect formation
-        FormationData formation = m_formation_detector->detectFormation(frame);
+        FormationData formation = m_formation_detector->detectFormation(frame, order);
         
         // Update display
         onFormationDetected(formation);
-        #endif
     }
+    #endif
 }
 
 void CoachingPanel::updateRealTimeDisplay() {
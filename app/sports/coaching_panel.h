@@ -31,6 +31,7 @@
 
 #include "sports_analysis_core.h"
 #include "formation_detector.h"
+#include "frame_mat_adapter.h"
 
 namespace amt {
 namespace sports {
@@ -150,6 +151,7 @@ public:
     void connectToVideoPlayer(QObject* video_player);
     void connectToTimeline(QObject* timeline);
     void setCurrentFrame(const QImage& frame);
+    void setCurrentFrame(olive::FramePtr frame);    // Analyzed in place, no copy
     
     // Sports Analysis Integration
     void setSportsAnalysisCore(SportsAnalysisCore* core);
@@ -166,6 +168,7 @@ public:
 
 public slots:
     void onFrameChanged(const QImage& frame);
+    void onFrameChanged(olive::FramePtr frame);
     void onTimelinePositionChanged(double seconds);
     void onVideoLoaded(const QString& filename);
     
@@ -224,6 +227,7 @@ private:
     QObject* m_video_player;
     QObject* m_timeline;
     QImage m_current_frame;
+    FrameMatView m_current_view;    // Decoded Olive frame, takes precedence over m_current_frame
     double m_current_timestamp;
 };
 
@@ -0,0 +1,165 @@
+/**
+ * @file detection_region_planner.cpp
+ * @brief Region-of-interest tiling for player detection
+ */
+
+#include "detection_region_planner.h"
+#include <algorithm>
+#include <cmath>
+
+namespace amt {
+namespace sports {
+
+namespace {
+
+float intersectionOverUnion(const cv::Rect2f& a, const cv::Rect2f& b) {
+    float x1 = std::max(a.x, b.x);
+    float y1 = std::max(a.y, b.y);
+    float x2 = std::min(a.x + a.width, b.x + b.width);
+    float y2 = std::min(a.y + a.height, b.y + b.height);
+    if (x2 <= x1 || y2 <= y1) {
+        return 0.0f;
+    }
+    float intersection = (x2 - x1) * (y2 - y1);
+    return intersection / (a.width * a.height + b.width * b.height - intersection);
+}
+
+} // namespace
+
+DetectionRegionPlanner::DetectionRegionPlanner()
+    : DetectionRegionPlanner(Config()) {}
+
+DetectionRegionPlanner::DetectionRegionPlanner(const Config& config)
+    : m_config(config) {}
+
+void DetectionRegionPlanner::setFieldRegion(const cv::Rect& region, double pixels_per_yard) {
+    m_field_region = region;
+    m_pixels_per_yard = pixels_per_yard;
+}
+
+std::vector<cv::Rect> DetectionRegionPlanner::plan(const cv::Size& frame_size, const cv::Size& input_size) {
+    const cv::Rect frame_rect(0, 0, frame_size.width, frame_size.height);
+    cv::Rect field = m_field_region & frame_rect;
+    
+    bool full_pass = m_player_extent.empty() || ++m_frames_since_full >= m_config.refresh_interval;
+    if (full_pass) {
+        // Whole field (or frame) in one downscaled pass, as without ROI mode
+        m_frames_since_full = 0;
+        m_full_passes++;
+        m_last_region = field.empty() ? frame_rect : field;
+        m_coverage_sum += static_cast<double>(m_last_region.area()) / std::max(1, frame_rect.area());
+        return {m_last_region};
+    }
+    
+    int min_margin = std::max(m_config.min_margin_pixels, 
+                              static_cast<int>(m_config.margin_yards * m_pixels_per_yard));
+    int margin_x = std::max(min_margin, static_cast<int>(m_player_extent.width * m_config.extent_margin));
+    int margin_y = std::max(min_margin, static_cast<int>(m_player_extent.height * m_config.extent_margin));
+    cv::Rect region(m_player_extent.x - margin_x, m_player_extent.y - margin_y,
+                    m_player_extent.width + 2 * margin_x, m_player_extent.height + 2 * margin_y);
+    region &= frame_rect;
+    
+    // Players do not leave the field; ignore the crowd and bench area
+    cv::Rect on_field = region & field;
+    if (!on_field.empty()) {
+        region = on_field;
+    }
+    
+    m_region_passes++;
+    m_last_region = region;
+    m_coverage_sum += static_cast<double>(region.area()) / std::max(1, frame_rect.area());
+    return tile(region, input_size);
+}
+
+std::vector<cv::Rect> DetectionRegionPlanner::tile(const cv::Rect& region, const cv::Size& input_size) const {
+    // Tiles of about the detector input size keep native resolution
+    int tiles_x = std::max(1, static_cast<int>(std::ceil(static_cast<double>(region.width) / input_size.width)));
+    int tiles_y = std::max(1, static_cast<int>(std::ceil(static_cast<double>(region.height) / input_size.height)));
+    while (tiles_x * tiles_y > std::max(1, m_config.max_tiles)) {
+        if (tiles_x >= tiles_y) {
+            tiles_x--;
+        } else {
+            tiles_y--;
+        }
+    }
+    
+    const int tile_width = (region.width + tiles_x - 1) / tiles_x;
+    const int tile_height = (region.height + tiles_y - 1) / tiles_y;
+    const int overlap_x = tiles_x > 1 ? static_cast<int>(tile_width * m_config.tile_overlap) : 0;
+    const int overlap_y = tiles_y > 1 ? static_cast<int>(tile_height * m_config.tile_overlap) : 0;
+    
+    std::vector<cv::Rect> tiles;
+    tiles.reserve(tiles_x * tiles_y);
+    for (int ty = 0; ty < tiles_y; ++ty) {
+        for (int tx = 0; tx < tiles_x; ++tx) {
+            cv::Rect tile_rect(region.x + tx * tile_width - overlap_x, region.y + ty * tile_height - overlap_y,
+                               tile_width + 2 * overlap_x, tile_height + 2 * overlap_y);
+            tiles.push_back(tile_rect & region);
+        }
+    }
+    return tiles;
+}
+
+std::vector<InferenceDetection> DetectionRegionPlanner::mapToFrame(
+        const std::vector<std::vector<InferenceDetection>>& tile_detections,
+        const std::vector<cv::Rect>& tiles, const cv::Size& frame_size) const {
+    std::vector<InferenceDetection> detections;
+    const float inv_width = 1.0f / frame_size.width;
+    const float inv_height = 1.0f / frame_size.height;
+    
+    for (size_t t = 0; t < tiles.size() && t < tile_detections.size(); ++t) {
+        const cv::Rect& tile_rect = tiles[t];
+        for (const auto& detection : tile_detections[t]) {
+            InferenceDetection mapped = detection;
+            mapped.box = cv::Rect2f((tile_rect.x + detection.box.x * tile_rect.width) * inv_width,
+                                    (tile_rect.y + detection.box.y * tile_rect.height) * inv_height,
+                                    detection.box.width * tile_rect.width * inv_width,
+                                    detection.box.height * tile_rect.height * inv_height);
+            detections.push_back(mapped);
+        }
+    }
+    if (tiles.size() < 2) {
+        return detections;
+    }
+    
+    // Players straddling a tile seam are detected twice
+    std::sort(detections.begin(), detections.end(), [](const InferenceDetection& a, const InferenceDetection& b) {
+        return a.confidence > b.confidence;
+    });
+    std::vector<InferenceDetection> kept;
+    kept.reserve(detections.size());
+    for (const auto& detection : detections) {
+        bool duplicate = std::any_of(kept.begin(), kept.end(), [&](const InferenceDetection& other) {
+            return other.class_id == detection.class_id &&
+                   intersectionOverUnion(other.box, detection.box) > m_config.nms_iou;
+        });
+        if (!duplicate) {
+            kept.push_back(detection);
+        }
+    }
+    return kept;
+}
+
+void DetectionRegionPlanner::update(const std::vector<cv::Rect>& player_boxes) {
+    m_player_extent = cv::Rect();
+    for (const auto& box : player_boxes) {
+        m_player_extent = m_player_extent.empty() ? box : (m_player_extent | box);
+    }
+}
+
+void DetectionRegionPlanner::reset() {
+    m_player_extent = cv::Rect();
+    m_last_region = cv::Rect();
+    m_frames_since_full = 0;
+    m_full_passes = 0;
+    m_region_passes = 0;
+    m_coverage_sum = 0.0;
+}
+
+double DetectionRegionPlanner::getAverageCoverage() const {
+    int passes = m_full_passes + m_region_passes;
+    return passes > 0 ? m_coverage_sum / passes : 0.0;
+}
+
+} // namespace sports
+} // namespace amt
@@ -0,0 +1,84 @@
+#ifndef DETECTION_REGION_PLANNER_H
+#define DETECTION_REGION_PLANNER_H
+
+/**
+ * @file detection_region_planner.h
+ * @brief Region-of-interest tiling for player detection
+ *
+ * On all-22 film the players occupy a band around the line of scrimmage.
+ * Once the field is calibrated and a frame has been detected, the next
+ * frame only needs the previous player extent (plus a margin) searched.
+ * That region is cut into detector-sized tiles at native resolution, so
+ * small players are not lost to the 608x608 downscale, and the tile
+ * detections are mapped back to full-frame coordinates.
+ */
+
+#include "inference_backend.h"
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace amt {
+namespace sports {
+
+/**
+ * @class DetectionRegionPlanner
+ * @brief Chooses the detection tiles for each frame of one video stream
+ */
+class DetectionRegionPlanner {
+public:
+    struct Config {
+        double extent_margin = 0.15;       // Fraction of the previous extent added on each side
+        double margin_yards = 5.0;         // Minimum margin once the field scale is known
+        int min_margin_pixels = 32;
+        int max_tiles = 4;                 // Larger regions are tiled coarser (downscaled)
+        double tile_overlap = 0.1;         // Fraction of a tile shared with its neighbour
+        int refresh_interval = 30;         // Full-region pass every N frames to pick up new players
+        double nms_iou = 0.5;              // Duplicate suppression across tile overlaps
+    };
+
+    DetectionRegionPlanner();
+    explicit DetectionRegionPlanner(const Config& config);
+
+    // Field area in frame coordinates (empty if not calibrated)
+    void setFieldRegion(const cv::Rect& region, double pixels_per_yard);
+
+    // Tiles to run the detector on for the next frame
+    std::vector<cv::Rect> plan(const cv::Size& frame_size, const cv::Size& input_size);
+
+    // Merges per-tile detections (normalized to their tile) into detections
+    // normalized to the full frame
+    std::vector<InferenceDetection> mapToFrame(const std::vector<std::vector<InferenceDetection>>& tile_detections,
+                                               const std::vector<cv::Rect>& tiles,
+                                               const cv::Size& frame_size) const;
+
+    // Feeds back this frame's player boxes; no players forces a full pass next
+    void update(const std::vector<cv::Rect>& player_boxes);
+    void reset();
+
+    void setConfig(const Config& config) { m_config = config; }
+    const Config& config() const { return m_config; }
+
+    // Statistics
+    const cv::Rect& lastRegion() const { return m_last_region; }
+    int getFullPasses() const { return m_full_passes; }
+    int getRegionPasses() const { return m_region_passes; }
+    double getAverageCoverage() const;     // Mean fraction of the frame searched
+
+private:
+    std::vector<cv::Rect> tile(const cv::Rect& region, const cv::Size& input_size) const;
+
+    Config m_config;
+    cv::Rect m_field_region;
+    double m_pixels_per_yard = 0.0;
+    cv::Rect m_player_extent;
+    cv::Rect m_last_region;
+    int m_frames_since_full = 0;
+    int m_full_passes = 0;
+    int m_region_passes = 0;
+    double m_coverage_sum = 0.0;
+};
+
+} // namespace sports
+} // namespace amt
+
+#endif // DETECTION_REGION_PLANNER_H
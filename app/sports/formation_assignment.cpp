@@ -0,0 +1,96 @@
+/**
+ * @file formation_assignment.cpp
+ * @brief Implementation of the Hungarian assignment solver
+ *
+ * O(rows^2 * cols) shortest augmenting path formulation with row and
+ * column potentials. Every row is matched to a distinct column; surplus
+ * columns (extra detected players) stay unassigned.
+ */
+
+#include "formation_assignment.h"
+#include <limits>
+
+namespace amt {
+namespace sports {
+
+double AssignmentSolver::solve(AssignmentWorkspace& ws, int rows, int cols) {
+    if (rows <= 0 || rows > cols || cols > AssignmentWorkspace::kMaxSize) {
+        return -1.0;
+    }
+
+    const double infinity = std::numeric_limits<double>::max();
+
+    for (int j = 0; j <= cols; ++j) {
+        ws.u[j] = 0.0;
+        ws.v[j] = 0.0;
+        ws.col_to_row[j] = 0;
+        ws.way[j] = 0;
+    }
+
+    for (int i = 1; i <= rows; ++i) {
+        // Grow an alternating tree from row i until it reaches a free column
+        ws.col_to_row[0] = i;
+        int j0 = 0;
+        for (int j = 0; j <= cols; ++j) {
+            ws.min_v[j] = infinity;
+            ws.used[j] = false;
+        }
+
+        do {
+            ws.used[j0] = true;
+            const int i0 = ws.col_to_row[j0];
+            double delta = infinity;
+            int j1 = 0;
+
+            for (int j = 1; j <= cols; ++j) {
+                if (ws.used[j]) {
+                    continue;
+                }
+                double reduced = ws.cost[i0 - 1][j - 1] - ws.u[i0] - ws.v[j];
+                if (reduced < ws.min_v[j]) {
+                    ws.min_v[j] = reduced;
+                    ws.way[j] = j0;
+                }
+                if (ws.min_v[j] < delta) {
+                    delta = ws.min_v[j];
+                    j1 = j;
+                }
+            }
+
+            for (int j = 0; j <= cols; ++j) {
+                if (ws.used[j]) {
+                    ws.u[ws.col_to_row[j]] += delta;
+                    ws.v[j] -= delta;
+                } else {
+                    ws.min_v[j] -= delta;
+                }
+            }
+            j0 = j1;
+        } while (ws.col_to_row[j0] != 0);
+
+        // Flip the augmenting path
+        do {
+            const int j1 = ws.way[j0];
+            ws.col_to_row[j0] = ws.col_to_row[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    double total = 0.0;
+    for (int j = 1; j <= cols; ++j) {
+        const int row = ws.col_to_row[j];
+        if (row != 0) {
+            ws.row_to_col[row - 1] = j - 1;
+            total += ws.cost[row - 1][j - 1];
+        }
+    }
+    return total;
+}
+
+AssignmentWorkspace& AssignmentSolver::threadWorkspace() {
+    thread_local AssignmentWorkspace workspace;
+    return workspace;
+}
+
+} // namespace sports
+} // namespace amt
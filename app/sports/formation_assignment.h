@@ -0,0 +1,53 @@
+#ifndef FORMATION_ASSIGNMENT_H
+#define FORMATION_ASSIGNMENT_H
+
+/**
+ * @file formation_assignment.h
+ * @brief Optimal player-to-slot assignment for formation scoring
+ *
+ * Hungarian (Jonker-Volgenant style shortest augmenting path) solver for
+ * mapping detected players onto pattern slots (8-11 players) and tracks
+ * onto detections (all 22 players plus false positives). Runs out of a
+ * fixed-size per-thread workspace, so solving never touches the heap.
+ */
+
+namespace amt {
+namespace sports {
+
+/**
+ * @struct AssignmentWorkspace
+ * @brief Preallocated buffers for a single assignment solve
+ */
+struct AssignmentWorkspace {
+    static constexpr int kMaxSize = 32;
+
+    double cost[kMaxSize][kMaxSize];   // cost[row][col], rows are slots
+    int row_to_col[kMaxSize];          // Result: assigned column per row
+
+    // Solver state (1-indexed, column 0 is the virtual start column)
+    double u[kMaxSize + 1];
+    double v[kMaxSize + 1];
+    double min_v[kMaxSize + 1];
+    int col_to_row[kMaxSize + 1];
+    int way[kMaxSize + 1];
+    bool used[kMaxSize + 1];
+};
+
+/**
+ * @class AssignmentSolver
+ * @brief Minimum-cost rectangular assignment, rows <= cols
+ */
+class AssignmentSolver {
+public:
+    // Solves the rows x cols problem held in workspace.cost; returns the
+    // total cost or a negative value if the dimensions are not supported
+    static double solve(AssignmentWorkspace& workspace, int rows, int cols);
+
+    // Workspace owned by the calling thread
+    static AssignmentWorkspace& threadWorkspace();
+};
+
+} // namespace sports
+} // namespace amt
+
+#endif // FORMATION_ASSIGNMENT_H
@@ -7,10 +7,22 @@
  */
 
 #include "formation_detector.h"
+#include "formation_pattern_bank.h"
+#include "formation_assignment.h"
+#include "player_tracker.h"
+#include "formation_history_store.h"
+#include "detection_region_planner.h"
 #include <iostream>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <map>
 
 #ifdef ENABLE_OPENCV_INTEGRATION
 #include <opencv2/opencv.hpp>
@@ -21,39 +33,284 @@
 namespace amt {
 namespace sports {
 
+namespace {
+
+/**
+ * Bounded blocking queue connecting the video pipeline stages. Producers
+ * block once the queue is full so a fast decoder cannot run ahead of
+ * inference and buffer an entire game in memory.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(std::max<size_t>(1, capacity)) {}
+    
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this] { return closed_ || queue_.size() < capacity_; });
+        if (closed_) {
+            return false;
+        }
+        queue_.push_back(std::move(item));
+        not_empty_.notify_one();
+        return true;
+    }
+    
+    // Returns false once the queue is closed and drained
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+        if (queue_.empty()) {
+            return false;
+        }
+        item = std::move(queue_.front());
+        queue_.pop_front();
+        not_full_.notify_one();
+        return true;
+    }
+    
+    // Blocks for the first item, then takes whatever else is ready up to max_items
+    size_t popBatch(std::vector<T>& items, size_t max_items) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_empty_.wait(lock, [this] { return closed_ || !queue_.empty(); });
+        size_t count = 0;
+        while (!queue_.empty() && count < max_items) {
+            items.push_back(std::move(queue_.front()));
+            queue_.pop_front();
+            ++count;
+        }
+        not_full_.notify_all();
+        return count;
+    }
+    
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+    
+    // Closes and drops anything still queued, so consumers stop at once
+    void abort() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        queue_.clear();
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+    
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return queue_.size();
+    }
+
+private:
+    size_t capacity_;
+    bool closed_ = false;
+    std::deque<T> queue_;
+    mutable std::mutex mutex_;
+    std::condition_variable not_empty_;
+    std::condition_variable not_full_;
+};
+
+/**
+ * Limits how far the decoder may run ahead of the oldest frame that has
+ * not been classified yet. Frames leave the preprocess pool out of order,
+ * so the bounded queues alone do not bound the reorder buffer.
+ */
+class FrameWindow {
+public:
+    explicit FrameWindow(int size) : size_(std::max(1, size)) {}
+    
+    // Blocks until frame index fits in the window; false once closed
+    bool acquire(int index) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        open_.wait(lock, [&] { return closed_ || index < next_ + size_; });
+        return !closed_;
+    }
+    
+    // Every frame before next has been classified
+    void advance(int next) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        next_ = next;
+        open_.notify_all();
+    }
+    
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        open_.notify_all();
+    }
+
+private:
+    int size_;
+    int next_ = 0;
+    bool closed_ = false;
+    std::mutex mutex_;
+    std::condition_variable open_;
+};
+
+struct PipelineFrame {
+    int index = 0;
+    cv::Mat frame;
+};
+
+struct PipelineDetection {
+    int index = 0;
+    std::vector<PlayerPosition> players;
+};
+
+double elapsedMs(std::chrono::high_resolution_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+}
+
+/**
+ * Brings a frame view to the 8-bit BGR the inference backends expect.
+ * BGR 8-bit frames pass through untouched; anything else is downscaled
+ * first (keeping aspect) so the depth and colour conversion run at
+ * inference resolution instead of copying the full frame.
+ */
+cv::Mat toInferenceInput(const cv::Mat& frame, FrameColorOrder order, const cv::Size& input_size) {
+    if (frame.empty() || (order == FrameColorOrder::BGR && frame.type() == CV_8UC3)) {
+        return frame;
+    }
+    
+    cv::Mat source = frame;
+    if (frame.depth() == CV_16F) {
+        frame.convertTo(source, CV_32F);  // cv::resize has no half-float path
+    }
+    
+    cv::Mat input;
+    double scale = std::min(1.0, static_cast<double>(std::max(input_size.width, input_size.height)) / 
+                                 std::max(frame.cols, frame.rows));
+    if (scale < 1.0) {
+        cv::resize(source, input, cv::Size(), scale, scale, cv::INTER_AREA);
+    } else {
+        input = source;
+    }
+    
+    if (input.depth() != CV_8U) {
+        double depth_scale = input.depth() == CV_16U ? 1.0 / 257.0 : 
+                             (input.depth() == CV_32F ? 255.0 : 1.0);
+        input.convertTo(input, CV_8U, depth_scale);
+    }
+    
+    switch (input.channels()) {
+    case 1:
+        cv::cvtColor(input, input, cv::COLOR_GRAY2BGR);
+        break;
+    case 4:
+        cv::cvtColor(input, input, order == FrameColorOrder::RGB ? cv::COLOR_RGBA2BGR : cv::COLOR_BGRA2BGR);
+        break;
+    default:
+        if (order == FrameColorOrder::RGB) {
+            cv::cvtColor(input, input, cv::COLOR_RGB2BGR);
+        }
+        break;
+    }
+    return input;
+}
+
+// Single channel view of an 8-bit BGR, BGRA or grayscale frame
+cv::Mat toGray(const cv::Mat& frame) {
+    cv::Mat gray;
+    switch (frame.channels()) {
+    case 3:
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+        break;
+    case 4:
+        cv::cvtColor(frame, gray, cv::COLOR_BGRA2GRAY);
+        break;
+    default:
+        gray = frame;
+        break;
+    }
+    return gray;
+}
+
+} // namespace
+
 class FormationDetector::Impl {
 public:
     // Detection Configuration
     double detection_threshold = 0.7;
     bool live_analysis_active = false;
-    int frames_processed = 0;
+    std::atomic<int> frames_processed{0};     // Advanced by the pipeline's inference thread
     double processing_fps = 0.0;
+    double batches_per_second = 0.0;
+    int batch_size = 8;
     
-    // AI Model
-    #ifdef ENABLE_OPENCV_INTEGRATION
-    cv::dnn::Net detection_model;
-    bool model_loaded = false;
-    #endif
+    // Video Pipeline Configuration
+    int preprocess_workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / 2);
+    int pipeline_queue_capacity = 32;
+    
+    // Per-stage pipeline metrics, written by the stage threads
+    struct StageMetrics {
+        std::atomic<int> queue_depth{0};
+        std::atomic<double> latency_ms{0.0};
+        
+        void recordLatency(double ms) {
+            // Exponential moving average; CAS loop since preprocess workers share it
+            double previous = latency_ms.load();
+            double updated;
+            do {
+                updated = (previous == 0.0) ? ms : previous * 0.9 + ms * 0.1;
+            } while (!latency_ms.compare_exchange_weak(previous, updated));
+        }
+        
+        void reset() {
+            queue_depth = 0;
+            latency_ms = 0.0;
+        }
+    };
+    StageMetrics pipeline_stages[4];
+    
+    StageMetrics& stage(PipelineStage s) {
+        return pipeline_stages[static_cast<int>(s)];
+    }
+    
+    // AI Model - the configured backend, or the rule-based detector until a model is loaded
+    std::unique_ptr<InferenceBackend> backend;
+    InferenceBackendType backend_type = InferenceBackendType::OPENCV_DNN;
+    InferenceOptions inference_options;
+    std::string model_path;
+    
+    // Region of Interest - detect around the previous player extent only
+    bool roi_mode = false;
+    DetectionRegionPlanner region_planner;
     
     // Field Geometry
     FieldGeometry current_field;
     bool field_calibrated = false;
     
+    // Calibration Cache - keypoints tracked frame to frame so a fixed or
+    // slowly panning camera only needs an incremental homography update
+    cv::Mat calibration_gray;
+    cv::Mat scene_signature;
+    std::vector<cv::Point2f> calibration_keypoints;
+    double scene_cut_threshold = 25.0;     // Mean abs diff of the 32x18 signature
+    int min_tracked_keypoints = 12;
+    int full_calibrations = 0;
+    int incremental_calibrations = 0;
+    
     // M.E.L. AI Integration
     bool mel_ai_connected = false;
     
     // Performance Monitoring
     std::chrono::high_resolution_clock::time_point last_frame_time;
     std::vector<double> processing_times;
+    std::vector<double> batch_times;
     
     // Triangle Defense Patterns
     struct DefensePattern {
         FormationType type;
         std::vector<cv::Point2f> expected_positions;
-        double pattern_confidence;
+        double pattern_confidence = 1.0;
     };
     
-    std::vector<DefensePattern> triangle_defense_patterns;
+    // Patterns are laid out structure-of-arrays for the SIMD matcher
+    FormationPatternBank pattern_bank;
     
     Impl() {
         initializeTriangleDefensePatterns();
@@ -74,7 +331,7 @@ public:
             cv::Point2f(0.6f, 0.5f),  // LB2
             cv::Point2f(0.5f, 0.6f),  // LB3
         };
-        triangle_defense_patterns.push_back(larry);
+        pattern_bank.addPattern(larry.type, larry.expected_positions, larry.pattern_confidence);
         
         // Linda Formation (pass coverage emphasis)
         DefensePattern linda;
@@ -89,7 +346,7 @@ public:
             cv::Point2f(0.65f, 0.6f),  // LB2
             cv::Point2f(0.5f, 0.7f),   // LB3
         };
-        triangle_defense_patterns.push_back(linda);
+        pattern_bank.addPattern(linda.type, linda.expected_positions, linda.pattern_confidence);
         
         // Rita Formation (run stopping)
         DefensePattern rita;
@@ -104,24 +361,31 @@ public:
             cv::Point2f(0.7f, 0.55f),  // LB2 (closer)
             cv::Point2f(0.5f, 0.65f),  // LB3
         };
-        triangle_defense_patterns.push_back(rita);
+        pattern_bank.addPattern(rita.type, rita.expected_positions, rita.pattern_confidence);
         
-        std::cout << "[Triangle Defense] Loaded " << triangle_defense_patterns.size() 
-                  << " formation patterns" << std::endl;
+        pattern_bank.build();
+        std::cout << "[Triangle Defense] Loaded " << pattern_bank.size() 
+                  << " formation patterns (" << FormationPatternBank::kernelName() 
+                  << " matcher)" << std::endl;
     }
     
-    void updatePerformanceMetrics() {
+    void updatePerformanceMetrics(int frame_count = 1) {
         auto current_time = std::chrono::high_resolution_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
             current_time - last_frame_time).count();
         
         if (duration > 0) {
-            double current_fps = 1000.0 / duration;
+            // One call covers a whole batch, so frame throughput scales with
+            // the number of frames that went through the forward pass
+            double current_fps = frame_count * 1000000.0 / duration;
+            double current_bps = 1000000.0 / duration;
             processing_times.push_back(current_fps);
+            batch_times.push_back(current_bps);
             
             // Keep only last 30 measurements for rolling average
             if (processing_times.size() > 30) {
                 processing_times.erase(processing_times.begin());
+                batch_times.erase(batch_times.begin());
             }
             
             // Calculate average FPS
@@ -130,10 +394,16 @@ public:
                 total_fps += fps;
             }
             processing_fps = total_fps / processing_times.size();
+            
+            double total_bps = 0.0;
+            for (double bps : batch_times) {
+                total_bps += bps;
+            }
+            batches_per_second = total_bps / batch_times.size();
         }
         
         last_frame_time = current_time;
-        frames_processed++;
+        frames_processed += frame_count;
     }
 };
 
@@ -148,61 +418,58 @@ bool FormationDetector::initialize(const std::string& model_path) {
     std::cout << "[Formation Detector] Initializing with model: " << model_path << std::endl;
     
     #ifdef ENABLE_OPENCV_INTEGRATION
-    try {
-        if (!model_path.empty()) {
-            m_impl->detection_model = cv::dnn::readNetFromDarknet(model_path);
-            m_impl->model_loaded = true;
-            std::cout << "[Formation Detector] AI model loaded successfully" << std::endl;
-        } else {
-            std::cout << "[Formation Detector] No model path provided - using rule-based detection" << std::endl;
-        }
-        return true;
-    } catch (const cv::Exception& e) {
-        std::cerr << "[Formation Detector] Error loading model: " << e.what() << std::endl;
-        return false;
+    if (model_path.empty()) {
+        std::cout << "[Formation Detector] No model path provided - using rule-based detection" << std::endl;
+        m_impl->model_path.clear();
+        m_impl->backend = InferenceBackend::create(InferenceBackendType::RULE_BASED);
+        return m_impl->backend->load("", m_impl->inference_options);
     }
+    return loadDetectionModel(model_path);
     #else
     std::cout << "[Formation Detector] OpenCV not available - using simulation mode" << std::endl;
     return true;
     #endif
 }
 
+bool FormationDetector::loadDetectionModel(const std::string& model_path) {
+    std::unique_ptr<InferenceBackend> backend = InferenceBackend::create(m_impl->backend_type);
+    if (!backend || !backend->load(model_path, m_impl->inference_options)) {
+        std::cerr << "[Formation Detector] Error loading model " << model_path 
+                  << " with " << InferenceBackend::backendName(m_impl->backend_type) << std::endl;
+        return false;
+    }
+    
+    m_impl->backend = std::move(backend);
+    m_impl->model_path = model_path;
+    std::cout << "[Formation Detector] AI model loaded successfully (" << m_impl->backend->name() << ")" << std::endl;
+    return true;
+}
+
 FormationData FormationDetector::detectFormation(const cv::Mat& frame) {
+    return detectFormation(frame, FrameColorOrder::BGR);
+}
+
+FormationData FormationDetector::detectFormation(const cv::Mat& frame, FrameColorOrder order) {
     m_impl->updatePerformanceMetrics();
     
     FormationData formation;
-    formation.frame_number = m_impl->frames_processed;
-    formation.timestamp = m_impl->frames_processed / 30.0; // Assume 30 FPS
     
     #ifdef ENABLE_OPENCV_INTEGRATION
     if (!frame.empty()) {
         // Detect players in frame
-        std::vector<PlayerPosition> players = detectPlayers(frame);
-        
-        // Separate offense and defense
-        std::vector<PlayerPosition> defense;
-        for (const auto& player : players) {
-            if (player.team == "defense") {
-                defense.push_back(player);
-            }
-        }
-        
-        // Classify Triangle Defense formation
-        formation.type = classifyTriangleDefense(defense);
-        formation.confidence = calculateFormationConfidence(defense, formation.type);
-        formation.description = getFormationDescription(formation.type);
-        
-        if (m_impl->mel_ai_connected) {
-            sendAnalysisToMEL(formation);
-        }
+        formation = buildFormation(detectPlayers(frame, order), m_impl->frames_processed);
     } else {
         // Simulation mode for testing
+        formation.frame_number = m_impl->frames_processed;
+        formation.timestamp = m_impl->frames_processed / 30.0; // Assume 30 FPS
         formation.type = FormationType::LARRY;
         formation.confidence = 0.85;
         formation.description = "Simulated Larry Formation";
     }
     #else
     // Fallback simulation when OpenCV not available
+    formation.frame_number = m_impl->frames_processed;
+    formation.timestamp = m_impl->frames_processed / 30.0; // Assume 30 FPS
     formation.type = FormationType::LARRY;
     formation.confidence = 0.85;
     formation.description = "Simulated Larry Formation (OpenCV disabled)";
@@ -214,69 +481,420 @@ FormationData FormationDetector::detectFormation(const cv::Mat& frame) {
     return formation;
 }
 
-std::vector<PlayerPosition> FormationDetector::detectPlayers(const cv::Mat& frame) {
-    std::vector<PlayerPosition> players;
+std::vector<FormationData> FormationDetector::detectFormationBatch(const std::vector<cv::Mat>& frames) {
+    std::vector<FormationData> formations;
+    if (frames.empty()) {
+        return formations;
+    }
+    
+    int first_frame = m_impl->frames_processed + 1;
+    std::vector<std::vector<PlayerPosition>> players = detectPlayersBatch(frames);
+    m_impl->updatePerformanceMetrics(static_cast<int>(frames.size()));
+    
+    formations.reserve(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        formations.push_back(buildFormation(players[i], first_frame + static_cast<int>(i)));
+    }
+    
+    return formations;
+}
+
+FormationData FormationDetector::buildFormation(const std::vector<PlayerPosition>& players, int frame_number) {
+    FormationData formation;
+    formation.frame_number = frame_number;
+    formation.timestamp = frame_number / 30.0; // Assume 30 FPS
+    
+    // Separate offense and defense
+    std::vector<PlayerPosition> defense;
+    for (const auto& player : players) {
+        if (player.team == "defense") {
+            defense.push_back(player);
+        }
+    }
+    
+    // Classify Triangle Defense formation
+    formation.type = classifyTriangleDefense(defense);
+    formation.confidence = calculateFormationConfidence(defense, formation.type);
+    formation.description = getFormationDescription(formation.type);
+    
+    if (m_impl->mel_ai_connected) {
+        sendAnalysisToMEL(formation);
+    }
+    
+    return formation;
+}
+
+std::vector<PlayerPosition> FormationDetector::detectPlayers(const cv::Mat& frame, FrameColorOrder order) {
+    return detectPlayersBatch(std::vector<cv::Mat>{frame}, order).front();
+}
+
+std::vector<std::vector<PlayerPosition>> FormationDetector::detectPlayersBatch(const std::vector<cv::Mat>& frames,
+                                                                               FrameColorOrder order) {
+    std::vector<std::vector<PlayerPosition>> players(frames.size());
     
     #ifdef ENABLE_OPENCV_INTEGRATION
-    if (m_impl->model_loaded) {
-        // AI-based player detection
-        cv::Mat blob;
-        cv::dnn::blobFromImage(frame, blob, 1/255.0, cv::Size(608, 608), cv::Scalar(0,0,0), true, false);
-        m_impl->detection_model.setInput(blob);
+    if (m_impl->backend) {
+        // Skip empty frames but remember where each batch slot came from. In
+        // ROI mode a frame contributes one slot per tile; every frame of a
+        // batch is planned from the previous batch's player extent
+        const cv::Size& input_size = m_impl->inference_options.input_size;
+        std::vector<cv::Mat> batch;
+        std::vector<size_t> batch_to_frame;
+        std::vector<std::vector<cv::Rect>> frame_tiles(frames.size());
+        for (size_t i = 0; i < frames.size(); ++i) {
+            if (frames[i].empty()) {
+                continue;
+            }
+            if (m_impl->roi_mode) {
+                frame_tiles[i] = m_impl->region_planner.plan(frames[i].size(), input_size);
+                for (const auto& tile : frame_tiles[i]) {
+                    batch.push_back(toInferenceInput(frames[i](tile), order, input_size));
+                    batch_to_frame.push_back(i);
+                }
+            } else {
+                batch.push_back(toInferenceInput(frames[i], order, input_size));
+                batch_to_frame.push_back(i);
+            }
+        }
+        if (batch.empty()) {
+            return players;
+        }
         
-        std::vector<cv::Mat> outputs;
-        m_impl->detection_model.forward(outputs, m_impl->detection_model.getUnconnectedOutLayersNames());
+        // One backend call for the whole batch
+        std::vector<std::vector<InferenceDetection>> detections = 
+            m_impl->backend->infer(batch, static_cast<float>(m_impl->detection_threshold));
         
-        // Process detections (simplified)
-        for (size_t i = 0; i < outputs.size(); ++i) {
-            float* data = (float*)outputs[i].data;
-            for (int j = 0; j < outputs[i].rows; ++j, data += outputs[i].cols) {
-                cv::Mat scores = outputs[i].row(j).colRange(5, outputs[i].cols);
-                cv::Point classIdPoint;
-                double confidence;
-                minMaxLoc(scores, 0, &confidence, 0, &classIdPoint);
-                
-                if (confidence > m_impl->detection_threshold) {
-                    PlayerPosition player;
-                    player.position = cv::Point2f(data[0] * frame.cols, data[1] * frame.rows);
-                    player.confidence = confidence;
-                    player.team = (classIdPoint.x == 0) ? "offense" : "defense";
-                    player.jersey_number = -1; // TODO: Implement jersey number recognition
-                    players.push_back(player);
+        // Regroup tile detections per frame, normalized to the full frame
+        std::vector<std::vector<InferenceDetection>> frame_detections(frames.size());
+        if (m_impl->roi_mode) {
+            std::vector<std::vector<InferenceDetection>> tile_detections;
+            for (size_t b = 0; b < batch.size(); ) {
+                size_t frame_index = batch_to_frame[b];
+                size_t tile_count = frame_tiles[frame_index].size();
+                tile_detections.assign(detections.begin() + b, detections.begin() + b + tile_count);
+                frame_detections[frame_index] = m_impl->region_planner.mapToFrame(
+                    tile_detections, frame_tiles[frame_index], frames[frame_index].size());
+                b += tile_count;
+            }
+        } else {
+            for (size_t b = 0; b < batch.size(); ++b) {
+                frame_detections[batch_to_frame[b]] = std::move(detections[b]);
+            }
+        }
+        
+        // Detections are normalized, so map them back onto the original frame
+        for (size_t i = 0; i < frames.size(); ++i) {
+            const cv::Mat& frame = frames[i];
+            std::vector<PlayerPosition>& frame_players = players[i];
+            frame_players.reserve(frame_detections[i].size());
+            
+            for (const auto& detection : frame_detections[i]) {
+                PlayerPosition player;
+                cv::Rect2f box(detection.box.x * frame.cols, detection.box.y * frame.rows,
+                               detection.box.width * frame.cols, detection.box.height * frame.rows);
+                player.position = cv::Point2f(box.x + box.width / 2.0f, box.y + box.height / 2.0f);
+                player.bounding_box = cv::Rect(box);
+                player.confidence = detection.confidence;
+                player.team = (detection.class_id == 0) ? "offense" : "defense";
+                player.jersey_number = -1; // TODO: Implement jersey number recognition
+                frame_players.push_back(player);
+            }
+        }
+        
+        if (m_impl->roi_mode) {
+            // The last non-empty frame seeds the next region
+            for (size_t i = frames.size(); i-- > 0; ) {
+                if (frames[i].empty()) {
+                    continue;
+                }
+                std::vector<cv::Rect> boxes;
+                boxes.reserve(players[i].size());
+                for (const auto& player : players[i]) {
+                    boxes.push_back(player.bounding_box);
                 }
+                m_impl->region_planner.update(boxes);
+                break;
             }
         }
     } else {
         // Rule-based player detection fallback
-        simulatePlayerDetection(frame, players);
+        for (size_t i = 0; i < frames.size(); ++i) {
+            simulatePlayerDetection(frames[i], players[i]);
+        }
     }
     #else
     // Simulation mode
-    simulatePlayerDetection(frame, players);
+    for (size_t i = 0; i < frames.size(); ++i) {
+        simulatePlayerDetection(frames[i], players[i]);
+    }
     #endif
     
     return players;
 }
 
+FieldGeometry FormationDetector::calibrateField(const cv::Mat& frame) {
+    if (frame.empty()) {
+        return m_impl->current_field;
+    }
+    
+    cv::Mat gray = toGray(frame);
+    
+    // Cheap scene signature to detect camera cuts
+    cv::Mat signature;
+    cv::resize(gray, signature, cv::Size(32, 18), 0, 0, cv::INTER_AREA);
+    bool scene_changed = m_impl->scene_signature.empty() ||
+        cv::norm(signature, m_impl->scene_signature, cv::NORM_L1) / signature.total() > m_impl->scene_cut_threshold;
+    m_impl->scene_signature = signature;
+    
+    if (!m_impl->field_calibrated || scene_changed || !refineCalibration(gray)) {
+        m_impl->current_field = performFullCalibration(gray);
+        m_impl->calibration_keypoints = detectKeyPoints(gray);
+        m_impl->field_calibrated = !m_impl->current_field.homography_matrix.empty();
+        m_impl->full_calibrations++;
+    } else {
+        m_impl->incremental_calibrations++;
+    }
+    
+    m_impl->calibration_gray = gray.clone();
+    updateFieldRegion(gray.size());
+    return m_impl->current_field;
+}
+
+void FormationDetector::updateFieldRegion(const cv::Size& frame_size) {
+    const FieldGeometry& field = m_impl->current_field;
+    if (!m_impl->field_calibrated || field.homography_matrix.empty()) {
+        m_impl->region_planner.setFieldRegion(cv::Rect(), 0.0);
+        return;
+    }
+    
+    // Calibrated yard lines plus one line of slack on either end
+    int line_count = 0;
+    for (int i = 0; i < FieldGeometry::kHashMarkLandmark; ++i) {
+        if (field.hasLandmark(i)) {
+            line_count++;
+        }
+    }
+    float last_line = std::max(0, line_count - 1) * 5.0f;
+    std::vector<cv::Point2f> corners = {
+        cv::Point2f(-5.0f, 0.0f), cv::Point2f(last_line + 5.0f, 0.0f),
+        cv::Point2f(last_line + 5.0f, 53.3f), cv::Point2f(-5.0f, 53.3f),
+    };
+    std::vector<cv::Point2f> frame_corners;
+    cv::perspectiveTransform(corners, frame_corners, field.homography_matrix);
+    
+    cv::Rect region = cv::boundingRect(frame_corners) & cv::Rect(0, 0, frame_size.width, frame_size.height);
+    m_impl->region_planner.setFieldRegion(region, field.pixels_per_yard);
+}
+
+void FormationDetector::invalidateFieldCalibration() {
+    m_impl->field_calibrated = false;
+    m_impl->region_planner.setFieldRegion(cv::Rect(), 0.0);
+    m_impl->scene_signature.release();
+    m_impl->calibration_keypoints.clear();
+}
+
+bool FormationDetector::refineCalibration(const cv::Mat& gray) {
+    if (m_impl->calibration_keypoints.size() < static_cast<size_t>(m_impl->min_tracked_keypoints)) {
+        return false;
+    }
+    
+    // Track last frame's field keypoints into this frame
+    std::vector<cv::Point2f> tracked;
+    std::vector<unsigned char> status;
+    std::vector<float> error;
+    cv::calcOpticalFlowPyrLK(m_impl->calibration_gray, gray, m_impl->calibration_keypoints, 
+                             tracked, status, error);
+    
+    std::vector<cv::Point2f> previous_points, current_points;
+    for (size_t i = 0; i < status.size(); ++i) {
+        if (status[i]) {
+            previous_points.push_back(m_impl->calibration_keypoints[i]);
+            current_points.push_back(tracked[i]);
+        }
+    }
+    if (current_points.size() < static_cast<size_t>(m_impl->min_tracked_keypoints)) {
+        return false;
+    }
+    
+    // Frame-to-frame homography from the camera pan/zoom
+    cv::Mat inlier_mask;
+    cv::Mat delta = cv::findHomography(previous_points, current_points, cv::RANSAC, 3.0, inlier_mask);
+    int inliers = inlier_mask.empty() ? 0 : cv::countNonZero(inlier_mask);
+    if (delta.empty() || inliers < m_impl->min_tracked_keypoints || 
+        inliers * 2 < static_cast<int>(current_points.size())) {
+        return false;
+    }
+    
+    // Move only the landmarks that were located; unset ones stay at (0,0)
+    FieldGeometry& field = m_impl->current_field;
+    cv::Point2f* slots[FieldGeometry::kLandmarkCount];
+    for (int i = 0; i < FieldGeometry::kLandmarkCount; ++i) {
+        slots[i] = i < FieldGeometry::kHashMarkLandmark ? &field.yard_lines[i] :
+                   i < FieldGeometry::kSidelineLandmark ? &field.hash_marks[i - FieldGeometry::kHashMarkLandmark] :
+                   &field.sidelines[i - FieldGeometry::kSidelineLandmark];
+    }
+    std::vector<cv::Point2f> landmarks;
+    for (int i = 0; i < FieldGeometry::kLandmarkCount; ++i) {
+        if (field.hasLandmark(i)) {
+            landmarks.push_back(*slots[i]);
+        }
+    }
+    if (!landmarks.empty()) {
+        cv::perspectiveTransform(landmarks, landmarks, delta);
+        size_t next = 0;
+        for (int i = 0; i < FieldGeometry::kLandmarkCount; ++i) {
+            if (field.hasLandmark(i)) {
+                *slots[i] = landmarks[next++];
+            }
+        }
+    }
+    
+    field.homography_matrix = delta * field.homography_matrix;
+    field.pixels_per_yard *= std::sqrt(std::abs(cv::determinant(delta(cv::Rect(0, 0, 2, 2)))));
+    
+    // Keep tracking the inliers; top up from the frame once they thin out
+    std::vector<cv::Point2f> surviving;
+    for (size_t i = 0; i < current_points.size(); ++i) {
+        if (inlier_mask.at<unsigned char>(static_cast<int>(i))) {
+            surviving.push_back(current_points[i]);
+        }
+    }
+    if (surviving.size() < static_cast<size_t>(m_impl->min_tracked_keypoints * 2)) {
+        surviving = detectKeyPoints(gray);
+    }
+    m_impl->calibration_keypoints = surviving;
+    
+    return true;
+}
+
+FieldGeometry FormationDetector::performFullCalibration(const cv::Mat& gray) {
+    FieldGeometry field;
+    field.pixels_per_yard = 0.0;
+    for (auto& line : field.yard_lines) line = cv::Point2f(0, 0);
+    for (auto& mark : field.hash_marks) mark = cv::Point2f(0, 0);
+    for (auto& sideline : field.sidelines) sideline = cv::Point2f(0, 0);
+    
+    // Painted lines are the brightest long structures on the field
+    cv::Mat lines_mask, edges;
+    cv::threshold(gray, lines_mask, 200, 255, cv::THRESH_BINARY);
+    cv::Canny(lines_mask, edges, 50, 150);
+    
+    std::vector<cv::Vec4i> segments;
+    cv::HoughLinesP(edges, segments, 1, CV_PI / 180, 80, gray.rows / 4.0, 10);
+    
+    // Yard lines run roughly top to bottom in sideline footage
+    struct YardLine { float x_mid; cv::Point2f top; cv::Point2f bottom; };
+    std::vector<YardLine> yard_lines;
+    for (const auto& s : segments) {
+        cv::Point2f a(s[0], s[1]), b(s[2], s[3]);
+        if (a.y > b.y) std::swap(a, b);
+        float dy = b.y - a.y;
+        if (dy <= 0.0f || std::abs(b.x - a.x) > dy * 0.6f) {
+            continue;
+        }
+        float x_mid = a.x + (b.x - a.x) * ((gray.rows / 2.0f - a.y) / dy);
+        yard_lines.push_back({x_mid, a, b});
+    }
+    std::sort(yard_lines.begin(), yard_lines.end(), [](const YardLine& l, const YardLine& r) {
+        return l.x_mid < r.x_mid;
+    });
+    
+    // Both edges of a painted line are detected; merge nearby segments
+    std::vector<YardLine> merged;
+    for (const auto& line : yard_lines) {
+        if (merged.empty() || line.x_mid - merged.back().x_mid > 10.0f) {
+            merged.push_back(line);
+        }
+    }
+    if (merged.size() > 11) {
+        merged.resize(11);
+    }
+    if (merged.size() < 2) {
+        std::cout << "[Field Calibration] Not enough yard lines detected" << std::endl;
+        return field;
+    }
+    
+    // Yard lines are 5 yards apart; map their ends onto the 53.3 yard width
+    const float field_width = 53.3f;
+    std::vector<cv::Point2f> field_points, image_points;
+    for (size_t i = 0; i < merged.size(); ++i) {
+        field.yard_lines[i] = cv::Point2f(merged[i].x_mid, gray.rows / 2.0f);
+        field.landmark_mask |= 1u << i;
+        field_points.emplace_back(i * 5.0f, 0.0f);
+        field_points.emplace_back(i * 5.0f, field_width);
+        image_points.push_back(merged[i].top);
+        image_points.push_back(merged[i].bottom);
+    }
+    field.pixels_per_yard = (merged.back().x_mid - merged.front().x_mid) / ((merged.size() - 1) * 5.0);
+    
+    if (field_points.size() >= 4) {
+        field.homography_matrix = cv::findHomography(field_points, image_points, cv::RANSAC, 5.0);
+    }
+    if (!field.homography_matrix.empty()) {
+        // NCAA hash marks sit 20 yards in from each sideline
+        float last_line = (merged.size() - 1) * 5.0f;
+        std::vector<cv::Point2f> field_marks = {
+            cv::Point2f(0.0f, 20.0f), cv::Point2f(0.0f, field_width - 20.0f),
+            cv::Point2f(last_line, 20.0f), cv::Point2f(last_line, field_width - 20.0f),
+            cv::Point2f(last_line / 2.0f, 0.0f), cv::Point2f(last_line / 2.0f, field_width),
+        };
+        std::vector<cv::Point2f> frame_marks;
+        cv::perspectiveTransform(field_marks, frame_marks, field.homography_matrix);
+        std::copy(frame_marks.begin(), frame_marks.begin() + 4, field.hash_marks);
+        std::copy(frame_marks.begin() + 4, frame_marks.end(), field.sidelines);
+        for (int i = FieldGeometry::kHashMarkLandmark; i < FieldGeometry::kLandmarkCount; ++i) {
+            field.landmark_mask |= 1u << i;
+        }
+    }
+    
+    std::cout << "[Field Calibration] Full calibration: " << merged.size() 
+              << " yard lines, " << field.pixels_per_yard << " px/yard" << std::endl;
+    
+    return field;
+}
+
+std::vector<cv::Point2f> FormationDetector::detectKeyPoints(const cv::Mat& frame) {
+    cv::Mat gray = toGray(frame);
+    
+    // Corners on painted markings are stable under player motion
+    cv::Mat lines_mask;
+    cv::threshold(gray, lines_mask, 200, 255, cv::THRESH_BINARY);
+    cv::dilate(lines_mask, lines_mask, cv::Mat());
+    
+    std::vector<cv::Point2f> keypoints;
+    cv::goodFeaturesToTrack(gray, keypoints, 96, 0.01, 12.0, lines_mask);
+    return keypoints;
+}
+
 FormationType FormationDetector::classifyTriangleDefense(const std::vector<PlayerPosition>& defense) {
     if (defense.size() < 8) {
         return FormationType::UNKNOWN;
     }
     
-    // Calculate formation characteristics
-    double formation_width = calculateFormationWidth(defense);
-    double formation_depth = calculateFormationDepth(defense);
-    cv::Point2f center_of_mass = formation_utils::calculateCenterOfMass(defense);
+    // Extent and center of mass in a single pass over the defense
+    FormationDescriptor descriptor = formation_utils::calculateFormationDescriptor(defense);
+    m_impl->pattern_bank.build();
     
-    // Compare against Triangle Defense patterns
+    // Score every Triangle Defense pattern in one vectorized pass
     FormationType best_match = FormationType::UNKNOWN;
     double best_score = 0.0;
     
-    for (const auto& pattern : m_impl->triangle_defense_patterns) {
-        double score = calculatePatternMatch(defense, pattern);
-        if (score > best_score && score > 0.6) {
-            best_score = score;
-            best_match = pattern.type;
+    std::vector<PatternMatch> candidates = m_impl->pattern_bank.match(defense, descriptor, 0, 0.6);
+    
+    // Rescore the candidates, best first, with an optimal one-to-one
+    // assignment. The nearest-defender score never undershoots the assigned
+    // score, so once a candidate cannot beat the current best the rest can be
+    // skipped; a fixed top-k cut could drop the best assignment
+    AssignmentWorkspace& workspace = AssignmentSolver::threadWorkspace();
+    for (const auto& candidate : candidates) {
+        if (candidate.score <= best_score) {
+            break;
+        }
+        PatternMatch refined = m_impl->pattern_bank.scoreAssignment(
+            candidate.pattern_index, defense, descriptor, workspace);
+        if (refined.score > best_score && refined.score > 0.6) {
+            best_score = refined.score;
+            best_match = refined.type;
         }
     }
     
@@ -287,6 +905,341 @@ FormationType FormationDetector::classifyTriangleDefense(const std::vector<Playe
     return best_match;
 }
 
+MOAnalysis FormationDetector::analyzeMO(const std::vector<PlayerPosition>& players) {
+    MOAnalysis analysis;
+    analysis.mo_position = cv::Point2f(0, 0);
+    analysis.recommended_formation = FormationType::UNKNOWN;
+    
+    std::vector<PlayerPosition> offense;
+    for (const auto& player : players) {
+        if (player.team == "offense") {
+            offense.push_back(player);
+        }
+    }
+    
+    // Canonical eligible alignment in the offense's unit square:
+    // two wide receivers, two slots and one back
+    static const cv::Point2f eligible_slots[] = {
+        cv::Point2f(0.0f, 0.0f),
+        cv::Point2f(0.25f, 0.1f),
+        cv::Point2f(0.5f, 1.0f),
+        cv::Point2f(0.75f, 0.1f),
+        cv::Point2f(1.0f, 0.0f),
+    };
+    const int slot_count = 5;
+    const int player_count = std::min(static_cast<int>(offense.size()), AssignmentWorkspace::kMaxSize);
+    
+    FormationDescriptor descriptor = formation_utils::calculateFormationDescriptor(offense);
+    if (player_count < slot_count || descriptor.width() <= 0.0 || descriptor.depth() <= 0.0) {
+        analysis.tactical_note = "Insufficient offensive players detected for MO analysis";
+        return analysis;
+    }
+    
+    // Pick the five eligibles with an optimal slot assignment rather than
+    // trusting detection order
+    AssignmentWorkspace& workspace = AssignmentSolver::threadWorkspace();
+    for (int s = 0; s < slot_count; ++s) {
+        for (int p = 0; p < player_count; ++p) {
+            float x = (offense[p].position.x - descriptor.extent.x) / descriptor.extent.width;
+            float y = (offense[p].position.y - descriptor.extent.y) / descriptor.extent.height;
+            float dx = x - eligible_slots[s].x;
+            float dy = y - eligible_slots[s].y;
+            workspace.cost[s][p] = dx * dx + dy * dy;
+        }
+    }
+    AssignmentSolver::solve(workspace, slot_count, player_count);
+    
+    for (int s = 0; s < slot_count; ++s) {
+        analysis.eligibles.push_back(offense[workspace.row_to_col[s]]);
+    }
+    
+    // MO is the middle eligible counting across the field
+    std::vector<PlayerPosition> by_width = analysis.eligibles;
+    std::sort(by_width.begin(), by_width.end(), [](const PlayerPosition& a, const PlayerPosition& b) {
+        return a.position.x < b.position.x;
+    });
+    analysis.mo_position = by_width[slot_count / 2].position;
+    
+    // Spread eligibles stress coverage, compressed eligibles stress the box
+    double eligible_spread = (by_width.back().position.x - by_width.front().position.x) / descriptor.width();
+    if (eligible_spread > 0.8) {
+        analysis.recommended_formation = FormationType::LINDA;
+        analysis.tactical_note = "Spread eligibles - rotate to Linda coverage shell";
+    } else if (eligible_spread < 0.5) {
+        analysis.recommended_formation = FormationType::RITA;
+        analysis.tactical_note = "Compressed eligibles - Rita box defender on MO";
+    } else {
+        analysis.recommended_formation = FormationType::LARRY;
+        analysis.tactical_note = "Balanced eligibles - standard Larry alignment on MO";
+    }
+    
+    std::cout << "[MO Analysis] MO at (" << analysis.mo_position.x << ", " << analysis.mo_position.y 
+              << ") - " << analysis.tactical_note << std::endl;
+    
+    return analysis;
+}
+
+int FormationDetector::addDefensePattern(FormationType type, const std::vector<cv::Point2f>& expected_positions, 
+                                         const std::string& label) {
+    // The SoA layout is rebuilt lazily on the next classification
+    return m_impl->pattern_bank.addPattern(type, expected_positions, 1.0, label);
+}
+
+size_t FormationDetector::getDefensePatternCount() const {
+    return m_impl->pattern_bank.size();
+}
+
+void FormationDetector::setBatchSize(int batch_size) {
+    m_impl->batch_size = std::max(1, batch_size);
+    std::cout << "[Formation Detector] Inference batch size: " << m_impl->batch_size << std::endl;
+}
+
+int FormationDetector::getBatchSize() const {
+    return m_impl->batch_size;
+}
+
+bool FormationDetector::setInferenceBackend(InferenceBackendType type) {
+    InferenceBackendType previous = m_impl->backend_type;
+    m_impl->backend_type = type;
+    if (m_impl->model_path.empty()) {
+        // Applied on the next initialize() with a model
+        return InferenceBackend::create(type) != nullptr;
+    }
+    if (!loadDetectionModel(m_impl->model_path)) {
+        m_impl->backend_type = previous;
+        return false;
+    }
+    return true;
+}
+
+InferenceBackendType FormationDetector::getInferenceBackend() const {
+    return m_impl->backend ? m_impl->backend->type() : m_impl->backend_type;
+}
+
+const char* FormationDetector::getInferenceBackendName() const {
+    return InferenceBackend::backendName(getInferenceBackend());
+}
+
+bool FormationDetector::setInferenceOptions(const InferenceOptions& options) {
+    m_impl->inference_options = options;
+    if (m_impl->model_path.empty()) {
+        return m_impl->backend ? m_impl->backend->load("", options) : true;
+    }
+    return loadDetectionModel(m_impl->model_path);
+}
+
+InferenceOptions FormationDetector::getInferenceOptions() const {
+    return m_impl->inference_options;
+}
+
+void FormationDetector::setRegionOfInterestMode(bool enabled) {
+    m_impl->roi_mode = enabled;
+    m_impl->region_planner.reset();
+    std::cout << "[Formation Detector] Region of interest mode " << (enabled ? "enabled" : "disabled") << std::endl;
+}
+
+bool FormationDetector::isRegionOfInterestMode() const {
+    return m_impl->roi_mode;
+}
+
+cv::Rect FormationDetector::getLastRegionOfInterest() const {
+    return m_impl->region_planner.lastRegion();
+}
+
+double FormationDetector::getRegionOfInterestCoverage() const {
+    return m_impl->region_planner.getAverageCoverage();
+}
+
+void FormationDetector::setPreprocessWorkers(int workers) {
+    m_impl->preprocess_workers = std::max(1, workers);
+}
+
+void FormationDetector::setPipelineQueueCapacity(int capacity) {
+    m_impl->pipeline_queue_capacity = std::max(1, capacity);
+}
+
+std::vector<FormationData> FormationDetector::processVideoStream(cv::VideoCapture& capture) {
+    std::vector<FormationData> formations;
+    if (!capture.isOpened()) {
+        std::cerr << "[Formation Detector] Video stream is not open" << std::endl;
+        return formations;
+    }
+    
+    const int batch_size = m_impl->batch_size;
+    const int worker_count = m_impl->preprocess_workers;
+    const size_t capacity = static_cast<size_t>(m_impl->pipeline_queue_capacity);
+    
+    std::cout << "[Formation Detector] Processing video stream: " << worker_count 
+              << " preprocess workers, batches of " << batch_size << " frames" << std::endl;
+    
+    // decode -> preprocess pool -> batched inference -> ordered classification
+    BoundedQueue<PipelineFrame> decoded(capacity);
+    BoundedQueue<PipelineFrame> preprocessed(std::max(capacity, static_cast<size_t>(batch_size)));
+    BoundedQueue<PipelineDetection> detected(capacity);
+    
+    // Everything the queues and workers can hold at once; a frame stuck in
+    // one worker stops the decoder after this many instead of letting the
+    // reorder buffer collect the rest of the video behind it
+    FrameWindow in_flight(static_cast<int>(capacity) * 2 + batch_size + worker_count);
+    
+    auto& decode_stats = m_impl->stage(PipelineStage::DECODE);
+    auto& preprocess_stats = m_impl->stage(PipelineStage::PREPROCESS);
+    auto& inference_stats = m_impl->stage(PipelineStage::INFERENCE);
+    auto& classify_stats = m_impl->stage(PipelineStage::CLASSIFY);
+    
+    const int first_frame = m_impl->frames_processed + 1;
+    
+    // The first exception from any stage tears the whole pipeline down and
+    // is rethrown to the caller once every thread has been joined
+    std::mutex failure_mutex;
+    std::exception_ptr failure;
+    auto fail = [&](std::exception_ptr error) {
+        {
+            std::lock_guard<std::mutex> lock(failure_mutex);
+            if (!failure) {
+                failure = error;
+            }
+        }
+        in_flight.close();
+        decoded.abort();
+        preprocessed.abort();
+        detected.abort();
+    };
+    
+    std::thread decode_thread([&]() {
+        try {
+            int index = 0;
+            while (in_flight.acquire(index)) {
+                auto start = std::chrono::high_resolution_clock::now();
+                
+                // Fresh Mat per frame so the decoder never overwrites a queued frame
+                PipelineFrame item;
+                if (!capture.read(item.frame)) {
+                    break;
+                }
+                item.index = index++;
+                decode_stats.recordLatency(elapsedMs(start));
+                
+                if (!decoded.push(std::move(item))) {
+                    break;
+                }
+                preprocess_stats.queue_depth = static_cast<int>(decoded.size());
+            }
+        } catch (...) {
+            fail(std::current_exception());
+        }
+        decoded.close();
+    });
+    
+    std::atomic<int> workers_remaining(worker_count);
+    std::vector<std::thread> preprocess_threads;
+    for (int w = 0; w < worker_count; ++w) {
+        preprocess_threads.emplace_back([&]() {
+            try {
+                PipelineFrame item;
+                while (decoded.pop(item)) {
+                    preprocess_stats.queue_depth = static_cast<int>(decoded.size());
+                    
+                    auto start = std::chrono::high_resolution_clock::now();
+                    item.frame = preprocessFrame(item.frame);
+                    preprocess_stats.recordLatency(elapsedMs(start));
+                    
+                    if (!preprocessed.push(std::move(item))) {
+                        break;
+                    }
+                    inference_stats.queue_depth = static_cast<int>(preprocessed.size());
+                }
+            } catch (...) {
+                fail(std::current_exception());
+            }
+            
+            // Last worker out closes the inference input
+            if (--workers_remaining == 0) {
+                preprocessed.close();
+            }
+        });
+    }
+    
+    // The DNN is not thread safe, so inference runs on a single thread
+    std::thread inference_thread([&]() {
+        try {
+            std::vector<PipelineFrame> batch;
+            std::vector<cv::Mat> frames;
+            while (true) {
+                batch.clear();
+                if (preprocessed.popBatch(batch, batch_size) == 0) {
+                    break;
+                }
+                inference_stats.queue_depth = static_cast<int>(preprocessed.size());
+                
+                frames.clear();
+                for (const auto& item : batch) {
+                    frames.push_back(item.frame);
+                }
+                
+                auto start = std::chrono::high_resolution_clock::now();
+                std::vector<std::vector<PlayerPosition>> players = detectPlayersBatch(frames);
+                m_impl->updatePerformanceMetrics(static_cast<int>(frames.size()));
+                inference_stats.recordLatency(elapsedMs(start) / frames.size());
+                
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    PipelineDetection detection;
+                    detection.index = batch[i].index;
+                    detection.players = std::move(players[i]);
+                    detected.push(std::move(detection));
+                }
+            }
+        } catch (...) {
+            fail(std::current_exception());
+        }
+        detected.close();
+    });
+    
+    // Preprocess workers finish out of order; reassemble by frame number here
+    std::map<int, std::vector<PlayerPosition>> reorder_buffer;
+    int next_index = 0;
+    try {
+        PipelineDetection detection;
+        while (detected.pop(detection)) {
+            reorder_buffer.emplace(detection.index, std::move(detection.players));
+            
+            auto it = reorder_buffer.begin();
+            while (it != reorder_buffer.end() && it->first == next_index) {
+                auto start = std::chrono::high_resolution_clock::now();
+                formations.push_back(buildFormation(it->second, first_frame + next_index));
+                classify_stats.recordLatency(elapsedMs(start));
+                
+                it = reorder_buffer.erase(it);
+                ++next_index;
+            }
+            in_flight.advance(next_index);
+            classify_stats.queue_depth = static_cast<int>(detected.size() + reorder_buffer.size());
+        }
+    } catch (...) {
+        fail(std::current_exception());
+    }
+    
+    decode_thread.join();
+    for (auto& thread : preprocess_threads) {
+        thread.join();
+    }
+    inference_thread.join();
+    
+    for (auto& stats : m_impl->pipeline_stages) {
+        stats.queue_depth = 0;
+    }
+    
+    if (failure) {
+        std::cerr << "[Formation Detector] Video stream aborted after " << next_index << " frames" << std::endl;
+        std::rethrow_exception(failure);
+    }
+    
+    std::cout << "[Formation Detector] Video stream complete - " << next_index 
+              << " frames (" << m_impl->processing_fps << " FPS)" << std::endl;
+    
+    return formations;
+}
+
 void FormationDetector::connectToMELAI() {
     std::cout << "[M.E.L. AI] Establishing connection to master intelligence system..." << std::endl;
     
@@ -313,14 +1266,242 @@ double FormationDetector::getProcessingFPS() const {
     return m_impl->processing_fps;
 }
 
+double FormationDetector::getBatchesPerSecond() const {
+    return m_impl->batches_per_second;
+}
+
 int FormationDetector::getFramesProcessed() const {
     return m_impl->frames_processed;
 }
 
+int FormationDetector::getPipelineQueueDepth(PipelineStage stage) const {
+    return m_impl->stage(stage).queue_depth;
+}
+
+double FormationDetector::getPipelineStageLatency(PipelineStage stage) const {
+    return m_impl->stage(stage).latency_ms;
+}
+
+int FormationDetector::getFullCalibrationCount() const {
+    return m_impl->full_calibrations;
+}
+
+int FormationDetector::getIncrementalCalibrationCount() const {
+    return m_impl->incremental_calibrations;
+}
+
 void FormationDetector::resetStatistics() {
     m_impl->frames_processed = 0;
     m_impl->processing_times.clear();
+    m_impl->batch_times.clear();
     m_impl->processing_fps = 0.0;
+    m_impl->batches_per_second = 0.0;
+    for (auto& stats : m_impl->pipeline_stages) {
+        stats.reset();
+    }
+    m_impl->full_calibrations = 0;
+    m_impl->incremental_calibrations = 0;
+}
+
+// Live Formation Tracker
+class LiveFormationTracker::TrackerImpl {
+public:
+    FormationDetector* detector = nullptr;
+    bool tracking_active = false;
+    int batch_size = 4;
+    int frames_seen = 0;
+    // Frames sent through the detector, including speculative keyframes
+    // whose results were dropped
+    int frames_inferred = 0;
+    
+    // Carries player identities between detector keyframes
+    PlayerTracker player_tracker;
+    
+    // Frames waiting for the next batched forward pass, in arrival order.
+    // Whether a frame is a keyframe is only decided when it is dequeued, so
+    // the decision sees the detections of every keyframe before it
+    struct PendingFrame {
+        cv::Mat frame;
+        double timestamp;
+    };
+    std::vector<PendingFrame> pending_frames;
+    
+    // Time-sorted formation history keyed by timestamp (seconds)
+    TimeIndexedStore<double, FormationData> formation_history;
+};
+
+LiveFormationTracker::LiveFormationTracker(FormationDetector* detector)
+    : m_tracker_impl(std::make_unique<TrackerImpl>()) {
+    m_tracker_impl->detector = detector;
+}
+
+LiveFormationTracker::~LiveFormationTracker() = default;
+
+void LiveFormationTracker::startTracking() {
+    m_tracker_impl->tracking_active = true;
+    std::cout << "[Live Tracker] Tracking started (batch size " << m_tracker_impl->batch_size 
+              << ", detection every " << m_tracker_impl->player_tracker.config().detection_interval 
+              << " frames)" << std::endl;
+}
+
+void LiveFormationTracker::stopTracking() {
+    flushPendingFrames();
+    m_tracker_impl->tracking_active = false;
+    std::cout << "[Live Tracker] Tracking stopped - " 
+              << m_tracker_impl->formation_history.size() << " formations recorded, " 
+              << getSkippedDetections() << " detector runs skipped" << std::endl;
+}
+
+void LiveFormationTracker::processFrame(const cv::Mat& frame, double timestamp) {
+    if (!m_tracker_impl->tracking_active || !m_tracker_impl->detector) {
+        return;
+    }
+    
+    // With nothing queued ahead the tracker state is current: tracked-only
+    // frames go straight through. Otherwise wait until the queue spans a
+    // full batch of interval-scheduled keyframes
+    const PlayerTracker& player_tracker = m_tracker_impl->player_tracker;
+    const size_t batch_span = static_cast<size_t>(m_tracker_impl->batch_size - 1) * 
+                              player_tracker.config().detection_interval + 1;
+    const size_t queued = m_tracker_impl->pending_frames.size() + 1;
+    const bool flush = (queued == 1 && !player_tracker.detectionDue()) || queued >= batch_span;
+    
+    // A frame flushed right away is done with before we return. One held
+    // for a later batch needs our own copy, since the caller may reuse its
+    // buffer (or hand us a view of a decoder frame) in the meantime
+    TrackerImpl::PendingFrame pending;
+    pending.frame = flush ? frame : frame.clone();
+    pending.timestamp = timestamp;
+    m_tracker_impl->pending_frames.push_back(std::move(pending));
+    
+    if (flush) {
+        flushPendingFrames();
+    }
+}
+
+void LiveFormationTracker::flushPendingFrames() {
+    if (m_tracker_impl->pending_frames.empty() || !m_tracker_impl->detector) {
+        return;
+    }
+    
+    std::vector<TrackerImpl::PendingFrame>& pending_frames = m_tracker_impl->pending_frames;
+    PlayerTracker& player_tracker = m_tracker_impl->player_tracker;
+    const size_t interval = static_cast<size_t>(player_tracker.config().detection_interval);
+    const size_t batch_size = static_cast<size_t>(m_tracker_impl->batch_size);
+    
+    // Detections already run for pending frames, keyed by queue position
+    std::map<size_t, std::vector<PlayerPosition>> detections;
+    
+    for (size_t i = 0; i < pending_frames.size(); ++i) {
+        player_tracker.predict();
+        if (player_tracker.scheduleDetection()) {
+            auto detected = detections.find(i);
+            if (detected == detections.end()) {
+                // One forward pass for this keyframe and the ones the interval
+                // will schedule after it; if a confidence drop moves the next
+                // keyframe, the speculative results are simply dropped
+                std::vector<size_t> indices;
+                std::vector<cv::Mat> keyframes;
+                for (size_t k = i; k < pending_frames.size() && keyframes.size() < batch_size; k += interval) {
+                    indices.push_back(k);
+                    keyframes.push_back(pending_frames[k].frame);
+                }
+                std::vector<std::vector<PlayerPosition>> results = 
+                    m_tracker_impl->detector->detectPlayersBatch(keyframes);
+                for (size_t k = 0; k < indices.size(); ++k) {
+                    // A moved schedule can run a speculative keyframe again
+                    if (detections.find(indices[k]) == detections.end()) {
+                        ++m_tracker_impl->frames_inferred;
+                    }
+                    detections[indices[k]] = std::move(results[k]);
+                }
+                detected = detections.find(i);
+            }
+            player_tracker.update(detected->second);
+            detections.erase(detected);
+        }
+        
+        FormationData formation = m_tracker_impl->detector->buildFormation(
+            player_tracker.currentPlayers(), ++m_tracker_impl->frames_seen);
+        formation.timestamp = pending_frames[i].timestamp;
+        m_tracker_impl->formation_history.insert(formation.timestamp, formation);
+    }
+    
+    pending_frames.clear();
+}
+
+void LiveFormationTracker::setBatchSize(int batch_size) {
+    m_tracker_impl->batch_size = std::max(1, batch_size);
+}
+
+int LiveFormationTracker::getBatchSize() const {
+    return m_tracker_impl->batch_size;
+}
+
+void LiveFormationTracker::setDetectionInterval(int frames) {
+    PlayerTracker::Config config = m_tracker_impl->player_tracker.config();
+    config.detection_interval = std::max(1, frames);
+    m_tracker_impl->player_tracker.setConfig(config);
+}
+
+int LiveFormationTracker::getDetectorInvocations() const {
+    return m_tracker_impl->player_tracker.getDetectorInvocations();
+}
+
+int LiveFormationTracker::getSkippedDetections() const {
+    // Frames the tracker carried without a detection may still have been
+    // run speculatively as part of a batch, so count what never went through
+    return m_tracker_impl->frames_seen - m_tracker_impl->frames_inferred;
+}
+
+std::vector<FormationData> LiveFormationTracker::getFormationHistory() {
+    return m_tracker_impl->formation_history.records();
+}
+
+FormationData LiveFormationTracker::getFormationAtTime(double timestamp) {
+    auto neighbours = m_tracker_impl->formation_history.neighbours(timestamp);
+    if (neighbours.before && (!neighbours.after || neighbours.before_time == timestamp)) {
+        return *neighbours.before;
+    }
+    if (!neighbours.before && neighbours.after) {
+        return *neighbours.after;
+    }
+    
+    if (neighbours.before && neighbours.after) {
+        // Formation records carry no player positions, so only the continuous
+        // fields are interpolated: the type (and its description) comes from
+        // the nearer record, and confidence only blends while both sides agree
+        double span = neighbours.after_time - neighbours.before_time;
+        double t = (timestamp - neighbours.before_time) / span;
+        const FormationData& nearer = t <= 0.5 ? *neighbours.before : *neighbours.after;
+        
+        FormationData interpolated = nearer;
+        interpolated.timestamp = timestamp;
+        interpolated.frame_number = neighbours.before->frame_number + static_cast<int>(std::lround(
+            t * (neighbours.after->frame_number - neighbours.before->frame_number)));
+        if (neighbours.before->type == neighbours.after->type) {
+            interpolated.confidence = neighbours.before->confidence + 
+                                      t * (neighbours.after->confidence - neighbours.before->confidence);
+        }
+        return interpolated;
+    }
+    
+    FormationData unknown;
+    unknown.type = FormationType::UNKNOWN;
+    unknown.confidence = 0.0;
+    unknown.frame_number = -1;
+    unknown.timestamp = timestamp;
+    return unknown;
+}
+
+std::vector<FormationData> LiveFormationTracker::analyzePlay(double start_time, double end_time) {
+    std::vector<FormationData> play;
+    auto range = m_tracker_impl->formation_history.rangeIndices(start_time, end_time);
+    play.reserve(range.second - range.first);
+    for (size_t i = range.first; i < range.second; ++i) {
+        play.push_back(m_tracker_impl->formation_history.recordAt(i));
+    }
+    return play;
 }
 
 // Utility function implementations
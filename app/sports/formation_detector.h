@@ -12,6 +12,7 @@
  */
 
 #include "sports_analysis_core.h"
+#include "inference_backend.h"
 #include <opencv2/opencv.hpp>
 #include <vector>
 #include <memory>
@@ -29,6 +30,7 @@ struct PlayerPosition {
     std::string team;          // "offense" or "defense"
     double confidence;         // Detection confidence 0.0-1.0
     cv::Rect bounding_box;     // Player bounding box
+    int track_id = -1;         // Stable ID assigned by PlayerTracker
 };
 
 /**
@@ -40,7 +42,16 @@ struct FieldGeometry {
     cv::Point2f hash_marks[4];     // Hash mark positions
     cv::Point2f sidelines[2];      // Sideline boundaries
     double pixels_per_yard;        // Scale factor
-    cv::Mat homography_matrix;     // Perspective transformation
+    cv::Mat homography_matrix;     // Field (yards) to frame perspective transformation
+    
+    // Landmarks in order yard lines, hash marks, sidelines; bit i of the
+    // mask is set only for landmarks that were actually located
+    static constexpr int kHashMarkLandmark = 11;
+    static constexpr int kSidelineLandmark = 15;
+    static constexpr int kLandmarkCount = 17;
+    unsigned int landmark_mask = 0;
+    
+    bool hasLandmark(int index) const { return (landmark_mask >> index) & 1u; }
 };
 
 /**
@@ -54,6 +65,26 @@ struct MOAnalysis {
     std::string tactical_note;     // Coaching recommendation
 };
 
+/**
+ * @enum PipelineStage
+ * @brief Stages of the offline video processing pipeline
+ */
+enum class PipelineStage {
+    DECODE,        // Frame capture from cv::VideoCapture
+    PREPROCESS,    // preprocessFrame worker pool
+    INFERENCE,     // Batched player detection
+    CLASSIFY       // Ordered Triangle Defense classification
+};
+
+/**
+ * @enum FrameColorOrder
+ * @brief Channel order of frames handed to the detector
+ */
+enum class FrameColorOrder {
+    BGR,           // OpenCV native (cv::VideoCapture, QImage::Format_RGB32)
+    RGB            // Olive decoded frames
+};
+
 /**
  * @class FormationDetector
  * @brief AI-powered formation detection and analysis engine
@@ -66,23 +97,63 @@ public:
     // Core Detection Functions
     bool initialize(const std::string& model_path = "");
     FormationData detectFormation(const cv::Mat& frame);
-    std::vector<PlayerPosition> detectPlayers(const cv::Mat& frame);
+    std::vector<PlayerPosition> detectPlayers(const cv::Mat& frame, FrameColorOrder order = FrameColorOrder::BGR);
+    
+    // Accepts 8/16-bit and float views with 1, 3 or 4 channels in either
+    // order (e.g. FrameMatAdapter views); conversion happens after the
+    // downscale to inference resolution, never on the full frame
+    FormationData detectFormation(const cv::Mat& frame, FrameColorOrder order);
+    
+    // Batched Detection - packs N frames into one NCHW blob and runs a
+    // single forward pass; results are returned in input frame order
+    std::vector<FormationData> detectFormationBatch(const std::vector<cv::Mat>& frames);
+    std::vector<std::vector<PlayerPosition>> detectPlayersBatch(const std::vector<cv::Mat>& frames,
+                                                                FrameColorOrder order = FrameColorOrder::BGR);
+    
+    // Classifies already-located players (detected or tracked) into a formation
+    FormationData buildFormation(const std::vector<PlayerPosition>& players, int frame_number);
     FieldGeometry calibrateField(const cv::Mat& frame);
+    void invalidateFieldCalibration();
     
     // Triangle Defense Analysis
     MOAnalysis analyzeMO(const std::vector<PlayerPosition>& players);
     FormationType classifyTriangleDefense(const std::vector<PlayerPosition>& defense);
     CLSAnalysis performAdvancedCLS(const FormationData& formation, const cv::Mat& frame);
     
+    // Additional patterns (e.g. per-opponent tendencies) on top of Larry/Linda/Rita
+    int addDefensePattern(FormationType type, const std::vector<cv::Point2f>& expected_positions, 
+                          const std::string& label = "");
+    size_t getDefensePatternCount() const;
+    
     // Real-time Processing
     void startLiveAnalysis();
     void stopLiveAnalysis();
-    void processVideoStream(cv::VideoCapture& capture);
+    // Runs the whole stream through the pipeline; formations come back in frame
+    // order. An exception in any stage stops the pipeline and is rethrown here
+    std::vector<FormationData> processVideoStream(cv::VideoCapture& capture);
     
     // Configuration
     void setDetectionThreshold(double threshold);
     void enableFormationType(FormationType type, bool enabled);
     void setFieldDimensions(int yard_width, int yard_height);
+    void setBatchSize(int batch_size);
+    int getBatchSize() const;
+    void setPreprocessWorkers(int workers);
+    void setPipelineQueueCapacity(int capacity);
+    
+    // Inference Backend - switching reloads the current model
+    bool setInferenceBackend(InferenceBackendType type);
+    InferenceBackendType getInferenceBackend() const;
+    const char* getInferenceBackendName() const;
+    bool setInferenceOptions(const InferenceOptions& options);
+    InferenceOptions getInferenceOptions() const;
+    
+    // Region of Interest - search only around the previous frame's players
+    // (clipped to the calibrated field), tiled at native resolution
+    void setRegionOfInterestMode(bool enabled);
+    bool isRegionOfInterestMode() const;
+    cv::Rect getLastRegionOfInterest() const;
+    double getRegionOfInterestCoverage() const;    // Mean fraction of the frame searched
     
     // M.E.L. AI Integration
     void connectToMELAI();
@@ -96,7 +167,12 @@ public:
     
     // Performance Monitoring
     double getProcessingFPS() const;
+    double getBatchesPerSecond() const;
     int getFramesProcessed() const;
+    int getPipelineQueueDepth(PipelineStage stage) const;
+    double getPipelineStageLatency(PipelineStage stage) const;  // Milliseconds per frame
+    int getFullCalibrationCount() const;
+    int getIncrementalCalibrationCount() const;
     void resetStatistics();
 
 private:
@@ -105,6 +181,9 @@ private:
     
     // Internal Processing
     std::vector<cv::Point2f> detectKeyPoints(const cv::Mat& frame);
+    FieldGeometry performFullCalibration(const cv::Mat& gray);
+    bool refineCalibration(const cv::Mat& gray);
+    void updateFieldRegion(const cv::Size& frame_size);
     cv::Mat preprocessFrame(const cv::Mat& input);
     bool validateDetection(const FormationData& formation);
     
@@ -135,9 +214,23 @@ public:
     void startTracking();
     void stopTracking();
     void processFrame(const cv::Mat& frame, double timestamp);
+    void flushPendingFrames();
+    
+    // Frames are buffered and sent to the detector in batches of this size
+    void setBatchSize(int batch_size);
+    int getBatchSize() const;
+    
+    // Temporal tracking - full detection runs every K frames or when
+    // track confidence drops; frames in between use tracked positions.
+    // Skipped detections are frames that never went through the detector
+    void setDetectionInterval(int frames);
+    int getDetectorInvocations() const;
+    int getSkippedDetections() const;
     
     // Timeline Integration
     std::vector<FormationData> getFormationHistory();
+    // Interpolated between the records either side of timestamp: frame number
+    // and (within one formation) confidence blend, the type is the nearer one's
     FormationData getFormationAtTime(double timestamp);
     void exportTimelineData(const std::string& filename);
     
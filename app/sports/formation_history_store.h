@@ -0,0 +1,179 @@
+#ifndef FORMATION_HISTORY_STORE_H
+#define FORMATION_HISTORY_STORE_H
+
+/**
+ * @file formation_history_store.h
+ * @brief Time-indexed columnar store for formation history
+ *
+ * Keeps formations sorted by timestamp with the timestamps in their own
+ * contiguous column, so scrubbing a season of film is a binary search
+ * rather than a scan. Appends in time order are O(1); point lookups,
+ * neighbour queries and range scans are O(log n) (+ k for ranges).
+ *
+ * Shared by LiveFormationTracker (amt::sports::FormationData, seconds)
+ * and TriangleDefenseSync (olive::FormationData, milliseconds).
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace amt {
+namespace sports {
+
+template<typename Timestamp, typename Record>
+class TimeIndexedStore {
+public:
+    /**
+     * @brief Closest records on either side of a timestamp
+     */
+    struct Neighbours {
+        const Record* before = nullptr;   // Latest record at or before the timestamp
+        const Record* after = nullptr;    // Earliest record after the timestamp
+        Timestamp before_time = Timestamp();
+        Timestamp after_time = Timestamp();
+    };
+
+    // Insertion - replaces any record already stored at the same timestamp
+    void insert(Timestamp timestamp, const Record& record) {
+        // Fast path: live tracking and sequential loads arrive in time order
+        if (m_timestamps.empty() || m_timestamps.back() < timestamp) {
+            m_timestamps.push_back(timestamp);
+            m_records.push_back(record);
+            return;
+        }
+
+        auto it = std::lower_bound(m_timestamps.begin(), m_timestamps.end(), timestamp);
+        size_t index = static_cast<size_t>(it - m_timestamps.begin());
+        if (it != m_timestamps.end() && *it == timestamp) {
+            m_records[index] = record;
+            return;
+        }
+        m_timestamps.insert(it, timestamp);
+        m_records.insert(m_records.begin() + index, record);
+    }
+
+    bool remove(Timestamp timestamp) {
+        size_t index = indexOf(timestamp);
+        if (index == npos) {
+            return false;
+        }
+        m_timestamps.erase(m_timestamps.begin() + index);
+        m_records.erase(m_records.begin() + index);
+        return true;
+    }
+
+    // Removes every record matching the predicate in one compaction pass
+    template<typename Predicate>
+    size_t removeIf(Predicate predicate) {
+        size_t write = 0;
+        for (size_t read = 0; read < m_records.size(); ++read) {
+            if (predicate(m_records[read])) {
+                continue;
+            }
+            if (write != read) {
+                m_timestamps[write] = std::move(m_timestamps[read]);
+                m_records[write] = std::move(m_records[read]);
+            }
+            ++write;
+        }
+        size_t removed = m_records.size() - write;
+        m_timestamps.resize(write);
+        m_records.resize(write);
+        return removed;
+    }
+
+    void clear() {
+        m_timestamps.clear();
+        m_records.clear();
+    }
+
+    void reserve(size_t count) {
+        m_timestamps.reserve(count);
+        m_records.reserve(count);
+    }
+
+    // Point Lookups
+    const Record* find(Timestamp timestamp) const {
+        size_t index = indexOf(timestamp);
+        return index == npos ? nullptr : &m_records[index];
+    }
+
+    Record* find(Timestamp timestamp) {
+        size_t index = indexOf(timestamp);
+        return index == npos ? nullptr : &m_records[index];
+    }
+
+    Neighbours neighbours(Timestamp timestamp) const {
+        Neighbours result;
+        auto it = std::upper_bound(m_timestamps.begin(), m_timestamps.end(), timestamp);
+        size_t index = static_cast<size_t>(it - m_timestamps.begin());
+        if (index > 0) {
+            result.before = &m_records[index - 1];
+            result.before_time = m_timestamps[index - 1];
+        }
+        if (index < m_timestamps.size()) {
+            result.after = &m_records[index];
+            result.after_time = m_timestamps[index];
+        }
+        return result;
+    }
+
+    const Record* nearest(Timestamp timestamp) const {
+        Neighbours n = neighbours(timestamp);
+        if (!n.before) return n.after;
+        if (!n.after) return n.before;
+        return (timestamp - n.before_time) <= (n.after_time - timestamp) ? n.before : n.after;
+    }
+
+    // Range Scans - inclusive on both ends
+    std::pair<size_t, size_t> rangeIndices(Timestamp start, Timestamp end) const {
+        auto first = std::lower_bound(m_timestamps.begin(), m_timestamps.end(), start);
+        auto last = std::upper_bound(first, m_timestamps.end(), end);
+        return {static_cast<size_t>(first - m_timestamps.begin()),
+                static_cast<size_t>(last - m_timestamps.begin())};
+    }
+
+    template<typename Visitor>
+    void forEachInRange(Timestamp start, Timestamp end, Visitor visitor) const {
+        auto range = rangeIndices(start, end);
+        for (size_t i = range.first; i < range.second; ++i) {
+            visitor(m_timestamps[i], m_records[i]);
+        }
+    }
+
+    // Column Access
+    size_t size() const { return m_records.size(); }
+    bool empty() const { return m_records.empty(); }
+    Timestamp timestampAt(size_t index) const { return m_timestamps[index]; }
+    const Record& recordAt(size_t index) const { return m_records[index]; }
+    Record& recordAt(size_t index) { return m_records[index]; }
+    const std::vector<Timestamp>& timestamps() const { return m_timestamps; }
+    const std::vector<Record>& records() const { return m_records; }
+
+    // Iteration over records in time order; timestamps must not be edited
+    typename std::vector<Record>::iterator begin() { return m_records.begin(); }
+    typename std::vector<Record>::iterator end() { return m_records.end(); }
+    typename std::vector<Record>::const_iterator begin() const { return m_records.begin(); }
+    typename std::vector<Record>::const_iterator end() const { return m_records.end(); }
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    size_t indexOf(Timestamp timestamp) const {
+        auto it = std::lower_bound(m_timestamps.begin(), m_timestamps.end(), timestamp);
+        if (it == m_timestamps.end() || *it != timestamp) {
+            return npos;
+        }
+        return static_cast<size_t>(it - m_timestamps.begin());
+    }
+
+    std::vector<Timestamp> m_timestamps;
+    std::vector<Record> m_records;
+};
+
+} // namespace sports
+} // namespace amt
+
+#endif // FORMATION_HISTORY_STORE_H
@@ -21,12 +21,21 @@
 #include <QtMath>
 #include <QElapsedTimer>
 #include <QOpenGLFramebufferObject>
+#include <QFontMetricsF>
 
 #include "panel/sequenceviewer/sequenceviewer.h"
 #include "video_timeline_sync.h"
 
 namespace olive {
 
+namespace {
+
+// M.E.L. boxes are keyed by their formation and sit beside its center
+const QString kMELIdPrefix = QStringLiteral("mel_");
+const QPointF kMELBoxOffset(15, -15);
+
+} // namespace
+
 FormationOverlay::FormationOverlay(QWidget* parent)
   : QOpenGLWidget(parent)
   , triangle_defense_sync_(nullptr)
@@ -68,6 +77,9 @@ FormationOverlay::FormationOverlay(QWidget* parent)
   , element_retention_time_ms_(300000) // 5 minutes
   , auto_cleanup_enabled_(true)
   , max_render_history_(100)
+  , frame_pending_(false)
+  , field_layer_dirty_(true)
+  , show_field_overlay_(false)
 {
   qInfo() << "Initializing Formation Overlay";
   
@@ -106,9 +118,9 @@ FormationOverlay::FormationOverlay(QWidget* parent)
   format.setDepthBufferSize(24);
   setFormat(format);
   
-  // Setup timers
+  // Setup timers; both run only while there is something to draw
   render_timer_ = new QTimer(this);
-  render_timer_->setInterval(16); // ~60 FPS
+  render_timer_->setInterval(16); // ~60 FPS frame pacing
   connect(render_timer_, &QTimer::timeout, this, &FormationOverlay::OnRenderTimer);
   
   animation_timer_ = new QTimer(this);
@@ -321,7 +333,11 @@ void FormationOverlay::SetRenderMode(OverlayRenderMode mode)
     }
     
     emit RenderModeChanged(mode);
-    update(); // Trigger repaint
+    
+    {
+      QMutexLocker locker(&overlay_mutex_);
+      InvalidateAll();
+    }
     
     qInfo() << "Overlay render mode changed to:" << static_cast<int>(mode);
   }
@@ -333,8 +349,8 @@ void FormationOverlay::SetRealTimeMode(bool enabled)
     real_time_mode_ = enabled;
 
     if (enabled) {
-      render_timer_->start();
-      if (animations_enabled_) {
+      ScheduleFrame();
+      if (animations_enabled_ && !active_animations_.isEmpty()) {
         animation_timer_->start();
       }
       qInfo() << "Real-time overlay mode enabled";
@@ -351,13 +367,17 @@ void FormationOverlay::UpdateVideoPosition(qint64 timestamp)
   current_video_timestamp_ = timestamp;
   
   if (real_time_mode_) {
-    // Update overlay elements based on current timestamp
-    UpdateFormationShapes();
-    UpdatePlayerPositions();
+    // Update overlay elements based on current timestamp. Elements are
+    // placed in field coordinates, so the playhead moving alone leaves
+    // the screen as it is; anything that does change damages itself.
     UpdateTriangleVisualizations();
     UpdateMELVisualizations();
     
-    update(); // Trigger repaint
+    // Only an update that damaged nothing saved a frame
+    if (!frame_pending_) {
+      QMutexLocker locker(&stats_mutex_);
+      overlay_statistics_.frames_skipped++;
+    }
   }
 }
 
@@ -400,7 +420,9 @@ void FormationOverlay::AddFormation(const FormationData& formation)
   CalculateFormationOutline(formation_shape);
   formation_shape.center_point = FormationOverlayUtils::CalculateFormationCentroid(formation_shape.players);
   
+  InvalidateElement(formation.formation_id);
   formations_[formation.formation_id] = formation_shape;
+  InvalidateElement(formation.formation_id);
   
   // Start animation if enabled
   if (animations_enabled_ && formation_shape.animated) {
@@ -423,6 +445,7 @@ void FormationOverlay::UpdateFormation(const FormationData& formation)
   QMutexLocker locker(&overlay_mutex_);
   
   if (formations_.contains(formation.formation_id)) {
+    InvalidateElement(formation.formation_id);
     FormationShape& formation_shape = formations_[formation.formation_id];
     
     // Update formation properties
@@ -458,6 +481,8 @@ void FormationOverlay::UpdateFormation(const FormationData& formation)
       formation_shape.center_point = FormationOverlayUtils::CalculateFormationCentroid(formation_shape.players);
     }
     
+    InvalidateElement(formation.formation_id);
+    
     qDebug() << "Formation updated in overlay:" << formation.formation_id;
   }
 }
@@ -467,6 +492,8 @@ void FormationOverlay::RemoveFormation(const QString& formation_id)
   QMutexLocker locker(&overlay_mutex_);
   
   if (formations_.contains(formation_id)) {
+    InvalidateElement(formation_id);
+    
     // Remove associated players
     const FormationShape& formation = formations_[formation_id];
     for (const PlayerPosition& player : formation.players) {
@@ -541,7 +568,9 @@ void FormationOverlay::AddTriangleVisualization(TriangleCall call, const Formati
     triangle_viz.call_position = formation_shape.center_point;
   }
   
+  InvalidateElement(triangle_viz.triangle_id);
   triangles_[triangle_viz.triangle_id] = triangle_viz;
+  InvalidateElement(triangle_viz.triangle_id);
   
   // Start animation if enabled
   if (animations_enabled_) {
@@ -563,7 +592,7 @@ void FormationOverlay::AddMELVisualization(const QString& formation_id, const ME
   QMutexLocker locker(&overlay_mutex_);
   
   MELVisualization mel_viz;
-  mel_viz.mel_id = QString("mel_%1").arg(formation_id);
+  mel_viz.mel_id = kMELIdPrefix + formation_id;
   mel_viz.mel_results = results;
   mel_viz.show_detailed_scores = true;
   mel_viz.show_progress_bars = true;
@@ -573,7 +602,7 @@ void FormationOverlay::AddMELVisualization(const QString& formation_id, const ME
   // Position M.E.L. visualization
   if (formations_.contains(formation_id)) {
     const FormationShape& formation = formations_[formation_id];
-    mel_viz.display_position = formation.center_point + QPointF(15, -15);
+    mel_viz.display_position = formation.center_point + kMELBoxOffset;
   } else {
     mel_viz.display_position = QPointF(10, 10); // Top-left corner
   }
@@ -582,7 +611,9 @@ void FormationOverlay::AddMELVisualization(const QString& formation_id, const ME
   mel_viz.background_color = QColor(0, 0, 0, 180); // Semi-transparent black
   mel_viz.text_color = QColor(255, 255, 255);
   
+  InvalidateElement(mel_viz.mel_id);
   mel_visualizations_[mel_viz.mel_id] = mel_viz;
+  InvalidateElement(mel_viz.mel_id);
   
   // Start animation if enabled
   if (animations_enabled_ && mel_viz.animated) {
@@ -617,7 +648,7 @@ void FormationOverlay::ClearOverlay()
   selected_element_id_.clear();
   hovered_element_id_.clear();
   
-  update(); // Trigger repaint
+  InvalidateAll();
   
   qInfo() << "Formation overlay cleared";
 }
@@ -635,7 +666,9 @@ void FormationOverlay::SetOverlayOpacity(double opacity)
   }
   
   emit OverlayOpacityChanged(overlay_opacity_);
-  update();
+  
+  QMutexLocker locker(&overlay_mutex_);
+  InvalidateAll();
 }
 
 void FormationOverlay::SetAnimationsEnabled(bool enabled)
@@ -651,9 +684,13 @@ void FormationOverlay::SetAnimationsEnabled(bool enabled)
     if (animation_timer_) {
       animation_timer_->stop();
     }
+    
+    // Elements that were animating go back into the cached layer
+    QMutexLocker locker(&overlay_mutex_);
+    InvalidateAll();
   } else if (real_time_mode_) {
     // Restart animation timer if in real-time mode
-    if (animation_timer_) {
+    if (animation_timer_ && !active_animations_.isEmpty()) {
       animation_timer_->start();
     }
   }
@@ -671,12 +708,26 @@ void FormationOverlay::SetFieldTemplate(const QString& template_name)
     UpdateFormationShapes();
     UpdatePlayerPositions();
     
-    update(); // Trigger repaint
+    {
+      QMutexLocker locker(&overlay_mutex_);
+      field_layer_dirty_ = true;
+      InvalidateAll();
+    }
     
     qInfo() << "Field template changed to:" << template_name;
   }
 }
 
+void FormationOverlay::SetFieldOverlay(bool enabled, const QSizeF& field_size)
+{
+  QMutexLocker locker(&overlay_mutex_);
+  
+  show_field_overlay_ = enabled;
+  field_dimensions_ = field_size;
+  field_layer_dirty_ = true;
+  ScheduleFrame();
+}
+
 OverlayStatistics FormationOverlay::GetOverlayStatistics() const
 {
   QMutexLocker locker(&stats_mutex_);
@@ -773,7 +824,10 @@ bool FormationOverlay::ImportOverlayConfig(const QJsonObject& config)
     }
   }
   
-  update(); // Trigger repaint
+  {
+    QMutexLocker locker(&overlay_mutex_);
+    InvalidateAll();
+  }
   
   qInfo() << "Overlay configuration imported successfully";
   return true;
@@ -891,6 +945,11 @@ void FormationOverlay::resizeGL(int width, int height)
   // Update all screen positions
   UpdateFormationShapes();
   UpdatePlayerPositions();
+  
+  // Layers are reallocated at the new size on the next paint
+  QMutexLocker locker(&overlay_mutex_);
+  field_layer_dirty_ = true;
+  InvalidateAll();
 }
 
 void FormationOverlay::paintGL()
@@ -910,11 +969,45 @@ void FormationOverlay::paintGL()
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
   
-  // Set up projection matrix
-  QMatrix4x4 projection;
-  projection.ortho(field_bounds_);
+  double damaged_area_ratio = 0.0;
   
-  RenderOverlay();
+  {
+    QMutexLocker locker(&overlay_mutex_);
+    
+    EnsureLayers();
+    QSet<QString> live_elements = LiveElementIds();
+    
+    // Bring the cached layer up to date inside the damaged region only
+    if (!content_damage_.isEmpty()) {
+      QPainter layer_painter(&content_layer_);
+      layer_painter.setRenderHint(QPainter::Antialiasing);
+      layer_painter.setClipRegion(content_damage_);
+      layer_painter.setCompositionMode(QPainter::CompositionMode_Source);
+      layer_painter.fillRect(content_damage_.boundingRect(), Qt::transparent);
+      layer_painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+      
+      RenderOverlay(layer_painter, &content_damage_, live_elements, false);
+      
+      qint64 damaged_area = 0;
+      for (const QRect& rect : content_damage_) {
+        damaged_area += static_cast<qint64>(rect.width()) * rect.height();
+      }
+      damaged_area_ratio = static_cast<double>(damaged_area) / qMax(1, width() * height());
+      content_damage_ = QRegion();
+    }
+    
+    // Composite the field, the cached elements, then animating elements live
+    QPainter painter(this);
+    if (show_field_overlay_) {
+      painter.drawPixmap(0, 0, field_layer_);
+    }
+    painter.drawImage(0, 0, content_layer_);
+    
+    if (!live_elements.isEmpty()) {
+      painter.setRenderHint(QPainter::Antialiasing);
+      RenderOverlay(painter, nullptr, live_elements, true);
+    }
+  }
   
   // Update render statistics
   double render_time = render_timer.nsecsElapsed() / 1000000.0; // Convert to milliseconds
@@ -922,6 +1015,8 @@ void FormationOverlay::paintGL()
   {
     QMutexLocker locker(&stats_mutex_);
     overlay_statistics_.frames_rendered++;
+    overlay_statistics_.last_render_time_ms = render_time;
+    overlay_statistics_.damaged_area_ratio = damaged_area_ratio;
     
     render_time_history_.enqueue(render_time);
     if (render_time_history_.size() > max_render_history_) {
@@ -945,37 +1040,45 @@ void FormationOverlay::mousePressEvent(QMouseEvent* event)
   // Convert to field coordinates
   QPointF field_position = ScreenToField(last_mouse_position_);
   
+  // Selection is drawn highlighted, so both old and new need repainting
+  auto select = [this](const QString& element_id) {
+    QMutexLocker locker(&overlay_mutex_);
+    InvalidateElement(selected_element_id_);
+    selected_element_id_ = element_id;
+    InvalidateElement(selected_element_id_);
+  };
+  
   // Check for clicks on overlay elements
   PlayerPosition* clicked_player = FindPlayerAt(last_mouse_position_);
   if (clicked_player) {
-    selected_element_id_ = clicked_player->player_id;
+    select(clicked_player->player_id);
     emit PlayerClicked(clicked_player->player_id, *clicked_player);
     return;
   }
   
   FormationShape* clicked_formation = FindFormationAt(last_mouse_position_);
   if (clicked_formation) {
-    selected_element_id_ = clicked_formation->formation_id;
+    select(clicked_formation->formation_id);
     emit FormationSelected(clicked_formation->formation_id);
     return;
   }
   
   TriangleVisualization* clicked_triangle = FindTriangleAt(last_mouse_position_);
   if (clicked_triangle) {
-    selected_element_id_ = clicked_triangle->triangle_id;
+    select(clicked_triangle->triangle_id);
     emit TriangleCallClicked(clicked_triangle->call_type, field_position);
     return;
   }
   
   MELVisualization* clicked_mel = FindMELVisualizationAt(last_mouse_position_);
   if (clicked_mel) {
-    selected_element_id_ = clicked_mel->mel_id;
+    select(clicked_mel->mel_id);
     emit MELVisualizationClicked(clicked_mel->mel_id);
     return;
   }
   
   // Clear selection if nothing clicked
-  selected_element_id_.clear();
+  select(QString());
 }
 
 void FormationOverlay::mouseReleaseEvent(QMouseEvent* event)
@@ -1008,7 +1111,9 @@ void FormationOverlay::mouseMoveEvent(QMouseEvent* event)
   
   // Update display if hover state changed
   if (hovered_element_id_ != previous_hovered) {
-    update();
+    QMutexLocker locker(&overlay_mutex_);
+    InvalidateElement(previous_hovered);
+    InvalidateElement(hovered_element_id_);
   }
 }
 
@@ -1027,7 +1132,9 @@ void FormationOverlay::wheelEvent(QWheelEvent* event)
   UpdateFormationShapes();
   UpdatePlayerPositions();
   
-  update();
+  QMutexLocker locker(&overlay_mutex_);
+  field_layer_dirty_ = true;
+  InvalidateAll();
 }
 
 void FormationOverlay::keyPressEvent(QKeyEvent* event)
@@ -1041,7 +1148,6 @@ void FormationOverlay::keyPressEvent(QKeyEvent* event)
     case Qt::Key_R:
       // Reset view
       resizeGL(width(), height());
-      update();
       break;
       
     case Qt::Key_C:
@@ -1199,92 +1305,66 @@ void FormationOverlay::LoadFieldTemplate()
            << "bounds:" << field_bounds_;
 }
 
-void FormationOverlay::RenderOverlay()
+void FormationOverlay::RenderOverlay(QPainter& painter, const QRegion* damage,
+                                     const QSet<QString>& live_elements, bool live_pass)
 {
-  QMutexLocker locker(&overlay_mutex_);
+  // Requires overlay_mutex_
+  bool show_formations = render_mode_ != OverlayRenderMode::MinimalMarkers;
+  bool show_triangles = render_mode_ == OverlayRenderMode::TriangleDefense ||
+                        render_mode_ == OverlayRenderMode::ComprehensiveView;
+  bool show_mel = render_mode_ == OverlayRenderMode::MELVisualization ||
+                  render_mode_ == OverlayRenderMode::ComprehensiveView;
   
-  // Set global opacity
-  glEnable(GL_BLEND);
-  glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+  // The cached pass draws settled elements inside the damage, the live
+  // pass draws animating elements at their current animation opacity
+  auto should_render = [&](const QString& element_id) {
+    if (live_elements.contains(element_id) != live_pass) {
+      return false;
+    }
+    if (damage && !damage->intersects(ElementBounds(element_id).toAlignedRect())) {
+      return false;
+    }
+    painter.setOpacity(live_pass ? AnimationOpacity(element_id) : 1.0);
+    return true;
+  };
   
-  // Render based on current mode
-  switch (render_mode_) {
-    case OverlayRenderMode::MinimalMarkers:
-      RenderPlayerPositions();
-      break;
-      
-    case OverlayRenderMode::BasicFormation:
-      RenderPlayerPositions();
-      RenderFormations();
-      break;
-      
-    case OverlayRenderMode::DetailedFormation:
-      RenderPlayerPositions();
-      RenderFormations();
-      break;
-      
-    case OverlayRenderMode::TriangleDefense:
-      RenderPlayerPositions();
-      RenderFormations();
-      RenderTriangleDefense();
-      break;
-      
-    case OverlayRenderMode::MELVisualization:
-      RenderPlayerPositions();
-      RenderFormations();
-      RenderMELVisualizations();
-      break;
-      
-    case OverlayRenderMode::ComprehensiveView:
-      RenderPlayerPositions();
-      RenderFormations();
-      RenderTriangleDefense();
-      RenderMELVisualizations();
-      break;
-      
-    default:
-      break;
-  }
-}
-
-void FormationOverlay::RenderFormations()
-{
-  // Render formation shapes and connections
-  for (const FormationShape& formation : formations_) {
-    RenderFormationShape(formation);
+  for (const PlayerPosition& player : players_) {
+    if (should_render(player.player_id)) {
+      RenderPlayerPosition(painter, player);
+    }
   }
-}
-
-void FormationOverlay::RenderTriangleDefense()
-{
-  // Render Triangle Defense visualizations
-  for (const TriangleVisualization& triangle : triangles_) {
-    RenderTriangleVisualization(triangle);
+  
+  if (show_formations) {
+    for (const FormationShape& formation : formations_) {
+      if (should_render(formation.formation_id)) {
+        RenderFormationShape(painter, formation);
+      }
+    }
   }
-}
-
-void FormationOverlay::RenderMELVisualizations()
-{
-  // Render M.E.L. score visualizations
-  for (const MELVisualization& mel_viz : mel_visualizations_) {
-    RenderMELVisualization(mel_viz);
+  
+  if (show_triangles) {
+    for (const TriangleVisualization& triangle : triangles_) {
+      if (should_render(triangle.triangle_id)) {
+        RenderTriangleVisualization(painter, triangle);
+      }
+    }
   }
-}
-
-void FormationOverlay::RenderPlayerPositions()
-{
-  // Render player position markers
-  for (const PlayerPosition& player : players_) {
-    RenderPlayerPosition(player);
+  
+  if (show_mel) {
+    for (const MELVisualization& mel_viz : mel_visualizations_) {
+      if (should_render(mel_viz.mel_id)) {
+        RenderMELVisualization(painter, mel_viz);
+      }
+    }
   }
+  
+  painter.setOpacity(1.0);
 }
 
-void FormationOverlay::RenderFormationShape(const FormationShape& formation)
+void FormationOverlay::RenderFormationShape(QPainter& painter, const FormationShape& formation)
 {
   // Render formation outline
   if (!formation.formation_outline.isEmpty()) {
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
     painter.setPen(QPen(formation.formation_color, formation_line_width_));
     painter.setBrush(QBrush(formation.formation_color, Qt::NoBrush));
     
@@ -1305,11 +1385,8 @@ void FormationOverlay::RenderFormationShape(const FormationShape& formation)
   }
 }
 
-void FormationOverlay::RenderPlayerPosition(const PlayerPosition& player)
+void FormationOverlay::RenderPlayerPosition(QPainter& painter, const PlayerPosition& player)
 {
-  QPainter painter(this);
-  painter.setRenderHint(QPainter::Antialiasing);
-  
   QPointF screen_pos = FieldToScreen(player.field_position);
   
   // Draw player marker
@@ -1341,15 +1418,12 @@ void FormationOverlay::RenderPlayerPosition(const PlayerPosition& player)
   }
 }
 
-void FormationOverlay::RenderTriangleVisualization(const TriangleVisualization& triangle)
+void FormationOverlay::RenderTriangleVisualization(QPainter& painter, const TriangleVisualization& triangle)
 {
   if (triangle.triangle_points.size() < 3) {
     return;
   }
   
-  QPainter painter(this);
-  painter.setRenderHint(QPainter::Antialiasing);
-  
   // Convert triangle points to screen coordinates
   QPolygonF screen_triangle;
   for (const QPointF& point : triangle.triangle_points) {
@@ -1388,11 +1462,8 @@ void FormationOverlay::RenderTriangleVisualization(const TriangleVisualization&
   }
 }
 
-void FormationOverlay::RenderMELVisualization(const MELVisualization& mel_viz)
+void FormationOverlay::RenderMELVisualization(QPainter& painter, const MELVisualization& mel_viz)
 {
-  QPainter painter(this);
-  painter.setRenderHint(QPainter::Antialiasing);
-  
   QPointF screen_pos = FieldToScreen(mel_viz.display_position);
   QSizeF screen_size = mel_viz.display_size;
   
@@ -1442,6 +1513,220 @@ void FormationOverlay::RenderMELVisualization(const MELVisualization& mel_viz)
   }
 }
 
+void FormationOverlay::ScheduleFrame()
+{
+  frame_pending_ = true;
+  
+  if (!real_time_mode_) {
+    update();
+  } else if (render_timer_ && !render_timer_->isActive()) {
+    // Frames are paced by the render timer and coalesced between ticks
+    render_timer_->start();
+  }
+}
+
+void FormationOverlay::InvalidateRect(const QRectF& rect)
+{
+  if (rect.isEmpty()) {
+    return;
+  }
+  
+  // Margin covers antialiasing and pen widths straddling the outline
+  content_damage_ += rect.toAlignedRect().adjusted(-2, -2, 2, 2).intersected(this->rect());
+  ScheduleFrame();
+}
+
+void FormationOverlay::InvalidateElement(const QString& element_id)
+{
+  if (!element_id.isEmpty()) {
+    InvalidateRect(ElementBounds(element_id));
+  }
+}
+
+void FormationOverlay::InvalidateAll()
+{
+  content_damage_ = QRegion(rect());
+  ScheduleFrame();
+}
+
+QRectF FormationOverlay::ElementBounds(const QString& element_id) const
+{
+  QFontMetricsF metrics(font());
+  
+  auto player_bounds = [&](const PlayerPosition& player) {
+    QPointF screen_pos = FieldToScreen(player.field_position);
+    double radius = player_marker_size_ + 3; // Includes the confidence ring
+    QRectF bounds(screen_pos.x() - radius, screen_pos.y() - radius, radius * 2, radius * 2);
+    if (show_player_labels_ && !player.position_label.isEmpty()) {
+      QRectF label = metrics.boundingRect(player.position_label);
+      bounds |= label.translated(screen_pos + QPointF(player_marker_size_ + 2, 0));
+    }
+    return bounds;
+  };
+  
+  auto label_bounds = [&](const QPointF& field_position, const QString& label) {
+    return metrics.boundingRect(label).translated(FieldToScreen(field_position));
+  };
+  
+  if (formations_.contains(element_id)) {
+    const FormationShape& formation = formations_[element_id];
+    
+    QPolygonF screen_outline;
+    for (const QPointF& point : formation.formation_outline) {
+      screen_outline.append(FieldToScreen(point));
+    }
+    
+    QRectF bounds = screen_outline.boundingRect().adjusted(-formation_line_width_, -formation_line_width_,
+                                                           formation_line_width_, formation_line_width_);
+    if (show_formation_labels_ && !formation.formation_label.isEmpty()) {
+      bounds |= label_bounds(formation.center_point, formation.formation_label);
+    }
+    for (const PlayerPosition& player : formation.players) {
+      bounds |= player_bounds(player);
+    }
+    return bounds;
+  }
+  
+  if (triangles_.contains(element_id)) {
+    const TriangleVisualization& triangle = triangles_[element_id];
+    
+    QPolygonF screen_triangle;
+    for (const QPointF& point : triangle.triangle_points) {
+      screen_triangle.append(FieldToScreen(point));
+    }
+    
+    QRectF bounds = screen_triangle.boundingRect().adjusted(-triangle_line_width_, -triangle_line_width_,
+                                                            triangle_line_width_, triangle_line_width_);
+    if (!triangle.call_label.isEmpty()) {
+      bounds |= label_bounds(triangle.call_position, triangle.call_label);
+    }
+    if (triangle.show_arrows) {
+      for (const QPolygonF& arrow : FormationOverlayUtils::GenerateTriangleArrows(
+             triangle.call_type, triangle.triangle_points)) {
+        for (const QPointF& point : arrow) {
+          QPointF screen_point = FieldToScreen(point);
+          bounds |= QRectF(screen_point, QSizeF(1, 1));
+        }
+      }
+    }
+    return bounds;
+  }
+  
+  if (mel_visualizations_.contains(element_id)) {
+    const MELVisualization& mel_viz = mel_visualizations_[element_id];
+    return QRectF(FieldToScreen(mel_viz.display_position), mel_viz.display_size);
+  }
+  
+  if (players_.contains(element_id)) {
+    return player_bounds(players_[element_id]);
+  }
+  
+  return QRectF();
+}
+
+QSet<QString> FormationOverlay::LiveElementIds() const
+{
+  QSet<QString> live_elements;
+  if (animations_enabled_) {
+    for (const AnimationState& animation : active_animations_) {
+      live_elements.insert(animation.target_element);
+    }
+  }
+  return live_elements;
+}
+
+double FormationOverlay::AnimationOpacity(const QString& element_id) const
+{
+  for (const AnimationState& animation : active_animations_) {
+    if (animation.target_element != element_id || animation.target_value <= 0.0) {
+      continue;
+    }
+    
+    double progress = qBound(0.0, animation.current_value / animation.target_value, 1.0);
+    if (animation.animation_type == "fade") {
+      return progress;
+    } else if (animation.animation_type == "pulse") {
+      return 0.6 + 0.4 * (1.0 - qAbs(2.0 * progress - 1.0));
+    }
+  }
+  return 1.0;
+}
+
+void FormationOverlay::EnsureLayers()
+{
+  qreal dpr = devicePixelRatioF();
+  QSize layer_size = size() * dpr;
+  
+  if (content_layer_.size() != layer_size) {
+    content_layer_ = QImage(layer_size, QImage::Format_ARGB32_Premultiplied);
+    content_layer_.setDevicePixelRatio(dpr);
+    content_layer_.fill(Qt::transparent);
+    content_damage_ = QRegion(rect());
+    field_layer_dirty_ = true;
+  }
+  
+  if (show_field_overlay_ && field_layer_dirty_) {
+    RenderFieldLayer();
+  }
+}
+
+void FormationOverlay::RenderFieldLayer()
+{
+  qreal dpr = devicePixelRatioF();
+  field_layer_ = QPixmap(size() * dpr);
+  field_layer_.setDevicePixelRatio(dpr);
+  field_layer_.fill(Qt::transparent);
+  field_layer_dirty_ = false;
+  
+  QPainter painter(&field_layer_);
+  painter.setRenderHint(QPainter::Antialiasing);
+  
+  double field_length = field_dimensions_.width();
+  double field_width = field_dimensions_.height();
+  QColor line_color(255, 255, 255, static_cast<int>(overlay_opacity_ * 160));
+  
+  auto field_line = [&](double x1, double y1, double x2, double y2) {
+    painter.drawLine(FieldToScreen(QPointF(x1, y1)), FieldToScreen(QPointF(x2, y2)));
+  };
+  
+  if (field_template_name_ == "american_football") {
+    // End zones
+    QColor end_zone_color = line_color;
+    end_zone_color.setAlpha(line_color.alpha() / 4);
+    painter.fillRect(QRectF(FieldToScreen(QPointF(0, 0)), FieldToScreen(QPointF(10, field_width))),
+                     end_zone_color);
+    painter.fillRect(QRectF(FieldToScreen(QPointF(field_length - 10, 0)),
+                            FieldToScreen(QPointF(field_length, field_width))), end_zone_color);
+    
+    // Yard lines every 5 yards, goal lines heavier
+    for (int yard = 10; yard <= field_length - 10; yard += 5) {
+      bool goal_line = (yard == 10 || yard == field_length - 10);
+      painter.setPen(QPen(line_color, goal_line ? 3 : 1));
+      field_line(yard, 0, yard, field_width);
+    }
+    
+    // Hash marks every yard, 70'9" from each sideline
+    double hash_offset = field_width / 2.0 - 23.58;
+    painter.setPen(QPen(line_color, 1));
+    for (int yard = 11; yard < field_length - 10; yard++) {
+      for (double hash_y : {field_width / 2.0 - hash_offset, field_width / 2.0 + hash_offset}) {
+        field_line(yard, hash_y - 0.33, yard, hash_y + 0.33);
+      }
+    }
+    
+    // Sidelines
+    painter.setPen(QPen(line_color, 3));
+    field_line(0, 0, field_length, 0);
+    field_line(0, field_width, field_length, field_width);
+  } else {
+    // Boundary and halfway line
+    painter.setPen(QPen(line_color, 2));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(QRectF(FieldToScreen(QPointF(0, 0)), FieldToScreen(QPointF(field_length, field_width))));
+    field_line(field_length / 2.0, 0, field_length / 2.0, field_width);
+  }
+}
+
 QPointF FormationOverlay::FieldToScreen(const QPointF& field_coords) const
 {
   // Convert field coordinates to screen coordinates
@@ -1524,9 +1809,21 @@ void FormationOverlay::UpdateMELVisualizations()
 {
   QMutexLocker locker(&overlay_mutex_);
   
-  for (MELVisualization& mel_viz : mel_visualizations_) {
-    // Update M.E.L. visualization positions if needed
-    mel_viz.display_position = FieldToScreen(mel_viz.display_position);
+  // Boxes follow their formation as it moves. Positions stay in field
+  // coordinates and are mapped to the screen at paint time, so a box whose
+  // formation did not move is left alone and damages nothing.
+  for (auto it = mel_visualizations_.begin(); it != mel_visualizations_.end(); ++it) {
+    auto formation = formations_.constFind(it.key().mid(kMELIdPrefix.size()));
+    if (formation == formations_.constEnd()) {
+      continue;
+    }
+    
+    QPointF anchored = formation->center_point + kMELBoxOffset;
+    if (it->display_position != anchored) {
+      InvalidateElement(it.key());
+      it->display_position = anchored;
+      InvalidateElement(it.key());
+    }
   }
 }
 
@@ -1590,6 +1887,12 @@ void FormationOverlay::StartAnimation(const QString& element_id, const QString&
   
   active_animations_[animation.animation_id] = animation;
   
+  // The element now draws live, so take it out of the cached layer
+  InvalidateElement(element_id);
+  if (real_time_mode_ && animation_timer_ && !animation_timer_->isActive()) {
+    animation_timer_->start();
+  }
+  
   qDebug() << "Started animation:" << animation.animation_id
            << "for element:" << element_id
            << "type:" << animation_type;
@@ -1604,21 +1907,39 @@ void FormationOverlay::StopAnimation(const QString& element_id)
       it.remove();
     }
   }
+  
+  InvalidateElement(element_id);
 }
 
 void FormationOverlay::OnRenderTimer()
 {
-  if (real_time_mode_) {
+  if (frame_pending_) {
+    frame_pending_ = false;
     update(); // Trigger repaint
+    return;
   }
+  
+  // Nothing changed since the last frame; idle until something is damaged
+  render_timer_->stop();
+  
+  QMutexLocker locker(&stats_mutex_);
+  overlay_statistics_.frames_skipped++;
 }
 
 void FormationOverlay::OnAnimationTimer()
 {
-  if (animations_enabled_ && !active_animations_.isEmpty()) {
+  if (!animations_enabled_ || active_animations_.isEmpty()) {
+    animation_timer_->stop();
+    return;
+  }
+  
+  {
+    QMutexLocker locker(&overlay_mutex_);
     UpdateAnimations();
-    update(); // Trigger repaint
   }
+  
+  // Animating elements are drawn live over the cached layer
+  ScheduleFrame();
 }
 
 void FormationOverlay::OnStatisticsTimer()
@@ -1645,9 +1966,10 @@ void FormationOverlay::UpdateAnimations()
         animation.start_time = current_time;
         progress = 0.0;
       } else {
-        // Animation complete
-        animation.current_value = animation.target_value;
+        // Animation complete; the element settles into the cached layer
+        QString element_id = animation.target_element;
         it.remove();
+        InvalidateElement(element_id);
         continue;
       }
     }
@@ -1693,6 +2015,8 @@ void FormationOverlay::CleanupOldElements()
   
   QMutexLocker locker(&overlay_mutex_);
   
+  int element_count = formations_.size() + triangles_.size() + mel_visualizations_.size() + players_.size();
+  
   // Clean up old formations
   QMutableMapIterator<QString, FormationShape> formation_it(formations_);
   while (formation_it.hasNext()) {
@@ -1729,6 +2053,10 @@ void FormationOverlay::CleanupOldElements()
     }
   }
   
+  if (formations_.size() + triangles_.size() + mel_visualizations_.size() + players_.size() != element_count) {
+    InvalidateAll();
+  }
+  
   qDebug() << "Cleaned up old overlay elements";
 }
 
@@ -31,6 +31,10 @@
 #include <QJsonArray>
 #include <QDateTime>
 #include <QElapsedTimer>
+#include <QImage>
+#include <QPixmap>
+#include <QRegion>
+#include <QSet>
 
 #include "triangle_defense_sync.h"
 
@@ -121,10 +125,14 @@ struct OverlayStatistics {
   QDateTime last_render_time;
   int active_animations;
   qint64 memory_usage_bytes;
+  double last_render_time_ms;   // Paint cost of the last frame
+  qint64 frames_skipped;        // Render ticks and position updates with nothing to repaint
+  double damaged_area_ratio;    // Share of the cached layer repainted by the last frame
   
   OverlayStatistics() : frames_rendered(0), formations_displayed(0), calls_displayed(0),
                         average_render_time_ms(0.0), current_fps(0.0), active_animations(0),
-                        memory_usage_bytes(0) {}
+                        memory_usage_bytes(0), last_render_time_ms(0.0), frames_skipped(0),
+                        damaged_area_ratio(0.0) {}
 };
 
 /**
@@ -233,6 +241,14 @@ private:
 
 /**
  * @brief Main formation overlay rendering system
+ *
+ * Frames are composited from retained layers: field markings rasterized
+ * once per resize, a cached layer holding every element that is not
+ * animating, and the animating elements drawn live on top. Changes damage
+ * only the screen bounds of the elements they touch, and only that region
+ * of the cached layer is repainted. The render timer coalesces damage into
+ * one frame per tick and stops once nothing is pending; the animation
+ * timer runs only while an animation is active.
  */
 class FormationOverlay : public QWidget
 {
@@ -416,7 +432,8 @@ private:
   void SetupAnimations();
   void ConnectSignals();
   
-  void RenderOverlay();
+  void RenderOverlay(QPainter& painter, const QRegion* damage,
+                     const QSet<QString>& live_elements, bool live_pass);
   void UpdateFormationVisuals();
   void UpdateCallVisuals();
   void UpdateFieldOverlay();
@@ -427,6 +444,18 @@ private:
   QPointF ConvertFieldCoordinates(const QPointF& field_pos, const QSizeF& video_size);
   QPointF ConvertVideoCoordinates(const QPointF& video_pos, const QSizeF& video_size);
   
+  // Damage tracking; all require overlay_mutex_
+  void InvalidateRect(const QRectF& rect);
+  void InvalidateElement(const QString& element_id);
+  void InvalidateAll();
+  QRectF ElementBounds(const QString& element_id) const;
+  QSet<QString> LiveElementIds() const;
+  double AnimationOpacity(const QString& element_id) const;
+  void EnsureLayers();
+  void RenderFieldLayer();
+  
+  void ScheduleFrame();
+  
   void CleanupExpiredElements();
   void UpdateRenderingStatistics();
   void HandleRenderingError(const QString& error);
@@ -476,6 +505,13 @@ private:
   QTimer* cleanup_timer_;
   QTimer* statistics_timer_;
   QElapsedTimer frame_timer_;
+  bool frame_pending_;
+  
+  // Retained layers, guarded by overlay_mutex_
+  QPixmap field_layer_;          // Static field markings
+  bool field_layer_dirty_;
+  QImage content_layer_;         // Every element that is not animating
+  QRegion content_damage_;       // Widget coordinates
   bool rendering_optimizations_enabled_;
   int max_rendered_formations_;
   int max_rendered_calls_;
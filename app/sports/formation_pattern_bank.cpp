@@ -0,0 +1,447 @@
+/**
+ * @file formation_pattern_bank.cpp
+ * @brief Implementation of the vectorized Triangle Defense pattern matcher
+ *
+ * Each pattern slot is scored against its nearest detected defender, with
+ * kLanes patterns evaluated per instruction. The kernel is selected at
+ * compile time from the target instruction set (the sports module builds
+ * with -march=native / /arch:AVX2).
+ */
+
+#include "formation_pattern_bank.h"
+#include "formation_detector.h"
+#include "formation_assignment.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FORMATION_KERNEL_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define FORMATION_KERNEL_SSE 1
+#endif
+
+namespace amt {
+namespace sports {
+
+namespace {
+
+// Score falloff: a mean squared slot distance of 0.01 (10% of the
+// formation extent per slot) scores ~0.6, the classification threshold
+constexpr double kScoreSharpness = 50.0;
+
+constexpr int kSlots = FormationPatternBank::kMaxSlots;
+constexpr int kLanes = FormationPatternBank::kLanes;
+
+struct PlayerSoA {
+    float x[FormationPatternBank::kMaxPlayers];
+    float y[FormationPatternBank::kMaxPlayers];
+    int count = 0;
+};
+
+void scoreBlocksScalar(const float* slot_x, const float* slot_y, const float* slot_weight,
+                       const float* inv_count, int first_block, int last_block,
+                       const PlayerSoA& players, float* out) {
+    for (int b = first_block; b < last_block; ++b) {
+        const size_t base = static_cast<size_t>(b) * kSlots * kLanes;
+        for (int lane = 0; lane < kLanes; ++lane) {
+            float acc = 0.0f;
+            for (int s = 0; s < kSlots; ++s) {
+                const size_t i = base + s * kLanes + lane;
+                float best = FLT_MAX;
+                for (int p = 0; p < players.count; ++p) {
+                    float dx = players.x[p] - slot_x[i];
+                    float dy = players.y[p] - slot_y[i];
+                    best = std::min(best, dx * dx + dy * dy);
+                }
+                acc += best * slot_weight[i];
+            }
+            out[b * kLanes + lane] = acc * inv_count[b * kLanes + lane];
+        }
+    }
+}
+
+#if defined(FORMATION_KERNEL_AVX2)
+void scoreBlocksAVX2(const float* slot_x, const float* slot_y, const float* slot_weight,
+                     const float* inv_count, int first_block, int last_block,
+                     const PlayerSoA& players, float* out) {
+    for (int b = first_block; b < last_block; ++b) {
+        const size_t base = static_cast<size_t>(b) * kSlots * kLanes;
+        __m256 acc = _mm256_setzero_ps();
+        for (int s = 0; s < kSlots; ++s) {
+            const size_t i = base + s * kLanes;
+            __m256 sx = _mm256_loadu_ps(slot_x + i);
+            __m256 sy = _mm256_loadu_ps(slot_y + i);
+            __m256 best = _mm256_set1_ps(FLT_MAX);
+            for (int p = 0; p < players.count; ++p) {
+                __m256 dx = _mm256_sub_ps(_mm256_set1_ps(players.x[p]), sx);
+                __m256 dy = _mm256_sub_ps(_mm256_set1_ps(players.y[p]), sy);
+                __m256 d = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+                best = _mm256_min_ps(best, d);
+            }
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(best, _mm256_loadu_ps(slot_weight + i)));
+        }
+        acc = _mm256_mul_ps(acc, _mm256_loadu_ps(inv_count + b * kLanes));
+        _mm256_storeu_ps(out + b * kLanes, acc);
+    }
+}
+#elif defined(FORMATION_KERNEL_SSE)
+void scoreBlocksSSE(const float* slot_x, const float* slot_y, const float* slot_weight,
+                    const float* inv_count, int first_block, int last_block,
+                    const PlayerSoA& players, float* out) {
+    // Two 4-wide halves per 8-lane block
+    for (int b = first_block; b < last_block; ++b) {
+        const size_t base = static_cast<size_t>(b) * kSlots * kLanes;
+        for (int half = 0; half < kLanes; half += 4) {
+            __m128 acc = _mm_setzero_ps();
+            for (int s = 0; s < kSlots; ++s) {
+                const size_t i = base + s * kLanes + half;
+                __m128 sx = _mm_loadu_ps(slot_x + i);
+                __m128 sy = _mm_loadu_ps(slot_y + i);
+                __m128 best = _mm_set1_ps(FLT_MAX);
+                for (int p = 0; p < players.count; ++p) {
+                    __m128 dx = _mm_sub_ps(_mm_set1_ps(players.x[p]), sx);
+                    __m128 dy = _mm_sub_ps(_mm_set1_ps(players.y[p]), sy);
+                    __m128 d = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+                    best = _mm_min_ps(best, d);
+                }
+                acc = _mm_add_ps(acc, _mm_mul_ps(best, _mm_loadu_ps(slot_weight + i)));
+            }
+            acc = _mm_mul_ps(acc, _mm_loadu_ps(inv_count + b * kLanes + half));
+            _mm_storeu_ps(out + b * kLanes + half, acc);
+        }
+    }
+}
+#endif
+
+void scoreBlocks(const float* slot_x, const float* slot_y, const float* slot_weight,
+                 const float* inv_count, int first_block, int last_block,
+                 const PlayerSoA& players, float* out) {
+#if defined(FORMATION_KERNEL_AVX2)
+    scoreBlocksAVX2(slot_x, slot_y, slot_weight, inv_count, first_block, last_block, players, out);
+#elif defined(FORMATION_KERNEL_SSE)
+    scoreBlocksSSE(slot_x, slot_y, slot_weight, inv_count, first_block, last_block, players, out);
+#else
+    scoreBlocksScalar(slot_x, slot_y, slot_weight, inv_count, first_block, last_block, players, out);
+#endif
+}
+
+int bucketCoordinate(float value, int grid_size) {
+    return std::clamp(static_cast<int>(value * grid_size), 0, grid_size - 1);
+}
+
+} // namespace
+
+FormationPatternBank::FormationPatternBank() = default;
+
+int FormationPatternBank::addPattern(FormationType type, const std::vector<cv::Point2f>& expected_positions,
+                                     double pattern_confidence, const std::string& label) {
+    if (expected_positions.empty() || expected_positions.size() > static_cast<size_t>(kMaxSlots)) {
+        return -1;
+    }
+
+    Pattern pattern;
+    pattern.type = type;
+    pattern.label = label;
+    pattern.prior = pattern_confidence;
+    pattern.positions = normalizePositions(expected_positions);
+
+    cv::Point2f sum(0, 0);
+    for (const auto& position : pattern.positions) {
+        sum += position;
+    }
+    pattern.center = sum * (1.0f / pattern.positions.size());
+
+    m_patterns.push_back(std::move(pattern));
+    m_dirty = true;
+    return static_cast<int>(m_patterns.size()) - 1;
+}
+
+void FormationPatternBank::clear() {
+    m_patterns.clear();
+    m_dirty = true;
+}
+
+void FormationPatternBank::build() {
+    if (!m_dirty) {
+        return;
+    }
+
+    // Group patterns by center-of-mass bucket
+    const int bucket_count = kGridSize * kGridSize;
+    std::vector<std::vector<int>> buckets(bucket_count);
+    for (size_t i = 0; i < m_patterns.size(); ++i) {
+        const cv::Point2f& c = m_patterns[i].center;
+        int cell = bucketCoordinate(c.y, kGridSize) * kGridSize + bucketCoordinate(c.x, kGridSize);
+        buckets[cell].push_back(static_cast<int>(i));
+    }
+
+    int total_blocks = 0;
+    for (const auto& bucket : buckets) {
+        total_blocks += static_cast<int>((bucket.size() + kLanes - 1) / kLanes);
+    }
+
+    const size_t slot_values = static_cast<size_t>(total_blocks) * kSlots * kLanes;
+    m_slot_x.assign(slot_values, 0.0f);
+    m_slot_y.assign(slot_values, 0.0f);
+    m_slot_weight.assign(slot_values, 0.0f);
+    m_inv_slot_count.assign(static_cast<size_t>(total_blocks) * kLanes, 0.0f);
+    m_lane_pattern.assign(static_cast<size_t>(total_blocks) * kLanes, -1);
+    m_bucket_begin.assign(bucket_count, 0);
+    m_bucket_end.assign(bucket_count, 0);
+    m_bucket_slot_counts.assign(bucket_count, 0);
+
+    m_max_prior = 0.0;
+    for (const auto& pattern : m_patterns) {
+        m_max_prior = std::max(m_max_prior, pattern.prior);
+    }
+
+    int block = 0;
+    for (int cell = 0; cell < bucket_count; ++cell) {
+        m_bucket_begin[cell] = block;
+        const auto& bucket = buckets[cell];
+        for (size_t j = 0; j < bucket.size(); ++j) {
+            const int b = block + static_cast<int>(j / kLanes);
+            const int lane = static_cast<int>(j % kLanes);
+            const Pattern& pattern = m_patterns[bucket[j]];
+
+            for (size_t s = 0; s < pattern.positions.size(); ++s) {
+                const size_t i = (static_cast<size_t>(b) * kSlots + s) * kLanes + lane;
+                m_slot_x[i] = pattern.positions[s].x;
+                m_slot_y[i] = pattern.positions[s].y;
+                m_slot_weight[i] = 1.0f;
+            }
+            m_inv_slot_count[b * kLanes + lane] = 1.0f / pattern.positions.size();
+            m_lane_pattern[b * kLanes + lane] = bucket[j];
+            m_bucket_slot_counts[cell] |= static_cast<uint16_t>(1u << pattern.positions.size());
+        }
+        block += static_cast<int>((bucket.size() + kLanes - 1) / kLanes);
+        m_bucket_end[cell] = block;
+    }
+
+    m_dirty = false;
+}
+
+size_t FormationPatternBank::size() const {
+    return m_patterns.size();
+}
+
+FormationType FormationPatternBank::patternType(int index) const {
+    return m_patterns[index].type;
+}
+
+const std::string& FormationPatternBank::patternLabel(int index) const {
+    return m_patterns[index].label;
+}
+
+const std::vector<cv::Point2f>& FormationPatternBank::patternPositions(int index) const {
+    return m_patterns[index].positions;
+}
+
+std::vector<PatternMatch> FormationPatternBank::match(const std::vector<PlayerPosition>& defense,
+                                                      const FormationDescriptor& descriptor,
+                                                      size_t top_k, double min_score) const {
+    std::vector<PatternMatch> matches;
+    if (m_dirty || m_patterns.empty() || defense.empty() ||
+        descriptor.extent.width <= 0.0f || descriptor.extent.height <= 0.0f) {
+        return matches;
+    }
+
+    // Players into the same unit square as the normalized patterns
+    PlayerSoA players;
+    const float inv_width = 1.0f / descriptor.extent.width;
+    const float inv_depth = 1.0f / descriptor.extent.height;
+    for (const auto& player : defense) {
+        if (players.count == kMaxPlayers) {
+            break;
+        }
+        players.x[players.count] = (player.position.x - descriptor.extent.x) * inv_width;
+        players.y[players.count] = (player.position.y - descriptor.extent.y) * inv_depth;
+        ++players.count;
+    }
+    const float center_x = (descriptor.center_of_mass.x - descriptor.extent.x) * inv_width;
+    const float center_y = (descriptor.center_of_mass.y - descriptor.extent.y) * inv_depth;
+
+    // An assignment's mean squared slot distance is at least the squared
+    // distance between the pattern's center of mass and that of the players
+    // it uses, so a pattern whose center is further than radius from theirs
+    // can not reach min_score. With S slots out of P defenders the used
+    // players' center sits within min(1, (P - S) / S) * d_max of the whole
+    // defense's, d_max being the furthest defender from it, which widens
+    // the radius per slot count. Patterns with more slots than defenders
+    // never score above zero
+    double radius = -1.0;
+    if (min_score > 0.0 && static_cast<int>(defense.size()) == players.count) {
+        radius = std::sqrt(std::max(0.0, std::log(m_max_prior / min_score)) / kScoreSharpness);
+    }
+
+    double furthest = 0.0;
+    for (int p = 0; p < players.count; ++p) {
+        const float dx = players.x[p] - center_x;
+        const float dy = players.y[p] - center_y;
+        furthest = std::max(furthest, static_cast<double>(std::sqrt(dx * dx + dy * dy)));
+    }
+    double slot_radius[kMaxSlots + 1];
+    for (int s = 1; s <= kMaxSlots; ++s) {
+        slot_radius[s] = radius + std::min(1.0, static_cast<double>(players.count - s) / s) * furthest;
+    }
+
+    thread_local std::vector<float> scratch;
+    scratch.resize(m_lane_pattern.size());
+
+    const float cell_size = 1.0f / kGridSize;
+    for (int row = 0; row < kGridSize; ++row) {
+        for (int col = 0; col < kGridSize; ++col) {
+            const int cell = row * kGridSize + col;
+            if (m_bucket_begin[cell] == m_bucket_end[cell]) {
+                continue;
+            }
+
+            if (radius >= 0.0) {
+                // The fewest slots any pattern here can fill give the widest radius
+                int fewest_slots = 0;
+                for (int s = 1; s <= std::min(players.count, static_cast<int>(kMaxSlots)); ++s) {
+                    if (m_bucket_slot_counts[cell] & (1u << s)) {
+                        fewest_slots = s;
+                        break;
+                    }
+                }
+                if (fewest_slots == 0) {
+                    continue;
+                }
+
+                float nearest_x = std::clamp(center_x, col * cell_size, (col + 1) * cell_size);
+                float nearest_y = std::clamp(center_y, row * cell_size, (row + 1) * cell_size);
+                float dx = center_x - nearest_x;
+                float dy = center_y - nearest_y;
+                if (std::sqrt(dx * dx + dy * dy) > slot_radius[fewest_slots]) {
+                    continue;
+                }
+            }
+
+            scoreBlocks(m_slot_x.data(), m_slot_y.data(), m_slot_weight.data(), m_inv_slot_count.data(),
+                        m_bucket_begin[cell], m_bucket_end[cell], players, scratch.data());
+
+            for (int lane = m_bucket_begin[cell] * kLanes; lane < m_bucket_end[cell] * kLanes; ++lane) {
+                const int index = m_lane_pattern[lane];
+                if (index < 0) {
+                    continue;
+                }
+                double score = scoreFromDistance(scratch[lane]) * m_patterns[index].prior;
+                if (score >= min_score) {
+                    matches.push_back({index, m_patterns[index].type, score});
+                }
+            }
+        }
+    }
+
+    auto by_score = [](const PatternMatch& a, const PatternMatch& b) { return a.score > b.score; };
+    if (top_k > 0 && matches.size() > top_k) {
+        std::partial_sort(matches.begin(), matches.begin() + top_k, matches.end(), by_score);
+        matches.resize(top_k);
+    } else {
+        std::sort(matches.begin(), matches.end(), by_score);
+    }
+
+    return matches;
+}
+
+PatternMatch FormationPatternBank::scoreAssignment(int pattern_index, const std::vector<PlayerPosition>& defense,
+                                                   const FormationDescriptor& descriptor,
+                                                   AssignmentWorkspace& workspace) const {
+    const Pattern& pattern = m_patterns[pattern_index];
+    PatternMatch result = {pattern_index, pattern.type, 0.0};
+
+    const int slots = static_cast<int>(pattern.positions.size());
+    const int players = std::min(static_cast<int>(defense.size()), AssignmentWorkspace::kMaxSize);
+    if (players < slots || descriptor.extent.width <= 0.0f || descriptor.extent.height <= 0.0f) {
+        return result;
+    }
+
+    const float inv_width = 1.0f / descriptor.extent.width;
+    const float inv_depth = 1.0f / descriptor.extent.height;
+    for (int p = 0; p < players; ++p) {
+        const float x = (defense[p].position.x - descriptor.extent.x) * inv_width;
+        const float y = (defense[p].position.y - descriptor.extent.y) * inv_depth;
+        for (int s = 0; s < slots; ++s) {
+            const float dx = x - pattern.positions[s].x;
+            const float dy = y - pattern.positions[s].y;
+            workspace.cost[s][p] = dx * dx + dy * dy;
+        }
+    }
+
+    double total = AssignmentSolver::solve(workspace, slots, players);
+    if (total >= 0.0) {
+        result.score = scoreFromDistance(total / slots) * pattern.prior;
+    }
+    return result;
+}
+
+std::vector<cv::Point2f> FormationPatternBank::normalizePositions(const std::vector<cv::Point2f>& positions) {
+    std::vector<cv::Point2f> normalized;
+    if (positions.empty()) {
+        return normalized;
+    }
+
+    cv::Point2f min_point = positions[0], max_point = positions[0];
+    for (const auto& position : positions) {
+        min_point.x = std::min(min_point.x, position.x);
+        min_point.y = std::min(min_point.y, position.y);
+        max_point.x = std::max(max_point.x, position.x);
+        max_point.y = std::max(max_point.y, position.y);
+    }
+
+    const float width = std::max(max_point.x - min_point.x, 1e-6f);
+    const float depth = std::max(max_point.y - min_point.y, 1e-6f);
+
+    normalized.reserve(positions.size());
+    for (const auto& position : positions) {
+        normalized.emplace_back((position.x - min_point.x) / width, (position.y - min_point.y) / depth);
+    }
+    return normalized;
+}
+
+double FormationPatternBank::scoreFromDistance(double mean_squared_distance) {
+    return std::exp(-kScoreSharpness * mean_squared_distance);
+}
+
+const char* FormationPatternBank::kernelName() {
+#if defined(FORMATION_KERNEL_AVX2)
+    return "AVX2";
+#elif defined(FORMATION_KERNEL_SSE)
+    return "SSE";
+#else
+    return "scalar";
+#endif
+}
+
+namespace formation_utils {
+    FormationDescriptor calculateFormationDescriptor(const std::vector<PlayerPosition>& players) {
+        FormationDescriptor descriptor;
+        descriptor.extent = cv::Rect2f(0, 0, 0, 0);
+        descriptor.center_of_mass = cv::Point2f(0, 0);
+        if (players.empty()) return descriptor;
+
+        float min_x = players[0].position.x, max_x = min_x;
+        float min_y = players[0].position.y, max_y = min_y;
+        float sum_x = 0, sum_y = 0;
+        for (const auto& player : players) {
+            min_x = std::min(min_x, player.position.x);
+            max_x = std::max(max_x, player.position.x);
+            min_y = std::min(min_y, player.position.y);
+            max_y = std::max(max_y, player.position.y);
+            sum_x += player.position.x;
+            sum_y += player.position.y;
+        }
+
+        descriptor.extent = cv::Rect2f(min_x, min_y, max_x - min_x, max_y - min_y);
+        descriptor.center_of_mass = cv::Point2f(sum_x / players.size(), sum_y / players.size());
+        return descriptor;
+    }
+}
+
+} // namespace sports
+} // namespace amt
@@ -0,0 +1,128 @@
+#ifndef FORMATION_PATTERN_BANK_H
+#define FORMATION_PATTERN_BANK_H
+
+/**
+ * @file formation_pattern_bank.h
+ * @brief Vectorized Triangle Defense pattern matching
+ *
+ * Stores defensive formation patterns in a structure-of-arrays layout
+ * and scores a detected defense against every candidate pattern in a
+ * single SIMD pass (AVX2 / SSE with scalar fallback).
+ *
+ * Patterns are bucketed by their normalized center of mass so that
+ * large per-opponent tendency libraries only score the buckets that
+ * can still beat the match threshold. The center-of-mass bound is
+ * widened for patterns with fewer slots than detected defenders, so a
+ * skipped pattern can never pass scoreAssignment at that threshold.
+ */
+
+#include "sports_analysis_core.h"
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+#include <string>
+
+namespace amt {
+namespace sports {
+
+struct PlayerPosition;
+struct AssignmentWorkspace;
+
+/**
+ * @struct FormationDescriptor
+ * @brief Formation extent and center of mass computed in a single pass
+ */
+struct FormationDescriptor {
+    cv::Rect2f extent;             // Bounding box of all players
+    cv::Point2f center_of_mass;    // Mean player position
+
+    double width() const { return extent.width; }
+    double depth() const { return extent.height; }
+};
+
+/**
+ * @struct PatternMatch
+ * @brief Score of a single pattern against a detected defense
+ */
+struct PatternMatch {
+    int pattern_index;             // Index into the pattern bank
+    FormationType type;            // Formation the pattern represents
+    double score;                  // Match score 0.0-1.0
+};
+
+/**
+ * @class FormationPatternBank
+ * @brief Structure-of-arrays pattern store with a SIMD scoring kernel
+ */
+class FormationPatternBank {
+public:
+    static constexpr int kMaxSlots = 11;      // Defensive slots per pattern
+    static constexpr int kMaxPlayers = 16;    // Detected defenders considered per frame
+    static constexpr int kLanes = 8;          // Patterns per SoA block
+
+    FormationPatternBank();
+
+    // Pattern Management
+    int addPattern(FormationType type, const std::vector<cv::Point2f>& expected_positions,
+                   double pattern_confidence = 1.0, const std::string& label = "");
+    void clear();
+    void build();
+    size_t size() const;
+
+    // Pattern Access; the label is empty unless one was given
+    FormationType patternType(int index) const;
+    const std::string& patternLabel(int index) const;
+    const std::vector<cv::Point2f>& patternPositions(int index) const;
+
+    // Matching - scores every candidate pattern, returns best first
+    std::vector<PatternMatch> match(const std::vector<PlayerPosition>& defense,
+                                    const FormationDescriptor& descriptor,
+                                    size_t top_k, double min_score) const;
+
+    // Rescores one pattern with an optimal one-to-one player-to-slot
+    // assignment; the slot-to-player mapping is left in workspace.row_to_col
+    PatternMatch scoreAssignment(int pattern_index, const std::vector<PlayerPosition>& defense,
+                                 const FormationDescriptor& descriptor,
+                                 AssignmentWorkspace& workspace) const;
+
+    // Normalizes positions into the unit square spanned by the formation extent
+    static std::vector<cv::Point2f> normalizePositions(const std::vector<cv::Point2f>& positions);
+    static double scoreFromDistance(double mean_squared_distance);
+    static const char* kernelName();
+
+private:
+    static constexpr int kGridSize = 8;       // Center-of-mass buckets per axis
+
+    struct Pattern {
+        FormationType type;
+        std::string label;
+        double prior;
+        std::vector<cv::Point2f> positions;   // Normalized slot positions
+        cv::Point2f center;                   // Normalized center of mass
+    };
+
+    std::vector<Pattern> m_patterns;
+    bool m_dirty = true;
+
+    // SoA blocks of kLanes patterns, slot-major inside each block
+    std::vector<float> m_slot_x;
+    std::vector<float> m_slot_y;
+    std::vector<float> m_slot_weight;
+    std::vector<float> m_inv_slot_count;
+    std::vector<int> m_lane_pattern;          // -1 for padding lanes
+
+    // Block range [begin, end) for every center-of-mass bucket
+    std::vector<int> m_bucket_begin;
+    std::vector<int> m_bucket_end;
+    std::vector<uint16_t> m_bucket_slot_counts;   // Bit n set if a pattern has n slots
+    double m_max_prior = 1.0;
+};
+
+namespace formation_utils {
+    FormationDescriptor calculateFormationDescriptor(const std::vector<PlayerPosition>& players);
+}
+
+} // namespace sports
+} // namespace amt
+
+#endif // FORMATION_PATTERN_BANK_H
@@ -0,0 +1,98 @@
+/**
+ * @file frame_mat_adapter.cpp
+ * @brief Zero-copy cv::Mat views over decoded Olive frames
+ */
+
+#include "frame_mat_adapter.h"
+#include <QDebug>
+
+namespace amt {
+namespace sports {
+
+FrameMatView FrameMatAdapter::wrap(const olive::FramePtr& frame) {
+    FrameMatView view;
+    if (!frame || !frame->is_allocated()) {
+        return view;
+    }
+    
+    int type = matType(frame->format(), frame->channel_count());
+    if (type < 0) {
+        qWarning() << "[Frame Adapter] Unsupported frame format" << static_cast<int>(frame->format())
+                   << "with" << frame->channel_count() << "channels";
+        return view;
+    }
+    
+    // Olive decodes to packed RGB(A) rows padded to linesize_bytes()
+    view.frame = frame;
+    view.mat = cv::Mat(frame->height(), frame->width(), type,
+                       const_cast<char*>(frame->const_data()),
+                       static_cast<size_t>(frame->linesize_bytes()));
+    view.color_order = FrameColorOrder::RGB;
+    return view;
+}
+
+cv::Mat FrameMatAdapter::wrap(const QImage& image, FrameColorOrder* color_order) {
+    if (image.isNull()) {
+        return cv::Mat();
+    }
+    
+    int type = -1;
+    FrameColorOrder order = FrameColorOrder::RGB;
+    switch (image.format()) {
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+    case QImage::Format_ARGB32_Premultiplied:
+        // 0xAARRGGBB words, so byte order depends on the host
+        #if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        type = CV_8UC4;
+        order = FrameColorOrder::BGR;
+        #endif
+        break;
+    case QImage::Format_RGBX8888:
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBA8888_Premultiplied:
+        type = CV_8UC4;
+        break;
+    case QImage::Format_RGB888:
+        type = CV_8UC3;
+        break;
+    case QImage::Format_BGR888:
+        type = CV_8UC3;
+        order = FrameColorOrder::BGR;
+        break;
+    default:
+        break;
+    }
+    if (type < 0) {
+        return cv::Mat();
+    }
+    
+    if (color_order) {
+        *color_order = order;
+    }
+    return cv::Mat(image.height(), image.width(), type,
+                   const_cast<uchar*>(image.constBits()),
+                   static_cast<size_t>(image.bytesPerLine()));
+}
+
+int FrameMatAdapter::matType(olive::PixelFormat format, int channel_count) {
+    if (channel_count < 1 || channel_count > 4) {
+        return -1;
+    }
+    
+    switch (format) {
+    case olive::PixelFormat::U8:
+        return CV_MAKETYPE(CV_8U, channel_count);
+    case olive::PixelFormat::U16:
+        return CV_MAKETYPE(CV_16U, channel_count);
+    case olive::PixelFormat::F16:
+        return CV_MAKETYPE(CV_16F, channel_count);
+    case olive::PixelFormat::F32:
+        return CV_MAKETYPE(CV_32F, channel_count);
+    default:
+        return -1;
+    }
+}
+
+} // namespace sports
+} // namespace amt
@@ -0,0 +1,56 @@
+#ifndef FRAME_MAT_ADAPTER_H
+#define FRAME_MAT_ADAPTER_H
+
+/**
+ * @file frame_mat_adapter.h
+ * @brief Zero-copy cv::Mat views over decoded Olive frames
+ *
+ * Wraps olive::Frame buffers (honouring linesize and pixel format) as
+ * cv::Mat headers so decoded pixels reach FormationDetector without a
+ * QImage round trip. The view holds the FramePtr, so the buffer stays
+ * alive for as long as the FrameMatView does.
+ */
+
+#include <QImage>
+
+#include "codec/frame.h"
+#include "formation_detector.h"
+
+namespace amt {
+namespace sports {
+
+/**
+ * @struct FrameMatView
+ * @brief Read-only cv::Mat over a frame buffer plus the owner keeping it alive
+ *
+ * Copies of `mat` do not extend the buffer lifetime; keep the view (or the
+ * FramePtr) around while the Mat is in use.
+ */
+struct FrameMatView {
+    olive::FramePtr frame;                             // Owner of the pixel buffer
+    cv::Mat mat;                                       // Header over frame->const_data()
+    FrameColorOrder color_order = FrameColorOrder::RGB;
+
+    bool isValid() const { return !mat.empty(); }
+};
+
+/**
+ * @class FrameMatAdapter
+ * @brief Builds cv::Mat views over Olive frames and QImages
+ */
+class FrameMatAdapter {
+public:
+    // Returns an invalid view for unallocated frames or unsupported formats
+    static FrameMatView wrap(const olive::FramePtr& frame);
+
+    // View over a 32-bit or 24-bit QImage; empty Mat if the format needs converting
+    static cv::Mat wrap(const QImage& image, FrameColorOrder* color_order);
+
+    // OpenCV element type for an Olive pixel format, -1 if unsupported
+    static int matType(olive::PixelFormat format, int channel_count);
+};
+
+} // namespace sports
+} // namespace amt
+
+#endif // FRAME_MAT_ADAPTER_H
@@ -0,0 +1,451 @@
+/**
+ * @file inference_backend.cpp
+ * @brief OpenCV DNN, ONNX Runtime and rule-based player detection backends
+ */
+
+#include "inference_backend.h"
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#ifdef ENABLE_OPENCV_INTEGRATION
+#include <opencv2/dnn.hpp>
+#endif
+
+#ifdef ONNX_AI_ENABLED
+#include <onnxruntime_cxx_api.h>
+#endif
+
+namespace amt {
+namespace sports {
+
+namespace {
+
+int resolveThreadCount(int requested) {
+    if (requested > 0) {
+        return requested;
+    }
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+// YOLO-style rows: [cx, cy, w, h, objectness, class scores...], normalized
+void appendYoloDetections(const float* data, int rows, int cols, float confidence_threshold,
+                          std::vector<InferenceDetection>& detections) {
+    for (int row = 0; row < rows; ++row, data += cols) {
+        const float* scores = data + 5;
+        const float* best = std::max_element(scores, data + cols);
+        if (best == data + cols || *best <= confidence_threshold) {
+            continue;
+        }
+        InferenceDetection detection;
+        detection.box = cv::Rect2f(data[0] - data[2] / 2.0f, data[1] - data[3] / 2.0f, data[2], data[3]);
+        detection.class_id = static_cast<int>(best - scores);
+        detection.confidence = *best;
+        detections.push_back(detection);
+    }
+}
+
+#ifdef ENABLE_OPENCV_INTEGRATION
+
+/**
+ * @class OpenCvDnnBackend
+ * @brief cv::dnn::Net on the CPU target
+ */
+class OpenCvDnnBackend : public InferenceBackend {
+public:
+    bool load(const std::string& model_path, const InferenceOptions& options) override {
+        m_options = options;
+        m_loaded = false;
+        try {
+            m_net = cv::dnn::readNet(resolveModelPath(model_path, options));
+            m_net.setPreferableBackend(cv::dnn::DNN_BACKEND_OPENCV);
+            m_net.setPreferableTarget(cv::dnn::DNN_TARGET_CPU);
+            m_output_names = m_net.getUnconnectedOutLayersNames();
+            m_loaded = !m_net.empty();
+        } catch (const cv::Exception& e) {
+            std::cerr << "[Inference Backend] OpenCV DNN failed to load " << model_path << ": " << e.what() << std::endl;
+            return false;
+        }
+
+        // cv::dnn has a single process-wide pool; inter-op settings do not apply
+        cv::setNumThreads(options.num_threads > 0 ? options.num_threads : -1);
+        return m_loaded;
+    }
+
+    bool isLoaded() const override { return m_loaded; }
+
+    std::vector<std::vector<InferenceDetection>> infer(const std::vector<cv::Mat>& frames,
+                                                       float confidence_threshold) override {
+        std::vector<std::vector<InferenceDetection>> detections(frames.size());
+        if (!m_loaded || frames.empty()) {
+            return detections;
+        }
+
+        // One NCHW blob for the whole batch
+        cv::Mat blob;
+        cv::dnn::blobFromImages(frames, blob, 1/255.0, m_options.input_size, cv::Scalar(0,0,0), true, false);
+        m_net.setInput(blob);
+
+        std::vector<cv::Mat> outputs;
+        m_net.forward(outputs, m_output_names);
+
+        // Region layers stack the detections of every image in the batch, so
+        // each output holds rows / batch_size rows per input frame
+        const int batch_count = static_cast<int>(frames.size());
+        for (const auto& output : outputs) {
+            const int rows_per_frame = output.rows / batch_count;
+            for (int b = 0; b < batch_count; ++b) {
+                appendYoloDetections(output.ptr<float>(b * rows_per_frame), rows_per_frame, output.cols,
+                                     confidence_threshold, detections[b]);
+            }
+        }
+        return detections;
+    }
+
+    InferenceBackendType type() const override { return InferenceBackendType::OPENCV_DNN; }
+    const char* name() const override { return "OpenCV DNN"; }
+
+private:
+    cv::dnn::Net m_net;
+    std::vector<std::string> m_output_names;
+    bool m_loaded = false;
+};
+
+#endif
+
+#ifdef ONNX_AI_ENABLED
+
+/**
+ * @class OnnxRuntimeBackend
+ * @brief ONNX Runtime CPU execution provider
+ */
+class OnnxRuntimeBackend : public InferenceBackend {
+public:
+    OnnxRuntimeBackend()
+        : m_env(ORT_LOGGING_LEVEL_WARNING, "amt_formation_detector") {}
+
+    bool load(const std::string& model_path, const InferenceOptions& options) override {
+        m_options = options;
+        m_session.reset();
+
+        Ort::SessionOptions session_options;
+        int intra_op = resolveThreadCount(options.intra_op_threads > 0 ? options.intra_op_threads : options.num_threads);
+        session_options.SetIntraOpNumThreads(intra_op);
+        session_options.SetInterOpNumThreads(std::max(1, options.inter_op_threads));
+        session_options.SetExecutionMode(options.inter_op_threads > 1 ? ExecutionMode::ORT_PARALLEL
+                                                                      : ExecutionMode::ORT_SEQUENTIAL);
+        session_options.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
+
+        std::string path = resolveModelPath(model_path, options);
+        try {
+            std::basic_string<ORTCHAR_T> ort_path(path.begin(), path.end());
+            m_session = std::make_unique<Ort::Session>(m_env, ort_path.c_str(), session_options);
+
+            Ort::AllocatorWithDefaultOptions allocator;
+            m_input_name = m_session->GetInputNameAllocated(0, allocator).get();
+            m_output_names.clear();
+            for (size_t i = 0; i < m_session->GetOutputCount(); ++i) {
+                m_output_names.push_back(m_session->GetOutputNameAllocated(i, allocator).get());
+            }
+
+            // Exported models often have a fixed batch dimension
+            auto input_shape = m_session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+            m_fixed_batch = (!input_shape.empty() && input_shape[0] > 0) ? static_cast<int>(input_shape[0]) : 0;
+        } catch (const Ort::Exception& e) {
+            std::cerr << "[Inference Backend] ONNX Runtime failed to load " << path << ": " << e.what() << std::endl;
+            m_session.reset();
+            return false;
+        }
+        return true;
+    }
+
+    bool isLoaded() const override { return m_session != nullptr; }
+
+    std::vector<std::vector<InferenceDetection>> infer(const std::vector<cv::Mat>& frames,
+                                                       float confidence_threshold) override {
+        std::vector<std::vector<InferenceDetection>> detections(frames.size());
+        if (!m_session || frames.empty()) {
+            return detections;
+        }
+
+        const int chunk = m_fixed_batch > 0 ? m_fixed_batch : static_cast<int>(frames.size());
+        for (size_t first = 0; first < frames.size(); first += chunk) {
+            size_t count = std::min(frames.size() - first, static_cast<size_t>(chunk));
+            runChunk(frames, first, count, chunk, confidence_threshold, detections);
+        }
+        return detections;
+    }
+
+    InferenceBackendType type() const override { return InferenceBackendType::ONNX_RUNTIME; }
+    const char* name() const override { return "ONNX Runtime"; }
+
+private:
+    void runChunk(const std::vector<cv::Mat>& frames, size_t first, size_t count, int batch,
+                  float confidence_threshold, std::vector<std::vector<InferenceDetection>>& detections) {
+        const int width = m_options.input_size.width;
+        const int height = m_options.input_size.height;
+        const size_t plane = static_cast<size_t>(width) * height;
+        m_input.assign(static_cast<size_t>(batch) * 3 * plane, 0.0f);
+
+        // NCHW, RGB, scaled to [0, 1]; a short final chunk is zero padded
+        cv::Mat resized, rgb;
+        for (size_t i = 0; i < count; ++i) {
+            cv::resize(frames[first + i], resized, m_options.input_size);
+            cv::cvtColor(resized, rgb, cv::COLOR_BGR2RGB);
+            float* image = m_input.data() + i * 3 * plane;
+            std::vector<cv::Mat> channels = {
+                cv::Mat(height, width, CV_32F, image),
+                cv::Mat(height, width, CV_32F, image + plane),
+                cv::Mat(height, width, CV_32F, image + 2 * plane),
+            };
+            std::vector<cv::Mat> planes;
+            cv::split(rgb, planes);
+            for (int c = 0; c < 3; ++c) {
+                planes[c].convertTo(channels[c], CV_32F, 1/255.0);
+            }
+        }
+
+        const int64_t shape[4] = {batch, 3, height, width};
+        Ort::MemoryInfo memory = Ort::MemoryInfo::CreateCpu(OrtArenaAllocator, OrtMemTypeDefault);
+        Ort::Value input = Ort::Value::CreateTensor<float>(memory, m_input.data(), m_input.size(), shape, 4);
+
+        const char* input_names[] = {m_input_name.c_str()};
+        std::vector<const char*> output_names;
+        for (const auto& output_name : m_output_names) {
+            output_names.push_back(output_name.c_str());
+        }
+        auto outputs = m_session->Run(Ort::RunOptions{nullptr}, input_names, &input, 1,
+                                      output_names.data(), output_names.size());
+
+        for (auto& output : outputs) {
+            auto output_shape = output.GetTensorTypeAndShapeInfo().GetShape();
+            if (output_shape.size() < 2) {
+                continue;
+            }
+            // [batch, rows, cols] or rows of all images stacked as [batch * rows, cols]
+            const int cols = static_cast<int>(output_shape.back());
+            const int64_t total_rows = output.GetTensorTypeAndShapeInfo().GetElementCount() / cols;
+            const int rows_per_frame = static_cast<int>(total_rows / batch);
+            const float* data = output.GetTensorData<float>();
+            for (size_t i = 0; i < count; ++i) {
+                appendYoloDetections(data + i * rows_per_frame * cols, rows_per_frame, cols,
+                                     confidence_threshold, detections[first + i]);
+            }
+        }
+    }
+
+    Ort::Env m_env;
+    std::unique_ptr<Ort::Session> m_session;
+    std::string m_input_name;
+    std::vector<std::string> m_output_names;
+    std::vector<float> m_input;
+    int m_fixed_batch = 0;
+};
+
+#endif
+
+/**
+ * @class RuleBasedBackend
+ * @brief Model-free detection: non-turf blobs of player size, split into
+ *        two teams by jersey hue
+ */
+class RuleBasedBackend : public InferenceBackend {
+public:
+    bool load(const std::string&, const InferenceOptions& options) override {
+        m_options = options;
+        return true;
+    }
+
+    bool isLoaded() const override { return true; }
+
+    std::vector<std::vector<InferenceDetection>> infer(const std::vector<cv::Mat>& frames,
+                                                       float confidence_threshold) override {
+        std::vector<std::vector<InferenceDetection>> detections(frames.size());
+        for (size_t i = 0; i < frames.size(); ++i) {
+            detectFrame(frames[i], confidence_threshold, detections[i]);
+        }
+        return detections;
+    }
+
+    InferenceBackendType type() const override { return InferenceBackendType::RULE_BASED; }
+    const char* name() const override { return "Rule-based"; }
+
+private:
+    void detectFrame(const cv::Mat& frame, float confidence_threshold,
+                     std::vector<InferenceDetection>& detections) const {
+        if (frame.empty() || frame.channels() != 3) {
+            return;
+        }
+
+        // Everything that is not saturated green turf is a player candidate;
+        // painted lines are removed later by the shape filter
+        cv::Mat hsv, turf, players;
+        cv::cvtColor(frame, hsv, cv::COLOR_BGR2HSV);
+        cv::inRange(hsv, cv::Scalar(35, 40, 40), cv::Scalar(85, 255, 255), turf);
+        cv::bitwise_not(turf, players);
+        cv::morphologyEx(players, players, cv::MORPH_OPEN,
+                         cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(3, 3)));
+
+        std::vector<std::vector<cv::Point>> contours;
+        cv::findContours(players, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+
+        struct Candidate { cv::Rect box; double hue; float confidence; };
+        std::vector<Candidate> candidates;
+        const int min_height = std::max(8, frame.rows / 50);
+        const int max_height = frame.rows / 4;
+        for (const auto& contour : contours) {
+            cv::Rect box = cv::boundingRect(contour);
+            double aspect = static_cast<double>(box.height) / std::max(1, box.width);
+            if (box.height < min_height || box.height > max_height || aspect < 1.0 || aspect > 4.0) {
+                continue;
+            }
+            float fill = static_cast<float>(cv::contourArea(contour) / box.area());
+            float confidence = 0.5f + 0.5f * std::min(1.0f, fill);
+            if (confidence <= confidence_threshold) {
+                continue;
+            }
+            double hue = cv::mean(hsv(box), players(box))[0];
+            candidates.push_back({box, hue, confidence});
+        }
+        if (candidates.empty()) {
+            return;
+        }
+
+        // Two jersey colours: split the sorted hues at the widest gap
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            return a.hue < b.hue;
+        });
+        size_t split = candidates.size();
+        double widest_gap = 0.0;
+        for (size_t i = 1; i < candidates.size(); ++i) {
+            double gap = candidates[i].hue - candidates[i - 1].hue;
+            if (gap > widest_gap) {
+                widest_gap = gap;
+                split = i;
+            }
+        }
+
+        const float inv_width = 1.0f / frame.cols;
+        const float inv_height = 1.0f / frame.rows;
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            const cv::Rect& box = candidates[i].box;
+            InferenceDetection detection;
+            detection.box = cv::Rect2f(box.x * inv_width, box.y * inv_height,
+                                       box.width * inv_width, box.height * inv_height);
+            detection.class_id = i < split ? 0 : 1;
+            detection.confidence = candidates[i].confidence;
+            detections.push_back(detection);
+        }
+    }
+};
+
+} // namespace
+
+std::unique_ptr<InferenceBackend> InferenceBackend::create(InferenceBackendType type) {
+    switch (type) {
+        case InferenceBackendType::OPENCV_DNN:
+            #ifdef ENABLE_OPENCV_INTEGRATION
+            return std::make_unique<OpenCvDnnBackend>();
+            #else
+            break;
+            #endif
+        case InferenceBackendType::ONNX_RUNTIME:
+            #ifdef ONNX_AI_ENABLED
+            return std::make_unique<OnnxRuntimeBackend>();
+            #else
+            break;
+            #endif
+        case InferenceBackendType::RULE_BASED:
+            return std::make_unique<RuleBasedBackend>();
+    }
+    std::cerr << "[Inference Backend] " << backendName(type) << " not available in this build" << std::endl;
+    return nullptr;
+}
+
+std::vector<InferenceBackendType> InferenceBackend::availableBackends() {
+    std::vector<InferenceBackendType> backends;
+    #ifdef ENABLE_OPENCV_INTEGRATION
+    backends.push_back(InferenceBackendType::OPENCV_DNN);
+    #endif
+    #ifdef ONNX_AI_ENABLED
+    backends.push_back(InferenceBackendType::ONNX_RUNTIME);
+    #endif
+    backends.push_back(InferenceBackendType::RULE_BASED);
+    return backends;
+}
+
+const char* InferenceBackend::backendName(InferenceBackendType type) {
+    switch (type) {
+        case InferenceBackendType::OPENCV_DNN: return "OpenCV DNN";
+        case InferenceBackendType::ONNX_RUNTIME: return "ONNX Runtime";
+        case InferenceBackendType::RULE_BASED: return "Rule-based";
+    }
+    return "Unknown";
+}
+
+std::string InferenceBackend::resolveModelPath(const std::string& model_path, const InferenceOptions& options) {
+    if (!options.use_int8 || model_path.empty()) {
+        return model_path;
+    }
+
+    std::string int8_path = options.int8_model_path;
+    if (int8_path.empty()) {
+        size_t dot = model_path.find_last_of('.');
+        size_t slash = model_path.find_last_of("/\\");
+        bool has_extension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+        int8_path = has_extension ? model_path.substr(0, dot) + ".int8" + model_path.substr(dot)
+                                  : model_path + ".int8";
+    }
+
+    if (!std::ifstream(int8_path).good()) {
+        std::cout << "[Inference Backend] INT8 model " << int8_path << " not found - using " << model_path << std::endl;
+        return model_path;
+    }
+    return int8_path;
+}
+
+InferenceBenchmarkResult benchmarkInferenceBackend(InferenceBackend& backend,
+                                                   const std::vector<cv::Mat>& frames,
+                                                   int batch_size, int iterations,
+                                                   float confidence_threshold) {
+    InferenceBenchmarkResult result;
+    result.type = backend.type();
+    result.options = backend.options();
+    result.batch_size = std::max(1, batch_size);
+    if (frames.empty() || !backend.isLoaded()) {
+        return result;
+    }
+
+    auto run_pass = [&]() {
+        size_t detections = 0;
+        for (size_t first = 0; first < frames.size(); first += result.batch_size) {
+            size_t last = std::min(frames.size(), first + static_cast<size_t>(result.batch_size));
+            std::vector<cv::Mat> batch(frames.begin() + first, frames.begin() + last);
+            for (const auto& frame_detections : backend.infer(batch, confidence_threshold)) {
+                detections += frame_detections.size();
+            }
+        }
+        return detections;
+    };
+
+    // Warm-up pass absorbs lazy allocation and graph optimization
+    result.detections = run_pass();
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < std::max(1, iterations); ++i) {
+        run_pass();
+    }
+    double elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+
+    double total_frames = static_cast<double>(frames.size()) * std::max(1, iterations);
+    result.ms_per_frame = elapsed_ms / total_frames;
+    result.frames_per_second = result.ms_per_frame > 0.0 ? 1000.0 / result.ms_per_frame : 0.0;
+    return result;
+}
+
+} // namespace sports
+} // namespace amt
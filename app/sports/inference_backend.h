@@ -0,0 +1,111 @@
+#ifndef INFERENCE_BACKEND_H
+#define INFERENCE_BACKEND_H
+
+/**
+ * @file inference_backend.h
+ * @brief Runtime-selectable CPU inference backends for player detection
+ *
+ * FormationDetector talks to the detection model only through
+ * InferenceBackend, so OpenCV DNN, ONNX Runtime and the rule-based
+ * detector can be swapped at runtime and benchmarked against each other
+ * on the deployment machine instead of being chosen at compile time.
+ */
+
+#include <opencv2/core.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace amt {
+namespace sports {
+
+/**
+ * @enum InferenceBackendType
+ * @brief Available player detection backends
+ */
+enum class InferenceBackendType {
+    OPENCV_DNN,        // cv::dnn on the CPU target
+    ONNX_RUNTIME,      // ONNX Runtime CPU execution provider
+    RULE_BASED         // Turf segmentation, no model required
+};
+
+/**
+ * @struct InferenceOptions
+ * @brief CPU execution settings shared by every backend
+ */
+struct InferenceOptions {
+    int num_threads = 0;               // 0 lets the runtime decide
+    int intra_op_threads = 0;          // Threads inside one operator, 0 = num_threads
+    int inter_op_threads = 1;          // Independent operators run concurrently when > 1
+    bool use_int8 = false;             // Prefer the quantized model when one is available
+    std::string int8_model_path;       // Defaults to <model>.int8.<ext>
+    cv::Size input_size = cv::Size(608, 608);
+};
+
+/**
+ * @struct InferenceDetection
+ * @brief One raw detection in normalized [0, 1] frame coordinates
+ */
+struct InferenceDetection {
+    cv::Rect2f box;                    // Normalized bounding box
+    int class_id;                      // 0 = offense, 1 = defense
+    float confidence;
+};
+
+/**
+ * @class InferenceBackend
+ * @brief Batched player detection over a list of frames
+ */
+class InferenceBackend {
+public:
+    virtual ~InferenceBackend() = default;
+
+    // Loads (or reloads) the model; model_path may be empty for backends
+    // that do not need one
+    virtual bool load(const std::string& model_path, const InferenceOptions& options) = 0;
+    virtual bool isLoaded() const = 0;
+
+    // Runs detection over non-empty frames; results are in input order
+    virtual std::vector<std::vector<InferenceDetection>> infer(const std::vector<cv::Mat>& frames,
+                                                               float confidence_threshold) = 0;
+
+    virtual InferenceBackendType type() const = 0;
+    virtual const char* name() const = 0;
+    const InferenceOptions& options() const { return m_options; }
+
+    // Factory - returns nullptr if the backend was not compiled in
+    static std::unique_ptr<InferenceBackend> create(InferenceBackendType type);
+    static std::vector<InferenceBackendType> availableBackends();
+    static const char* backendName(InferenceBackendType type);
+
+    // Picks the INT8 model path when requested and present on disk
+    static std::string resolveModelPath(const std::string& model_path, const InferenceOptions& options);
+
+protected:
+    InferenceOptions m_options;
+};
+
+/**
+ * @struct InferenceBenchmarkResult
+ * @brief Throughput of one backend configuration
+ */
+struct InferenceBenchmarkResult {
+    InferenceBackendType type = InferenceBackendType::RULE_BASED;
+    InferenceOptions options;
+    int batch_size = 1;
+    double ms_per_frame = 0.0;
+    double frames_per_second = 0.0;
+    size_t detections = 0;             // Per pass, to sanity check backends against each other
+};
+
+// Shared benchmark harness: warms the backend up, then times repeated
+// batched passes over the given frames
+InferenceBenchmarkResult benchmarkInferenceBackend(InferenceBackend& backend,
+                                                   const std::vector<cv::Mat>& frames,
+                                                   int batch_size, int iterations,
+                                                   float confidence_threshold = 0.5f);
+
+} // namespace sports
+} // namespace amt
+
+#endif // INFERENCE_BACKEND_H
@@ -0,0 +1,396 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Kafka Event Codec Implementation
+  Compact binary payloads for Kafka events
+***/
+
+#include "kafka_event_codec.h"
+
+#include <QCborMap>
+#include <QCborValue>
+#include <QDebug>
+#include <QJsonDocument>
+#include <QtEndian>
+
+#include <cmath>
+#include <cstring>
+
+namespace olive {
+
+namespace {
+
+// Leading byte; JSON payloads always start with '{'
+constexpr quint8 kPayloadMagic = 0xAC;
+constexpr quint8 kFormatVersion = 1;
+
+// Schema byte flag: _metadata is laid out inline instead of in the extras
+constexpr quint8 kInlineMetadataFlag = 0x80;
+
+enum class FieldType : quint8 {
+  String,
+  Integer,
+  Float32
+};
+
+struct SchemaField {
+  const char* name;
+  FieldType type;
+};
+
+// Field order is the wire order; append only, never reorder
+const SchemaField kFormationFields[] = {
+  {"formation_id", FieldType::String},
+  {"type", FieldType::Integer},
+  {"confidence", FieldType::Float32},
+  {"video_timestamp", FieldType::Integer},
+  {"hash_position", FieldType::String},
+  {"field_zone", FieldType::String},
+  {"recommended_call", FieldType::Integer},
+  {"detection_timestamp", FieldType::Integer}
+};
+
+const SchemaField kCoachingAlertFields[] = {
+  {"alert_type", FieldType::String},
+  {"message", FieldType::String},
+  {"timestamp", FieldType::Integer},
+  {"alert_id", FieldType::String},
+  {"priority_level", FieldType::Integer},
+  {"video_timestamp", FieldType::Integer},
+  {"related_formation", FieldType::String}
+};
+
+struct SchemaLayout {
+  const SchemaField* fields;
+  int count;
+};
+
+SchemaLayout LayoutForSchema(quint8 schema)
+{
+  switch (schema) {
+    case KafkaEventCodec::kFormationSchema:
+      return {kFormationFields, int(sizeof(kFormationFields) / sizeof(SchemaField))};
+    case KafkaEventCodec::kCoachingAlertSchema:
+      return {kCoachingAlertFields, int(sizeof(kCoachingAlertFields) / sizeof(SchemaField))};
+    default:
+      return {nullptr, 0};
+  }
+}
+
+quint8 SchemaForEvent(EventType type)
+{
+  switch (type) {
+    case EventType::FormationUpdate: return KafkaEventCodec::kFormationSchema;
+    case EventType::CoachingAlert: return KafkaEventCodec::kCoachingAlertSchema;
+    default: return KafkaEventCodec::kGenericSchema;
+  }
+}
+
+bool IsInteger(const QJsonValue& value)
+{
+  if (!value.isDouble()) {
+    return false;
+  }
+  double number = value.toDouble();
+  return std::floor(number) == number && std::fabs(number) < 9007199254740992.0; // 2^53
+}
+
+bool FitsField(const QJsonValue& value, FieldType type)
+{
+  switch (type) {
+    case FieldType::String: return value.isString();
+    case FieldType::Integer: return IsInteger(value);
+    case FieldType::Float32: return value.isDouble();
+  }
+  return false;
+}
+
+// Little-endian writer/reader with LEB128 varints (zigzag for signed)
+void PutVarint(QByteArray& out, quint64 value)
+{
+  while (value >= 0x80) {
+    out.append(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.append(static_cast<char>(value));
+}
+
+void PutSigned(QByteArray& out, qint64 value)
+{
+  PutVarint(out, (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63));
+}
+
+void PutString(QByteArray& out, const QString& value)
+{
+  QByteArray utf8 = value.toUtf8();
+  PutVarint(out, static_cast<quint64>(utf8.size()));
+  out.append(utf8);
+}
+
+void PutFloat32(QByteArray& out, float value)
+{
+  quint32 bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  char bytes[4];
+  qToLittleEndian(bits, bytes);
+  out.append(bytes, 4);
+}
+
+class Reader
+{
+public:
+  Reader(const char* data, int size) : data_(data), size_(size), pos_(0), ok_(true) {}
+
+  bool ok() const { return ok_; }
+  bool AtEnd() const { return pos_ >= size_; }
+  int Position() const { return pos_; }
+
+  quint8 Byte()
+  {
+    if (!Require(1)) {
+      return 0;
+    }
+    return static_cast<quint8>(data_[pos_++]);
+  }
+
+  quint64 Varint()
+  {
+    quint64 value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      quint8 byte = Byte();
+      if (!ok_) {
+        return 0;
+      }
+      value |= static_cast<quint64>(byte & 0x7F) << shift;
+      if (!(byte & 0x80)) {
+        return value;
+      }
+    }
+    ok_ = false;
+    return 0;
+  }
+
+  qint64 Signed()
+  {
+    quint64 raw = Varint();
+    return static_cast<qint64>(raw >> 1) ^ -static_cast<qint64>(raw & 1);
+  }
+
+  float Float32()
+  {
+    if (!Require(4)) {
+      return 0.0f;
+    }
+    quint32 bits = qFromLittleEndian<quint32>(data_ + pos_);
+    pos_ += 4;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  QByteArray Bytes(quint64 length)
+  {
+    if (length > static_cast<quint64>(size_ - pos_) || !Require(static_cast<int>(length))) {
+      ok_ = false;
+      return QByteArray();
+    }
+    QByteArray bytes(data_ + pos_, static_cast<int>(length));
+    pos_ += static_cast<int>(length);
+    return bytes;
+  }
+
+  QString String() { return QString::fromUtf8(Bytes(Varint())); }
+
+private:
+  bool Require(int bytes)
+  {
+    if (!ok_ || bytes < 0 || pos_ + bytes > size_) {
+      ok_ = false;
+    }
+    return ok_;
+  }
+
+  const char* data_;
+  int size_;
+  int pos_;
+  bool ok_;
+};
+
+// _metadata as built by KafkaPublisher::CreateEventMetadata can be stored
+// as two bytes plus three short strings; anything else goes to the extras
+bool IsStandardMetadata(const QJsonValue& value, const KafkaEvent& event)
+{
+  if (!value.isObject()) {
+    return false;
+  }
+  QJsonObject metadata = value.toObject();
+  return metadata.size() == 6
+      && metadata.value("event_type").toString() == KafkaUtils::EventTypeToString(event.type)
+      && metadata.value("priority").toString() == KafkaUtils::EventPriorityToString(event.priority)
+      && metadata.value("source").isString()
+      && metadata.value("hostname").isString()
+      && metadata.value("version").isString()
+      && IsInteger(metadata.value("timestamp"));
+}
+
+QByteArray EncodeBinary(const KafkaEvent& event)
+{
+  QJsonObject extras = event.data;
+  quint8 schema = SchemaForEvent(event.type);
+  SchemaLayout layout = LayoutForSchema(schema);
+
+  bool inline_metadata = IsStandardMetadata(event.data.value("_metadata"), event);
+
+  QByteArray out;
+  out.reserve(96);
+  out.append(static_cast<char>(kPayloadMagic));
+  out.append(static_cast<char>(kFormatVersion));
+  out.append(static_cast<char>(schema | (inline_metadata ? kInlineMetadataFlag : 0)));
+
+  if (inline_metadata) {
+    QJsonObject metadata = extras.take("_metadata").toObject();
+    out.append(static_cast<char>(event.type));
+    out.append(static_cast<char>(event.priority));
+    PutSigned(out, static_cast<qint64>(metadata.value("timestamp").toDouble()));
+    PutString(out, metadata.value("source").toString());
+    PutString(out, metadata.value("hostname").toString());
+    PutString(out, metadata.value("version").toString());
+  }
+
+  // Presence bitmask, then the present fields in schema order
+  quint64 present = 0;
+  for (int i = 0; i < layout.count; i++) {
+    if (FitsField(extras.value(layout.fields[i].name), layout.fields[i].type)) {
+      present |= (1ull << i);
+    }
+  }
+  PutVarint(out, present);
+
+  for (int i = 0; i < layout.count; i++) {
+    if (!(present & (1ull << i))) {
+      continue;
+    }
+    QJsonValue value = extras.take(layout.fields[i].name);
+    switch (layout.fields[i].type) {
+      case FieldType::String:
+        PutString(out, value.toString());
+        break;
+      case FieldType::Integer:
+        PutSigned(out, static_cast<qint64>(value.toDouble()));
+        break;
+      case FieldType::Float32:
+        PutFloat32(out, static_cast<float>(value.toDouble()));
+        break;
+    }
+  }
+
+  // Everything the schema does not cover (player positions, context...)
+  if (!extras.isEmpty()) {
+    out.append(QCborMap::fromJsonObject(extras).toCborValue().toCbor());
+  }
+
+  return out;
+}
+
+bool DecodeBinary(const QByteArray& payload, QJsonObject* data)
+{
+  Reader reader(payload.constData(), payload.size());
+  if (reader.Byte() != kPayloadMagic || reader.Byte() != kFormatVersion) {
+    return false;
+  }
+
+  quint8 schema_byte = reader.Byte();
+  quint8 schema = schema_byte & ~kInlineMetadataFlag;
+  SchemaLayout layout = LayoutForSchema(schema);
+  if (schema != KafkaEventCodec::kGenericSchema && !layout.fields) {
+    qWarning() << "Unknown Kafka payload schema:" << schema;
+    return false;
+  }
+
+  QJsonObject result;
+
+  if (schema_byte & kInlineMetadataFlag) {
+    QJsonObject metadata;
+    metadata["event_type"] = KafkaUtils::EventTypeToString(static_cast<EventType>(reader.Byte()));
+    metadata["priority"] = KafkaUtils::EventPriorityToString(static_cast<EventPriority>(reader.Byte()));
+    metadata["timestamp"] = reader.Signed();
+    metadata["source"] = reader.String();
+    metadata["hostname"] = reader.String();
+    metadata["version"] = reader.String();
+    result["_metadata"] = metadata;
+  }
+
+  quint64 present = reader.Varint();
+  for (int i = 0; i < layout.count && reader.ok(); i++) {
+    if (!(present & (1ull << i))) {
+      continue;
+    }
+    switch (layout.fields[i].type) {
+      case FieldType::String:
+        result[layout.fields[i].name] = reader.String();
+        break;
+      case FieldType::Integer:
+        result[layout.fields[i].name] = reader.Signed();
+        break;
+      case FieldType::Float32:
+        result[layout.fields[i].name] = static_cast<double>(reader.Float32());
+        break;
+    }
+  }
+
+  if (!reader.ok()) {
+    return false;
+  }
+
+  if (!reader.AtEnd()) {
+    QCborParserError error;
+    QCborValue extras = QCborValue::fromCbor(payload.mid(reader.Position()), &error);
+    if (error.error != QCborError::NoError || !extras.isMap()) {
+      return false;
+    }
+    QJsonObject extra_fields = extras.toMap().toJsonObject();
+    for (auto it = extra_fields.constBegin(); it != extra_fields.constEnd(); ++it) {
+      result.insert(it.key(), it.value());
+    }
+  }
+
+  *data = result;
+  return true;
+}
+
+} // namespace
+
+QByteArray KafkaEventCodec::Encode(const KafkaEvent& event, KafkaPayloadEncoding encoding)
+{
+  if (encoding == KafkaPayloadEncoding::Binary) {
+    return EncodeBinary(event);
+  }
+  return QJsonDocument(event.data).toJson(QJsonDocument::Compact);
+}
+
+bool KafkaEventCodec::Decode(const QByteArray& payload, QJsonObject* data)
+{
+  if (!data || payload.isEmpty()) {
+    return false;
+  }
+
+  if (IsBinaryPayload(payload)) {
+    return DecodeBinary(payload, data);
+  }
+
+  QJsonParseError error;
+  QJsonDocument doc = QJsonDocument::fromJson(payload, &error);
+  if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+    return false;
+  }
+  *data = doc.object();
+  return true;
+}
+
+bool KafkaEventCodec::IsBinaryPayload(const QByteArray& payload)
+{
+  return !payload.isEmpty() && static_cast<quint8>(payload.at(0)) == kPayloadMagic;
+}
+
+} // namespace olive
@@ -0,0 +1,55 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Kafka Event Codec
+  Compact binary payloads for Kafka events
+***/
+
+#ifndef KAFKAEVENTCODEC_H
+#define KAFKAEVENTCODEC_H
+
+#include <QByteArray>
+#include <QJsonObject>
+
+#include "kafka_publisher.h"
+
+namespace olive {
+
+/**
+ * @brief Encodes KafkaEvent payloads, and decodes them again
+ *
+ * Binary payloads start with a magic byte and a schema id. FormationUpdate
+ * and CoachingAlert events lay their known fields out as typed values
+ * (varints, f32 confidence, length-prefixed strings) instead of repeating
+ * JSON keys, with any remaining fields appended as a CBOR map. Every
+ * payload is its own Kafka message; compression and batching are left to
+ * the producer (compression.codec, linger.ms), so consumers only need
+ * Decode and any standard Kafka client.
+ */
+class KafkaEventCodec
+{
+public:
+  // Schema ids for binary payloads
+  enum Schema : quint8 {
+    kGenericSchema = 0,
+    kFormationSchema = 1,
+    kCoachingAlertSchema = 2
+  };
+
+  /**
+   * @brief Encode one event's data (including _metadata)
+   */
+  static QByteArray Encode(const KafkaEvent& event, KafkaPayloadEncoding encoding);
+
+  /**
+   * @brief Decode a single JSON or binary payload back into event data
+   */
+  static bool Decode(const QByteArray& payload, QJsonObject* data);
+
+  static bool IsBinaryPayload(const QByteArray& payload);
+};
+
+} // namespace olive
+
+#endif // KAFKAEVENTCODEC_H
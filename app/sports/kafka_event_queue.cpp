@@ -0,0 +1,154 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Kafka Event Queue Implementation
+  Bounded lock-free event queue between publishers and the producer worker
+***/
+
+#include "kafka_event_queue.h"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <algorithm>
+#include <thread>
+
+namespace olive {
+
+KafkaEventQueue::KafkaEventQueue(int capacity)
+  : capacity_(std::max(1, capacity))
+  , size_(0)
+  , high_water_(0)
+  , drain_requested_(false)
+  , policy_(KafkaOverflowPolicy::DropLowestPriority)
+  , block_timeout_ms_(1000)
+  , dropped_(0)
+  , evicted_(0)
+  , spilled_(0)
+{
+  // Each ring can hold the whole budget; the shared counter enforces it
+  for (int level = 0; level < kPriorityLevels; level++) {
+    rings_[level] = std::make_unique<MpscRingBuffer<KafkaEvent>>(static_cast<size_t>(capacity_));
+  }
+}
+
+KafkaEventQueue::~KafkaEventQueue() = default;
+
+bool KafkaEventQueue::Push(KafkaEvent event)
+{
+  if (TryReserveSlot()) {
+    return PushReserved(std::move(event));
+  }
+
+  switch (policy_.load(std::memory_order_relaxed)) {
+    case KafkaOverflowPolicy::Block: {
+      // Back off until the worker frees a slot, then give up
+      QElapsedTimer timer;
+      timer.start();
+      int backoff_us = 1;
+      while (timer.elapsed() < block_timeout_ms_.load(std::memory_order_relaxed)) {
+        if (TryReserveSlot()) {
+          return PushReserved(std::move(event));
+        }
+        if (backoff_us < 64) {
+          std::this_thread::yield();
+        } else {
+          QThread::usleep(static_cast<unsigned long>(backoff_us));
+        }
+        backoff_us = std::min(backoff_us * 2, 1000);
+      }
+      break;
+    }
+    case KafkaOverflowPolicy::DropLowestPriority:
+      // The evicted event's slot goes to this one
+      if (EvictLowerPriority(event.priority)) {
+        return PushReserved(std::move(event));
+      }
+      break;
+    case KafkaOverflowPolicy::SpillToDisk:
+      if (spill_handler_ && spill_handler_(event)) {
+        spilled_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+      break;
+  }
+
+  dropped_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+int KafkaEventQueue::PopBatch(QVector<KafkaEvent>* events, int max_events)
+{
+  int popped = 0;
+  KafkaEvent event;
+  for (int level = kPriorityLevels - 1; level >= 0 && popped < max_events; level--) {
+    while (popped < max_events && rings_[level]->TryPop(event)) {
+      events->append(std::move(event));
+      popped++;
+    }
+  }
+
+  if (popped > 0) {
+    size_.fetch_sub(popped, std::memory_order_acq_rel);
+  }
+
+  return popped;
+}
+
+void KafkaEventQueue::SetOverflowPolicy(KafkaOverflowPolicy policy, int block_timeout_ms)
+{
+  policy_.store(policy, std::memory_order_relaxed);
+  block_timeout_ms_.store(std::max(0, block_timeout_ms), std::memory_order_relaxed);
+}
+
+bool KafkaEventQueue::TryReserveSlot()
+{
+  int current = size_.load(std::memory_order_relaxed);
+  do {
+    if (current >= capacity_) {
+      return false;
+    }
+  } while (!size_.compare_exchange_weak(current, current + 1, std::memory_order_acq_rel));
+
+  int high_water = high_water_.load(std::memory_order_relaxed);
+  while (current + 1 > high_water &&
+         !high_water_.compare_exchange_weak(high_water, current + 1, std::memory_order_relaxed)) {
+  }
+  return true;
+}
+
+void KafkaEventQueue::ReleaseSlot()
+{
+  size_.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+bool KafkaEventQueue::PushReserved(KafkaEvent&& event)
+{
+  int level = std::clamp(static_cast<int>(event.priority), 0, kPriorityLevels - 1);
+  if (rings_[level]->TryPush(std::move(event))) {
+    return true;
+  }
+
+  // Only reachable while a concurrent pop is still releasing its cell
+  ReleaseSlot();
+  dropped_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+bool KafkaEventQueue::EvictLowerPriority(EventPriority priority)
+{
+  KafkaEvent victim;
+  for (int level = 0; level < static_cast<int>(priority); level++) {
+    if (rings_[level]->TryPop(victim)) {
+      evicted_.fetch_add(1, std::memory_order_relaxed);
+      if (eviction_handler_) {
+        eviction_handler_(victim);
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace olive
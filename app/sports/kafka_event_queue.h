@@ -0,0 +1,211 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Kafka Event Queue
+  Bounded lock-free event queue between publishers and the producer worker
+***/
+
+#ifndef KAFKAEVENTQUEUE_H
+#define KAFKAEVENTQUEUE_H
+
+#include <QVector>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "kafka_publisher.h"
+
+namespace olive {
+
+/**
+ * @brief Bounded lock-free ring buffer (Vyukov sequence-per-cell design)
+ *
+ * Any number of threads may push. Pops are also lock-free, which lets a
+ * producer evict from a lower priority ring, but in normal operation only
+ * the producer worker consumes.
+ */
+template<typename T>
+class MpscRingBuffer
+{
+public:
+  explicit MpscRingBuffer(size_t capacity)
+    : capacity_(RoundUpToPowerOfTwo(capacity))
+    , mask_(capacity_ - 1)
+    , cells_(new Cell[capacity_])
+    , enqueue_pos_(0)
+    , dequeue_pos_(0)
+  {
+    for (size_t i = 0; i < capacity_; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscRingBuffer(const MpscRingBuffer&) = delete;
+  MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+  bool TryPush(T&& value)
+  {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[pos & mask_];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false; // Full
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool TryPop(T& value)
+  {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+      Cell& cell = cells_[pos & mask_];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          value = std::move(cell.value);
+          cell.value = T();
+          cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false; // Empty
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  size_t Capacity() const { return capacity_; }
+
+  // Approximate while other threads are pushing or popping
+  size_t Size() const
+  {
+    size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+    size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+    return tail >= head ? tail - head : 0;
+  }
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  static size_t RoundUpToPowerOfTwo(size_t value)
+  {
+    size_t result = 2;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+
+  // Producer and consumer positions on separate cache lines
+  alignas(64) std::atomic<size_t> enqueue_pos_;
+  alignas(64) std::atomic<size_t> dequeue_pos_;
+};
+
+/**
+ * @brief Priority-aware bounded event queue shared by KafkaPublisher and its worker
+ *
+ * One lock-free ring per EventPriority, with a shared capacity. Producers
+ * never take a lock unless the queue is full and the overflow policy
+ * spills to disk. The worker drains highest priority first, in batches.
+ */
+class KafkaEventQueue
+{
+public:
+  explicit KafkaEventQueue(int capacity = 10000);
+  ~KafkaEventQueue();
+
+  /**
+   * @brief Queue an event, applying the overflow policy when full
+   *
+   * Returns false only if the event itself was dropped.
+   */
+  bool Push(KafkaEvent event);
+
+  /**
+   * @brief Pop up to max_events, highest priority first (worker thread)
+   */
+  int PopBatch(QVector<KafkaEvent>* events, int max_events);
+
+  /**
+   * @brief Wake-up coalescing: true if the caller should schedule a drain
+   */
+  bool RequestDrain() { return !drain_requested_.exchange(true, std::memory_order_acq_rel); }
+  void BeginDrain() { drain_requested_.store(false, std::memory_order_release); }
+
+  void SetOverflowPolicy(KafkaOverflowPolicy policy, int block_timeout_ms = 1000);
+  KafkaOverflowPolicy GetOverflowPolicy() const { return policy_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Where SpillToDisk sends events; returns false if it could not take one
+   *
+   * Set before the queue is shared with other threads.
+   */
+  void SetSpillHandler(std::function<bool(const KafkaEvent&)> handler) { spill_handler_ = std::move(handler); }
+
+  /**
+   * @brief Told about every event evicted by DropLowestPriority
+   */
+  void SetEvictionHandler(std::function<void(const KafkaEvent&)> handler) { eviction_handler_ = std::move(handler); }
+
+  int Size() const { return size_.load(std::memory_order_relaxed); }
+  int Capacity() const { return capacity_; }
+  bool IsEmpty() const { return Size() == 0; }
+
+  // Counters
+  qint64 DroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+  qint64 EvictedCount() const { return evicted_.load(std::memory_order_relaxed); }
+  qint64 SpilledCount() const { return spilled_.load(std::memory_order_relaxed); }
+  int HighWaterMark() const { return high_water_.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr int kPriorityLevels = 4;
+
+  bool TryReserveSlot();
+  void ReleaseSlot();
+  bool PushReserved(KafkaEvent&& event);
+  bool EvictLowerPriority(EventPriority priority);
+
+  const int capacity_;
+  std::unique_ptr<MpscRingBuffer<KafkaEvent>> rings_[kPriorityLevels];
+  std::atomic<int> size_;
+  std::atomic<int> high_water_;
+  std::atomic<bool> drain_requested_;
+
+  std::atomic<KafkaOverflowPolicy> policy_;
+  std::atomic<int> block_timeout_ms_;
+
+  std::atomic<qint64> dropped_;
+  std::atomic<qint64> evicted_;
+  std::atomic<qint64> spilled_;
+
+  std::function<bool(const KafkaEvent&)> spill_handler_;
+  std::function<void(const KafkaEvent&)> eviction_handler_;
+};
+
+} // namespace olive
+
+#endif // KAFKAEVENTQUEUE_H
@@ -7,12 +7,16 @@
 ***/
 
 #include "kafka_publisher.h"
+#include "kafka_event_codec.h"
+#include "kafka_event_queue.h"
+#include "kafka_spill_journal.h"
 
 #include <QDebug>
 #include <QCoreApplication>
 #include <QJsonArray>
 #include <QUuid>
 #include <QHostInfo>
+#include <QStandardPaths>
 #include <QNetworkRequest>
 #include <QUrlQuery>
 #include <cstdlib>
@@ -33,13 +37,21 @@ KafkaPublisher::KafkaPublisher(QObject* parent)
   , flush_interval_ms_(1000)
   , max_retry_count_(3)
   , reconnect_interval_ms_(5000)
+  , compression_(KafkaCompression::None)
   , is_connected_(false)
   , is_initialized_(false)
   , connection_retry_count_(0)
+  , event_queue_(std::make_shared<KafkaEventQueue>())
+  , queue_capacity_(10000)
   , process_timer_(nullptr)
   , flush_timer_(nullptr)
   , reconnect_timer_(nullptr)
   , stats_timer_(nullptr)
+  , journal_enabled_(false)
+  , journal_max_bytes_(256LL * 1024 * 1024)
+  , spill_threshold_(8000)
+  , replay_bytes_per_second_(4 * 1024 * 1024)
+  , replay_timer_(nullptr)
   , worker_thread_(nullptr)
   , worker_(nullptr)
   , network_manager_(nullptr)
@@ -50,6 +62,7 @@ KafkaPublisher::KafkaPublisher(QObject* parent)
   qRegisterMetaType<KafkaEvent>("KafkaEvent");
   qRegisterMetaType<EventType>("EventType");
   qRegisterMetaType<EventPriority>("EventPriority");
+  qRegisterMetaType<QList<qint64>>("QList<qint64>");
 
   SetupTimers();
   
@@ -76,6 +89,7 @@ bool KafkaPublisher::Initialize(const QString& bootstrap_servers, const QString&
           << "servers:" << bootstrap_servers_
           << "client_id:" << client_id_;
 
+  OpenSpillJournal();
   StartWorkerThread();
 
   is_initialized_ = true;
@@ -103,6 +117,9 @@ void KafkaPublisher::Shutdown()
   if (stats_timer_ && stats_timer_->isActive()) {
     stats_timer_->stop();
   }
+  if (replay_timer_ && replay_timer_->isActive()) {
+    replay_timer_->stop();
+  }
 
   // Flush remaining events
   FlushEvents();
@@ -110,6 +127,12 @@ void KafkaPublisher::Shutdown()
   // Stop worker thread
   StopWorkerThread();
 
+  // Whatever never reached the producer survives the restart
+  SpillQueuedEvents();
+  if (journal_) {
+    journal_->Close();
+  }
+
   is_initialized_ = false;
   is_connected_ = false;
 
@@ -217,9 +240,24 @@ QJsonObject KafkaPublisher::GetStatistics() const
   stats["events_published"] = static_cast<qint64>(stats_.events_published);
   stats["events_failed"] = static_cast<qint64>(stats_.events_failed);
   stats["bytes_sent"] = static_cast<qint64>(stats_.bytes_sent);
-  stats["queue_size"] = static_cast<qint64>(stats_.queue_size);
+  stats["broker_bytes_sent"] = static_cast<qint64>(stats_.broker_bytes_sent);
+  stats["compression"] = KafkaUtils::CompressionCodecName(compression_);
+  stats["queue_size"] = static_cast<qint64>(event_queue_->Size());
+  stats["queue_capacity"] = event_queue_->Capacity();
+  stats["queue_high_water"] = event_queue_->HighWaterMark();
+  stats["events_dropped"] = event_queue_->DroppedCount();
+  stats["events_evicted"] = event_queue_->EvictedCount();
+  stats["events_spilled"] = event_queue_->SpilledCount();
+  if (journal_) {
+    stats["journal_pending"] = journal_->PendingCount();
+    stats["journal_outstanding"] = journal_->OutstandingCount();
+    stats["journal_bytes"] = journal_->DiskBytes();
+    stats["events_journaled"] = journal_->AppendedCount();
+    stats["events_replayed"] = journal_->ReplayedCount();
+    stats["journal_dropped"] = journal_->DroppedCount();
+  }
   stats["events_per_second"] = stats_.events_per_second;
-  stats["is_connected"] = is_connected_;
+  stats["is_connected"] = is_connected_.load();
   stats["uptime_seconds"] = stats_.start_time.secsTo(QDateTime::currentDateTime());
   stats["last_event_timestamp"] = static_cast<qint64>(stats_.last_event_timestamp);
 
@@ -232,6 +270,11 @@ void KafkaPublisher::SetBatchMode(bool enabled, int batch_size, int flush_interv
   batch_size_ = batch_size;
   flush_interval_ms_ = flush_interval_ms;
 
+  if (worker_) {
+    worker_->SetDrainBatchSize(batch_size_);
+    worker_->SetProducerBatching(batch_mode_enabled_, batch_size_, flush_interval_ms_, compression_);
+  }
+
   if (flush_timer_) {
     flush_timer_->setInterval(flush_interval_ms_);
     if (enabled && is_connected_) {
@@ -245,6 +288,70 @@ void KafkaPublisher::SetBatchMode(bool enabled, int batch_size, int flush_interv
           << "batch_size:" << batch_size << "flush_interval:" << flush_interval_ms;
 }
 
+void KafkaPublisher::SetOverflowPolicy(KafkaOverflowPolicy policy, int block_timeout_ms)
+{
+  event_queue_->SetOverflowPolicy(policy, block_timeout_ms);
+  qInfo() << "Queue overflow policy:" << static_cast<int>(policy) << "block timeout:" << block_timeout_ms;
+}
+
+void KafkaPublisher::SetQueueCapacity(int capacity)
+{
+  if (is_initialized_) {
+    qWarning() << "Queue capacity can only be changed before Initialize";
+    return;
+  }
+
+  queue_capacity_ = qMax(1, capacity);
+  auto queue = std::make_shared<KafkaEventQueue>(queue_capacity_);
+  queue->SetOverflowPolicy(event_queue_->GetOverflowPolicy());
+  event_queue_ = queue;
+  spill_threshold_ = queue_capacity_ * 4 / 5;
+}
+
+void KafkaPublisher::SetSpillJournal(bool enabled, const QString& directory, qint64 max_bytes)
+{
+  if (is_initialized_) {
+    qWarning() << "Spill journal can only be configured before Initialize";
+    return;
+  }
+
+  journal_enabled_ = enabled;
+  journal_directory_ = directory;
+  journal_max_bytes_ = max_bytes;
+}
+
+void KafkaPublisher::SetSpillThreshold(int queued_events)
+{
+  // Headroom below capacity so replayed events are never evicted
+  spill_threshold_ = qBound(1, queued_events, qMax(1, event_queue_->Capacity() * 9 / 10));
+}
+
+void KafkaPublisher::SetReplayRate(qint64 bytes_per_second)
+{
+  replay_bytes_per_second_ = qMax<qint64>(1024, bytes_per_second);
+}
+
+void KafkaPublisher::SetTopicEncoding(const QString& topic, KafkaPayloadEncoding encoding)
+{
+  topic_encodings_[topic] = encoding;
+  if (worker_) {
+    worker_->SetTopicEncoding(topic, encoding);
+  }
+
+  qInfo() << "Topic" << topic << "encoding:"
+          << (encoding == KafkaPayloadEncoding::Binary ? "binary" : "json");
+}
+
+void KafkaPublisher::SetCompression(KafkaCompression compression)
+{
+  compression_ = compression;
+  if (worker_) {
+    worker_->SetProducerBatching(batch_mode_enabled_, batch_size_, flush_interval_ms_, compression_);
+  }
+
+  qInfo() << "Producer compression:" << KafkaUtils::CompressionCodecName(compression);
+}
+
 void KafkaPublisher::SetEventFilter(const QStringList& allowed_topics)
 {
   allowed_topics_ = allowed_topics;
@@ -260,8 +367,7 @@ void KafkaPublisher::FlushEvents()
 
 void KafkaPublisher::OnConnectionStatusChanged(bool connected)
 {
-  if (is_connected_ != connected) {
-    is_connected_ = connected;
+  if (is_connected_.exchange(connected) != connected) {
     
     if (connected) {
       qInfo() << "Kafka connection established";
@@ -275,9 +381,16 @@ void KafkaPublisher::OnConnectionStatusChanged(bool connected)
       if (batch_mode_enabled_ && flush_timer_ && !flush_timer_->isActive()) {
         flush_timer_->start();
       }
+      if (journal_ && replay_timer_ && !replay_timer_->isActive()) {
+        replay_timer_->start();
+      }
+      ScheduleDrain();
       emit ConnectionEstablished();
     } else {
       qWarning() << "Kafka connection lost";
+      if (replay_timer_) {
+        replay_timer_->stop();
+      }
       if (reconnect_timer_ && !reconnect_timer_->isActive()) {
         reconnect_timer_->start();
       }
@@ -301,6 +414,21 @@ void KafkaPublisher::OnEventDelivered(const QString& topic, const QString& key,
   stats_.last_event_timestamp = QDateTime::currentMSecsSinceEpoch();
 }
 
+void KafkaPublisher::OnJournalEventsDelivered(const QList<qint64>& sequences, bool success)
+{
+  if (!journal_) {
+    return;
+  }
+
+  for (qint64 sequence : sequences) {
+    if (success) {
+      journal_->Acknowledge(sequence);
+    } else {
+      journal_->Reject(sequence);
+    }
+  }
+}
+
 void KafkaPublisher::OnError(const QString& error_message, int error_code)
 {
   qWarning() << "Kafka error:" << error_message << "code:" << error_code;
@@ -313,30 +441,12 @@ void KafkaPublisher::OnError(const QString& error_message, int error_code)
 
 void KafkaPublisher::ProcessEventQueue()
 {
-  if (!is_connected_ || !worker_) {
-    return;
-  }
+  // Safety net for wake-ups lost across reconnects; the worker drains
+  // the queue itself in batches
+  ScheduleDrain();
 
-  QMutexLocker locker(&queue_mutex_);
-  
-  int processed = 0;
-  while (!event_queue_.isEmpty() && processed < batch_size_) {
-    KafkaEvent event = event_queue_.dequeue();
-    locker.unlock();
-    
-    // Send to worker thread
-    QMetaObject::invokeMethod(worker_, "PublishEvent", Qt::QueuedConnection,
-                             Q_ARG(KafkaEvent, event));
-    
-    processed++;
-    locker.relock();
-  }
-  
-  // Update queue size stat
-  {
-    QMutexLocker stats_locker(&stats_mutex_);
-    stats_.queue_size = event_queue_.size();
-  }
+  QMutexLocker stats_locker(&stats_mutex_);
+  stats_.queue_size = event_queue_->Size();
 }
 
 void KafkaPublisher::OnFlushTimer()
@@ -366,9 +476,62 @@ void KafkaPublisher::OnStatsTimer()
     }
   }
   
+  if (journal_) {
+    journal_->Sync();
+  }
+
+  // Serves the producer's statistics callback even when nothing is draining
+  if (worker_) {
+    QMetaObject::invokeMethod(worker_, "PollProducer", Qt::QueuedConnection);
+  }
+  
   emit StatisticsUpdated(GetStatistics());
 }
 
+void KafkaPublisher::OnPayloadBytesProduced(qint64 bytes)
+{
+  QMutexLocker locker(&stats_mutex_);
+  stats_.bytes_sent += bytes;
+}
+
+void KafkaPublisher::OnBrokerBytesSent(qint64 bytes)
+{
+  QMutexLocker locker(&stats_mutex_);
+  stats_.broker_bytes_sent += bytes;
+}
+
+void KafkaPublisher::OnReplayTimer()
+{
+  if (!journal_) {
+    return;
+  }
+
+  if (!is_connected_ || !journal_->HasPending()) {
+    return;
+  }
+
+  // Refill the queue up to the spill threshold, within the bandwidth budget
+  int room = spill_threshold_ - event_queue_->Size();
+  if (room <= 0) {
+    return;
+  }
+
+  QVector<KafkaEvent> events;
+  qint64 budget = replay_bytes_per_second_ * replay_timer_->interval() / 1000;
+  journal_->ReadForReplay(&events, room, budget);
+
+  for (KafkaEvent& event : events) {
+    qint64 sequence = event.journal_sequence;
+    if (!event_queue_->Push(std::move(event))) {
+      journal_->Reject(sequence);
+    }
+  }
+
+  if (!events.isEmpty()) {
+    ScheduleDrain();
+  }
+}
+
 void KafkaPublisher::SetupTimers()
 {
   // Process timer for event queue
@@ -391,6 +554,11 @@ void KafkaPublisher::SetupTimers()
   stats_timer_->setInterval(10000); // 10 seconds
   connect(stats_timer_, &QTimer::timeout, this, &KafkaPublisher::OnStatsTimer);
   stats_timer_->start();
+
+  // Journal replay, paced by replay_bytes_per_second_
+  replay_timer_ = new QTimer(this);
+  replay_timer_->setInterval(100);
+  connect(replay_timer_, &QTimer::timeout, this, &KafkaPublisher::OnReplayTimer);
 }
 
 void KafkaPublisher::StartWorkerThread()
@@ -400,7 +568,12 @@ void KafkaPublisher::StartWorkerThread()
   }
 
   worker_thread_ = new QThread(this);
-  worker_ = new KafkaProducerWorker(bootstrap_servers_, client_id_);
+  worker_ = new KafkaProducerWorker(bootstrap_servers_, client_id_, event_queue_);
+  worker_->SetDrainBatchSize(batch_size_);
+  worker_->SetProducerBatching(batch_mode_enabled_, batch_size_, flush_interval_ms_, compression_);
+  for (auto it = topic_encodings_.constBegin(); it != topic_encodings_.constEnd(); ++it) {
+    worker_->SetTopicEncoding(it.key(), it.value());
+  }
   worker_->moveToThread(worker_thread_);
 
   // Connect signals
@@ -408,6 +581,9 @@ void KafkaPublisher::StartWorkerThread()
   connect(worker_thread_, &QThread::finished, worker_, &QObject::deleteLater);
   connect(worker_, &KafkaProducerWorker::Initialized, this, &KafkaPublisher::OnConnectionStatusChanged);
   connect(worker_, &KafkaProducerWorker::EventDelivered, this, &KafkaPublisher::OnEventDelivered);
+  connect(worker_, &KafkaProducerWorker::JournalEventsDelivered, this, &KafkaPublisher::OnJournalEventsDelivered);
+  connect(worker_, &KafkaProducerWorker::PayloadBytesProduced, this, &KafkaPublisher::OnPayloadBytesProduced);
+  connect(worker_, &KafkaProducerWorker::BrokerBytesSent, this, &KafkaPublisher::OnBrokerBytesSent);
   connect(worker_, &KafkaProducerWorker::ErrorOccurred, this, &KafkaPublisher::OnError);
   connect(worker_, &KafkaProducerWorker::ConnectionStatusChanged, this, &KafkaPublisher::OnConnectionStatusChanged);
 
@@ -457,34 +633,79 @@ bool KafkaPublisher::ValidateEvent(const KafkaEvent& event)
 
 void KafkaPublisher::EnqueueEvent(const KafkaEvent& event)
 {
-  QMutexLocker locker(&queue_mutex_);
-  
-  // Drop low priority events if queue is full
-  if (event_queue_.size() > 10000 && event.priority == EventPriority::Low) {
-    qWarning() << "Dropping low priority event, queue full";
+  // Journal while the broker is away or the queue is backed up; once the
+  // journal holds events, new ones go behind them to keep publish order
+  if (journal_ && (!is_connected_ || journal_->HasPending() ||
+                   event_queue_->Size() >= spill_threshold_)) {
+    if (journal_->Append(event)) {
+      return;
+    }
+  }
+
+  // Lock-free; overflow is handled by the queue's policy
+  if (!event_queue_->Push(event)) {
     return;
   }
 
-  event_queue_.enqueue(event);
-  
-  // Start processing if not running
-  if (is_connected_ && process_timer_ && !process_timer_->isActive()) {
-    process_timer_->start();
+  ScheduleDrain();
+}
+
+void KafkaPublisher::ScheduleDrain()
+{
+  // At most one DrainQueue call is in flight, however many events arrive
+  if (is_connected_ && worker_ && event_queue_->RequestDrain()) {
+    QMetaObject::invokeMethod(worker_, "DrainQueue", Qt::QueuedConnection);
   }
 }
 
-void KafkaPublisher::UpdateStatistics(const KafkaEvent& event, bool success)
+void KafkaPublisher::OpenSpillJournal()
 {
-  QMutexLocker locker(&stats_mutex_);
-  
-  if (success) {
-    stats_.events_published++;
-    stats_.bytes_sent += KafkaUtils::CalculateEventSize(event);
-  } else {
-    stats_.events_failed++;
+  if (!journal_enabled_) {
+    journal_.reset();
+    return;
+  }
+
+  QString directory = journal_directory_;
+  if (directory.isEmpty()) {
+    directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/kafka/journal";
+  }
+
+  journal_ = std::make_shared<KafkaSpillJournal>(directory, journal_max_bytes_);
+  if (!journal_->Open()) {
+    qWarning() << "Kafka spill journal unavailable, events stay in memory during outages";
+    journal_.reset();
+  }
+
+  // Queue overflow (SpillToDisk) and evicted replays go through the journal
+  std::weak_ptr<KafkaSpillJournal> journal = journal_;
+  event_queue_->SetSpillHandler([journal](const KafkaEvent& event) {
+    auto target = journal.lock();
+    return target && event.journal_sequence < 0 && target->Append(event);
+  });
+  event_queue_->SetEvictionHandler([journal](const KafkaEvent& event) {
+    auto target = journal.lock();
+    if (target && event.journal_sequence >= 0) {
+      target->Reject(event.journal_sequence);
+    }
+  });
+}
+
+void KafkaPublisher::SpillQueuedEvents()
+{
+  if (!journal_) {
+    return;
+  }
+
+  QVector<KafkaEvent> events;
+  while (event_queue_->PopBatch(&events, batch_size_) > 0) {
+    for (const KafkaEvent& event : events) {
+      // Replayed events are still in the journal and are replayed again
+      if (event.journal_sequence < 0) {
+        journal_->Append(event);
+      }
+    }
+    events.clear();
   }
-  
-  stats_.last_event_timestamp = event.timestamp;
 }
 
 QJsonObject KafkaPublisher::CreateEventMetadata(EventType type, EventPriority priority)
@@ -539,13 +760,21 @@ void KafkaPublisher::AttemptReconnection()
 }
 
 // KafkaProducerWorker Implementation
-KafkaProducerWorker::KafkaProducerWorker(const QString& bootstrap_servers, const QString& client_id)
+KafkaProducerWorker::KafkaProducerWorker(const QString& bootstrap_servers, const QString& client_id,
+                                         std::shared_ptr<KafkaEventQueue> queue)
   : QObject(nullptr)
   , bootstrap_servers_(bootstrap_servers)
   , client_id_(client_id)
   , producer_(nullptr)
   , config_(nullptr)
   , is_initialized_(false)
+  , queue_(std::move(queue))
+  , drain_batch_size_(100)
+  , compression_(KafkaCompression::None)
+  , batch_mode_(true)
+  , producer_batch_size_(100)
+  , linger_ms_(1000)
+  , broker_tx_bytes_(0)
 {
 }
 
@@ -583,6 +812,26 @@ void KafkaProducerWorker::Shutdown()
   emit ConnectionStatusChanged(false);
 }
 
+void KafkaProducerWorker::SetDrainBatchSize(int batch_size)
+{
+  drain_batch_size_.store(qMax(1, batch_size), std::memory_order_relaxed);
+}
+
+void KafkaProducerWorker::SetTopicEncoding(const QString& topic, KafkaPayloadEncoding encoding)
+{
+  QMutexLocker locker(&config_mutex_);
+  topic_encodings_[topic] = encoding;
+}
+
+void KafkaProducerWorker::SetProducerBatching(bool batch_mode, int batch_size, int linger_ms, KafkaCompression compression)
+{
+  QMutexLocker locker(&config_mutex_);
+  batch_mode_ = batch_mode;
+  producer_batch_size_ = qMax(1, batch_size);
+  linger_ms_ = qMax(0, linger_ms);
+  compression_ = compression;
+}
+
 void KafkaProducerWorker::PublishEvent(const KafkaEvent& event)
 {
   if (!producer_) {
@@ -591,34 +840,143 @@ void KafkaProducerWorker::PublishEvent(const KafkaEvent& event)
   }
 
   QMutexLocker locker(&producer_mutex_);
+  ProduceBatch(QVector<KafkaEvent>{event});
+}
 
-  // Convert event data to JSON
-  QJsonDocument doc(event.data);
-  QByteArray payload = doc.toJson(QJsonDocument::Compact);
+void KafkaProducerWorker::DrainQueue()
+{
+  if (!queue_) {
+    return;
+  }
+  queue_->BeginDrain();
+
+  // Events stay queued until the producer is back
+  if (!producer_) {
+    return;
+  }
+
+  QVector<KafkaEvent> batch;
+  int batch_size = drain_batch_size_.load(std::memory_order_relaxed);
+  batch.reserve(batch_size);
+  queue_->PopBatch(&batch, batch_size);
+
+  if (!batch.isEmpty()) {
+    QMutexLocker locker(&producer_mutex_);
+    ProduceBatch(batch);
+
+    // Serve delivery reports for earlier batches without blocking
+    rd_kafka_poll(static_cast<rd_kafka_t*>(producer_), 0);
+  }
+
+  // Yield to the event loop between batches so flush/shutdown can run
+  if (!queue_->IsEmpty() && queue_->RequestDrain()) {
+    QMetaObject::invokeMethod(this, "DrainQueue", Qt::QueuedConnection);
+  }
+}
+
+namespace {
+
+// Spill journal sequence of a journaled event, handed back by the delivery
+// report
+struct DeliveredEvent {
+  qint64 journal_sequence;
+};
+
+// librdkafka fills message sets up to this many bytes per partition
+constexpr int kProducerBatchBytes = 1024 * 1024;
+
+// How often librdkafka reports its statistics, matching the stats timer
+constexpr int kProducerStatisticsIntervalMs = 10000;
+
+} // namespace
+
+void KafkaProducerWorker::ProduceBatch(const QVector<KafkaEvent>& batch)
+{
+  QHash<QString, KafkaPayloadEncoding> encodings;
+  {
+    QMutexLocker locker(&config_mutex_);
+    encodings = topic_encodings_;
+  }
+
+  // One message per event so each keeps its key and partition; the producer
+  // batches and compresses them per partition (linger.ms, compression.codec)
+  qint64 produced_bytes = 0;
+  for (const KafkaEvent& event : batch) {
+    QByteArray payload = KafkaEventCodec::Encode(event, encodings.value(event.topic, KafkaPayloadEncoding::Json));
+
+    // Only journaled events need their sequence back
+    DeliveredEvent* delivered = nullptr;
+    if (event.journal_sequence >= 0) {
+      delivered = new DeliveredEvent{event.journal_sequence};
+    }
+
+    if (ProduceMessage(event.topic, event.key.toUtf8(), payload, delivered)) {
+      produced_bytes += payload.size();
+    } else {
+      emit EventDelivered(event.topic, event.key, false);
+      if (delivered) {
+        emit JournalEventsDelivered(QList<qint64>{delivered->journal_sequence}, false);
+        delete delivered;
+      }
+    }
+  }
+
+  emit PayloadBytesProduced(produced_bytes);
+}
+
+bool KafkaProducerWorker::ProduceMessage(const QString& topic, const QByteArray& key,
+                                         const QByteArray& payload, void* delivery_opaque)
+{
+  QByteArray topic_name = topic.toUtf8();
 
   // Publish to Kafka
   rd_kafka_resp_err_t err = rd_kafka_producev(
     static_cast<rd_kafka_t*>(producer_),
-    RD_KAFKA_V_TOPIC(event.topic.toUtf8().constData()),
-    RD_KAFKA_V_KEY(event.key.toUtf8().constData(), event.key.toUtf8().length()),
+    RD_KAFKA_V_TOPIC(topic_name.constData()),
+    RD_KAFKA_V_KEY(key.constData(), key.length()),
     RD_KAFKA_V_VALUE(payload.constData(), payload.length()),
-    RD_KAFKA_V_OPAQUE(this),
+    RD_KAFKA_V_MSGFLAGS(RD_KAFKA_MSG_F_COPY),
+    RD_KAFKA_V_OPAQUE(delivery_opaque),
     RD_KAFKA_V_END
   );
 
   if (err) {
     qWarning() << "Failed to publish event:" << rd_kafka_err2str(err);
-    emit EventDelivered(event.topic, event.key, false);
     emit ErrorOccurred(QString::fromUtf8(rd_kafka_err2str(err)), err);
+    return false;
   }
+  return true;
 }
 
 void KafkaProducerWorker::FlushProducer()
 {
-  if (producer_) {
-    QMutexLocker locker(&producer_mutex_);
-    rd_kafka_flush(static_cast<rd_kafka_t*>(producer_), 1000); // 1 second timeout
+  if (!producer_) {
+    return;
   }
+
+  // Hand everything still queued to librdkafka before flushing
+  if (queue_) {
+    QVector<KafkaEvent> batch;
+    int batch_size = drain_batch_size_.load(std::memory_order_relaxed);
+    while (queue_->PopBatch(&batch, batch_size) > 0) {
+      QMutexLocker locker(&producer_mutex_);
+      ProduceBatch(batch);
+      batch.clear();
+    }
+  }
+
+  QMutexLocker locker(&producer_mutex_);
+  rd_kafka_flush(static_cast<rd_kafka_t*>(producer_), 1000); // 1 second timeout
+}
+
+void KafkaProducerWorker::PollProducer()
+{
+  if (!producer_) {
+    return;
+  }
+
+  QMutexLocker locker(&producer_mutex_);
+  rd_kafka_poll(static_cast<rd_kafka_t*>(producer_), 0);
 }
 
 void KafkaProducerWorker::SetupProducer()
@@ -641,15 +999,40 @@ void KafkaProducerWorker::SetupProducer()
     qWarning() << "Failed to set client.id:" << errstr;
   }
 
-  // Set callbacks
+  // Set callbacks; the conf opaque is what the callbacks receive as opaque
+  rd_kafka_conf_set_opaque(static_cast<rd_kafka_conf_t*>(config_), this);
   rd_kafka_conf_set_dr_msg_cb(static_cast<rd_kafka_conf_t*>(config_), DeliveryReportCallback);
   rd_kafka_conf_set_error_cb(static_cast<rd_kafka_conf_t*>(config_), ErrorCallback);
+  rd_kafka_conf_set_stats_cb(static_cast<rd_kafka_conf_t*>(config_), StatisticsCallback);
+  rd_kafka_conf_set(static_cast<rd_kafka_conf_t*>(config_), "statistics.interval.ms",
+                    QByteArray::number(kProducerStatisticsIntervalMs).constData(), nullptr, 0);
+  broker_tx_bytes_ = 0;
 
   // Additional producer settings
   rd_kafka_conf_set(static_cast<rd_kafka_conf_t*>(config_), "acks", "1", nullptr, 0);
   rd_kafka_conf_set(static_cast<rd_kafka_conf_t*>(config_), "retries", "3", nullptr, 0);
-  rd_kafka_conf_set(static_cast<rd_kafka_conf_t*>(config_), "batch.size", "16384", nullptr, 0);
-  rd_kafka_conf_set(static_cast<rd_kafka_conf_t*>(config_), "linger.ms", "50", nullptr, 0);
+
+  // Batching and compression happen in librdkafka per partition, so
+  // messages keep their keys and consumers need no custom framing
+  QString compression;
+  int batch_size;
+  int linger_ms;
+  {
+    QMutexLocker locker(&config_mutex_);
+    compression = KafkaUtils::CompressionCodecName(compression_);
+    batch_size = batch_mode_ ? producer_batch_size_ : 1;
+    linger_ms = batch_mode_ ? linger_ms_ : 0;
+  }
+  rd_kafka_conf_set(static_cast<rd_kafka_conf_t*>(config_), "batch.size",
+                    QByteArray::number(kProducerBatchBytes).constData(), nullptr, 0);
+  rd_kafka_conf_set(static_cast<rd_kafka_conf_t*>(config_), "batch.num.messages",
+                    QByteArray::number(batch_size).constData(), nullptr, 0);
+  rd_kafka_conf_set(static_cast<rd_kafka_conf_t*>(config_), "linger.ms",
+                    QByteArray::number(linger_ms).constData(), nullptr, 0);
+  if (rd_kafka_conf_set(static_cast<rd_kafka_conf_t*>(config_), "compression.codec",
+                        compression.toUtf8().constData(), errstr, sizeof(errstr)) != RD_KAFKA_CONF_OK) {
+    qWarning() << "Failed to set compression.codec:" << errstr;
+  }
 
   // Create producer
   producer_ = rd_kafka_new(RD_KAFKA_PRODUCER, static_cast<rd_kafka_conf_t*>(config_), errstr, sizeof(errstr));
@@ -684,13 +1067,23 @@ void KafkaProducerWorker::DeliveryReportCallback(void* producer, const void* mes
   const rd_kafka_message_t* msg = static_cast<const rd_kafka_message_t*>(message);
   KafkaProducerWorker* worker = static_cast<KafkaProducerWorker*>(opaque);
 
+  // Journaled events carry their spill journal sequence
+  std::unique_ptr<DeliveredEvent> delivered(static_cast<DeliveredEvent*>(msg->_private));
+
   if (worker) {
     QString topic = QString::fromUtf8(rd_kafka_topic_name(msg->rkt));
     QString key = QString::fromUtf8(static_cast<const char*>(msg->key), msg->key_len);
     bool success = (msg->err == RD_KAFKA_RESP_ERR_NO_ERROR);
-    
+
     QMetaObject::invokeMethod(worker, "EventDelivered", Qt::QueuedConnection,
                              Q_ARG(QString, topic), Q_ARG(QString, key), Q_ARG(bool, success));
+
+    // Lets the spill journal checkpoint past (or replay) this event
+    if (delivered) {
+      QMetaObject::invokeMethod(worker, "JournalEventsDelivered", Qt::QueuedConnection,
+                               Q_ARG(QList<qint64>, QList<qint64>{delivered->journal_sequence}),
+                               Q_ARG(bool, success));
+    }
   }
 }
 
@@ -707,6 +1100,34 @@ void KafkaProducerWorker::ErrorCallback(void* producer, int error_code, const ch
   }
 }
 
+int KafkaProducerWorker::StatisticsCallback(void* producer, char* json, size_t json_len, void* opaque)
+{
+  Q_UNUSED(producer)
+
+  KafkaProducerWorker* worker = static_cast<KafkaProducerWorker*>(opaque);
+  if (!worker) {
+    return 0;
+  }
+
+  // Bytes on the wire, after compression and protocol framing, summed over
+  // the brokers; called from rd_kafka_poll on the worker thread
+  QJsonObject stats = QJsonDocument::fromJson(QByteArray(json, static_cast<int>(json_len))).object();
+  QJsonObject brokers = stats.value("brokers").toObject();
+  qint64 tx_bytes = 0;
+  for (auto it = brokers.constBegin(); it != brokers.constEnd(); ++it) {
+    tx_bytes += it.value().toObject().value("txbytes").toVariant().toLongLong();
+  }
+
+  if (tx_bytes > worker->broker_tx_bytes_) {
+    qint64 sent = tx_bytes - worker->broker_tx_bytes_;
+    worker->broker_tx_bytes_ = tx_bytes;
+    QMetaObject::invokeMethod(worker, "BrokerBytesSent", Qt::QueuedConnection, Q_ARG(qint64, sent));
+  }
+
+  // librdkafka frees the JSON
+  return 0;
+}
+
 // KafkaUtils Implementation
 namespace KafkaUtils {
 
@@ -736,6 +1157,18 @@ QString EventPriorityToString(EventPriority priority)
   }
 }
 
+QString CompressionCodecName(KafkaCompression compression)
+{
+  switch (compression) {
+    case KafkaCompression::None: return "none";
+    case KafkaCompression::Gzip: return "gzip";
+    case KafkaCompression::Snappy: return "snappy";
+    case KafkaCompression::Lz4: return "lz4";
+    case KafkaCompression::Zstd: return "zstd";
+  }
+  return "none";
+}
+
 QString GenerateTopicName(EventType type)
 {
   QString base = EventTypeToString(type);
@@ -774,6 +1207,39 @@ qint64 CalculateEventSize(const KafkaEvent& event)
          data.length();
 }
 
+QJsonObject EventToJson(const KafkaEvent& event)
+{
+  QJsonObject json;
+  json["topic"] = event.topic;
+  json["key"] = event.key;
+  json["data"] = event.data;
+  json["type"] = static_cast<int>(event.type);
+  json["priority"] = static_cast<int>(event.priority);
+  json["timestamp"] = event.timestamp;
+  json["retry_count"] = event.retry_count;
+  json["source"] = event.source_component;
+
+  return json;
+}
+
+bool EventFromJson(const QJsonObject& json, KafkaEvent* event)
+{
+  if (!event || !json.contains("topic") || !json["data"].isObject()) {
+    return false;
+  }
+
+  event->topic = json["topic"].toString();
+  event->key = json["key"].toString();
+  event->data = json["data"].toObject();
+  event->type = static_cast<EventType>(json["type"].toInt(static_cast<int>(EventType::SystemMetric)));
+  event->priority = static_cast<EventPriority>(qBound(0, json["priority"].toInt(1), 3));
+  event->timestamp = static_cast<qint64>(json["timestamp"].toDouble());
+  event->retry_count = json["retry_count"].toInt();
+  event->source_component = json["source"].toString("apache-cleats");
+
+  return true;
+}
+
 } // namespace KafkaUtils
 
 } // namespace olive
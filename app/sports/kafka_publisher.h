@@ -11,20 +11,26 @@
 
 #include <QObject>
 #include <QTimer>
-#include <QQueue>
 #include <QMutex>
 #include <QThread>
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QString>
 #include <QStringList>
+#include <QVector>
 #include <QDateTime>
+#include <QHash>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 
+#include <atomic>
+#include <memory>
+
 namespace olive {
 
 class KafkaProducerWorker;
+class KafkaEventQueue;
+class KafkaSpillJournal;
 
 /**
  * @brief Event types for Kafka publishing
@@ -50,6 +56,34 @@ enum class EventPriority {
   Critical = 3
 };
 
+/**
+ * @brief What publishers do when the event queue is full
+ */
+enum class KafkaOverflowPolicy {
+  Block,                // Wait (bounded) for the worker to free a slot
+  DropLowestPriority,   // Evict a lower priority event, else drop the new one
+  SpillToDisk           // Append to the spill journal, replayed once the queue drains
+};
+
+/**
+ * @brief Wire format of a single event payload, chosen per topic
+ */
+enum class KafkaPayloadEncoding {
+  Json,     // Compact JSON text, readable by any consumer
+  Binary    // Schema'd layout for formation/alert events, CBOR for the rest
+};
+
+/**
+ * @brief Producer compression.codec, applied by librdkafka per message batch
+ */
+enum class KafkaCompression {
+  None,
+  Gzip,
+  Snappy,
+  Lz4,
+  Zstd
+};
+
 /**
  * @brief Event data structure for Kafka publishing
  */
@@ -62,13 +96,15 @@ struct KafkaEvent {
   qint64 timestamp;
   int retry_count;
   QString source_component;
+  qint64 journal_sequence;  // Spill journal record, -1 if never spilled
   
   KafkaEvent() 
     : type(EventType::SystemMetric)
     , priority(EventPriority::Normal)
     , timestamp(QDateTime::currentMSecsSinceEpoch())
     , retry_count(0)
-    , source_component("apache-cleats") {}
+    , source_component("apache-cleats")
+    , journal_sequence(-1) {}
 };
 
 /**
@@ -137,14 +173,65 @@ public:
 
   /**
    * @brief Get producer statistics
+   *
+   * bytes_sent counts encoded payloads before producer compression;
+   * broker_bytes_sent is what librdkafka reports sending to the brokers.
    */
   QJsonObject GetStatistics() const;
 
   /**
    * @brief Enable/disable batch publishing
+   *
+   * In batch mode the producer lingers up to flush_interval_ms (linger.ms)
+   * to fill batches of batch_size messages (batch.num.messages). Producer
+   * settings take effect when the producer is created at Initialize.
    */
   void SetBatchMode(bool enabled, int batch_size = 100, int flush_interval_ms = 1000);
 
+  /**
+   * @brief Configure queue overflow handling
+   */
+  void SetOverflowPolicy(KafkaOverflowPolicy policy, int block_timeout_ms = 1000);
+
+  /**
+   * @brief Set the event queue capacity (before Initialize)
+   */
+  void SetQueueCapacity(int capacity);
+
+  /**
+   * @brief Spill events to an on-disk journal while disconnected or backed up
+   *
+   * Off by default. Takes effect at Initialize. An empty directory uses
+   * AppData/kafka/journal; max_bytes caps the journal's disk use, oldest
+   * segments are dropped beyond it.
+   */
+  void SetSpillJournal(bool enabled, const QString& directory = QString(),
+                       qint64 max_bytes = 256LL * 1024 * 1024);
+
+  /**
+   * @brief Queued events above which new events go to the journal
+   */
+  void SetSpillThreshold(int queued_events);
+
+  /**
+   * @brief Bandwidth budget for replaying the journal after reconnecting
+   */
+  void SetReplayRate(qint64 bytes_per_second);
+
+  /**
+   * @brief Choose the payload encoding for a topic (JSON by default)
+   */
+  void SetTopicEncoding(const QString& topic, KafkaPayloadEncoding encoding);
+
+  /**
+   * @brief Producer compression.codec (before Initialize)
+   *
+   * librdkafka compresses each partition's message batch, so events stay
+   * one Kafka message each, keep their own key and partition, and any
+   * consumer can read them.
+   */
+  void SetCompression(KafkaCompression compression);
+
   /**
    * @brief Set event filtering
    */
@@ -165,6 +252,7 @@ public slots:
    * @brief Handle delivery reports
    */
   void OnEventDelivered(const QString& topic, const QString& key, bool success);
+  void OnJournalEventsDelivered(const QList<qint64>& sequences, bool success);
 
   /**
    * @brief Handle errors
@@ -186,6 +274,9 @@ private slots:
   void OnFlushTimer();
   void OnReconnectTimer();
   void OnStatsTimer();
+  void OnPayloadBytesProduced(qint64 bytes);
+  void OnBrokerBytesSent(qint64 bytes);
+  void OnReplayTimer();
 
 private:
   void SetupTimers();
@@ -193,7 +284,9 @@ private:
   void StopWorkerThread();
   bool ValidateEvent(const KafkaEvent& event);
   void EnqueueEvent(const KafkaEvent& event);
-  void UpdateStatistics(const KafkaEvent& event, bool success);
+  void ScheduleDrain();
+  void OpenSpillJournal();
+  void SpillQueuedEvents();
   QJsonObject CreateEventMetadata(EventType type, EventPriority priority);
   QString GenerateEventKey(EventType type, const QString& custom_key = QString());
   void HandleConnectionFailure();
@@ -208,21 +301,32 @@ private:
   int flush_interval_ms_;
   int max_retry_count_;
   int reconnect_interval_ms_;
+  QHash<QString, KafkaPayloadEncoding> topic_encodings_;
+  KafkaCompression compression_;
   
-  // Connection state
-  bool is_connected_;
+  // Connection state - written on the worker's signals, read by publishers on any thread
+  std::atomic<bool> is_connected_;
   bool is_initialized_;
   QDateTime last_connection_attempt_;
   int connection_retry_count_;
   
-  // Event queue and processing
-  QQueue<KafkaEvent> event_queue_;
-  QMutex queue_mutex_;
+  // Event queue and processing - lock-free, drained in batches by the worker
+  std::shared_ptr<KafkaEventQueue> event_queue_;
+  int queue_capacity_;
   QTimer* process_timer_;
   QTimer* flush_timer_;
   QTimer* reconnect_timer_;
   QTimer* stats_timer_;
   
+  // Spill journal for broker outages and backlogs
+  std::shared_ptr<KafkaSpillJournal> journal_;
+  bool journal_enabled_;
+  QString journal_directory_;
+  qint64 journal_max_bytes_;
+  int spill_threshold_;
+  qint64 replay_bytes_per_second_;
+  QTimer* replay_timer_;
+  
   // Worker thread for Kafka operations
   QThread* worker_thread_;
   KafkaProducerWorker* worker_;
@@ -232,13 +336,14 @@ private:
   struct Statistics {
     qint64 events_published;
     qint64 events_failed;
-    qint64 bytes_sent;
+    qint64 bytes_sent;        // Encoded payloads, before producer compression
+    qint64 broker_bytes_sent; // Sent to the brokers, from librdkafka's txbytes
     qint64 queue_size;
     qint64 last_event_timestamp;
     double events_per_second;
     QDateTime start_time;
     
-    Statistics() : events_published(0), events_failed(0), bytes_sent(0),
+    Statistics() : events_published(0), events_failed(0), bytes_sent(0), broker_bytes_sent(0),
                    queue_size(0), last_event_timestamp(0), events_per_second(0.0),
                    start_time(QDateTime::currentDateTime()) {}
   } stats_;
@@ -257,26 +362,51 @@ class KafkaProducerWorker : public QObject
   Q_OBJECT
 
 public:
-  explicit KafkaProducerWorker(const QString& bootstrap_servers, const QString& client_id);
+  explicit KafkaProducerWorker(const QString& bootstrap_servers, const QString& client_id,
+                               std::shared_ptr<KafkaEventQueue> queue = nullptr);
   virtual ~KafkaProducerWorker();
 
+  /**
+   * @brief Maximum events produced per DrainQueue pass (thread-safe)
+   */
+  void SetDrainBatchSize(int batch_size);
+
+  /**
+   * @brief Payload encoding per topic (thread-safe)
+   */
+  void SetTopicEncoding(const QString& topic, KafkaPayloadEncoding encoding);
+
+  /**
+   * @brief linger.ms, batch.num.messages and compression.codec for the next SetupProducer
+   */
+  void SetProducerBatching(bool batch_mode, int batch_size, int linger_ms, KafkaCompression compression);
+
 public slots:
   void Initialize();
   void Shutdown();
   void PublishEvent(const KafkaEvent& event);
+  void DrainQueue();
   void FlushProducer();
+  void PollProducer();
 
 signals:
   void Initialized(bool success);
   void EventDelivered(const QString& topic, const QString& key, bool success);
+  void JournalEventsDelivered(const QList<qint64>& sequences, bool success);
+  void PayloadBytesProduced(qint64 bytes);
+  void BrokerBytesSent(qint64 bytes);
   void ErrorOccurred(const QString& error, int error_code);
   void ConnectionStatusChanged(bool connected);
 
 private:
   void SetupProducer();
   void CleanupProducer();
+  void ProduceBatch(const QVector<KafkaEvent>& batch);
+  bool ProduceMessage(const QString& topic, const QByteArray& key, const QByteArray& payload,
+                      void* delivery_opaque);
   static void DeliveryReportCallback(void* producer, const void* message, void* opaque);
   static void ErrorCallback(void* producer, int error_code, const char* reason, void* opaque);
+  static int StatisticsCallback(void* producer, char* json, size_t json_len, void* opaque);
 
   QString bootstrap_servers_;
   QString client_id_;
@@ -284,6 +414,21 @@ private:
   void* config_;   // rd_kafka_conf_t*
   bool is_initialized_;
   QMutex producer_mutex_;
+  std::shared_ptr<KafkaEventQueue> queue_;
+  std::atomic<int> drain_batch_size_;
+
+  // Broker txbytes total at the last statistics callback; librdkafka's
+  // counters start over with each producer
+  qint64 broker_tx_bytes_;
+
+  // Encoding settings, snapshotted once per drained batch; producer
+  // batching is read when the producer is created
+  QMutex config_mutex_;
+  QHash<QString, KafkaPayloadEncoding> topic_encodings_;
+  KafkaCompression compression_;
+  bool batch_mode_;
+  int producer_batch_size_;
+  int linger_ms_;
 };
 
 /**
@@ -317,11 +462,22 @@ QJsonObject CreateStandardEvent(EventType type, const QString& source,
  */
 bool IsValidTopicName(const QString& topic);
 
+/**
+ * @brief librdkafka compression.codec value
+ */
+QString CompressionCodecName(KafkaCompression compression);
+
 /**
  * @brief Calculate event payload size
  */
 qint64 CalculateEventSize(const KafkaEvent& event);
 
+/**
+ * @brief Self-contained JSON form of an event (spill journal records)
+ */
+QJsonObject EventToJson(const KafkaEvent& event);
+bool EventFromJson(const QJsonObject& json, KafkaEvent* event);
+
 } // namespace KafkaUtils
 
 } // namespace olive
@@ -0,0 +1,599 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Kafka Spill Journal Implementation
+  Durable on-disk journal for events published while the broker is unreachable
+***/
+
+#include "kafka_spill_journal.h"
+
+#include <QCborMap>
+#include <QCborValue>
+#include <QDebug>
+#include <QDir>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#endif
+
+namespace olive {
+
+namespace {
+
+constexpr quint32 kSegmentMagic = 0x4A4B4341; // "ACKJ"
+constexpr quint32 kCheckpointMagic = 0x504B4341; // "ACKP"
+constexpr quint32 kJournalVersion = 1;
+
+// Segment: magic, version, first sequence; then records back to back. The
+// file is preallocated with zeros, so a zero length marks the end.
+struct SegmentHeader {
+  quint32 magic;
+  quint32 version;
+  qint64 first_sequence;
+};
+
+struct RecordHeader {
+  quint32 length;     // Payload bytes, written last
+  quint32 checksum;   // FNV-1a over sequence and payload
+  qint64 sequence;
+};
+
+constexpr qint64 kSegmentHeaderSize = sizeof(SegmentHeader);
+constexpr qint64 kRecordHeaderSize = sizeof(RecordHeader);
+
+// Segments are never smaller than this, and the budget holds at least one
+constexpr qint64 kMinSegmentSize = 64 * 1024;
+
+// Acknowledgements between checkpoint writes when no segment is dropped
+constexpr qint64 kCheckpointInterval = 1024;
+
+quint32 Checksum(qint64 sequence, const char* data, qint64 size)
+{
+  quint32 hash = 2166136261u;
+  auto mix = [&hash](const char* bytes, qint64 count) {
+    for (qint64 i = 0; i < count; i++) {
+      hash ^= static_cast<quint8>(bytes[i]);
+      hash *= 16777619u;
+    }
+  };
+  mix(reinterpret_cast<const char*>(&sequence), sizeof(sequence));
+  mix(data, size);
+  return hash;
+}
+
+QString SegmentFileName(qint64 first_sequence)
+{
+  // Zero-padded so name order is sequence order
+  return QString("segment-%1.log").arg(first_sequence, 20, 10, QChar('0'));
+}
+
+} // namespace
+
+KafkaSpillJournal::KafkaSpillJournal(const QString& directory, qint64 max_bytes, qint64 segment_size)
+  : directory_(directory)
+  , max_bytes_(std::max<qint64>(max_bytes, std::max<qint64>(segment_size, kMinSegmentSize)))
+  , segment_size_(std::max<qint64>(segment_size, kMinSegmentSize))
+  , is_open_(false)
+  , disk_bytes_(0)
+  , next_sequence_(0)
+  , cursor_index_(0)
+  , cursor_offset_(kSegmentHeaderSize)
+  , acked_through_(-1)
+  , checkpointed_through_(-1)
+  , pending_(0)
+  , appended_(0)
+  , replayed_(0)
+  , dropped_(0)
+{
+}
+
+KafkaSpillJournal::~KafkaSpillJournal()
+{
+  Close();
+}
+
+bool KafkaSpillJournal::Open()
+{
+  QMutexLocker locker(&mutex_);
+  if (is_open_.load(std::memory_order_relaxed)) {
+    return true;
+  }
+
+  QDir dir(directory_);
+  if (!dir.mkpath(".")) {
+    qWarning() << "Failed to create Kafka spill journal directory:" << directory_;
+    return false;
+  }
+
+  ReadCheckpoint();
+  next_sequence_ = acked_through_ + 1;
+
+  // Recover segments in sequence order, deleting fully delivered ones
+  const QStringList names = dir.entryList(QStringList() << "segment-*.log", QDir::Files, QDir::Name);
+  for (const QString& name : names) {
+    auto segment = std::make_unique<Segment>();
+    segment->path = dir.filePath(name);
+    segment->file = std::make_unique<QFile>(segment->path);
+    if (!segment->file->open(QIODevice::ReadWrite) || !MapSegment(segment.get(), segment->file->size())) {
+      qWarning() << "Skipping unreadable Kafka journal segment:" << segment->path;
+      continue;
+    }
+
+    SegmentHeader header;
+    std::memcpy(&header, segment->data, sizeof(header));
+    if (header.magic != kSegmentMagic || header.version != kJournalVersion) {
+      qWarning() << "Skipping Kafka journal segment with bad header:" << segment->path;
+      segment->file->unmap(segment->data);
+      continue;
+    }
+    segment->first_sequence = header.first_sequence;
+    ScanSegment(segment.get());
+
+    if (segment->last_sequence <= acked_through_) {
+      segment->file->unmap(segment->data);
+      segment->file->remove();
+      continue;
+    }
+
+    next_sequence_ = std::max(next_sequence_, segment->last_sequence + 1);
+    disk_bytes_ += segment->size;
+    segments_.push_back(std::move(segment));
+  }
+
+  // Position the cursor on the first undelivered record
+  cursor_index_ = 0;
+  cursor_offset_ = kSegmentHeaderSize;
+  qint64 pending = 0;
+  bool cursor_found = false;
+  for (size_t i = 0; i < segments_.size(); i++) {
+    Segment* segment = segments_[i].get();
+    qint64 offset = kSegmentHeaderSize;
+    while (offset < segment->write_offset) {
+      RecordHeader header;
+      std::memcpy(&header, segment->data + offset, sizeof(header));
+      if (header.sequence > acked_through_) {
+        if (!cursor_found) {
+          cursor_index_ = i;
+          cursor_offset_ = offset;
+          cursor_found = true;
+        }
+        pending++;
+      }
+      offset += kRecordHeaderSize + header.length;
+    }
+  }
+  if (!cursor_found && !segments_.empty()) {
+    cursor_index_ = segments_.size() - 1;
+    cursor_offset_ = segments_.back()->write_offset;
+  }
+
+  pending_.store(pending, std::memory_order_release);
+  checkpointed_through_ = acked_through_;
+  is_open_.store(true, std::memory_order_release);
+
+  qInfo() << "Kafka spill journal opened:" << directory_
+          << "segments:" << segments_.size() << "pending events:" << pending;
+  return true;
+}
+
+void KafkaSpillJournal::Close()
+{
+  QMutexLocker locker(&mutex_);
+  if (!is_open_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+  WriteCheckpoint();
+
+  for (auto& segment : segments_) {
+    if (segment->data) {
+      segment->file->unmap(segment->data);
+      segment->data = nullptr;
+    }
+    segment->file->close();
+  }
+  segments_.clear();
+  outstanding_.clear();
+  rejected_.clear();
+  disk_bytes_ = 0;
+  pending_.store(0, std::memory_order_release);
+  is_open_.store(false, std::memory_order_release);
+}
+
+bool KafkaSpillJournal::Append(const KafkaEvent& event)
+{
+  QByteArray payload = QCborMap::fromJsonObject(KafkaUtils::EventToJson(event)).toCborValue().toCbor();
+  const qint64 record_size = kRecordHeaderSize + payload.size();
+
+  QMutexLocker locker(&mutex_);
+  if (!is_open_.load(std::memory_order_relaxed)) {
+    return false;
+  }
+
+  Segment* segment = segments_.empty() ? nullptr : segments_.back().get();
+  if (!segment || segment->write_offset + record_size > segment->size) {
+    const qint64 size = std::max(segment_size_, kSegmentHeaderSize + record_size);
+
+    // A long outage fills the budget: the oldest events give way
+    while (disk_bytes_ + size > max_bytes_ && !segments_.empty()) {
+      DropOldestSegment();
+    }
+
+    segment = CreateSegment(next_sequence_, size);
+    if (!segment) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+
+  RecordHeader header;
+  header.sequence = next_sequence_;
+  header.checksum = Checksum(header.sequence, payload.constData(), payload.size());
+  header.length = 0;
+
+  uchar* record = segment->data + segment->write_offset;
+  std::memcpy(record, &header, sizeof(header));
+  std::memcpy(record + kRecordHeaderSize, payload.constData(), static_cast<size_t>(payload.size()));
+
+  // Length last: a record is only visible to recovery once complete
+  quint32 length = static_cast<quint32>(payload.size());
+  std::memcpy(record + offsetof(RecordHeader, length), &length, sizeof(length));
+
+  segment->write_offset += record_size;
+  segment->last_sequence = next_sequence_++;
+
+  pending_.fetch_add(1, std::memory_order_release);
+  appended_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+int KafkaSpillJournal::ReadForReplay(QVector<KafkaEvent>* events, int max_events, qint64 max_bytes)
+{
+  QMutexLocker locker(&mutex_);
+  if (!is_open_.load(std::memory_order_relaxed)) {
+    return 0;
+  }
+
+  int count = 0;
+  qint64 bytes = 0;
+
+  // Rejected events go first, oldest first
+  while (!rejected_.empty() && count < max_events && (count == 0 || bytes < max_bytes)) {
+    qint64 sequence = *rejected_.begin();
+    rejected_.erase(rejected_.begin());
+    pending_.fetch_sub(1, std::memory_order_release);
+
+    auto it = outstanding_.find(sequence);
+    if (it == outstanding_.end()) {
+      continue;
+    }
+
+    KafkaEvent event;
+    qint64 record_size = 0;
+    if (!ReadRecord(it->second.segment, it->second.offset, &event, &record_size)) {
+      outstanding_.erase(it);
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+    event.journal_sequence = sequence;
+    events->append(std::move(event));
+    bytes += record_size;
+    count++;
+  }
+
+  // Then new records from the cursor
+  while (cursor_index_ < segments_.size() && count < max_events && (count == 0 || bytes < max_bytes)) {
+    Segment* segment = segments_[cursor_index_].get();
+    if (cursor_offset_ >= segment->write_offset) {
+      if (cursor_index_ + 1 >= segments_.size()) {
+        break;
+      }
+      cursor_index_++;
+      cursor_offset_ = kSegmentHeaderSize;
+      continue;
+    }
+
+    KafkaEvent event;
+    qint64 record_size = 0;
+    bool valid = ReadRecord(segment, cursor_offset_, &event, &record_size);
+
+    RecordHeader header;
+    std::memcpy(&header, segment->data + cursor_offset_, sizeof(header));
+    const qint64 offset = cursor_offset_;
+    cursor_offset_ += kRecordHeaderSize + header.length;
+    pending_.fetch_sub(1, std::memory_order_release);
+
+    if (!valid) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      continue;
+    }
+
+    event.journal_sequence = header.sequence;
+    outstanding_.emplace(header.sequence, RecordLocation{segment, offset});
+    events->append(std::move(event));
+    replayed_.fetch_add(1, std::memory_order_relaxed);
+    bytes += record_size;
+    count++;
+  }
+
+  // Records skipped as unreadable may let the checkpoint move
+  AdvanceCheckpoint();
+  return count;
+}
+
+void KafkaSpillJournal::Acknowledge(qint64 sequence)
+{
+  QMutexLocker locker(&mutex_);
+  if (outstanding_.erase(sequence) == 0) {
+    return;
+  }
+  if (rejected_.erase(sequence) > 0) {
+    pending_.fetch_sub(1, std::memory_order_release);
+  }
+  AdvanceCheckpoint();
+}
+
+void KafkaSpillJournal::Reject(qint64 sequence)
+{
+  QMutexLocker locker(&mutex_);
+  if (outstanding_.count(sequence) && rejected_.insert(sequence).second) {
+    pending_.fetch_add(1, std::memory_order_release);
+  }
+}
+
+void KafkaSpillJournal::Sync()
+{
+  QMutexLocker locker(&mutex_);
+  if (!is_open_.load(std::memory_order_relaxed)) {
+    return;
+  }
+
+#ifdef Q_OS_UNIX
+  for (const auto& segment : segments_) {
+    msync(segment->data, static_cast<size_t>(segment->size), MS_ASYNC);
+  }
+#endif
+
+  WriteCheckpoint();
+}
+
+qint64 KafkaSpillJournal::OutstandingCount() const
+{
+  QMutexLocker locker(&mutex_);
+  return static_cast<qint64>(outstanding_.size());
+}
+
+qint64 KafkaSpillJournal::DiskBytes() const
+{
+  QMutexLocker locker(&mutex_);
+  return disk_bytes_;
+}
+
+KafkaSpillJournal::Segment* KafkaSpillJournal::CreateSegment(qint64 first_sequence, qint64 size)
+{
+  auto segment = std::make_unique<Segment>();
+  segment->path = QDir(directory_).filePath(SegmentFileName(first_sequence));
+  segment->file = std::make_unique<QFile>(segment->path);
+  segment->first_sequence = first_sequence;
+
+  // Preallocated (sparse where supported) so appends never grow the file
+  if (!segment->file->open(QIODevice::ReadWrite | QIODevice::Truncate) ||
+      !segment->file->resize(size) || !MapSegment(segment.get(), size)) {
+    qWarning() << "Failed to create Kafka journal segment:" << segment->path
+               << segment->file->errorString();
+    segment->file->remove();
+    return nullptr;
+  }
+
+  SegmentHeader header{kSegmentMagic, kJournalVersion, first_sequence};
+  std::memcpy(segment->data, &header, sizeof(header));
+  segment->write_offset = kSegmentHeaderSize;
+
+  // Cursor sat at the end of the last segment (or there was none)
+  if (cursor_index_ + 1 == segments_.size() && cursor_offset_ >= segments_.back()->write_offset) {
+    cursor_index_ = segments_.size();
+    cursor_offset_ = kSegmentHeaderSize;
+  } else if (segments_.empty()) {
+    cursor_index_ = 0;
+    cursor_offset_ = kSegmentHeaderSize;
+  }
+
+  disk_bytes_ += size;
+  segments_.push_back(std::move(segment));
+  return segments_.back().get();
+}
+
+bool KafkaSpillJournal::MapSegment(Segment* segment, qint64 size)
+{
+  if (size < kSegmentHeaderSize) {
+    return false;
+  }
+  segment->data = segment->file->map(0, size);
+  segment->size = segment->data ? size : 0;
+  return segment->data != nullptr;
+}
+
+void KafkaSpillJournal::ScanSegment(Segment* segment)
+{
+  // Stop at the first empty or torn record
+  qint64 offset = kSegmentHeaderSize;
+  while (offset + kRecordHeaderSize <= segment->size) {
+    RecordHeader header;
+    std::memcpy(&header, segment->data + offset, sizeof(header));
+    if (header.length == 0 || offset + kRecordHeaderSize + header.length > segment->size) {
+      break;
+    }
+    const char* payload = reinterpret_cast<const char*>(segment->data + offset + kRecordHeaderSize);
+    if (Checksum(header.sequence, payload, header.length) != header.checksum) {
+      qWarning() << "Kafka journal segment truncated at corrupt record:" << segment->path << offset;
+      break;
+    }
+    segment->last_sequence = header.sequence;
+    offset += kRecordHeaderSize + header.length;
+  }
+  segment->write_offset = offset;
+
+  // Clear whatever follows so later appends are not mistaken for a torn tail
+  if (offset < segment->size) {
+    std::memset(segment->data + offset, 0, static_cast<size_t>(std::min<qint64>(kRecordHeaderSize, segment->size - offset)));
+  }
+}
+
+void KafkaSpillJournal::RemoveFrontSegment()
+{
+  std::unique_ptr<Segment> segment = std::move(segments_.front());
+  segments_.pop_front();
+
+  segment->file->unmap(segment->data);
+  segment->file->close();
+  segment->file->remove();
+  disk_bytes_ -= segment->size;
+
+  if (cursor_index_ > 0) {
+    cursor_index_--;
+  } else {
+    cursor_offset_ = kSegmentHeaderSize;
+  }
+}
+
+void KafkaSpillJournal::DropOldestSegment()
+{
+  Segment* segment = segments_.front().get();
+
+  // Count what is lost: records not handed out yet, and outstanding ones
+  qint64 lost = 0;
+  for (auto it = outstanding_.begin(); it != outstanding_.end();) {
+    if (it->second.segment == segment) {
+      if (rejected_.erase(it->first) > 0) {
+        pending_.fetch_sub(1, std::memory_order_release);
+      }
+      it = outstanding_.erase(it);
+      lost++;
+    } else {
+      ++it;
+    }
+  }
+  if (cursor_index_ == 0) {
+    qint64 offset = cursor_offset_;
+    while (offset < segment->write_offset) {
+      RecordHeader header;
+      std::memcpy(&header, segment->data + offset, sizeof(header));
+      offset += kRecordHeaderSize + header.length;
+      pending_.fetch_sub(1, std::memory_order_release);
+      lost++;
+    }
+  }
+
+  qWarning() << "Kafka spill journal full, dropping" << lost << "events from" << segment->path;
+  dropped_.fetch_add(lost, std::memory_order_relaxed);
+  acked_through_ = std::max(acked_through_, segment->last_sequence);
+
+  RemoveFrontSegment();
+}
+
+bool KafkaSpillJournal::ReadRecord(const Segment* segment, qint64 offset, KafkaEvent* event,
+                                   qint64* record_size) const
+{
+  RecordHeader header;
+  std::memcpy(&header, segment->data + offset, sizeof(header));
+  *record_size = kRecordHeaderSize + header.length;
+
+  QByteArray payload = QByteArray::fromRawData(
+    reinterpret_cast<const char*>(segment->data + offset + kRecordHeaderSize), static_cast<int>(header.length));
+  QCborValue value = QCborValue::fromCbor(payload);
+  return value.isMap() && KafkaUtils::EventFromJson(value.toMap().toJsonObject(), event);
+}
+
+qint64 KafkaSpillJournal::CursorSequence() const
+{
+  if (cursor_index_ >= segments_.size()) {
+    return next_sequence_;
+  }
+
+  const Segment* segment = segments_[cursor_index_].get();
+  if (cursor_offset_ < segment->write_offset) {
+    RecordHeader header;
+    std::memcpy(&header, segment->data + cursor_offset_, sizeof(header));
+    return header.sequence;
+  }
+  if (cursor_index_ + 1 < segments_.size()) {
+    return segments_[cursor_index_ + 1]->first_sequence;
+  }
+  return next_sequence_;
+}
+
+void KafkaSpillJournal::AdvanceCheckpoint()
+{
+  qint64 first_undelivered = CursorSequence();
+  if (!outstanding_.empty()) {
+    first_undelivered = std::min(first_undelivered, outstanding_.begin()->first);
+  }
+  acked_through_ = std::max(acked_through_, first_undelivered - 1);
+
+  // Drop segments that are fully delivered and fully read
+  bool removed = false;
+  while (!segments_.empty() && segments_.front()->last_sequence <= acked_through_) {
+    Segment* front = segments_.front().get();
+    bool cursor_past = cursor_index_ > 0 || cursor_offset_ >= front->write_offset;
+    if (!cursor_past) {
+      break;
+    }
+    RemoveFrontSegment();
+    removed = true;
+  }
+
+  if (removed || acked_through_ - checkpointed_through_ >= kCheckpointInterval) {
+    WriteCheckpoint();
+  }
+}
+
+void KafkaSpillJournal::WriteCheckpoint()
+{
+  if (acked_through_ == checkpointed_through_) {
+    return;
+  }
+
+  QSaveFile file(QDir(directory_).filePath("checkpoint"));
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "Failed to write Kafka journal checkpoint:" << file.errorString();
+    return;
+  }
+
+  quint32 magic = kCheckpointMagic;
+  file.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+  file.write(reinterpret_cast<const char*>(&acked_through_), sizeof(acked_through_));
+  if (file.commit()) {
+    checkpointed_through_ = acked_through_;
+  }
+}
+
+bool KafkaSpillJournal::ReadCheckpoint()
+{
+  QFile file(QDir(directory_).filePath("checkpoint"));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  QByteArray data = file.readAll();
+  quint32 magic = 0;
+  qint64 acked_through = -1;
+  if (data.size() != static_cast<int>(sizeof(magic) + sizeof(acked_through))) {
+    return false;
+  }
+  std::memcpy(&magic, data.constData(), sizeof(magic));
+  std::memcpy(&acked_through, data.constData() + sizeof(magic), sizeof(acked_through));
+  if (magic != kCheckpointMagic) {
+    return false;
+  }
+
+  acked_through_ = acked_through;
+  return true;
+}
+
+} // namespace olive
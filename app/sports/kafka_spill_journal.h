@@ -0,0 +1,163 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Kafka Spill Journal
+  Durable on-disk journal for events published while the broker is unreachable
+***/
+
+#ifndef KAFKASPILLJOURNAL_H
+#define KAFKASPILLJOURNAL_H
+
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+
+#include "kafka_publisher.h"
+
+namespace olive {
+
+/**
+ * @brief Append-only, memory-mapped segment journal of Kafka events
+ *
+ * Events are appended to preallocated segment files mapped into memory,
+ * each record tagged with a monotonically increasing sequence number.
+ * Replay hands them back in sequence order; a replayed event stays
+ * outstanding until Acknowledge() (delivered) or Reject() (replay again).
+ * Segments whose events are all acknowledged are deleted, and the
+ * acknowledged sequence is checkpointed so a restart resumes where
+ * delivery left off. Delivery is at-least-once: events acknowledged after
+ * the last checkpoint are replayed again after a crash.
+ *
+ * All methods are thread-safe.
+ */
+class KafkaSpillJournal
+{
+public:
+  explicit KafkaSpillJournal(const QString& directory,
+                             qint64 max_bytes = 256LL * 1024 * 1024,
+                             qint64 segment_size = 8 * 1024 * 1024);
+  ~KafkaSpillJournal();
+
+  KafkaSpillJournal(const KafkaSpillJournal&) = delete;
+  KafkaSpillJournal& operator=(const KafkaSpillJournal&) = delete;
+
+  /**
+   * @brief Open the directory, recovering segments and the checkpoint
+   */
+  bool Open();
+
+  /**
+   * @brief Write the checkpoint and unmap all segments
+   */
+  void Close();
+
+  bool IsOpen() const { return is_open_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Append an event; false if the journal is closed or full
+   */
+  bool Append(const KafkaEvent& event);
+
+  /**
+   * @brief Hand out the next events for replay, rejected ones first
+   *
+   * Stops after max_events or once max_bytes of records were read (at
+   * least one event is returned if any is pending). Each event's
+   * journal_sequence is set.
+   */
+  int ReadForReplay(QVector<KafkaEvent>* events, int max_events, qint64 max_bytes);
+
+  /**
+   * @brief Delivery confirmed; advances the checkpoint and drops finished segments
+   */
+  void Acknowledge(qint64 sequence);
+
+  /**
+   * @brief Delivery failed or the event was lost in memory; replay it again
+   */
+  void Reject(qint64 sequence);
+
+  /**
+   * @brief Schedule mapped pages for writeback and persist the checkpoint
+   */
+  void Sync();
+
+  // Events not handed out yet (cheap, no lock)
+  bool HasPending() const { return pending_.load(std::memory_order_acquire) > 0; }
+  qint64 PendingCount() const { return pending_.load(std::memory_order_relaxed); }
+
+  qint64 OutstandingCount() const;
+  qint64 DiskBytes() const;
+  QString Directory() const { return directory_; }
+
+  // Counters
+  qint64 AppendedCount() const { return appended_.load(std::memory_order_relaxed); }
+  qint64 ReplayedCount() const { return replayed_.load(std::memory_order_relaxed); }
+  qint64 DroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  struct Segment {
+    QString path;
+    std::unique_ptr<QFile> file;
+    uchar* data = nullptr;
+    qint64 size = 0;
+    qint64 write_offset = 0;
+    qint64 first_sequence = 0;
+    qint64 last_sequence = -1;    // -1 while empty
+  };
+
+  struct RecordLocation {
+    Segment* segment;
+    qint64 offset;
+  };
+
+  Segment* CreateSegment(qint64 first_sequence, qint64 size);
+  bool MapSegment(Segment* segment, qint64 size);
+  void ScanSegment(Segment* segment);
+  void RemoveFrontSegment();
+  void DropOldestSegment();
+  bool ReadRecord(const Segment* segment, qint64 offset, KafkaEvent* event, qint64* record_size) const;
+  qint64 CursorSequence() const;
+  void AdvanceCheckpoint();
+  void WriteCheckpoint();
+  bool ReadCheckpoint();
+
+  const QString directory_;
+  const qint64 max_bytes_;
+  const qint64 segment_size_;
+
+  mutable QMutex mutex_;
+  std::atomic<bool> is_open_;
+  std::deque<std::unique_ptr<Segment>> segments_;
+  qint64 disk_bytes_;
+  qint64 next_sequence_;
+
+  // Replay cursor: next record never handed out
+  size_t cursor_index_;
+  qint64 cursor_offset_;
+
+  // Handed out but not acknowledged, and the subset to replay again
+  std::map<qint64, RecordLocation> outstanding_;
+  std::set<qint64> rejected_;
+
+  // Every sequence up to here is delivered
+  qint64 acked_through_;
+  qint64 checkpointed_through_;
+
+  std::atomic<qint64> pending_;
+  std::atomic<qint64> appended_;
+  std::atomic<qint64> replayed_;
+  std::atomic<qint64> dropped_;
+};
+
+} // namespace olive
+
+#endif // KAFKASPILLJOURNAL_H
@@ -0,0 +1,277 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  MinIO Chunk Store Implementation
+***/
+
+#include "minio_chunk_store.h"
+
+#include <QByteArrayView>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+
+#include <array>
+
+namespace olive {
+
+namespace {
+
+constexpr qint64 kReadBlockSize = 4 * 1024 * 1024;
+constexpr int kDigestSize = 32;
+constexpr int kManifestVersion = 1;
+
+// Normalized chunking: harder to cut before the average size, easier after
+constexpr int kStrictMaskBits = 23;
+constexpr int kLooseMaskBits = 19;
+constexpr quint64 kStrictMask = ~0ULL << (64 - kStrictMaskBits);
+constexpr quint64 kLooseMask = ~0ULL << (64 - kLooseMaskBits);
+
+// Fixed pseudo-random byte -> value table; it must never change, or
+// previously stored chunks stop matching
+const std::array<quint64, 256>& GearTable()
+{
+  static const std::array<quint64, 256> table = [] {
+    std::array<quint64, 256> values{};
+    quint64 state = 0x41504143484531ULL; // splitmix64
+    for (quint64& value : values) {
+      state += 0x9E3779B97F4A7C15ULL;
+      quint64 z = state;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+      value = z ^ (z >> 31);
+    }
+    return values;
+  }();
+  return table;
+}
+
+} // namespace
+
+bool MinIOChunker::ChunkFile(const QString& file_path, QVector<MinIOChunk>* chunks, QString* error)
+{
+  chunks->clear();
+
+  QFile file(file_path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    if (error) {
+      *error = file.errorString();
+    }
+    return false;
+  }
+
+  const std::array<quint64, 256>& gear_table = GearTable();
+  QByteArray buffer(kReadBlockSize, Qt::Uninitialized);
+  QCryptographicHash hash(QCryptographicHash::Sha256);
+
+  quint64 gear = 0;
+  qint64 chunk_offset = 0;
+  qint64 chunk_size = 0;
+
+  auto finish_chunk = [&]() {
+    MinIOChunk chunk;
+    chunk.hash = QString::fromLatin1(hash.result().toHex());
+    chunk.offset = chunk_offset;
+    chunk.size = chunk_size;
+    chunks->append(chunk);
+
+    hash.reset();
+    chunk_offset += chunk_size;
+    chunk_size = 0;
+    gear = 0;
+  };
+
+  while (true) {
+    qint64 read = file.read(buffer.data(), buffer.size());
+    if (read < 0) {
+      if (error) {
+        *error = file.errorString();
+      }
+      return false;
+    }
+    if (read == 0) {
+      break;
+    }
+
+    const uchar* data = reinterpret_cast<const uchar*>(buffer.constData());
+    qint64 hashed = 0;
+    for (qint64 i = 0; i < read; i++) {
+      chunk_size++;
+
+      // No cut point can fall below the minimum, so skip rolling over it
+      if (chunk_size <= kMinChunkSize) {
+        continue;
+      }
+
+      gear = (gear << 1) + gear_table[data[i]];
+      quint64 mask = chunk_size < kAverageChunkSize ? kStrictMask : kLooseMask;
+      if ((gear & mask) == 0 || chunk_size >= kMaxChunkSize) {
+        hash.addData(QByteArrayView(buffer.constData() + hashed, i + 1 - hashed));
+        hashed = i + 1;
+        finish_chunk();
+      }
+    }
+    hash.addData(QByteArrayView(buffer.constData() + hashed, read - hashed));
+  }
+
+  if (chunk_size > 0) {
+    finish_chunk();
+  }
+  return true;
+}
+
+QString MinIOChunker::ChunkObjectKey(const QString& hash)
+{
+  return QString("chunks/%1/%2").arg(hash.left(2), hash);
+}
+
+QString MinIOChunker::ManifestObjectKey(const QString& object_key)
+{
+  return object_key + ".chunks.json";
+}
+
+bool MinIOChunker::IsManifestObjectKey(const QString& key)
+{
+  return key.endsWith(".chunks.json");
+}
+
+QByteArray MinIOChunker::BuildManifest(const QVector<MinIOChunk>& chunks, qint64 file_size,
+                                       const QString& original_filename)
+{
+  QJsonArray chunk_list;
+  for (const MinIOChunk& chunk : chunks) {
+    chunk_list.append(QJsonArray{chunk.hash, chunk.size});
+  }
+
+  QJsonObject manifest;
+  manifest["format"] = "amt-chunks";
+  manifest["version"] = kManifestVersion;
+  manifest["size"] = file_size;
+  manifest["original_filename"] = original_filename;
+  manifest["chunks"] = chunk_list;
+  return QJsonDocument(manifest).toJson(QJsonDocument::Compact);
+}
+
+bool MinIOChunker::ParseManifest(const QByteArray& manifest, QVector<MinIOChunk>* chunks, qint64* file_size)
+{
+  QJsonObject object = QJsonDocument::fromJson(manifest).object();
+  if (object["format"].toString() != "amt-chunks" || object["version"].toInt() != kManifestVersion) {
+    return false;
+  }
+
+  chunks->clear();
+  qint64 offset = 0;
+  for (const QJsonValue& value : object["chunks"].toArray()) {
+    QJsonArray entry = value.toArray();
+    MinIOChunk chunk;
+    chunk.hash = entry.at(0).toString();
+    chunk.offset = offset;
+    chunk.size = static_cast<qint64>(entry.at(1).toDouble());
+    if (chunk.hash.size() != kDigestSize * 2 || chunk.size <= 0) {
+      return false;
+    }
+    chunks->append(chunk);
+    offset += chunk.size;
+  }
+
+  *file_size = static_cast<qint64>(object["size"].toDouble());
+  return offset == *file_size;
+}
+
+MinIOChunkIndex::MinIOChunkIndex(const QString& index_path)
+  : index_path_(index_path)
+  , file_(index_path)
+{
+  Load();
+}
+
+bool MinIOChunkIndex::Contains(const QString& hash) const
+{
+  QByteArray digest = QByteArray::fromHex(hash.toLatin1());
+  QMutexLocker locker(&mutex_);
+  return digests_.contains(digest);
+}
+
+void MinIOChunkIndex::Insert(const QString& hash)
+{
+  QByteArray digest = QByteArray::fromHex(hash.toLatin1());
+  if (digest.size() != kDigestSize) {
+    return;
+  }
+
+  QMutexLocker locker(&mutex_);
+  if (digests_.contains(digest)) {
+    return;
+  }
+  digests_.insert(digest);
+
+  // Append right away so an interrupted upload keeps what it stored
+  if (file_.isOpen()) {
+    file_.write(digest);
+    file_.flush();
+  }
+}
+
+void MinIOChunkIndex::Remove(const QString& hash)
+{
+  QByteArray digest = QByteArray::fromHex(hash.toLatin1());
+
+  QMutexLocker locker(&mutex_);
+  if (!digests_.remove(digest)) {
+    return;
+  }
+
+  // Records are only ever appended, so dropping one rewrites the file
+  if (file_.isOpen()) {
+    file_.resize(0);
+    file_.seek(0);
+    for (const QByteArray& remaining : std::as_const(digests_)) {
+      file_.write(remaining);
+    }
+    file_.flush();
+  }
+}
+
+int MinIOChunkIndex::Size() const
+{
+  QMutexLocker locker(&mutex_);
+  return digests_.size();
+}
+
+QString MinIOChunkIndex::IndexPath(const QString& endpoint, const QString& bucket)
+{
+  QByteArray id = QCryptographicHash::hash((endpoint + "|" + bucket).toUtf8(),
+                                           QCryptographicHash::Sha1).toHex();
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+         + "/minio/chunks/" + QString::fromLatin1(id) + ".idx";
+}
+
+void MinIOChunkIndex::Load()
+{
+  QDir().mkpath(QFileInfo(index_path_).absolutePath());
+  if (!file_.open(QIODevice::ReadWrite)) {
+    qWarning() << "Cannot open chunk index:" << index_path_ << file_.errorString()
+               << "- every chunk will be uploaded";
+    return;
+  }
+
+  // A torn final record from a crash is dropped
+  qint64 valid_size = file_.size() - file_.size() % kDigestSize;
+  while (file_.pos() < valid_size) {
+    digests_.insert(file_.read(kDigestSize));
+  }
+  if (file_.size() != valid_size) {
+    file_.resize(valid_size);
+  }
+  file_.seek(valid_size);
+
+  qInfo() << "Loaded chunk index:" << index_path_ << "chunks:" << digests_.size();
+}
+
+} // namespace olive
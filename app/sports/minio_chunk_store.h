@@ -0,0 +1,118 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  MinIO Chunk Store
+  Content-defined chunking and chunk index for deduplicated video uploads
+***/
+
+#ifndef MINIOCHUNKSTORE_H
+#define MINIOCHUNKSTORE_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+namespace olive {
+
+/**
+ * @brief One content-defined chunk of a file
+ */
+struct MinIOChunk {
+  QString hash;    // SHA-256, hex
+  qint64 offset;
+  qint64 size;
+
+  MinIOChunk() : offset(0), size(0) {}
+};
+
+/**
+ * @brief Content-defined chunking and chunk manifests
+ *
+ * Chunk boundaries come from a gear rolling hash (FastCDC with normalized
+ * chunking), so they depend on the bytes around them rather than on file
+ * offsets. An edit or a re-export that shifts data only changes the chunks
+ * it touches; the rest hash the same and are already in the bucket.
+ *
+ * A deduplicated upload stores every chunk once under chunks/ and a small
+ * JSON manifest, tagged with ManifestContentType, at ManifestObjectKey().
+ * Nothing is stored at the object's own key.
+ */
+class MinIOChunker
+{
+public:
+  static constexpr qint64 kMinChunkSize = 512 * 1024;
+  static constexpr qint64 kAverageChunkSize = 2 * 1024 * 1024;
+  static constexpr qint64 kMaxChunkSize = 8 * 1024 * 1024;
+
+  /**
+   * @brief Split a file into chunks, streaming it from disk
+   */
+  static bool ChunkFile(const QString& file_path, QVector<MinIOChunk>* chunks, QString* error = nullptr);
+
+  /**
+   * @brief Object key a chunk is stored under, shared by all files in the bucket
+   */
+  static QString ChunkObjectKey(const QString& hash);
+
+  /**
+   * @brief Object key of the chunk manifest for a deduplicated object
+   */
+  static QString ManifestObjectKey(const QString& object_key);
+  static bool IsManifestObjectKey(const QString& key);
+
+  static QByteArray BuildManifest(const QVector<MinIOChunk>& chunks, qint64 file_size,
+                                  const QString& original_filename);
+
+  /**
+   * @brief Parse a manifest; chunk offsets are rebuilt and must add up to the file size
+   */
+  static bool ParseManifest(const QByteArray& manifest, QVector<MinIOChunk>* chunks, qint64* file_size);
+
+  static const char* ManifestContentType() { return "application/vnd.amt.chunk-manifest+json"; }
+};
+
+/**
+ * @brief Local record of the chunks known to exist in one bucket
+ *
+ * Backed by an append-only file of raw digests, so chunks stored by an
+ * interrupted upload are remembered and skipped when it is retried. Chunks
+ * can still disappear from the bucket (a lifecycle rule, or DeleteFile
+ * removing the last manifest that used them), so uploads check a listed
+ * chunk with a HEAD and Remove() it when it is gone.
+ *
+ * All methods are thread-safe.
+ */
+class MinIOChunkIndex
+{
+public:
+  explicit MinIOChunkIndex(const QString& index_path);
+
+  MinIOChunkIndex(const MinIOChunkIndex&) = delete;
+  MinIOChunkIndex& operator=(const MinIOChunkIndex&) = delete;
+
+  bool Contains(const QString& hash) const;
+  void Insert(const QString& hash);
+  void Remove(const QString& hash);
+  int Size() const;
+
+  /**
+   * @brief Index file for a bucket on a given endpoint
+   */
+  static QString IndexPath(const QString& endpoint, const QString& bucket);
+
+private:
+  void Load();
+
+  const QString index_path_;
+  mutable QMutex mutex_;
+  QSet<QByteArray> digests_;
+  QFile file_;
+};
+
+} // namespace olive
+
+#endif // MINIOCHUNKSTORE_H
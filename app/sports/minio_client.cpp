@@ -21,7 +21,13 @@
 #include <QRegularExpression>
 #include <QMimeDatabase>
 #include <QImageReader>
+#include <QMessageAuthenticationCode>
 #include <QBuffer>
+#include <QFutureWatcher>
+#include <QtConcurrent>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 #include <QtMath>
 
 // Include FFmpeg headers for video analysis
@@ -34,6 +40,157 @@ extern "C" {
 
 namespace olive {
 
+namespace {
+
+// S3 limits: parts of at least 5 MB (except the last), at most 10000 parts
+constexpr qint64 kMinPartSize = 5 * 1024 * 1024;
+constexpr int kMaxParts = 10000;
+constexpr int kManifestVersion = 1;
+
+using ChunkingResult = QPair<QVector<MinIOChunk>, QString>; // chunks, error
+
+// Ranged downloads
+constexpr qint64 kDefaultRangeSize = 8 * 1024 * 1024;
+constexpr qint64 kMinRangeSize = 1024 * 1024;
+constexpr qint64 kReadBufferSize = 1024 * 1024;
+
+/**
+ * @brief Read-only window onto a byte range of a file, for reading one part
+ */
+class FileRangeDevice : public QIODevice
+{
+public:
+  FileRangeDevice(const QString& file_path, qint64 offset, qint64 length, QObject* parent = nullptr)
+    : QIODevice(parent), file_(file_path), offset_(offset), length_(length), position_(0) {}
+
+  bool open(OpenMode mode) override
+  {
+    if (!file_.open(QIODevice::ReadOnly | QIODevice::Unbuffered) || file_.size() < offset_ + length_) {
+      return false;
+    }
+    position_ = 0;
+    return QIODevice::open(mode | QIODevice::Unbuffered);
+  }
+
+  void close() override
+  {
+    file_.close();
+    QIODevice::close();
+  }
+
+  bool isSequential() const override { return false; }
+  qint64 size() const override { return length_; }
+
+  bool seek(qint64 pos) override
+  {
+    if (pos < 0 || pos > length_) {
+      return false;
+    }
+    position_ = pos;
+    return QIODevice::seek(pos);
+  }
+
+protected:
+  qint64 readData(char* data, qint64 max_size) override
+  {
+    qint64 remaining = length_ - position_;
+    if (remaining <= 0) {
+      return 0;
+    }
+    if (!file_.seek(offset_ + position_)) {
+      return -1;
+    }
+    qint64 read = file_.read(data, qMin(max_size, remaining));
+    if (read > 0) {
+      position_ += read;
+    }
+    return read;
+  }
+
+  qint64 writeData(const char*, qint64) override { return -1; }
+
+private:
+  QFile file_;
+  qint64 offset_;
+  qint64 length_;
+  qint64 position_;
+};
+
+// AWS Signature Version 4
+const char* const kSigV4Algorithm = "AWS4-HMAC-SHA256";
+const char* const kUnsignedPayload = "UNSIGNED-PAYLOAD";
+const char* const kSigV4TimeFormat = "yyyyMMdd'T'HHmmss'Z'";
+
+// SigV4 URI encoding: everything but unreserved characters, per path segment
+QByteArray SigV4Encode(const QString& value)
+{
+  return QUrl::toPercentEncoding(value);
+}
+
+QByteArray HmacSha256(const QByteArray& key, const QByteArray& message)
+{
+  return QMessageAuthenticationCode::hash(message, key, QCryptographicHash::Sha256);
+}
+
+// A part as read from the file, with the hashes of what was read
+struct PartRead {
+  QByteArray data;
+  QByteArray md5;
+  QByteArray sha256; // Hex, as chunk objects are keyed
+};
+
+PartRead ReadPart(const QString& file_path, qint64 offset, qint64 size)
+{
+  PartRead part;
+  FileRangeDevice device(file_path, offset, size);
+  if (device.open(QIODevice::ReadOnly)) {
+    part.data = device.read(size);
+    part.md5 = QCryptographicHash::hash(part.data, QCryptographicHash::Md5);
+    part.sha256 = QCryptographicHash::hash(part.data, QCryptographicHash::Sha256).toHex();
+  }
+  return part;
+}
+
+// Whether an S3 XML response is an error document; CompleteMultipartUpload
+// can send one with a 200 status once it has started answering
+bool IsXmlError(const QByteArray& xml)
+{
+  QXmlStreamReader reader(xml);
+  while (!reader.atEnd()) {
+    if (reader.readNext() == QXmlStreamReader::StartElement) {
+      return reader.name() == QLatin1String("Error");
+    }
+  }
+  return false;
+}
+
+// Text of every such element in an S3 XML response, in order
+QStringList ReadXmlElements(const QByteArray& xml, const QString& element)
+{
+  QStringList values;
+  QXmlStreamReader reader(xml);
+  while (!reader.atEnd()) {
+    if (reader.readNext() == QXmlStreamReader::StartElement && reader.name() == element) {
+      values.append(reader.readElementText());
+    }
+  }
+  return values;
+}
+
+// First text of the given element in an S3 XML response
+QString ReadXmlElement(const QByteArray& xml, const QString& element)
+{
+  QXmlStreamReader reader(xml);
+  while (!reader.atEnd()) {
+    if (reader.readNext() == QXmlStreamReader::StartElement && reader.name() == element) {
+      return reader.readElementText();
+    }
+  }
+  return QString();
+}
+
+} // namespace
+
 // MinIOUploadOperation Implementation
 MinIOUploadOperation::MinIOUploadOperation(const QString& operation_id, const QString& file_path,
                                          const QString& bucket, const QString& object_key,
@@ -46,6 +203,16 @@ MinIOUploadOperation::MinIOUploadOperation(const QString& operation_id, const QS
   , current_reply_(nullptr)
   , network_manager_(nullptr)
   , retry_count_(0)
+  , multipart_enabled_(true)
+  , part_size_(kMinPartSize)
+  , max_concurrent_parts_(4)
+  , active_parts_(0)
+  , part_generation_(0)
+  , cancelled_(false)
+  , restarted_upload_(false)
+  , resumed_bytes_(0)
+  , deduplicated_bytes_(0)
+  , chunking_generation_(0)
 {
   progress_.operation_id = operation_id;
   progress_.file_path = file_path;
@@ -55,6 +222,31 @@ MinIOUploadOperation::MinIOUploadOperation(const QString& operation_id, const QS
   network_manager_ = new QNetworkAccessManager(this);
 }
 
+void MinIOUploadOperation::SetMultipart(bool enabled, qint64 part_size, int max_concurrent_parts)
+{
+  multipart_enabled_ = enabled;
+  part_size_ = qMax(kMinPartSize, part_size);
+  max_concurrent_parts_ = qBound(1, max_concurrent_parts, 16);
+}
+
+QString MinIOUploadOperation::FindResumableObjectKey(const QString& file_path, const QString& bucket)
+{
+  QFile file(ManifestPath(file_path, bucket));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return QString();
+  }
+
+  QJsonObject manifest = QJsonDocument::fromJson(file.readAll()).object();
+  QFileInfo file_info(file_path);
+  if (manifest["version"].toInt() != kManifestVersion ||
+      static_cast<qint64>(manifest["file_size"].toDouble()) != file_info.size() ||
+      static_cast<qint64>(manifest["file_mtime"].toDouble()) != file_info.lastModified().toMSecsSinceEpoch()) {
+    return QString();
+  }
+
+  return manifest["object_key"].toString();
+}
+
 void MinIOUploadOperation::Start()
 {
   QFileInfo file_info(file_path_);
@@ -68,8 +260,21 @@ void MinIOUploadOperation::Start()
   progress_.total_bytes = file_info.size();
   progress_.status = "uploading";
   progress_.start_time = QDateTime::currentDateTime();
-  
-  // Create multipart upload request
+  cancelled_ = false;
+  transfer_timer_.start();
+
+  if (chunk_index_) {
+    StartDeduplicated();
+  } else if (multipart_enabled_ && progress_.total_bytes > part_size_) {
+    StartMultipart();
+  } else {
+    StartSinglePut();
+  }
+}
+
+void MinIOUploadOperation::StartSinglePut()
+{
+  // Create upload request
   QFile* file = new QFile(file_path_);
   if (!file->open(QIODevice::ReadOnly)) {
     progress_.status = "failed";
@@ -79,9 +284,7 @@ void MinIOUploadOperation::Start()
     return;
   }
   
-  // Create request (this would be handled by parent MinIOClient in practice)
-  QNetworkRequest request;
-  request.setUrl(QUrl(QString("https://storage.endpoint/%1/%2").arg(bucket_name_, object_key_)));
+  QNetworkRequest request = CreateRequest("PUT");
   request.setHeader(QNetworkRequest::ContentTypeHeader, "application/octet-stream");
   request.setHeader(QNetworkRequest::ContentLengthHeader, progress_.total_bytes);
   
@@ -96,13 +299,410 @@ void MinIOUploadOperation::Start()
   qInfo() << "Started upload operation:" << operation_id_ << "file:" << file_path_;
 }
 
+void MinIOUploadOperation::StartMultipart()
+{
+  PlanParts();
+
+  if (LoadManifest()) {
+    resumed_bytes_ = 0;
+    for (const UploadPart& part : parts_) {
+      if (!part.etag.isEmpty()) {
+        resumed_bytes_ += part.size;
+      }
+    }
+    qInfo() << "Resuming multipart upload:" << operation_id_ << "upload id:" << upload_id_
+            << "already stored:" << MinIOUtils::FormatFileSize(resumed_bytes_);
+    UpdateProgress();
+    ScheduleParts();
+    return;
+  }
+
+  InitiateMultipartUpload();
+}
+
+void MinIOUploadOperation::StartDeduplicated()
+{
+  // Chunking reads and hashes the whole file, so it runs off this thread.
+  // A stale result from before a cancel or retry is dropped.
+  int generation = ++chunking_generation_;
+  QString file_path = file_path_;
+
+  auto* watcher = new QFutureWatcher<ChunkingResult>(this);
+  connect(watcher, &QFutureWatcher<ChunkingResult>::finished, this, [this, watcher, generation]() {
+    ChunkingResult result = watcher->result();
+    watcher->deleteLater();
+    if (generation == chunking_generation_ && !cancelled_) {
+      OnChunkingFinished(result.first, result.second);
+    }
+  });
+  watcher->setFuture(QtConcurrent::run([file_path]() {
+    ChunkingResult result;
+    if (!MinIOChunker::ChunkFile(file_path, &result.first, &result.second) && result.second.isEmpty()) {
+      result.second = "Cannot read file";
+    }
+    return result;
+  }));
+}
+
+void MinIOUploadOperation::OnChunkingFinished(const QVector<MinIOChunk>& chunks, const QString& error)
+{
+  if (!error.isEmpty()) {
+    FailUpload(QString("Failed to chunk file: %1").arg(error));
+    return;
+  }
+
+  // Every distinct chunk becomes a part once. Chunks the index lists are only
+  // checked with a HEAD, since the bucket may have dropped them since
+  chunks_ = chunks;
+  parts_.clear();
+  active_parts_ = 0;
+  part_generation_++;
+  deduplicated_bytes_ = 0;
+
+  QSet<QString> queued;
+  for (const MinIOChunk& chunk : chunks_) {
+    if (queued.contains(chunk.hash)) {
+      deduplicated_bytes_ += chunk.size;
+      continue;
+    }
+    queued.insert(chunk.hash);
+
+    UploadPart part;
+    part.number = parts_.size() + 1;
+    part.offset = chunk.offset;
+    part.size = chunk.size;
+    part.chunk_hash = chunk.hash;
+    if (chunk_index_->Contains(chunk.hash)) {
+      part.verify = true;
+      deduplicated_bytes_ += chunk.size;
+    }
+    parts_.append(part);
+  }
+  resumed_bytes_ = deduplicated_bytes_;
+  progress_.parts_total = parts_.size();
+
+  qInfo() << "Deduplicated upload:" << operation_id_ << "chunks:" << chunks_.size()
+          << "to send:" << parts_.size() << "already stored:" << MinIOUtils::FormatFileSize(deduplicated_bytes_);
+  UpdateProgress();
+  ScheduleParts();
+}
+
+void MinIOUploadOperation::PutChunkManifest()
+{
+  QByteArray manifest = MinIOChunker::BuildManifest(chunks_, progress_.total_bytes,
+                                                    QFileInfo(file_path_).fileName());
+
+  // The manifest has its own key; the video key never serves it in place of the video
+  QNetworkRequest request = CreateRequest("PUT", QUrlQuery(), MinIOChunker::ManifestObjectKey(object_key_));
+  request.setHeader(QNetworkRequest::ContentTypeHeader, MinIOChunker::ManifestContentType());
+
+  current_reply_ = network_manager_->put(request, manifest);
+  connect(current_reply_, &QNetworkReply::finished, this, &MinIOUploadOperation::OnUploadFinished);
+}
+
+void MinIOUploadOperation::PlanParts()
+{
+  // Grow the part size for very large files to stay under the part limit
+  qint64 part_size = qMax(part_size_, (progress_.total_bytes + kMaxParts - 1) / kMaxParts);
+
+  parts_.clear();
+  part_generation_++;
+  for (qint64 offset = 0; offset < progress_.total_bytes; offset += part_size) {
+    UploadPart part;
+    part.number = parts_.size() + 1;
+    part.offset = offset;
+    part.size = qMin(part_size, progress_.total_bytes - offset);
+    parts_.append(part);
+  }
+  active_parts_ = 0;
+  progress_.parts_total = parts_.size();
+}
+
+void MinIOUploadOperation::InitiateMultipartUpload()
+{
+  QUrlQuery query;
+  query.addQueryItem("uploads", QString());
+
+  QNetworkRequest request = CreateRequest("POST", query);
+  request.setHeader(QNetworkRequest::ContentTypeHeader, "application/octet-stream");
+  current_reply_ = network_manager_->post(request, QByteArray());
+
+  connect(current_reply_, &QNetworkReply::finished, this, [this]() {
+    QNetworkReply* reply = current_reply_;
+    current_reply_ = nullptr;
+    reply->deleteLater();
+
+    if (cancelled_) {
+      return;
+    }
+    if (reply->error() != QNetworkReply::NoError) {
+      FailUpload(QString("Failed to start multipart upload: %1").arg(reply->errorString()));
+      return;
+    }
+
+    upload_id_ = ReadXmlElement(reply->readAll(), "UploadId");
+    if (upload_id_.isEmpty()) {
+      FailUpload("Multipart upload response has no UploadId");
+      return;
+    }
+
+    resumed_bytes_ = 0;
+    SaveManifest();
+    qInfo() << "Started multipart upload:" << operation_id_ << "parts:" << parts_.size()
+            << "concurrency:" << max_concurrent_parts_;
+    ScheduleParts();
+  });
+}
+
+void MinIOUploadOperation::ScheduleParts()
+{
+  if (cancelled_) {
+    return;
+  }
+
+  // Retries come back through here once their backoff is over, so they
+  // count against the concurrency limit like any other part
+  for (int i = 0; i < parts_.size() && active_parts_ < max_concurrent_parts_; i++) {
+    const UploadPart& part = parts_[i];
+    if (part.etag.isEmpty() && !part.reply && !part.reading && !part.backing_off) {
+      UploadPartAt(i);
+    }
+  }
+
+  bool all_stored = true;
+  for (const UploadPart& part : parts_) {
+    if (part.etag.isEmpty()) {
+      all_stored = false;
+      break;
+    }
+  }
+
+  if (all_stored && active_parts_ == 0) {
+    if (chunk_index_) {
+      PutChunkManifest();
+    } else {
+      CompleteMultipartUpload();
+    }
+  }
+}
+
+void MinIOUploadOperation::UploadPartAt(int index)
+{
+  UploadPart& part = parts_[index];
+  if (part.verify) {
+    VerifyChunkAt(index);
+    return;
+  }
+
+  part.reading = true;
+  active_parts_++;
+
+  // The server checks the body against Content-MD5 and a chunk must still
+  // hash to the key it is stored under, so the part is read and hashed on a
+  // worker and exactly those bytes are sent. A read from before an abort or
+  // replan is dropped.
+  int generation = part_generation_;
+  QString file_path = file_path_;
+  qint64 offset = part.offset;
+  qint64 size = part.size;
+
+  auto* watcher = new QFutureWatcher<PartRead>(this);
+  connect(watcher, &QFutureWatcher<PartRead>::finished, this, [this, watcher, index, generation]() {
+    PartRead read = watcher->result();
+    watcher->deleteLater();
+    if (generation == part_generation_ && !cancelled_ && index < parts_.size() && parts_[index].reading) {
+      OnPartRead(index, read.data, read.md5, read.sha256);
+    }
+  });
+  watcher->setFuture(QtConcurrent::run([file_path, offset, size]() {
+    return ReadPart(file_path, offset, size);
+  }));
+}
+
+void MinIOUploadOperation::VerifyChunkAt(int index)
+{
+  UploadPart& part = parts_[index];
+  part.attempts++;
+  QNetworkReply* reply = network_manager_->head(
+    CreateRequest("HEAD", QUrlQuery(), MinIOChunker::ChunkObjectKey(part.chunk_hash)));
+  part.reply = reply;
+  active_parts_++;
+
+  connect(reply, &QNetworkReply::finished, this, [this, index, reply]() {
+    OnPartFinished(index, reply);
+  });
+}
+
+void MinIOUploadOperation::OnPartRead(int index, const QByteArray& data, const QByteArray& md5,
+                                      const QByteArray& sha256)
+{
+  UploadPart& part = parts_[index];
+  part.reading = false;
+
+  if (data.size() != part.size) {
+    FailUpload(QString("Cannot read part %1 from file").arg(part.number));
+    return;
+  }
+  if (!part.chunk_hash.isEmpty() && QString::fromLatin1(sha256) != part.chunk_hash) {
+    FailUpload("File changed after it was chunked");
+    return;
+  }
+
+  QNetworkRequest request;
+  if (part.chunk_hash.isEmpty()) {
+    QUrlQuery query;
+    query.addQueryItem("partNumber", QString::number(part.number));
+    query.addQueryItem("uploadId", upload_id_);
+    request = CreateRequest("PUT", query);
+  } else {
+    request = CreateRequest("PUT", QUrlQuery(), MinIOChunker::ChunkObjectKey(part.chunk_hash));
+  }
+  request.setHeader(QNetworkRequest::ContentTypeHeader, "application/octet-stream");
+  request.setHeader(QNetworkRequest::ContentLengthHeader, part.size);
+  request.setRawHeader("Content-MD5", md5.toBase64());
+
+  part.attempts++;
+  part.bytes_sent = 0;
+  QNetworkReply* reply = network_manager_->put(request, data);
+  part.reply = reply;
+
+  connect(reply, &QNetworkReply::uploadProgress, this, [this, index, reply](qint64 bytes_sent, qint64) {
+    if (index < parts_.size() && parts_[index].reply == reply) {
+      parts_[index].bytes_sent = bytes_sent;
+      UpdateProgress();
+    }
+  });
+  connect(reply, &QNetworkReply::finished, this, [this, index, reply]() {
+    OnPartFinished(index, reply);
+  });
+}
+
+void MinIOUploadOperation::OnPartFinished(int index, QNetworkReply* reply)
+{
+  reply->deleteLater();
+
+  // Aborted by a cancel, failure or restart
+  if (index >= parts_.size() || parts_[index].reply != reply) {
+    return;
+  }
+
+  UploadPart& part = parts_[index];
+  part.reply = nullptr;
+  active_parts_--;
+
+  if (cancelled_) {
+    return;
+  }
+
+  int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  QByteArray etag = reply->rawHeader("ETag");
+
+  if (part.verify && status == 200) {
+    part.etag = etag.isEmpty() ? QString("stored") : QString::fromUtf8(etag);
+    UpdateProgress();
+    ScheduleParts();
+    return;
+  }
+  if (part.verify && status == 404) {
+    // The index was stale; the chunk goes up like any other
+    qInfo() << "Chunk" << part.chunk_hash << "is no longer in" << bucket_name_ << "- uploading it again";
+    chunk_index_->Remove(part.chunk_hash);
+    part.verify = false;
+    part.attempts = 0;
+    deduplicated_bytes_ -= part.size;
+    resumed_bytes_ -= part.size;
+    UpdateProgress();
+    ScheduleParts();
+    return;
+  }
+
+  if (!part.verify && reply->error() == QNetworkReply::NoError && !etag.isEmpty()) {
+    part.etag = QString::fromUtf8(etag);
+    part.bytes_sent = part.size;
+    if (part.chunk_hash.isEmpty()) {
+      SaveManifest();
+    } else {
+      chunk_index_->Insert(part.chunk_hash);
+    }
+    UpdateProgress();
+    ScheduleParts();
+    return;
+  }
+
+  part.bytes_sent = 0;
+
+  // Without an ETag the part cannot be listed in the completion, so it is
+  // retried like any other failure
+  QString error = reply->error() == QNetworkReply::NoError ? QString("response carried no ETag")
+                                                           : reply->errorString();
+
+  // The upload id expired or was aborted server side: start over once
+  if (status == 404 && part.chunk_hash.isEmpty() && !restarted_upload_) {
+    qWarning() << "Multipart upload" << upload_id_ << "no longer exists, restarting:" << operation_id_;
+    restarted_upload_ = true;
+    AbortParts();
+    RemoveManifest();
+    PlanParts();
+    InitiateMultipartUpload();
+    return;
+  }
+
+  if (part.attempts > MAX_RETRIES) {
+    FailUpload(QString("Part %1 failed after %2 attempts: %3")
+               .arg(part.number).arg(part.attempts).arg(error));
+    return;
+  }
+
+  // Back off and retry just this part; the others keep going, and the part
+  // goes back to the dispatcher afterwards so it waits for a free slot
+  int delay_ms = 500 * (1 << (part.attempts - 1));
+  qWarning() << "Part" << part.number << "of" << operation_id_ << "failed:" << error
+             << "- retrying in" << delay_ms << "ms";
+  part.backing_off = true;
+  int generation = part_generation_;
+  QTimer::singleShot(delay_ms, this, [this, index, generation]() {
+    if (generation == part_generation_ && index < parts_.size()) {
+      parts_[index].backing_off = false;
+      ScheduleParts();
+    }
+  });
+  ScheduleParts();
+}
+
+void MinIOUploadOperation::CompleteMultipartUpload()
+{
+  QByteArray body;
+  QXmlStreamWriter writer(&body);
+  writer.writeStartElement("CompleteMultipartUpload");
+  for (const UploadPart& part : parts_) {
+    writer.writeStartElement("Part");
+    writer.writeTextElement("PartNumber", QString::number(part.number));
+    writer.writeTextElement("ETag", part.etag);
+    writer.writeEndElement();
+  }
+  writer.writeEndElement();
+
+  QUrlQuery query;
+  query.addQueryItem("uploadId", upload_id_);
+  QNetworkRequest request = CreateRequest("POST", query);
+  request.setHeader(QNetworkRequest::ContentTypeHeader, "application/xml");
+
+  current_reply_ = network_manager_->post(request, body);
+  connect(current_reply_, &QNetworkReply::finished, this, &MinIOUploadOperation::OnUploadFinished);
+}
+
 void MinIOUploadOperation::Cancel()
 {
+  cancelled_ = true;
+
   if (current_reply_) {
     current_reply_->abort();
-    progress_.status = "cancelled";
-    qInfo() << "Cancelled upload operation:" << operation_id_;
   }
+  AbortParts();
+
+  // The manifest stays, so the upload can resume later
+  progress_.status = "cancelled";
+  qInfo() << "Cancelled upload operation:" << operation_id_;
 }
 
 void MinIOUploadOperation::Retry()
@@ -120,48 +720,766 @@ void MinIOUploadOperation::Retry()
   }
 }
 
-void MinIOUploadOperation::OnUploadProgress(qint64 bytes_sent, qint64 bytes_total)
+void MinIOUploadOperation::OnUploadProgress(qint64 bytes_sent, qint64 bytes_total)
+{
+  progress_.bytes_transferred = bytes_sent;
+  progress_.total_bytes = bytes_total;
+  progress_.percentage = (bytes_total > 0) ? (static_cast<double>(bytes_sent) / bytes_total) * 100.0 : 0.0;
+  progress_.last_update = QDateTime::currentDateTime();
+  qint64 elapsed_ms = transfer_timer_.elapsed();
+  progress_.throughput_bytes_per_sec = elapsed_ms > 0 ? bytes_sent * 1000.0 / elapsed_ms : 0.0;
+  
+  emit ProgressUpdated(progress_);
+}
+
+void MinIOUploadOperation::OnUploadFinished()
+{
+  if (!current_reply_) {
+    return;
+  }
+  
+  QByteArray body = current_reply_->readAll();
+  QString error;
+  if (current_reply_->error() != QNetworkReply::NoError) {
+    error = current_reply_->errorString();
+  } else if (!upload_id_.isEmpty() && IsXmlError(body)) {
+    // The parts are all stored, so the manifest stays and a retry only
+    // completes the upload again
+    error = QString("Failed to complete multipart upload: %1 %2")
+            .arg(ReadXmlElement(body, "Code"), ReadXmlElement(body, "Message"));
+  }
+
+  if (error.isEmpty()) {
+    progress_.status = "completed";
+    progress_.percentage = 100.0;
+    progress_.bytes_transferred = progress_.total_bytes;
+    progress_.last_update = QDateTime::currentDateTime();
+    
+    // Create metadata from response
+    VideoMetadata metadata;
+    metadata.file_id = operation_id_;
+    metadata.original_filename = QFileInfo(file_path_).fileName();
+    metadata.bucket_name = bucket_name_;
+    metadata.object_key = object_key_;
+    metadata.file_size = progress_.total_bytes;
+    metadata.upload_timestamp = QDateTime::currentDateTime();
+    metadata.etag = current_reply_->rawHeader("ETag");
+
+    if (chunk_index_) {
+      metadata.custom_metadata["chunk_manifest"] = MinIOChunker::ManifestObjectKey(object_key_);
+    }
+
+    if (!upload_id_.isEmpty()) {
+      // CompleteMultipartUpload reports the object ETag in its body
+      metadata.etag = ReadXmlElement(body, "ETag");
+      RemoveManifest();
+      upload_id_.clear();
+    }
+    
+    emit Completed(metadata);
+    qInfo() << "Upload completed:" << operation_id_;
+  } else if (!cancelled_) {
+    progress_.status = "failed";
+    progress_.error_message = error;
+    emit Failed(progress_.error_message);
+    qWarning() << "Upload failed:" << operation_id_ << progress_.error_message;
+  }
+  
+  current_reply_->deleteLater();
+  current_reply_ = nullptr;
+}
+
+QNetworkRequest MinIOUploadOperation::CreateRequest(const QString& method, const QUrlQuery& query,
+                                                   const QString& object_key) const
+{
+  const QString& key = object_key.isEmpty() ? object_key_ : object_key;
+  if (request_factory_) {
+    return request_factory_(method, bucket_name_, key, query);
+  }
+
+  // Unsigned fallback when used without a MinIOClient
+  QUrl url(QString("https://storage.endpoint/%1/%2").arg(bucket_name_, key));
+  url.setQuery(query);
+  return QNetworkRequest(url);
+}
+
+void MinIOUploadOperation::FailUpload(const QString& error)
+{
+  cancelled_ = true;
+  AbortParts();
+
+  progress_.status = "failed";
+  progress_.error_message = error;
+  progress_.parts_active = 0;
+  emit Failed(error);
+  qWarning() << "Upload failed:" << operation_id_ << error
+             << "- completed parts are kept for resume";
+}
+
+void MinIOUploadOperation::AbortParts()
+{
+  part_generation_++;
+  for (UploadPart& part : parts_) {
+    part.reading = false;
+    part.backing_off = false;
+    if (part.reply) {
+      // Detach first so the synchronous finished() is ignored
+      QNetworkReply* reply = part.reply;
+      part.reply = nullptr;
+      part.bytes_sent = 0;
+      reply->abort();
+    }
+  }
+  active_parts_ = 0;
+}
+
+void MinIOUploadOperation::UpdateProgress()
+{
+  qint64 transferred = deduplicated_bytes_;
+  int completed = 0;
+  for (const UploadPart& part : parts_) {
+    if (!part.etag.isEmpty()) {
+      completed++;
+    }
+    if (part.verify) {
+      continue; // Already counted as deduplicated
+    }
+    transferred += part.etag.isEmpty() ? part.bytes_sent : part.size;
+  }
+
+  progress_.bytes_transferred = transferred;
+  progress_.percentage = progress_.total_bytes > 0
+    ? static_cast<double>(transferred) / progress_.total_bytes * 100.0 : 0.0;
+  progress_.parts_completed = completed;
+  progress_.parts_active = active_parts_;
+  progress_.last_update = QDateTime::currentDateTime();
+
+  // Resumed parts did not cross the wire in this session
+  qint64 elapsed_ms = transfer_timer_.elapsed();
+  progress_.throughput_bytes_per_sec = elapsed_ms > 0
+    ? (transferred - resumed_bytes_) * 1000.0 / elapsed_ms : 0.0;
+
+  emit ProgressUpdated(progress_);
+}
+
+bool MinIOUploadOperation::LoadManifest()
+{
+  QFile file(ManifestPath(file_path_, bucket_name_));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  QJsonObject manifest = QJsonDocument::fromJson(file.readAll()).object();
+  QFileInfo file_info(file_path_);
+  if (manifest["version"].toInt() != kManifestVersion ||
+      manifest["object_key"].toString() != object_key_ ||
+      static_cast<qint64>(manifest["file_size"].toDouble()) != file_info.size() ||
+      static_cast<qint64>(manifest["file_mtime"].toDouble()) != file_info.lastModified().toMSecsSinceEpoch() ||
+      manifest["upload_id"].toString().isEmpty()) {
+    return false;
+  }
+
+  // Parts are only reusable with the same layout
+  QJsonArray stored_parts = manifest["parts"].toArray();
+  if (manifest["part_count"].toInt() != parts_.size()) {
+    return false;
+  }
+
+  upload_id_ = manifest["upload_id"].toString();
+  for (const QJsonValue& value : stored_parts) {
+    QJsonObject stored = value.toObject();
+    int index = stored["number"].toInt() - 1;
+    if (index >= 0 && index < parts_.size()) {
+      parts_[index].etag = stored["etag"].toString();
+    }
+  }
+  return true;
+}
+
+void MinIOUploadOperation::SaveManifest() const
+{
+  QFileInfo file_info(file_path_);
+
+  QJsonArray stored_parts;
+  for (const UploadPart& part : parts_) {
+    if (!part.etag.isEmpty()) {
+      QJsonObject stored;
+      stored["number"] = part.number;
+      stored["etag"] = part.etag;
+      stored_parts.append(stored);
+    }
+  }
+
+  QJsonObject manifest;
+  manifest["version"] = kManifestVersion;
+  manifest["file_path"] = file_path_;
+  manifest["file_size"] = file_info.size();
+  manifest["file_mtime"] = file_info.lastModified().toMSecsSinceEpoch();
+  manifest["bucket"] = bucket_name_;
+  manifest["object_key"] = object_key_;
+  manifest["upload_id"] = upload_id_;
+  manifest["part_count"] = parts_.size();
+  manifest["parts"] = stored_parts;
+
+  QString path = ManifestPath(file_path_, bucket_name_);
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QSaveFile file(path);
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "Failed to write upload manifest:" << path << file.errorString();
+    return;
+  }
+  file.write(QJsonDocument(manifest).toJson(QJsonDocument::Compact));
+  file.commit();
+}
+
+void MinIOUploadOperation::RemoveManifest() const
+{
+  QFile::remove(ManifestPath(file_path_, bucket_name_));
+}
+
+QString MinIOUploadOperation::ManifestPath(const QString& file_path, const QString& bucket)
+{
+  QByteArray id = QCryptographicHash::hash((QFileInfo(file_path).absoluteFilePath() + "|" + bucket).toUtf8(),
+                                           QCryptographicHash::Sha1).toHex();
+  return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+         + "/minio/uploads/" + QString::fromLatin1(id) + ".json";
+}
+
+// MinIODownloadOperation Implementation
+MinIODownloadOperation::MinIODownloadOperation(const QString& operation_id, const QString& bucket,
+                                             const QString& object_key, const QString& local_path,
+                                             QObject* parent)
+  : QObject(parent)
+  , operation_id_(operation_id)
+  , bucket_name_(bucket)
+  , object_key_(object_key)
+  , local_path_(local_path)
+  , network_manager_(nullptr)
+  , control_reply_(nullptr)
+  , range_size_(kDefaultRangeSize)
+  , max_concurrent_ranges_(4)
+  , object_size_(0)
+  , active_ranges_(0)
+  , cancelled_(false)
+  , resumed_bytes_(0)
+  , file_(nullptr)
+{
+  progress_.operation_id = operation_id;
+  progress_.file_path = local_path;
+  progress_.status = "pending";
+  progress_.start_time = QDateTime::currentDateTime();
+
+  network_manager_ = new QNetworkAccessManager(this);
+}
+
+MinIODownloadOperation::~MinIODownloadOperation()
+{
+  AbortRanges();
+  ReleaseFile();
+}
+
+void MinIODownloadOperation::SetRanges(qint64 range_size, int max_concurrent_ranges)
+{
+  range_size_ = qMax(kMinRangeSize, range_size);
+  max_concurrent_ranges_ = qBound(1, max_concurrent_ranges, 16);
+}
+
+void MinIODownloadOperation::Start()
+{
+  progress_.status = "downloading";
+  progress_.start_time = QDateTime::currentDateTime();
+  cancelled_ = false;
+  transfer_timer_.start();
+
+  // Size and ETag decide the range layout and whether a partial file is reusable
+  control_reply_ = network_manager_->head(CreateRequest("HEAD"));
+  connect(control_reply_, &QNetworkReply::finished, this, &MinIODownloadOperation::OnHeadFinished);
+}
+
+void MinIODownloadOperation::OnHeadFinished()
+{
+  QNetworkReply* reply = control_reply_;
+  control_reply_ = nullptr;
+  reply->deleteLater();
+
+  if (cancelled_) {
+    return;
+  }
+  // Deduplicated uploads have no object at the key, only a chunk manifest beside it
+  if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 404) {
+    FetchChunkManifest();
+    return;
+  }
+  if (reply->error() != QNetworkReply::NoError) {
+    FailDownload(reply->errorString());
+    return;
+  }
+
+  object_size_ = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+  object_etag_ = QString::fromUtf8(reply->rawHeader("ETag"));
+
+  PlanRanges();
+  BeginTransfer();
+}
+
+void MinIODownloadOperation::FetchChunkManifest()
+{
+  control_reply_ = network_manager_->get(CreateRequest("GET", MinIOChunker::ManifestObjectKey(object_key_)));
+  connect(control_reply_, &QNetworkReply::finished, this, [this]() {
+    QNetworkReply* reply = control_reply_;
+    control_reply_ = nullptr;
+    reply->deleteLater();
+
+    if (cancelled_) {
+      return;
+    }
+    if (reply->error() != QNetworkReply::NoError) {
+      FailDownload(QString("Failed to fetch chunk manifest: %1").arg(reply->errorString()));
+      return;
+    }
+
+    // The manifest's ETag versions the partial file like an object's would
+    object_etag_ = QString::fromUtf8(reply->rawHeader("ETag"));
+
+    QVector<MinIOChunk> chunks;
+    if (!MinIOChunker::ParseManifest(reply->readAll(), &chunks, &object_size_)) {
+      FailDownload("Invalid chunk manifest");
+      return;
+    }
+
+    // Each chunk object fills its own range of the file
+    ranges_.clear();
+    for (const MinIOChunk& chunk : chunks) {
+      DownloadRange range;
+      range.offset = chunk.offset;
+      range.size = chunk.size;
+      range.object_key = MinIOChunker::ChunkObjectKey(chunk.hash);
+      ranges_.append(range);
+    }
+    BeginTransfer();
+  });
+}
+
+void MinIODownloadOperation::BeginTransfer()
+{
+  progress_.total_bytes = object_size_;
+  progress_.parts_total = ranges_.size();
+  active_ranges_ = 0;
+  resumed_bytes_ = 0;
+
+  if (!PrepareFile()) {
+    FailDownload("Failed to prepare local file");
+    return;
+  }
+
+  if (resumed_bytes_ > 0) {
+    qInfo() << "Resuming download:" << operation_id_ << "already stored:"
+            << MinIOUtils::FormatFileSize(resumed_bytes_);
+  }
+  qInfo() << "Downloading" << MinIOUtils::FormatFileSize(object_size_) << "in" << ranges_.size()
+          << "ranges:" << operation_id_;
+
+  UpdateProgress();
+  ScheduleRanges();
+}
+
+void MinIODownloadOperation::PlanRanges()
+{
+  ranges_.clear();
+  for (qint64 offset = 0; offset < object_size_; offset += range_size_) {
+    DownloadRange range;
+    range.offset = offset;
+    range.size = qMin(range_size_, object_size_ - offset);
+    ranges_.append(range);
+  }
+}
+
+bool MinIODownloadOperation::PrepareFile()
+{
+  QDir().mkpath(QFileInfo(local_path_).absolutePath());
+
+  bool resume = LoadManifest() && QFileInfo(PartialPath()).size() == object_size_;
+  if (!resume) {
+    for (DownloadRange& range : ranges_) {
+      range.done = false;
+    }
+    QFile::remove(PartialPath());
+  }
+
+  file_ = new QFile(PartialPath());
+  if (!file_->open(QIODevice::ReadWrite)) {
+    qWarning() << "Cannot open partial download:" << PartialPath() << file_->errorString();
+    return false;
+  }
+
+  // Reserve the whole object up front; ranges fill it in any order
+  if (!resume && !file_->resize(object_size_)) {
+    qWarning() << "Cannot preallocate" << MinIOUtils::FormatFileSize(object_size_)
+               << "for" << PartialPath() << file_->errorString();
+    return false;
+  }
+
+  for (const DownloadRange& range : ranges_) {
+    if (range.done) {
+      resumed_bytes_ += range.size;
+    }
+  }
+  SaveManifest();
+  return true;
+}
+
+void MinIODownloadOperation::ScheduleRanges()
+{
+  if (cancelled_) {
+    return;
+  }
+
+  // Ranges with attempts > 0 are waiting out a retry backoff
+  for (int i = 0; i < ranges_.size() && active_ranges_ < max_concurrent_ranges_; i++) {
+    const DownloadRange& range = ranges_[i];
+    if (!range.done && !range.reply && range.attempts == 0) {
+      FetchRangeAt(i);
+    }
+  }
+
+  bool all_done = true;
+  for (const DownloadRange& range : ranges_) {
+    if (!range.done) {
+      all_done = false;
+      break;
+    }
+  }
+
+  if (all_done && active_ranges_ == 0) {
+    FinishDownload();
+  }
+}
+
+void MinIODownloadOperation::FetchRangeAt(int index)
+{
+  DownloadRange& range = ranges_[index];
+
+  // A retry picks up after the bytes the failed attempt already wrote.
+  // Chunk objects are addressed from their own start and never change.
+  QNetworkRequest request = CreateRequest("GET", range.object_key);
+  qint64 object_offset = range.object_key.isEmpty() ? range.offset : 0;
+  request.setRawHeader("Range", QString("bytes=%1-%2")
+                       .arg(object_offset + range.bytes_written)
+                       .arg(object_offset + range.size - 1).toUtf8());
+  if (range.object_key.isEmpty() && !object_etag_.isEmpty()) {
+    request.setRawHeader("If-Match", object_etag_.toUtf8());
+  }
+
+  // Only ranges in flight are mapped, not the whole object
+  if (!range.data) {
+    range.data = file_->map(range.offset, range.size);
+    if (!range.data) {
+      qWarning() << "Cannot map range at" << range.offset << "of" << PartialPath()
+                 << "- writing through the file instead";
+    }
+  }
+
+  range.attempts++;
+  QNetworkReply* reply = network_manager_->get(request);
+  reply->setReadBufferSize(kReadBufferSize); // Backpressure instead of buffering the range
+  range.reply = reply;
+  active_ranges_++;
+
+  connect(reply, &QNetworkReply::readyRead, this, [this, index, reply]() {
+    OnRangeReadyRead(index, reply);
+  });
+  connect(reply, &QNetworkReply::finished, this, [this, index, reply]() {
+    OnRangeFinished(index, reply);
+  });
+}
+
+void MinIODownloadOperation::OnRangeReadyRead(int index, QNetworkReply* reply)
+{
+  if (index >= ranges_.size() || ranges_[index].reply != reply) {
+    return;
+  }
+
+  DownloadRange& range = ranges_[index];
+  int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  if (status != 200 && status != 206) {
+    reply->readAll(); // Error body, not object data
+    return;
+  }
+
+  qint64 start = range.offset + range.bytes_written;
+
+  // A 200 carries the whole object, which only lines up with a range from its start
+  qint64 object_position = range.object_key.isEmpty() ? start : range.bytes_written;
+  if (status == 200 && object_position != 0) {
+    FailDownload("Server ignored the Range header");
+    return;
+  }
+
+  qint64 remaining = range.size - range.bytes_written;
+  qint64 available = reply->bytesAvailable();
+  if (available > remaining) {
+    FailDownload(QString("Server sent more than the requested range at offset %1").arg(start));
+    return;
+  }
+
+  qint64 read = 0;
+  if (range.data) {
+    read = reply->read(reinterpret_cast<char*>(range.data + range.bytes_written), available);
+  } else {
+    QByteArray chunk = reply->read(available);
+    if (file_->seek(start) && file_->write(chunk) == chunk.size()) {
+      read = chunk.size();
+    } else {
+      read = -1;
+    }
+  }
+  if (read < 0) {
+    FailDownload("Failed to write local file");
+    return;
+  }
+
+  range.bytes_written += read;
+  UpdateProgress();
+}
+
+void MinIODownloadOperation::OnRangeFinished(int index, QNetworkReply* reply)
+{
+  reply->deleteLater();
+
+  // Aborted by a cancel or failure
+  if (index >= ranges_.size() || ranges_[index].reply != reply) {
+    return;
+  }
+
+  // Drain whatever arrived with the final chunk
+  OnRangeReadyRead(index, reply);
+  if (cancelled_) {
+    return;
+  }
+
+  DownloadRange& range = ranges_[index];
+  range.reply = nullptr;
+  active_ranges_--;
+
+  int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  if (status == 412) {
+    // The object changed since the partial file was started
+    FailDownload("Object changed during download", true);
+    return;
+  }
+
+  if (reply->error() == QNetworkReply::NoError && range.bytes_written == range.size) {
+    range.done = true;
+    UnmapRange(range);
+    SaveManifest();
+    UpdateProgress();
+    ScheduleRanges();
+    return;
+  }
+
+  QString error = reply->error() != QNetworkReply::NoError
+    ? reply->errorString() : QString("Range ended after %1 of %2 bytes").arg(range.bytes_written).arg(range.size);
+
+  if (range.attempts > MAX_RETRIES) {
+    FailDownload(QString("Range at offset %1 failed after %2 attempts: %3")
+                 .arg(range.offset).arg(range.attempts).arg(error));
+    return;
+  }
+
+  // Back off and retry just this range; the others keep going
+  int delay_ms = 500 * (1 << (range.attempts - 1));
+  qWarning() << "Range at offset" << range.offset << "of" << operation_id_ << "failed:" << error
+             << "- retrying in" << delay_ms << "ms";
+  QTimer::singleShot(delay_ms, this, [this, index]() {
+    if (!cancelled_ && ranges_.size() > index && !ranges_[index].done && !ranges_[index].reply) {
+      FetchRangeAt(index);
+    }
+  });
+}
+
+void MinIODownloadOperation::FinishDownload()
+{
+  ReleaseFile();
+
+  QFile::remove(local_path_);
+  if (!QFile::rename(PartialPath(), local_path_)) {
+    FailDownload("Failed to move completed download into place");
+    return;
+  }
+  QFile::remove(ManifestPath());
+
+  progress_.status = "completed";
+  progress_.bytes_transferred = object_size_;
+  progress_.percentage = 100.0;
+  progress_.parts_active = 0;
+  progress_.last_update = QDateTime::currentDateTime();
+
+  emit Completed(local_path_);
+  qInfo() << "Download completed:" << operation_id_ << local_path_;
+}
+
+void MinIODownloadOperation::Cancel()
+{
+  cancelled_ = true;
+
+  if (control_reply_) {
+    control_reply_->abort();
+  }
+  AbortRanges();
+  ReleaseFile();
+
+  // The partial file and its manifest stay, so the download can resume later
+  progress_.status = "cancelled";
+  qInfo() << "Cancelled download operation:" << operation_id_;
+}
+
+void MinIODownloadOperation::FailDownload(const QString& error, bool discard_partial)
+{
+  cancelled_ = true;
+  AbortRanges();
+  ReleaseFile();
+
+  if (discard_partial) {
+    QFile::remove(PartialPath());
+    QFile::remove(ManifestPath());
+  }
+
+  progress_.status = "failed";
+  progress_.error_message = error;
+  progress_.parts_active = 0;
+  emit Failed(error);
+  qWarning() << "Download failed:" << operation_id_ << error;
+}
+
+void MinIODownloadOperation::AbortRanges()
+{
+  for (DownloadRange& range : ranges_) {
+    if (range.reply) {
+      // Detach first so the synchronous finished() is ignored
+      QNetworkReply* reply = range.reply;
+      range.reply = nullptr;
+      reply->abort();
+    }
+  }
+  active_ranges_ = 0;
+}
+
+void MinIODownloadOperation::ReleaseFile()
+{
+  if (!file_) {
+    return;
+  }
+
+  for (DownloadRange& range : ranges_) {
+    UnmapRange(range);
+  }
+  file_->close();
+  delete file_;
+  file_ = nullptr;
+}
+
+void MinIODownloadOperation::UnmapRange(DownloadRange& range)
+{
+  // Dirty pages stay in the page cache for writeback; the mapping itself goes
+  if (range.data) {
+    file_->unmap(range.data);
+    range.data = nullptr;
+  }
+}
+
+void MinIODownloadOperation::UpdateProgress()
+{
+  qint64 transferred = 0;
+  int completed = 0;
+  for (const DownloadRange& range : ranges_) {
+    if (range.done) {
+      transferred += range.size;
+      completed++;
+    } else {
+      transferred += range.bytes_written;
+    }
+  }
+
+  progress_.bytes_transferred = transferred;
+  progress_.percentage = object_size_ > 0
+    ? static_cast<double>(transferred) / object_size_ * 100.0 : 0.0;
+  progress_.parts_completed = completed;
+  progress_.parts_active = active_ranges_;
+  progress_.last_update = QDateTime::currentDateTime();
+
+  // Resumed ranges did not cross the wire in this session
+  qint64 elapsed_ms = transfer_timer_.elapsed();
+  progress_.throughput_bytes_per_sec = elapsed_ms > 0
+    ? (transferred - resumed_bytes_) * 1000.0 / elapsed_ms : 0.0;
+
+  emit ProgressUpdated(progress_);
+}
+
+bool MinIODownloadOperation::LoadManifest()
 {
-  progress_.bytes_transferred = bytes_sent;
-  progress_.total_bytes = bytes_total;
-  progress_.percentage = (bytes_total > 0) ? (static_cast<double>(bytes_sent) / bytes_total) * 100.0 : 0.0;
-  progress_.last_update = QDateTime::currentDateTime();
-  
-  emit ProgressUpdated(progress_);
+  QFile file(ManifestPath());
+  if (!file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+
+  // Ranges are only reusable for the same object version and layout
+  QJsonObject manifest = QJsonDocument::fromJson(file.readAll()).object();
+  if (manifest["version"].toInt() != kManifestVersion ||
+      object_etag_.isEmpty() ||
+      manifest["etag"].toString() != object_etag_ ||
+      static_cast<qint64>(manifest["object_size"].toDouble()) != object_size_ ||
+      static_cast<qint64>(manifest["range_size"].toDouble()) != range_size_ ||
+      manifest["range_count"].toInt() != ranges_.size()) {
+    return false;
+  }
+
+  for (const QJsonValue& value : manifest["done"].toArray()) {
+    int index = value.toInt(-1);
+    if (index >= 0 && index < ranges_.size()) {
+      ranges_[index].done = true;
+    }
+  }
+  return true;
 }
 
-void MinIOUploadOperation::OnUploadFinished()
+void MinIODownloadOperation::SaveManifest() const
 {
-  if (!current_reply_) {
+  QJsonArray done;
+  for (int i = 0; i < ranges_.size(); i++) {
+    if (ranges_[i].done) {
+      done.append(i);
+    }
+  }
+
+  QJsonObject manifest;
+  manifest["version"] = kManifestVersion;
+  manifest["bucket"] = bucket_name_;
+  manifest["object_key"] = object_key_;
+  manifest["etag"] = object_etag_;
+  manifest["object_size"] = object_size_;
+  manifest["range_size"] = range_size_;
+  manifest["range_count"] = ranges_.size();
+  manifest["done"] = done;
+
+  QSaveFile file(ManifestPath());
+  if (!file.open(QIODevice::WriteOnly)) {
+    qWarning() << "Failed to write download manifest:" << ManifestPath() << file.errorString();
     return;
   }
-  
-  if (current_reply_->error() == QNetworkReply::NoError) {
-    progress_.status = "completed";
-    progress_.percentage = 100.0;
-    progress_.last_update = QDateTime::currentDateTime();
-    
-    // Create metadata from response
-    VideoMetadata metadata;
-    metadata.file_id = operation_id_;
-    metadata.original_filename = QFileInfo(file_path_).fileName();
-    metadata.bucket_name = bucket_name_;
-    metadata.object_key = object_key_;
-    metadata.file_size = progress_.total_bytes;
-    metadata.upload_timestamp = QDateTime::currentDateTime();
-    metadata.etag = current_reply_->rawHeader("ETag");
-    
-    emit Completed(metadata);
-    qInfo() << "Upload completed:" << operation_id_;
-  } else {
-    progress_.status = "failed";
-    progress_.error_message = current_reply_->errorString();
-    emit Failed(progress_.error_message);
-    qWarning() << "Upload failed:" << operation_id_ << progress_.error_message;
+  file.write(QJsonDocument(manifest).toJson(QJsonDocument::Compact));
+  file.commit();
+}
+
+QNetworkRequest MinIODownloadOperation::CreateRequest(const QString& method, const QString& object_key) const
+{
+  const QString& key = object_key.isEmpty() ? object_key_ : object_key;
+  if (request_factory_) {
+    return request_factory_(method, bucket_name_, key, QUrlQuery());
   }
-  
-  current_reply_->deleteLater();
-  current_reply_ = nullptr;
+
+  // Unsigned fallback when used without a MinIOClient
+  return QNetworkRequest(QUrl(QString("https://storage.endpoint/%1/%2").arg(bucket_name_, key)));
 }
 
 // MinIOClient Implementation
@@ -170,11 +1488,16 @@ MinIOClient::MinIOClient(QObject* parent)
   , endpoint_("localhost:9000")
   , access_key_("")
   , secret_key_("")
+  , region_("us-east-1")
   , use_ssl_(false)
   , is_connected_(false)
   , is_initialized_(false)
   , multipart_enabled_(true)
   , multipart_part_size_(5 * 1024 * 1024) // 5MB
+  , multipart_concurrency_(4)
+  , download_range_size_(8 * 1024 * 1024) // 8MB
+  , download_concurrency_(4)
+  , deduplication_enabled_(false)
   , connect_timeout_ms_(10000)
   , transfer_timeout_ms_(300000)
   , video_analysis_enabled_(false)
@@ -267,7 +1590,7 @@ void MinIOClient::Shutdown()
 }
 
 QString MinIOClient::UploadVideoFile(const QString& file_path, const QString& bucket,
-                                   const QJsonObject& metadata)
+                                   const QJsonObject& metadata, const QString& requested_id)
 {
   if (!is_connected_) {
     qWarning() << "MinIO client not connected";
@@ -286,16 +1609,18 @@ QString MinIOClient::UploadVideoFile(const QString& file_path, const QString& bu
     return QString();
   }
 
-  QString operation_id = GenerateOperationId();
-  QString object_key = MinIOUtils::GenerateVideoObjectKey(file_info.fileName());
+  QString operation_id = requested_id.isEmpty() ? GenerateOperationId() : requested_id;
 
-  // Create upload operation
-  MinIOUploadOperation* upload_op = new MinIOUploadOperation(
-    operation_id, file_path, bucket, object_key, this);
+  // Pick up an interrupted multipart upload of the same file where it left off
+  QString object_key = MinIOUploadOperation::FindResumableObjectKey(file_path, bucket);
+  if (object_key.isEmpty()) {
+    object_key = MinIOUtils::GenerateVideoObjectKey(file_info.fileName());
+  }
 
-  {
-    QMutexLocker locker(&operations_mutex_);
-    active_uploads_[operation_id] = upload_op;
+  // Create upload operation
+  MinIOUploadOperation* upload_op = CreateUploadOperation(operation_id, file_path, bucket, object_key);
+  if (deduplication_enabled_) {
+    upload_op->SetDeduplication(ChunkIndexFor(bucket));
   }
 
   // Connect signals
@@ -349,13 +1674,7 @@ QString MinIOClient::UploadFabricatorResult(const QString& file_path, const QStr
   QString bucket = "fabricator-results";
 
   // Create upload operation
-  MinIOUploadOperation* upload_op = new MinIOUploadOperation(
-    operation_id, file_path, bucket, object_key, this);
-
-  {
-    QMutexLocker locker(&operations_mutex_);
-    active_uploads_[operation_id] = upload_op;
-  }
+  MinIOUploadOperation* upload_op = CreateUploadOperation(operation_id, file_path, bucket, object_key);
 
   // Connect signals
   connect(upload_op, &MinIOUploadOperation::Completed,
@@ -402,63 +1721,43 @@ QString MinIOClient::DownloadFile(const QString& bucket, const QString& object_k
 
   QString operation_id = GenerateOperationId();
   
-  // Create download request
-  QNetworkRequest request = CreateRequest("GET", bucket, object_key);
-  
-  QNetworkReply* reply = network_manager_->get(request);
+  // Create download operation
+  MinIODownloadOperation* download_op = new MinIODownloadOperation(
+    operation_id, bucket, object_key, local_path, this);
+  download_op->SetRequestFactory(SignedRequestFactory());
+  download_op->SetRanges(download_range_size_, download_concurrency_);
   
   {
     QMutexLocker locker(&operations_mutex_);
-    active_downloads_[operation_id] = reply;
-  }
-
-  // Create progress tracking
-  TransferProgress progress;
-  progress.operation_id = operation_id;
-  progress.file_path = local_path;
-  progress.status = "downloading";
-  progress.start_time = QDateTime::currentDateTime();
-
-  connect(reply, &QNetworkReply::downloadProgress,
-          this, [this, operation_id](qint64 bytes_received, qint64 bytes_total) {
-            TransferProgress progress;
-            progress.operation_id = operation_id;
-            progress.bytes_transferred = bytes_received;
-            progress.total_bytes = bytes_total;
-            progress.percentage = (bytes_total > 0) ? 
-              (static_cast<double>(bytes_received) / bytes_total) * 100.0 : 0.0;
-            progress.status = "downloading";
-            progress.last_update = QDateTime::currentDateTime();
-            
-            emit DownloadProgressUpdated(operation_id, progress);
+    active_downloads_[operation_id] = download_op;
+  }
+
+  // Connect signals
+  connect(download_op, &MinIODownloadOperation::ProgressUpdated,
+          this, [this, operation_id](const TransferProgress& progress) {
+            OnTransferProgress(operation_id, progress);
           });
 
-  connect(reply, &QNetworkReply::finished,
-          this, [this, operation_id, local_path, reply]() {
-            if (reply->error() == QNetworkReply::NoError) {
-              // Save file to local path
-              QFile file(local_path);
-              if (file.open(QIODevice::WriteOnly)) {
-                file.write(reply->readAll());
-                file.close();
-                
-                OnTransferCompleted(operation_id);
-                emit FileDownloaded(operation_id, local_path);
-                qInfo() << "File downloaded successfully:" << local_path;
-              } else {
-                OnTransferFailed(operation_id, "Failed to write local file");
-              }
-            } else {
-              OnTransferFailed(operation_id, reply->errorString());
-            }
+  connect(download_op, &MinIODownloadOperation::Completed,
+          this, [this, operation_id](const QString& path) {
+            OnTransferCompleted(operation_id);
+            emit FileDownloaded(operation_id, path);
+            qInfo() << "File downloaded successfully:" << path;
+          });
+
+  connect(download_op, &MinIODownloadOperation::Failed,
+          this, [this, operation_id](const QString& error) {
+            OnTransferFailed(operation_id, error);
             
-            {
-              QMutexLocker locker(&operations_mutex_);
-              active_downloads_.remove(operation_id);
+            QMutexLocker locker(&operations_mutex_);
+            if (MinIODownloadOperation* download = active_downloads_.take(operation_id)) {
+              download->deleteLater();
             }
-            reply->deleteLater();
           });
 
+  // Start download
+  download_op->Start();
+
   qInfo() << "Started download:" << operation_id << "from" << bucket << "/" << object_key;
   return operation_id;
 }
@@ -475,6 +1774,14 @@ QString MinIOClient::GetPresignedUrl(const QString& bucket, const QString& objec
     stats_.cache_hits++;
     return cached_url;
   }
+
+  // Whoever uploaded it, the bucket tells whether there is an object to stream
+  if (is_connected_ && HeadObject(bucket, object_key) == 404 &&
+      HeadObject(bucket, MinIOChunker::ManifestObjectKey(object_key)) == 200) {
+    qWarning() << "Video is stored as deduplicated chunks and has no streamable object,"
+               << "download it with DownloadFile instead:" << cache_key;
+    return QString();
+  }
   
   // Generate new presigned URL
   QString presigned_url = CreatePresignedUrl("GET", bucket, object_key, expiry_seconds);
@@ -505,16 +1812,12 @@ QList<VideoMetadata> MinIOClient::ListVideos(const QString& bucket, const QStrin
   QList<VideoMetadata> videos;
   
   // Create list objects request
-  QNetworkRequest request = CreateRequest("GET", bucket, QString());
-  
-  QUrl url = request.url();
   QUrlQuery query;
   if (!prefix.isEmpty()) {
     query.addQueryItem("prefix", prefix);
   }
   query.addQueryItem("max-keys", QString::number(max_results));
-  url.setQuery(query);
-  request.setUrl(url);
+  QNetworkRequest request = CreateRequest("GET", bucket, QString(), query);
   
   // This would be a synchronous request in practice - using async pattern here
   QNetworkReply* reply = network_manager_->get(request);
@@ -577,25 +1880,25 @@ bool MinIOClient::DeleteFile(const QString& bucket, const QString& object_key)
   if (!is_connected_) {
     return false;
   }
-  
-  QNetworkRequest request = CreateRequest("DELETE", bucket, object_key);
-  QNetworkReply* reply = network_manager_->deleteResource(request);
-  
-  // Wait for completion
-  QEventLoop loop;
-  connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-  loop.exec();
-  
-  bool success = (reply->error() == QNetworkReply::NoError);
-  
-  if (success) {
-    qInfo() << "File deleted:" << bucket << "/" << object_key;
-  } else {
-    qWarning() << "Failed to delete file:" << reply->errorString();
+
+  {
+    QMutexLocker locker(&cache_mutex_);
+    presigned_url_cache_.remove(QString("%1/%2").arg(bucket, object_key));
   }
-  
-  reply->deleteLater();
-  return success;
+
+  // A deduplicated upload has nothing at its key, only its manifest
+  QString manifest_key = MinIOChunker::ManifestObjectKey(object_key);
+  QVector<MinIOChunk> chunks;
+  qint64 file_size = 0;
+  if (HeadObject(bucket, object_key) != 404 || !FetchChunkManifest(bucket, manifest_key, &chunks, &file_size)) {
+    return DeleteObject(bucket, object_key);
+  }
+
+  if (!DeleteObject(bucket, manifest_key)) {
+    return false;
+  }
+  DeleteUnreferencedChunks(bucket, manifest_key, chunks);
+  return true;
 }
 
 bool MinIOClient::FileExists(const QString& bucket, const QString& object_key) const
@@ -603,19 +1906,12 @@ bool MinIOClient::FileExists(const QString& bucket, const QString& object_key) c
   if (!is_connected_) {
     return false;
   }
-  
-  QNetworkRequest request = CreateRequest("HEAD", bucket, object_key);
-  QNetworkReply* reply = network_manager_->head(request);
-  
-  // Wait for completion
-  QEventLoop loop;
-  connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-  loop.exec();
-  
-  bool exists = (reply->error() == QNetworkReply::NoError);
-  reply->deleteLater();
-  
-  return exists;
+
+  int status = HeadObject(bucket, object_key);
+  if (status == 404) {
+    status = HeadObject(bucket, MinIOChunker::ManifestObjectKey(object_key));
+  }
+  return status == 200;
 }
 
 qint64 MinIOClient::GetFileSize(const QString& bucket, const QString& object_key) const
@@ -623,22 +1919,17 @@ qint64 MinIOClient::GetFileSize(const QString& bucket, const QString& object_key
   if (!is_connected_) {
     return -1;
   }
-  
-  QNetworkRequest request = CreateRequest("HEAD", bucket, object_key);
-  QNetworkReply* reply = network_manager_->head(request);
-  
-  // Wait for completion
-  QEventLoop loop;
-  connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-  loop.exec();
-  
+
   qint64 size = -1;
-  if (reply->error() == QNetworkReply::NoError) {
-    size = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+  int status = HeadObject(bucket, object_key, &size);
+  if (status == 404) {
+    QVector<MinIOChunk> chunks;
+    if (!FetchChunkManifest(bucket, MinIOChunker::ManifestObjectKey(object_key), &chunks, &size)) {
+      return -1;
+    }
+    return size;
   }
-  
-  reply->deleteLater();
-  return size;
+  return status == 200 ? size : -1;
 }
 
 bool MinIOClient::CreateBucket(const QString& bucket_name)
@@ -684,6 +1975,10 @@ QJsonObject MinIOClient::GetStatistics() const
   stats["cache_misses"] = static_cast<qint64>(stats_.cache_misses);
   stats["cache_hit_ratio"] = static_cast<double>(stats_.cache_hits) / 
                             qMax(1LL, stats_.cache_hits + stats_.cache_misses);
+  stats["dedup_logical_bytes"] = static_cast<qint64>(stats_.dedup_logical_bytes);
+  stats["dedup_skipped_bytes"] = static_cast<qint64>(stats_.dedup_skipped_bytes);
+  stats["dedup_ratio"] = static_cast<double>(stats_.dedup_skipped_bytes) /
+                         qMax(1LL, stats_.dedup_logical_bytes);
   stats["average_upload_speed"] = stats_.average_upload_speed;
   stats["average_download_speed"] = stats_.average_download_speed;
   stats["uptime_seconds"] = stats_.start_time.secsTo(QDateTime::currentDateTime());
@@ -694,13 +1989,35 @@ QJsonObject MinIOClient::GetStatistics() const
   return stats;
 }
 
-void MinIOClient::SetMultipartUpload(bool enabled, qint64 part_size)
+void MinIOClient::SetMultipartUpload(bool enabled, qint64 part_size, int max_concurrent_parts)
 {
   multipart_enabled_ = enabled;
   multipart_part_size_ = part_size;
+  multipart_concurrency_ = qMax(1, max_concurrent_parts);
   
   qInfo() << "Multipart upload" << (enabled ? "enabled" : "disabled")
-          << "part size:" << MinIOUtils::FormatFileSize(part_size);
+          << "part size:" << MinIOUtils::FormatFileSize(part_size)
+          << "concurrent parts:" << multipart_concurrency_;
+}
+
+void MinIOClient::SetRegion(const QString& region)
+{
+  region_ = region;
+}
+
+void MinIOClient::SetDeduplication(bool enabled)
+{
+  deduplication_enabled_ = enabled;
+  qInfo() << "Deduplicated video uploads" << (enabled ? "enabled" : "disabled");
+}
+
+void MinIOClient::SetRangedDownload(qint64 range_size, int max_concurrent_ranges)
+{
+  download_range_size_ = range_size;
+  download_concurrency_ = qMax(1, max_concurrent_ranges);
+  
+  qInfo() << "Ranged download size:" << MinIOUtils::FormatFileSize(range_size)
+          << "concurrent ranges:" << download_concurrency_;
 }
 
 void MinIOClient::SetTimeouts(int connect_timeout_ms, int transfer_timeout_ms)
@@ -732,8 +2049,8 @@ void MinIOClient::CancelAllTransfers()
   }
   
   // Cancel downloads
-  for (QNetworkReply* reply : active_downloads_) {
-    reply->abort();
+  for (MinIODownloadOperation* download : active_downloads_) {
+    download->Cancel();
   }
   
   qInfo() << "Cancelled" << active_uploads_.size() << "uploads and" 
@@ -754,9 +2071,24 @@ void MinIOClient::OnTransferCompleted(const QString& operation_id)
   QMutexLocker locker(&operations_mutex_);
   
   if (active_uploads_.contains(operation_id)) {
-    active_uploads_[operation_id]->deleteLater();
-    active_uploads_.remove(operation_id);
-    UpdateStatistics("upload", 0, true);
+    MinIOUploadOperation* upload = active_uploads_.take(operation_id);
+    qint64 total_bytes = upload->GetProgress().total_bytes;
+    if (upload->IsDeduplicated()) {
+      // Only the missing chunks went over the wire
+      qint64 skipped_bytes = upload->GetDeduplicatedBytes();
+      UpdateStatistics("upload", total_bytes - skipped_bytes, true);
+      
+      QMutexLocker stats_locker(&stats_mutex_);
+      stats_.dedup_logical_bytes += total_bytes;
+      stats_.dedup_skipped_bytes += skipped_bytes;
+    } else {
+      UpdateStatistics("upload", total_bytes, true);
+    }
+    upload->deleteLater();
+  } else if (active_downloads_.contains(operation_id)) {
+    MinIODownloadOperation* download = active_downloads_.take(operation_id);
+    UpdateStatistics("download", download->GetProgress().total_bytes, true);
+    download->deleteLater();
   }
   
   completed_operations_.enqueue(operation_id);
@@ -805,8 +2137,160 @@ QString MinIOClient::GenerateOperationId() const
   return QUuid::createUuid().toString().remove('{').remove('}');
 }
 
+QNetworkReply* MinIOClient::WaitForReply(QNetworkReply* reply) const
+{
+  QEventLoop loop;
+  connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+  loop.exec();
+  return reply;
+}
+
+int MinIOClient::HeadObject(const QString& bucket, const QString& object_key, qint64* size) const
+{
+  QNetworkReply* reply = WaitForReply(network_manager_->head(CreateRequest("HEAD", bucket, object_key)));
+  int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+  if (size && status == 200) {
+    *size = reply->header(QNetworkRequest::ContentLengthHeader).toLongLong();
+  }
+  reply->deleteLater();
+  return status;
+}
+
+bool MinIOClient::FetchChunkManifest(const QString& bucket, const QString& manifest_key,
+                                     QVector<MinIOChunk>* chunks, qint64* file_size) const
+{
+  QNetworkReply* reply = WaitForReply(network_manager_->get(CreateRequest("GET", bucket, manifest_key)));
+  bool ok = reply->error() == QNetworkReply::NoError &&
+            MinIOChunker::ParseManifest(reply->readAll(), chunks, file_size);
+  reply->deleteLater();
+  return ok;
+}
+
+bool MinIOClient::DeleteObject(const QString& bucket, const QString& object_key)
+{
+  QNetworkReply* reply = WaitForReply(network_manager_->deleteResource(CreateRequest("DELETE", bucket, object_key)));
+  bool success = (reply->error() == QNetworkReply::NoError);
+
+  if (success) {
+    qInfo() << "File deleted:" << bucket << "/" << object_key;
+  } else {
+    qWarning() << "Failed to delete file:" << reply->errorString();
+  }
+
+  reply->deleteLater();
+  return success;
+}
+
+bool MinIOClient::ListObjectKeys(const QString& bucket, QStringList* keys) const
+{
+  // ListObjectsV2, a page at a time
+  QString continuation;
+  for (;;) {
+    QUrlQuery query;
+    query.addQueryItem("list-type", "2");
+    if (!continuation.isEmpty()) {
+      query.addQueryItem("continuation-token", continuation);
+    }
+
+    QNetworkReply* reply = WaitForReply(network_manager_->get(CreateRequest("GET", bucket, QString(), query)));
+    QByteArray body = reply->readAll();
+    bool ok = reply->error() == QNetworkReply::NoError;
+    reply->deleteLater();
+    if (!ok) {
+      return false;
+    }
+
+    keys->append(ReadXmlElements(body, "Key"));
+    if (ReadXmlElement(body, "IsTruncated") != "true") {
+      return true;
+    }
+    continuation = ReadXmlElement(body, "NextContinuationToken");
+    if (continuation.isEmpty()) {
+      return false;
+    }
+  }
+}
+
+void MinIOClient::DeleteUnreferencedChunks(const QString& bucket, const QString& manifest_key,
+                                           const QVector<MinIOChunk>& chunks)
+{
+  // Chunks are shared by every deduplicated upload in the bucket. Without a
+  // complete view of the other manifests nothing is deleted; an orphaned
+  // chunk only costs storage, a missing one breaks a video.
+  QStringList keys;
+  if (!ListObjectKeys(bucket, &keys)) {
+    qWarning() << "Cannot list" << bucket << "- keeping the chunks of" << manifest_key;
+    return;
+  }
+
+  QSet<QString> in_use;
+  for (const QString& key : std::as_const(keys)) {
+    if (key == manifest_key || !MinIOChunker::IsManifestObjectKey(key)) {
+      continue;
+    }
+    QVector<MinIOChunk> other;
+    qint64 file_size = 0;
+    if (!FetchChunkManifest(bucket, key, &other, &file_size)) {
+      qWarning() << "Cannot read chunk manifest" << key << "- keeping the chunks of" << manifest_key;
+      return;
+    }
+    for (const MinIOChunk& chunk : std::as_const(other)) {
+      in_use.insert(chunk.hash);
+    }
+  }
+
+  // Dropped from the index first, so no upload skips a chunk being deleted
+  std::shared_ptr<MinIOChunkIndex> index = ChunkIndexFor(bucket);
+  QSet<QString> deleted;
+  for (const MinIOChunk& chunk : chunks) {
+    if (in_use.contains(chunk.hash) || deleted.contains(chunk.hash)) {
+      continue;
+    }
+    deleted.insert(chunk.hash);
+    index->Remove(chunk.hash);
+    DeleteObject(bucket, MinIOChunker::ChunkObjectKey(chunk.hash));
+  }
+}
+
+MinIOUploadOperation::RequestFactory MinIOClient::SignedRequestFactory()
+{
+  // Transfer operations sign their requests against the configured endpoint
+  return [this](const QString& method, const QString& bucket,
+                const QString& object_key, const QUrlQuery& query) {
+    return CreateRequest(method, bucket, object_key, query);
+  };
+}
+
+std::shared_ptr<MinIOChunkIndex> MinIOClient::ChunkIndexFor(const QString& bucket)
+{
+  QMutexLocker locker(&cache_mutex_);
+  
+  std::shared_ptr<MinIOChunkIndex>& index = chunk_indexes_[bucket];
+  if (!index) {
+    index = std::make_shared<MinIOChunkIndex>(MinIOChunkIndex::IndexPath(endpoint_, bucket));
+  }
+  return index;
+}
+
+MinIOUploadOperation* MinIOClient::CreateUploadOperation(const QString& operation_id, const QString& file_path,
+                                                        const QString& bucket, const QString& object_key)
+{
+  MinIOUploadOperation* upload_op = new MinIOUploadOperation(
+    operation_id, file_path, bucket, object_key, this);
+  upload_op->SetRequestFactory(SignedRequestFactory());
+  upload_op->SetMultipart(multipart_enabled_, multipart_part_size_, multipart_concurrency_);
+
+  {
+    QMutexLocker locker(&operations_mutex_);
+    active_uploads_[operation_id] = upload_op;
+  }
+
+  return upload_op;
+}
+
 QNetworkRequest MinIOClient::CreateRequest(const QString& method, const QString& bucket,
-                                         const QString& object_key, const QJsonObject& headers) const
+                                         const QString& object_key, const QUrlQuery& query,
+                                         const QJsonObject& headers) const
 {
   QString scheme = use_ssl_ ? "https" : "http";
   QString url_string = QString("%1://%2/%3").arg(scheme, endpoint_, bucket);
@@ -815,41 +2299,36 @@ QNetworkRequest MinIOClient::CreateRequest(const QString& method, const QString&
     url_string += "/" + object_key;
   }
   
+  // The query is final before signing; SigV4 covers every query item
+  QUrl url(url_string);
+  url.setQuery(query);
+
   QNetworkRequest request;
-  request.setUrl(QUrl(url_string));
-  
-  // Add authentication headers
-  QString date = QDateTime::currentDateTimeUtc().toString("ddd, dd MMM yyyy hh:mm:ss 'GMT'");
-  request.setRawHeader("Date", date.toUtf8());
-  request.setRawHeader("Host", endpoint_.toUtf8());
-  
-  // Create signature
-  QString signature = CreateSignature(method, bucket, object_key, date, headers);
-  QString auth_header = QString("AWS %1:%2").arg(access_key_, signature);
-  request.setRawHeader("Authorization", auth_header.toUtf8());
-  
-  // Add custom headers
+  request.setUrl(url);
+
+  QDateTime timestamp = QDateTime::currentDateTimeUtc();
+  QByteArray payload_hash = headers.value("x-amz-content-sha256").toString(kUnsignedPayload).toUtf8();
+
+  QMap<QByteArray, QByteArray> signed_headers;
+  signed_headers["host"] = endpoint_.toUtf8();
+  signed_headers["x-amz-content-sha256"] = payload_hash;
+  signed_headers["x-amz-date"] = timestamp.toString(kSigV4TimeFormat).toUtf8();
   for (auto it = headers.constBegin(); it != headers.constEnd(); ++it) {
-    request.setRawHeader(it.key().toUtf8(), it.value().toString().toUtf8());
+    signed_headers[it.key().toLower().toUtf8()] = it.value().toString().trimmed().toUtf8();
   }
-  
-  return request;
-}
 
-QString MinIOClient::CreateSignature(const QString& method, const QString& bucket, 
-                                    const QString& object_key, const QString& date,
-                                    const QJsonObject& headers) const
-{
-  // Simplified signature creation - in practice would use proper AWS signature v4
-  QString string_to_sign = QString("%1\n\n\n%2\n/%3/%4")
-                          .arg(method, date, bucket, object_key);
-  
-  QByteArray signature = QCryptographicHash::hash(
-    (secret_key_ + string_to_sign).toUtf8(), 
-    QCryptographicHash::Sha256
-  ).toBase64();
+  for (auto it = signed_headers.constBegin(); it != signed_headers.constEnd(); ++it) {
+    request.setRawHeader(it.key() == "host" ? QByteArray("Host") : it.key(), it.value());
+  }
+
+  QString signature = MinIOUtils::SignatureV4(method, url, signed_headers, payload_hash,
+                                              secret_key_, region_, timestamp);
+  QString auth_header = QString("%1 Credential=%2/%3, SignedHeaders=%4, Signature=%5")
+                        .arg(QString::fromLatin1(kSigV4Algorithm), access_key_, MinIOUtils::SignatureV4Scope(region_, timestamp),
+                             QString::fromUtf8(signed_headers.keys().join(';')), signature);
+  request.setRawHeader("Authorization", auth_header.toUtf8());
   
-  return QString::fromUtf8(signature);
+  return request;
 }
 
 QString MinIOClient::CreatePresignedUrl(const QString& method, const QString& bucket,
@@ -857,22 +2336,33 @@ QString MinIOClient::CreatePresignedUrl(const QString& method, const QString& bu
                                        const QJsonObject& query_params) const
 {
   QString scheme = use_ssl_ ? "https" : "http";
-  qint64 expires = QDateTime::currentSecsSinceEpoch() + expiry_seconds;
+  QDateTime timestamp = QDateTime::currentDateTimeUtc();
   
   QUrl url(QString("%1://%2/%3/%4").arg(scheme, endpoint_, bucket, object_key));
   QUrlQuery query;
   
-  query.addQueryItem("AWSAccessKeyId", access_key_);
-  query.addQueryItem("Expires", QString::number(expires));
-  query.addQueryItem("Signature", CreateSignature(method, bucket, object_key, QString::number(expires)));
+  query.addQueryItem("X-Amz-Algorithm", kSigV4Algorithm);
+  query.addQueryItem("X-Amz-Credential",
+                     QString("%1/%2").arg(access_key_, MinIOUtils::SignatureV4Scope(region_, timestamp)));
+  query.addQueryItem("X-Amz-Date", timestamp.toString(kSigV4TimeFormat));
+  query.addQueryItem("X-Amz-Expires", QString::number(expiry_seconds));
+  query.addQueryItem("X-Amz-SignedHeaders", "host");
   
   // Add custom query parameters
   for (auto it = query_params.constBegin(); it != query_params.constEnd(); ++it) {
     query.addQueryItem(it.key(), it.value().toString());
   }
+  url.setQuery(query);
+
+  // Everything but the signature itself is signed
+  QMap<QByteArray, QByteArray> signed_headers;
+  signed_headers["host"] = endpoint_.toUtf8();
+  QString signature = MinIOUtils::SignatureV4(method, url, signed_headers, kUnsignedPayload,
+                                              secret_key_, region_, timestamp);
+  query.addQueryItem("X-Amz-Signature", signature);
   
   url.setQuery(query);
-  return url.toString();
+  return url.toString(QUrl::FullyEncoded);
 }
 
 void MinIOClient::ProcessVideoFile(const QString& file_path, VideoMetadata& metadata)
@@ -1163,6 +2653,62 @@ QJsonObject GetStreamingParams(const VideoMetadata& metadata, const QString& qua
   return params;
 }
 
+QString SignatureV4Scope(const QString& region, const QDateTime& timestamp)
+{
+  return QString("%1/%2/s3/aws4_request").arg(timestamp.toUTC().toString("yyyyMMdd"), region);
+}
+
+QString SignatureV4(const QString& method, const QUrl& url, const QMap<QByteArray, QByteArray>& headers,
+                    const QByteArray& payload_hash, const QString& secret_key, const QString& region,
+                    const QDateTime& timestamp)
+{
+  QStringList segments = url.path(QUrl::FullyDecoded).split('/');
+  QByteArrayList encoded_segments;
+  for (const QString& segment : segments) {
+    encoded_segments.append(SigV4Encode(segment));
+  }
+  QByteArray canonical_uri = encoded_segments.join('/');
+  if (canonical_uri.isEmpty()) {
+    canonical_uri = "/";
+  }
+
+  // Query items sorted by encoded name then value; a bare name signs as "name="
+  QList<QPair<QByteArray, QByteArray>> query_items;
+  for (const auto& item : QUrlQuery(url).queryItems(QUrl::FullyDecoded)) {
+    query_items.append(qMakePair(SigV4Encode(item.first), SigV4Encode(item.second)));
+  }
+  std::sort(query_items.begin(), query_items.end());
+  QByteArrayList canonical_query;
+  for (const auto& item : query_items) {
+    canonical_query.append(item.first + '=' + item.second);
+  }
+
+  QByteArray canonical_headers;
+  for (auto it = headers.constBegin(); it != headers.constEnd(); ++it) {
+    canonical_headers += it.key() + ':' + it.value().trimmed() + '\n';
+  }
+
+  QByteArray canonical_request = method.toUtf8() + '\n'
+                                 + canonical_uri + '\n'
+                                 + canonical_query.join('&') + '\n'
+                                 + canonical_headers + '\n'
+                                 + headers.keys().join(';') + '\n'
+                                 + payload_hash;
+
+  QDateTime utc = timestamp.toUTC();
+  QByteArray string_to_sign = QByteArray(kSigV4Algorithm) + '\n'
+                              + utc.toString(kSigV4TimeFormat).toUtf8() + '\n'
+                              + SignatureV4Scope(region, utc).toUtf8() + '\n'
+                              + QCryptographicHash::hash(canonical_request, QCryptographicHash::Sha256).toHex();
+
+  QByteArray key = HmacSha256("AWS4" + secret_key.toUtf8(), utc.toString("yyyyMMdd").toUtf8());
+  key = HmacSha256(key, region.toUtf8());
+  key = HmacSha256(key, "s3");
+  key = HmacSha256(key, "aws4_request");
+
+  return QString::fromLatin1(HmacSha256(key, string_to_sign).toHex());
+}
+
 QByteArray ExtractVideoFrame(const QString& file_path, qint64 timestamp_ms)
 {
   // Simplified frame extraction using FFmpeg
@@ -15,18 +15,27 @@
 #include <QTimer>
 #include <QMutex>
 #include <QQueue>
+#include <QSet>
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QDateTime>
 #include <QFileInfo>
 #include <QIODevice>
+#include <QFile>
 #include <QByteArray>
 #include <QUrl>
 #include <QUrlQuery>
 #include <QCryptographicHash>
 #include <QThread>
 #include <QProgressBar>
+#include <QElapsedTimer>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+
+#include "minio_chunk_store.h"
 
 namespace olive {
 
@@ -90,18 +99,37 @@ struct TransferProgress {
   QDateTime start_time;
   QDateTime last_update;
   QString error_message;
+  double throughput_bytes_per_sec; // Aggregate over all parallel parts, this session
+  int parts_completed;
+  int parts_total;
+  int parts_active;
   
-  TransferProgress() : bytes_transferred(0), total_bytes(0), percentage(0.0) {}
+  TransferProgress() : bytes_transferred(0), total_bytes(0), percentage(0.0),
+                       throughput_bytes_per_sec(0.0), parts_completed(0),
+                       parts_total(0), parts_active(0) {}
 };
 
 /**
  * @brief MinIO upload operation
+ *
+ * Files larger than one part go through S3 multipart upload with several
+ * parts in flight at once. Completed parts are recorded in a manifest on
+ * disk, so an interrupted upload (failure, cancel, restart) resumes with
+ * the remaining parts of the same upload id.
+ *
+ * With deduplication the file is split into content-defined chunks and
+ * only chunks missing from the bucket's chunk index are sent, followed by
+ * a chunk manifest beside the object key (see MinIOChunker).
  */
 class MinIOUploadOperation : public QObject
 {
   Q_OBJECT
 
 public:
+  // Builds a signed request; query carries uploads/uploadId/partNumber
+  using RequestFactory = std::function<QNetworkRequest(const QString& method, const QString& bucket,
+                                                       const QString& object_key, const QUrlQuery& query)>;
+
   explicit MinIOUploadOperation(const QString& operation_id, const QString& file_path,
                                const QString& bucket, const QString& object_key,
                                QObject* parent = nullptr);
@@ -112,6 +140,18 @@ public:
   QString GetObjectKey() const { return object_key_; }
   TransferProgress GetProgress() const { return progress_; }
 
+  void SetRequestFactory(RequestFactory factory) { request_factory_ = std::move(factory); }
+  void SetMultipart(bool enabled, qint64 part_size, int max_concurrent_parts);
+  void SetDeduplication(std::shared_ptr<MinIOChunkIndex> chunk_index) { chunk_index_ = std::move(chunk_index); }
+
+  bool IsDeduplicated() const { return chunk_index_ != nullptr; }
+  qint64 GetDeduplicatedBytes() const { return deduplicated_bytes_; }
+
+  /**
+   * @brief Object key of an unfinished multipart upload of this file, if any
+   */
+  static QString FindResumableObjectKey(const QString& file_path, const QString& bucket);
+
 public slots:
   void Start();
   void Cancel();
@@ -127,6 +167,43 @@ private slots:
   void OnUploadFinished();
 
 private:
+  struct UploadPart {
+    int number = 0;          // 1-based S3 part number
+    qint64 offset = 0;
+    qint64 size = 0;
+    qint64 bytes_sent = 0;
+    QString etag;            // Set once the part is stored
+    int attempts = 0;
+    QNetworkReply* reply = nullptr;
+    bool reading = false;    // Being read and hashed on a worker
+    bool backing_off = false; // Waiting out a retry delay
+    QString chunk_hash;      // Deduplicated uploads: the part is a chunk object
+    bool verify = false;     // Chunk the index lists: HEAD it, upload only if missing
+  };
+
+  QNetworkRequest CreateRequest(const QString& method, const QUrlQuery& query = QUrlQuery(),
+                                const QString& object_key = QString()) const;
+  void StartSinglePut();
+  void StartMultipart();
+  void StartDeduplicated();
+  void OnChunkingFinished(const QVector<MinIOChunk>& chunks, const QString& error);
+  void PutChunkManifest();
+  void InitiateMultipartUpload();
+  void PlanParts();
+  void ScheduleParts();
+  void UploadPartAt(int index);
+  void VerifyChunkAt(int index);
+  void OnPartRead(int index, const QByteArray& data, const QByteArray& md5, const QByteArray& sha256);
+  void OnPartFinished(int index, QNetworkReply* reply);
+  void CompleteMultipartUpload();
+  void AbortParts();
+  void FailUpload(const QString& error);
+  void UpdateProgress();
+  bool LoadManifest();
+  void SaveManifest() const;
+  void RemoveManifest() const;
+  static QString ManifestPath(const QString& file_path, const QString& bucket);
+
   QString operation_id_;
   QString file_path_;
   QString bucket_name_;
@@ -136,6 +213,127 @@ private:
   QNetworkAccessManager* network_manager_;
   int retry_count_;
   static const int MAX_RETRIES = 3;
+
+  // Multipart state
+  RequestFactory request_factory_;
+  bool multipart_enabled_;
+  qint64 part_size_;
+  int max_concurrent_parts_;
+  QString upload_id_;
+  QVector<UploadPart> parts_;
+  int active_parts_;       // Parts being read or sent
+  int part_generation_;    // Bumped when parts are aborted or replanned
+  bool cancelled_;
+  bool restarted_upload_;
+  qint64 resumed_bytes_;
+  QElapsedTimer transfer_timer_;
+
+  // Deduplication state
+  std::shared_ptr<MinIOChunkIndex> chunk_index_;
+  QVector<MinIOChunk> chunks_;
+  qint64 deduplicated_bytes_;
+  int chunking_generation_;
+};
+
+/**
+ * @brief MinIO download operation
+ *
+ * Data is written straight into a preallocated "<path>.part" file as it
+ * arrives instead of being buffered in memory. Each range maps only its own
+ * window of the file while in flight and unmaps it once stored. Objects larger
+ * than one range are fetched with several HTTP Range requests in flight.
+ * Finished ranges are recorded next to the partial file, so an interrupted
+ * download resumes with the missing ranges while the object's ETag is
+ * unchanged. The partial file is renamed into place once complete.
+ * Deduplicated uploads, which only have a chunk manifest beside their key,
+ * are reassembled from their chunks, one range each.
+ */
+class MinIODownloadOperation : public QObject
+{
+  Q_OBJECT
+
+public:
+  using RequestFactory = MinIOUploadOperation::RequestFactory;
+
+  explicit MinIODownloadOperation(const QString& operation_id, const QString& bucket,
+                                 const QString& object_key, const QString& local_path,
+                                 QObject* parent = nullptr);
+  virtual ~MinIODownloadOperation();
+
+  QString GetOperationId() const { return operation_id_; }
+  QString GetBucketName() const { return bucket_name_; }
+  QString GetObjectKey() const { return object_key_; }
+  QString GetLocalPath() const { return local_path_; }
+  TransferProgress GetProgress() const { return progress_; }
+
+  void SetRequestFactory(RequestFactory factory) { request_factory_ = std::move(factory); }
+  void SetRanges(qint64 range_size, int max_concurrent_ranges);
+
+public slots:
+  void Start();
+  void Cancel();
+
+signals:
+  void ProgressUpdated(const TransferProgress& progress);
+  void Completed(const QString& local_path);
+  void Failed(const QString& error);
+
+private:
+  struct DownloadRange {
+    qint64 offset = 0;
+    qint64 size = 0;
+    qint64 bytes_written = 0;
+    bool done = false;
+    int attempts = 0;
+    QNetworkReply* reply = nullptr;
+    QString object_key;      // Chunk object for deduplicated objects, else empty
+    uchar* data = nullptr;   // Mapped window onto the range while it is in flight
+  };
+
+  QNetworkRequest CreateRequest(const QString& method, const QString& object_key = QString()) const;
+  void OnHeadFinished();
+  void FetchChunkManifest();
+  void BeginTransfer();
+  bool PrepareFile();
+  void PlanRanges();
+  void ScheduleRanges();
+  void FetchRangeAt(int index);
+  void OnRangeReadyRead(int index, QNetworkReply* reply);
+  void OnRangeFinished(int index, QNetworkReply* reply);
+  void AbortRanges();
+  void FinishDownload();
+  void FailDownload(const QString& error, bool discard_partial = false);
+  void ReleaseFile();
+  void UnmapRange(DownloadRange& range);
+  void UpdateProgress();
+  bool LoadManifest();
+  void SaveManifest() const;
+  QString PartialPath() const { return local_path_ + ".part"; }
+  QString ManifestPath() const { return local_path_ + ".part.json"; }
+
+  QString operation_id_;
+  QString bucket_name_;
+  QString object_key_;
+  QString local_path_;
+  TransferProgress progress_;
+  QNetworkAccessManager* network_manager_;
+  QNetworkReply* control_reply_; // HEAD, then the chunk manifest if any
+  RequestFactory request_factory_;
+  static const int MAX_RETRIES = 3;
+
+  // Ranged transfer state
+  qint64 range_size_;
+  int max_concurrent_ranges_;
+  qint64 object_size_;
+  QString object_etag_;
+  QVector<DownloadRange> ranges_;
+  int active_ranges_;
+  bool cancelled_;
+  qint64 resumed_bytes_;
+  QElapsedTimer transfer_timer_;
+
+  // Destination; ranges whose window could not be mapped write through file_
+  QFile* file_;
 };
 
 /**
@@ -162,9 +360,13 @@ public:
 
   /**
    * @brief Upload video file asynchronously
+   *
+   * The upload can fail before this returns. Callers that track it by
+   * operation id pass their own, so the id is known before any signal.
    */
   QString UploadVideoFile(const QString& file_path, const QString& bucket = "videos",
-                         const QJsonObject& metadata = QJsonObject());
+                         const QJsonObject& metadata = QJsonObject(),
+                         const QString& operation_id = QString());
 
   /**
    * @brief Upload Dynamic Fabricator result
@@ -210,6 +412,9 @@ public:
 
   /**
    * @brief Delete file from storage
+   *
+   * A deduplicated upload's manifest is deleted, along with the chunks no
+   * other manifest in the bucket uses.
    */
   bool DeleteFile(const QString& bucket, const QString& object_key);
 
@@ -219,7 +424,7 @@ public:
   bool FileExists(const QString& bucket, const QString& object_key) const;
 
   /**
-   * @brief Get file size
+   * @brief Get file size, from the chunk manifest for deduplicated uploads
    */
   qint64 GetFileSize(const QString& bucket, const QString& object_key) const;
 
@@ -243,10 +448,27 @@ public:
    */
   QJsonObject GetStatistics() const;
 
+  /**
+   * @brief Region named in request signatures (MinIO defaults to us-east-1)
+   */
+  void SetRegion(const QString& region);
+
   /**
    * @brief Enable/disable multipart uploads
    */
-  void SetMultipartUpload(bool enabled, qint64 part_size = 5 * 1024 * 1024); // 5MB default
+  void SetMultipartUpload(bool enabled, qint64 part_size = 5 * 1024 * 1024, // 5MB default
+                          int max_concurrent_parts = 4);
+
+  /**
+   * @brief Upload videos as deduplicated content-defined chunks
+   */
+  void SetDeduplication(bool enabled);
+
+  /**
+   * @brief Range size and parallelism of downloads
+   */
+  void SetRangedDownload(qint64 range_size = 8 * 1024 * 1024, // 8MB default
+                         int max_concurrent_ranges = 4);
 
   /**
    * @brief Set upload/download timeouts
@@ -309,12 +531,27 @@ private:
   void SetupNetworking();
   void SetupTimers();
   QString GenerateOperationId() const;
+  MinIOUploadOperation::RequestFactory SignedRequestFactory();
+  std::shared_ptr<MinIOChunkIndex> ChunkIndexFor(const QString& bucket);
+  MinIOUploadOperation* CreateUploadOperation(const QString& operation_id, const QString& file_path,
+                                              const QString& bucket, const QString& object_key);
+  // Signs with SigV4; headers are sent and signed, x-amz-content-sha256 defaults to UNSIGNED-PAYLOAD
   QNetworkRequest CreateRequest(const QString& method, const QString& bucket,
-                               const QString& object_key, const QJsonObject& headers = QJsonObject()) const;
-  QString CreateSignature(const QString& method, const QString& bucket, const QString& object_key,
-                         const QString& date, const QJsonObject& headers = QJsonObject()) const;
+                               const QString& object_key, const QUrlQuery& query = QUrlQuery(),
+                               const QJsonObject& headers = QJsonObject()) const;
   QString CreatePresignedUrl(const QString& method, const QString& bucket, const QString& object_key,
                             int expiry_seconds, const QJsonObject& query_params = QJsonObject()) const;
+
+  // Blocking object requests; a deduplicated upload only has its chunk
+  // manifest and chunks in the bucket, never an object at its own key
+  QNetworkReply* WaitForReply(QNetworkReply* reply) const;
+  int HeadObject(const QString& bucket, const QString& object_key, qint64* size = nullptr) const;
+  bool FetchChunkManifest(const QString& bucket, const QString& manifest_key,
+                          QVector<MinIOChunk>* chunks, qint64* file_size) const;
+  bool DeleteObject(const QString& bucket, const QString& object_key);
+  bool ListObjectKeys(const QString& bucket, QStringList* keys) const;
+  void DeleteUnreferencedChunks(const QString& bucket, const QString& manifest_key,
+                                const QVector<MinIOChunk>& chunks);
   
   void ProcessVideoFile(const QString& file_path, VideoMetadata& metadata);
   void ExtractVideoMetadata(const QString& file_path, VideoMetadata& metadata);
@@ -331,6 +568,7 @@ private:
   QString endpoint_;
   QString access_key_;
   QString secret_key_;
+  QString region_;
   bool use_ssl_;
   bool is_connected_;
   bool is_initialized_;
@@ -338,6 +576,10 @@ private:
   // Upload/Download settings
   bool multipart_enabled_;
   qint64 multipart_part_size_;
+  int multipart_concurrency_;
+  qint64 download_range_size_;
+  int download_concurrency_;
+  bool deduplication_enabled_;
   int connect_timeout_ms_;
   int transfer_timeout_ms_;
   bool video_analysis_enabled_;
@@ -350,7 +592,7 @@ private:
   // Operation tracking
   mutable QMutex operations_mutex_;
   QMap<QString, MinIOUploadOperation*> active_uploads_;
-  QMap<QString, QNetworkReply*> active_downloads_;
+  QMap<QString, MinIODownloadOperation*> active_downloads_;
   QQueue<QString> completed_operations_;
   QQueue<QString> failed_operations_;
   
@@ -359,6 +601,7 @@ private:
   QMap<QString, VideoMetadata> video_cache_;
   QMap<QString, QList<FabricatorResult>> fabricator_cache_;
   QMap<QString, QPair<QString, QDateTime>> presigned_url_cache_; // key -> (url, expiry)
+  QMap<QString, std::shared_ptr<MinIOChunkIndex>> chunk_indexes_; // bucket -> index
   
   // Statistics
   mutable QMutex stats_mutex_;
@@ -373,12 +616,15 @@ private:
     qint64 cache_misses;
     double average_upload_speed; // bytes per second
     double average_download_speed;
+    qint64 dedup_logical_bytes;   // Size of deduplicated uploads
+    qint64 dedup_skipped_bytes;   // Of which already stored in the bucket
     QDateTime start_time;
     
     Statistics() : files_uploaded(0), files_downloaded(0), bytes_uploaded(0),
                    bytes_downloaded(0), upload_failures(0), download_failures(0),
                    cache_hits(0), cache_misses(0), average_upload_speed(0.0),
-                   average_download_speed(0.0), start_time(QDateTime::currentDateTime()) {}
+                   average_download_speed(0.0), dedup_logical_bytes(0),
+                   dedup_skipped_bytes(0), start_time(QDateTime::currentDateTime()) {}
   } stats_;
 };
 
@@ -440,6 +686,21 @@ QString FormatFileSize(qint64 bytes);
  */
 QString CalculateETag(const QString& file_path);
 
+/**
+ * @brief AWS Signature Version 4 of a request, as a hex string
+ *
+ * Covers the method, the path and every query item of @p url, and
+ * @p headers keyed by lowercase name (host and x-amz-date at least).
+ */
+QString SignatureV4(const QString& method, const QUrl& url, const QMap<QByteArray, QByteArray>& headers,
+                    const QByteArray& payload_hash, const QString& secret_key, const QString& region,
+                    const QDateTime& timestamp);
+
+/**
+ * @brief Credential scope of a SigV4 signature: date/region/s3/aws4_request
+ */
+QString SignatureV4Scope(const QString& region, const QDateTime& timestamp);
+
 /**
  * @brief Extract video frame at timestamp
  */
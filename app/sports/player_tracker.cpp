@@ -0,0 +1,276 @@
+/**
+ * @file player_tracker.cpp
+ * @brief Implementation of temporal player tracking
+ *
+ * Tracks are associated with fresh detections by solving a 1 - IoU
+ * assignment with the shared Hungarian solver, so identities stay stable
+ * even when the detector reports players in a different order.
+ */
+
+#include "player_tracker.h"
+#include "formation_assignment.h"
+#include <algorithm>
+#include <iostream>
+
+namespace amt {
+namespace sports {
+
+namespace {
+
+double intersectionOverUnion(const cv::Rect& a, const cv::Rect& b) {
+    const int left = std::max(a.x, b.x);
+    const int top = std::max(a.y, b.y);
+    const int right = std::min(a.x + a.width, b.x + b.width);
+    const int bottom = std::min(a.y + a.height, b.y + b.height);
+    if (right <= left || bottom <= top) {
+        return 0.0;
+    }
+
+    const double intersection = static_cast<double>(right - left) * (bottom - top);
+    const double union_area = static_cast<double>(a.width) * a.height +
+                              static_cast<double>(b.width) * b.height - intersection;
+    return union_area > 0.0 ? intersection / union_area : 0.0;
+}
+
+} // namespace
+
+void PlayerTrack::AxisFilter::predict(float process_noise) {
+    // x' = F x, P' = F P F^T + Q with F = [[1, 1], [0, 1]]
+    position += velocity;
+    const float p00 = covariance[0][0] + covariance[0][1] + covariance[1][0] + covariance[1][1];
+    const float p01 = covariance[0][1] + covariance[1][1];
+    const float p10 = covariance[1][0] + covariance[1][1];
+    covariance[0][0] = p00 + process_noise;
+    covariance[0][1] = p01;
+    covariance[1][0] = p10;
+    covariance[1][1] += process_noise;
+}
+
+void PlayerTrack::AxisFilter::correct(float measurement, float measurement_noise) {
+    const float innovation = measurement - position;
+    const float s = covariance[0][0] + measurement_noise;
+    const float k0 = covariance[0][0] / s;
+    const float k1 = covariance[1][0] / s;
+
+    position += k0 * innovation;
+    velocity += k1 * innovation;
+
+    const float p00 = covariance[0][0], p01 = covariance[0][1];
+    covariance[0][0] -= k0 * p00;
+    covariance[0][1] -= k0 * p01;
+    covariance[1][0] -= k1 * p00;
+    covariance[1][1] -= k1 * p01;
+}
+
+cv::Rect PlayerTrack::predictedBox() const {
+    return cv::Rect(static_cast<int>(x.position - box_size.width / 2),
+                    static_cast<int>(y.position - box_size.height / 2),
+                    static_cast<int>(box_size.width),
+                    static_cast<int>(box_size.height));
+}
+
+PlayerTracker::PlayerTracker()
+    : PlayerTracker(Config()) {
+}
+
+PlayerTracker::PlayerTracker(const Config& config)
+    : m_config(config) {
+}
+
+bool PlayerTracker::scheduleDetection() {
+    bool detect = m_tracks.empty() ||
+                  m_frames_since_detection + 1 >= m_config.detection_interval ||
+                  averageConfidence() < m_config.min_track_confidence;
+
+    if (detect) {
+        m_frames_since_detection = 0;
+        ++m_detector_invocations;
+    } else {
+        ++m_frames_since_detection;
+        ++m_skipped_detections;
+    }
+    return detect;
+}
+
+bool PlayerTracker::detectionDue() const {
+    // predict() decays every track by the same factor, so the mean does too
+    return m_tracks.empty() ||
+           m_frames_since_detection + 1 >= m_config.detection_interval ||
+           averageConfidence() * m_config.confidence_decay < m_config.min_track_confidence;
+}
+
+void PlayerTracker::predict() {
+    for (auto& track : m_tracks) {
+        track.x.predict(m_config.process_noise);
+        track.y.predict(m_config.process_noise);
+        track.confidence *= m_config.confidence_decay;
+    }
+}
+
+void PlayerTracker::update(const std::vector<PlayerPosition>& detections) {
+    const int max_size = AssignmentWorkspace::kMaxSize;
+    const int track_count = std::min(static_cast<int>(m_tracks.size()), max_size);
+    const int detection_count = std::min(static_cast<int>(detections.size()), max_size);
+
+    std::vector<int> track_to_detection(m_tracks.size(), -1);
+    std::vector<bool> detection_matched(detections.size(), false);
+
+    if (!m_warned_assignment_cap && (static_cast<int>(m_tracks.size()) > max_size ||
+                                     static_cast<int>(detections.size()) > max_size)) {
+        std::cerr << "[Player Tracker] " << m_tracks.size() << " tracks / " << detections.size()
+                  << " detections exceed the " << max_size << "-player assignment solver;"
+                  << " associating the remainder greedily" << std::endl;
+        m_warned_assignment_cap = true;
+    }
+
+    if (track_count > 0 && detection_count > 0) {
+        // The solver needs rows <= cols, so transpose when tracks outnumber detections
+        const bool transpose = track_count > detection_count;
+        const int rows = transpose ? detection_count : track_count;
+        const int cols = transpose ? track_count : detection_count;
+
+        AssignmentWorkspace& workspace = AssignmentSolver::threadWorkspace();
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                const int t = transpose ? c : r;
+                const int d = transpose ? r : c;
+                workspace.cost[r][c] = 1.0 - intersectionOverUnion(m_tracks[t].predictedBox(),
+                                                                   detectionBox(detections[d]));
+            }
+        }
+        AssignmentSolver::solve(workspace, rows, cols);
+
+        for (int r = 0; r < rows; ++r) {
+            const int c = workspace.row_to_col[r];
+            if (1.0 - workspace.cost[r][c] < m_config.iou_threshold) {
+                continue;
+            }
+            const int t = transpose ? c : r;
+            const int d = transpose ? r : c;
+            track_to_detection[t] = d;
+            detection_matched[d] = true;
+        }
+    }
+
+    // Tracks and detections past the solver size are matched greedily by
+    // IoU, so a crowded frame never turns known players into new tracks
+    if (static_cast<int>(m_tracks.size()) > track_count || static_cast<int>(detections.size()) > detection_count) {
+        while (true) {
+            double best_iou = m_config.iou_threshold;
+            int best_track = -1;
+            int best_detection = -1;
+            for (size_t t = 0; t < m_tracks.size(); ++t) {
+                if (track_to_detection[t] >= 0) {
+                    continue;
+                }
+                const cv::Rect predicted = m_tracks[t].predictedBox();
+                for (size_t d = 0; d < detections.size(); ++d) {
+                    if (detection_matched[d]) {
+                        continue;
+                    }
+                    const double iou = intersectionOverUnion(predicted, detectionBox(detections[d]));
+                    if (iou >= best_iou) {
+                        best_iou = iou;
+                        best_track = static_cast<int>(t);
+                        best_detection = static_cast<int>(d);
+                    }
+                }
+            }
+            if (best_track < 0) {
+                break;
+            }
+            track_to_detection[best_track] = best_detection;
+            detection_matched[best_detection] = true;
+        }
+    }
+
+    for (size_t t = 0; t < m_tracks.size(); ++t) {
+        PlayerTrack& track = m_tracks[t];
+        if (track_to_detection[t] < 0) {
+            ++track.missed_updates;
+            continue;
+        }
+
+        const PlayerPosition& detection = detections[track_to_detection[t]];
+        const cv::Rect box = detectionBox(detection);
+        track.x.correct(detection.position.x, m_config.measurement_noise);
+        track.y.correct(detection.position.y, m_config.measurement_noise);
+        track.box_size = cv::Size2f(static_cast<float>(box.width), static_cast<float>(box.height));
+        track.player = detection;
+        track.confidence = detection.confidence;
+        track.missed_updates = 0;
+    }
+
+    m_tracks.erase(std::remove_if(m_tracks.begin(), m_tracks.end(), [this](const PlayerTrack& track) {
+        return track.missed_updates > m_config.max_missed_updates;
+    }), m_tracks.end());
+
+    for (size_t d = 0; d < detections.size(); ++d) {
+        if (detection_matched[d]) {
+            continue;
+        }
+
+        const cv::Rect box = detectionBox(detections[d]);
+        PlayerTrack track;
+        track.id = m_next_id++;
+        track.x.position = detections[d].position.x;
+        track.y.position = detections[d].position.y;
+        track.box_size = cv::Size2f(static_cast<float>(box.width), static_cast<float>(box.height));
+        track.player = detections[d];
+        track.confidence = detections[d].confidence;
+        track.missed_updates = 0;
+        m_tracks.push_back(track);
+    }
+}
+
+std::vector<PlayerPosition> PlayerTracker::currentPlayers() const {
+    std::vector<PlayerPosition> players;
+    players.reserve(m_tracks.size());
+    for (const auto& track : m_tracks) {
+        PlayerPosition player = track.player;
+        player.position = cv::Point2f(track.x.position, track.y.position);
+        player.bounding_box = track.predictedBox();
+        player.confidence = track.confidence;
+        player.track_id = track.id;
+        players.push_back(player);
+    }
+    return players;
+}
+
+double PlayerTracker::averageConfidence() const {
+    if (m_tracks.empty()) {
+        return 0.0;
+    }
+
+    double total = 0.0;
+    for (const auto& track : m_tracks) {
+        total += track.confidence;
+    }
+    return total / m_tracks.size();
+}
+
+void PlayerTracker::setConfig(const Config& config) {
+    m_config = config;
+}
+
+void PlayerTracker::reset() {
+    m_tracks.clear();
+    m_next_id = 0;
+    m_frames_since_detection = 0;
+    m_detector_invocations = 0;
+    m_skipped_detections = 0;
+}
+
+cv::Rect PlayerTracker::detectionBox(const PlayerPosition& detection) const {
+    // Rule-based detections carry no box; assume a nominal player size
+    if (detection.bounding_box.width > 0 && detection.bounding_box.height > 0) {
+        return detection.bounding_box;
+    }
+    const cv::Size& size = m_config.default_box_size;
+    return cv::Rect(static_cast<int>(detection.position.x - size.width / 2),
+                    static_cast<int>(detection.position.y - size.height / 2),
+                    size.width, size.height);
+}
+
+} // namespace sports
+} // namespace amt
@@ -0,0 +1,105 @@
+#ifndef PLAYER_TRACKER_H
+#define PLAYER_TRACKER_H
+
+/**
+ * @file player_tracker.h
+ * @brief Temporal player tracking between detector keyframes
+ *
+ * Constant-velocity Kalman tracks with IoU association over
+ * PlayerPosition::bounding_box. Tracks keep stable player IDs across
+ * frames so the DNN detector only has to run every K frames, or sooner
+ * when track confidence drops.
+ */
+
+#include "formation_detector.h"
+#include <vector>
+
+namespace amt {
+namespace sports {
+
+/**
+ * @struct PlayerTrack
+ * @brief Kalman-filtered state for one tracked player
+ */
+struct PlayerTrack {
+    // Constant-velocity filter for one axis: state [position, velocity]
+    struct AxisFilter {
+        float position = 0.0f;
+        float velocity = 0.0f;
+        float covariance[2][2] = {{1.0f, 0.0f}, {0.0f, 1.0f}};
+
+        void predict(float process_noise);
+        void correct(float measurement, float measurement_noise);
+    };
+
+    int id;                    // Stable player ID
+    AxisFilter x;
+    AxisFilter y;
+    cv::Size2f box_size;       // Last measured bounding box size
+    PlayerPosition player;     // Latest detection attributes (team, jersey, ...)
+    double confidence;         // Decays while the track is only predicted
+    int missed_updates;        // Consecutive keyframes without a match
+
+    cv::Rect predictedBox() const;
+};
+
+/**
+ * @class PlayerTracker
+ * @brief Multi-player tracker deciding when the detector must run
+ */
+class PlayerTracker {
+public:
+    struct Config {
+        int detection_interval = 5;        // Run the detector every K frames
+        double min_track_confidence = 0.5; // Force detection below this mean confidence
+        double confidence_decay = 0.95;    // Per predicted frame
+        double iou_threshold = 0.3;        // Minimum IoU to associate a detection
+        int max_missed_updates = 2;        // Keyframes before a track is dropped
+        float process_noise = 1.0f;        // Pixels^2 per frame
+        float measurement_noise = 4.0f;    // Pixels^2
+        cv::Size default_box_size = cv::Size(24, 48);
+    };
+
+    PlayerTracker();
+    explicit PlayerTracker(const Config& config);
+
+    // Scheduling - call once per frame after predict(), in order, so the
+    // decision sees every earlier frame's update
+    bool scheduleDetection();
+    // What scheduleDetection() would return for the next frame; no side effects
+    bool detectionDue() const;
+
+    // Per-frame processing - predict every frame, then update on keyframes.
+    // Association is optimal for up to AssignmentWorkspace::kMaxSize tracks
+    // and detections; anything beyond that is matched greedily by IoU
+    void predict();
+    void update(const std::vector<PlayerPosition>& detections);
+    std::vector<PlayerPosition> currentPlayers() const;
+
+    // State
+    const std::vector<PlayerTrack>& tracks() const { return m_tracks; }
+    double averageConfidence() const;
+    void setConfig(const Config& config);
+    const Config& config() const { return m_config; }
+    void reset();
+
+    // Statistics
+    int getDetectorInvocations() const { return m_detector_invocations; }
+    int getSkippedDetections() const { return m_skipped_detections; }
+
+private:
+    Config m_config;
+    std::vector<PlayerTrack> m_tracks;
+    int m_next_id = 0;
+    int m_frames_since_detection = 0;
+    int m_detector_invocations = 0;
+    int m_skipped_detections = 0;
+    bool m_warned_assignment_cap = false;
+
+    cv::Rect detectionBox(const PlayerPosition& detection) const;
+};
+
+} // namespace sports
+} // namespace amt
+
+#endif // PLAYER_TRACKER_H
@@ -166,15 +166,5 @@ std::vector<std::string> SportsAnalysisCore::generateCoachingInsights(const Form
     return insights;
 }
 
-void SportsAnalysisCore::exportCoachingClip(double start_time, double end_time) {
-    std::cout << "[Coaching Export] Creating clip: " 
-              << start_time << "s to " << end_time << "s" << std::endl;
-    
-    // TODO: Integrate with Olive's video export system
-    // Export with Triangle Defense annotations and insights
-    
-    std::cout << "[Coaching Export] Clip ready for coaching presentation" << std::endl;
-}
-
 } // namespace sports  
 } // namespace amt
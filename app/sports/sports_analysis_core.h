@@ -63,7 +63,6 @@ public:
     
     // Coaching Tools
     std::vector<std::string> generateCoachingInsights(const FormationData& formation);
-    void exportCoachingClip(double start_time, double end_time);
     
 private:
     class Impl;
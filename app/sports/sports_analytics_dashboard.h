@@ -32,6 +32,7 @@
 #include <QButtonGroup>
 #include <QTimer>
 #include <QMutex>
+#include <QHash>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
 #include <QNetworkReply>
@@ -46,6 +47,7 @@
 #include <QScatterSeries>
 #include <QPieSeries>
 #include <QAreaSeries>
+#include <QXYSeries>
 #include <QValueAxis>
 #include <QCategoryAxis>
 #include <QDateTimeAxis>
@@ -54,6 +56,8 @@
 #include <QWebChannel>
 #include <QJSEngine>
 
+#include "chart_decimation.h"
+#include "sports_analytics_engine.h"
 #include "triangle_defense_sync.h"
 #include "video_timeline_sync.h"
 #include "superset_panel_integration.h"
@@ -460,6 +464,12 @@ private:
   void ConfigureChartAxes(QChart* chart, const QJsonObject& config);
   void SetupChartInteractivity(QChartView* chart_view);
   
+  QVector<QPointF> ChartPoints(const QJsonArray& data, const QString& x_field, const QString& y_field) const;
+  void AttachDecimation(QChart* chart, QXYSeries* series, const DashboardWidget& widget,
+                        const QJsonArray& data, ChartDecimator::Method method);
+  void FitChartAxes(QXYSeries* series);
+  void DecimateSeries(QXYSeries* series);
+  
   QJsonArray QueryFormationData(const AnalyticsQuery& query);
   QJsonArray QueryTriangleDefenseData(const AnalyticsQuery& query);
   QJsonArray QueryMELData(const AnalyticsQuery& query);
@@ -467,6 +477,11 @@ private:
   QJsonArray QueryHistoricalData(const AnalyticsQuery& query);
   QJsonArray QuerySupersetData(const AnalyticsQuery& query);
   
+  AnalyticsQuery BuildWidgetQuery(const DashboardWidget& widget) const;
+  bool SourceRevision(AnalyticsDataSource source, quint64* revision) const;
+  QByteArray QueryCacheKey(const AnalyticsQuery& query) const;
+  AnalyticsResultCache::Dependency QueryDependency(const AnalyticsQuery& query) const;
+  
   void ProcessRealTimeData(const QJsonObject& data);
   void UpdateDashboardMetrics();
   void CalculateAdvancedMetrics();
@@ -547,6 +562,17 @@ private:
   QMap<QString, QChart*> charts_;
   QMap<QString, QWidget*> widgets_;
   
+  // Full-resolution points behind each line, area and scatter series; the
+  // series itself only holds what the current zoom and plot size can show
+  struct DecimatedSeries {
+    QChart* chart;
+    QVector<QPointF> points;
+    QString x_field;
+    QString y_field;
+    ChartDecimator::Method method;
+  };
+  QHash<QXYSeries*, DecimatedSeries> decimated_series_;
+  
   // Real-time metrics
   mutable QMutex metrics_mutex_;
   QMap<QString, RealTimeMetrics> real_time_metrics_;
@@ -559,6 +585,11 @@ private:
   QMap<QString, QJsonArray> cached_data_;
   QMap<AnalyticsDataSource, bool> data_source_status_;
   
+  // Local rollups behind the formation, Triangle Defense and M.E.L. queries
+  SportsAnalyticsEngine aggregation_engine_;
+  QMap<QString, quint64> widget_revisions_;
+  AnalyticsResultCache query_cache_;
+  
   // Superset integration
   SupersetIntegration superset_config_;
   QNetworkAccessManager* network_manager_;
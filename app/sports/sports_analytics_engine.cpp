@@ -0,0 +1,731 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Sports Analytics Engine Implementation
+***/
+
+#include "sports_analytics_engine.h"
+
+#include <QDateTime>
+#include <QtMath>
+
+namespace olive {
+
+namespace {
+
+const char* const kQuarterNames[] = {"unknown", "Q1", "Q2", "Q3", "Q4", "OT"};
+const char* const kFormationTypeNames[] = {"Larry", "Linda", "Rita", "Ricky", "Randy", "Pat", "Unknown"};
+const char* const kTriangleCallNames[] = {"strong_side", "weak_side", "middle_hash", "left_hash",
+                                          "right_hash", "red_zone", "goal_line", "no_call"};
+const char* const kMELStageNames[] = {"making", "efficiency", "logical", "combined"};
+
+// Context values may sit in field_context or at the top level of an event
+QJsonValue ContextValue(const QJsonObject& context, const QJsonObject& fallback, const char* key)
+{
+  QJsonValue value = context.value(key);
+  return value.isUndefined() ? fallback.value(key) : value;
+}
+
+int QuarterIndex(const QJsonValue& value)
+{
+  int quarter = value.toInt();
+  return quarter <= 0 ? 0 : qMin(quarter, SportsAnalyticsEngine::kQuarterCount - 1);
+}
+
+int DownIndex(const QJsonValue& value)
+{
+  int down = value.toInt();
+  return (down >= 1 && down < SportsAnalyticsEngine::kDownCount) ? down : 0;
+}
+
+int ConfidenceBin(double confidence)
+{
+  int bin = static_cast<int>(confidence * SportsAnalyticsEngine::kConfidenceBins);
+  return qBound(0, bin, SportsAnalyticsEngine::kConfidenceBins - 1);
+}
+
+// Kafka events carry enums as ints, Supabase rows as names
+template<typename Enum, int Count>
+Enum EnumFromJson(const QJsonValue& value, const char* const (&names)[Count], Enum fallback)
+{
+  if (value.isDouble()) {
+    int index = value.toInt();
+    return (index >= 0 && index < Count) ? static_cast<Enum>(index) : fallback;
+  }
+
+  QString name = value.toString();
+  for (int i = 0; i < Count; i++) {
+    if (name.compare(names[i], Qt::CaseInsensitive) == 0) {
+      return static_cast<Enum>(i);
+    }
+  }
+  return fallback;
+}
+
+} // namespace
+
+void SportsAnalyticsEngine::Moments::Add(double value, int sign)
+{
+  count += sign;
+  sum += sign * value;
+  sum_squares += sign * value * value;
+}
+
+QJsonObject SportsAnalyticsEngine::Moments::ToJson() const
+{
+  QJsonObject object;
+  object["count"] = count;
+  if (count > 0) {
+    double mean = sum / count;
+    object["mean"] = mean;
+    object["stddev"] = qSqrt(qMax(0.0, sum_squares / count - mean * mean));
+  }
+  return object;
+}
+
+SportsAnalyticsEngine::SportsAnalyticsEngine()
+  : call_counts_(kDownCount * kDistanceBucketCount * kTriangleCallCount, 0)
+  , events_ingested_(0)
+  , rows_updated_(0)
+{
+  for (auto& quarter : quarter_counts_) {
+    quarter.fill(0);
+  }
+  for (auto& histogram : confidence_histogram_) {
+    histogram.fill(0);
+  }
+  alert_priority_counts_.fill(0);
+  revisions_.fill(0);
+}
+
+AnalyticsChange SportsAnalyticsEngine::IngestFormation(const FormationData& formation)
+{
+  AnalyticsChange change;
+  if (formation.formation_id.isEmpty()) {
+    return change;
+  }
+
+  QMutexLocker locker(&mutex_);
+
+  // A replaced row also changes results around where it used to be
+  auto existing = row_by_id_.constFind(formation.formation_id);
+  if (existing != row_by_id_.constEnd()) {
+    change.Touch(kFormationTable, video_timestamp_[existing.value()]);
+    if (has_mel_[existing.value()]) {
+      change.Touch(kMELTable, video_timestamp_[existing.value()]);
+    }
+  }
+
+  int row = UpsertRow(formation.formation_id);
+
+  const QJsonObject& context = formation.field_context;
+  video_timestamp_[row] = formation.video_timestamp;
+  detection_timestamp_[row] = formation.detection_timestamp;
+  type_[row] = static_cast<qint8>(formation.type);
+  call_[row] = static_cast<qint8>(formation.recommended_call);
+  quarter_[row] = QuarterIndex(context.value("quarter"));
+  down_[row] = DownIndex(context.value("down"));
+  distance_bucket_[row] = DistanceBucket(context.contains("distance") ? context.value("distance").toDouble() : -1.0);
+  confidence_[row] = formation.confidence;
+
+  // Formations fetched with their scores already carry M.E.L. results
+  auto pending = pending_mel_.find(formation.formation_id);
+  const MELResult* mel = nullptr;
+  if (pending != pending_mel_.end()) {
+    mel = &pending.value();
+  } else if (formation.mel_results.processing_timestamp > 0 || formation.mel_results.combined_score > 0.0) {
+    mel = &formation.mel_results;
+  }
+  if (mel) {
+    has_mel_[row] = true;
+    mel_[row] = {static_cast<float>(mel->making_score), static_cast<float>(mel->efficiency_score),
+                 static_cast<float>(mel->logical_score), static_cast<float>(mel->combined_score)};
+  }
+  if (pending != pending_mel_.end()) {
+    pending_mel_.erase(pending);
+  }
+
+  rows_by_time_.insert(formation.video_timestamp, row);
+  Accumulate(row, 1);
+
+  events_ingested_++;
+  revisions_[kFormationTable]++;
+  change.Touch(kFormationTable, formation.video_timestamp);
+  if (has_mel_[row]) {
+    revisions_[kMELTable]++;
+    change.Touch(kMELTable, formation.video_timestamp);
+  }
+  return change;
+}
+
+AnalyticsChange SportsAnalyticsEngine::IngestMELResult(const QString& formation_id, const MELResult& results)
+{
+  QMutexLocker locker(&mutex_);
+
+  AnalyticsChange change;
+  events_ingested_++;
+
+  auto it = row_by_id_.constFind(formation_id);
+  if (it == row_by_id_.constEnd()) {
+    pending_mel_.insert(formation_id, results);
+    return change;
+  }
+
+  int row = it.value();
+  Accumulate(row, -1);
+  has_mel_[row] = true;
+  mel_[row] = {static_cast<float>(results.making_score), static_cast<float>(results.efficiency_score),
+               static_cast<float>(results.logical_score), static_cast<float>(results.combined_score)};
+  Accumulate(row, 1);
+
+  rows_updated_++;
+  revisions_[kMELTable]++;
+  change.Touch(kMELTable, video_timestamp_[row]);
+  return change;
+}
+
+AnalyticsChange SportsAnalyticsEngine::IngestEvent(const QJsonObject& event)
+{
+  AnalyticsChange change;
+
+  if (event.contains("alert_type")) {
+    QMutexLocker locker(&mutex_);
+
+    int priority = event.contains("priority_level") ? event.value("priority_level").toInt()
+                                                    : event.value("priority").toInt();
+    alert_type_counts_[event.value("alert_type").toString()]++;
+    alert_priority_counts_[qBound(0, priority, kAlertPriorityCount - 1)]++;
+
+    events_ingested_++;
+    revisions_[kAlertTable]++;
+    if (event.contains("video_timestamp")) {
+      change.Touch(kAlertTable, event.value("video_timestamp").toVariant().toLongLong());
+    } else {
+      change.TouchAll(kAlertTable);
+    }
+    return change;
+  }
+
+  QString formation_id = event.value("formation_id").toString();
+  if (formation_id.isEmpty()) {
+    formation_id = event.value("id").toString();
+  }
+  if (formation_id.isEmpty()) {
+    return change;
+  }
+
+  FormationData formation;
+  formation.formation_id = formation_id;
+  formation.type = EnumFromJson(event.contains("type") ? event.value("type") : event.value("formation_type"),
+                                kFormationTypeNames, FormationType::Unknown);
+  formation.recommended_call = EnumFromJson(event.value("recommended_call"), kTriangleCallNames,
+                                            TriangleCall::NoCall);
+  formation.confidence = event.value("confidence").toDouble();
+  formation.video_timestamp = event.value("video_timestamp").toVariant().toLongLong();
+  formation.detection_timestamp = event.value("detection_timestamp").toVariant().toLongLong();
+
+  // Situation fields are usually sent alongside rather than inside field_context
+  QJsonObject context = event.value("field_context").toObject();
+  for (const char* key : {"quarter", "down", "distance"}) {
+    QJsonValue value = ContextValue(context, event, key);
+    if (!value.isUndefined()) {
+      context[key] = value;
+    }
+  }
+  formation.field_context = context;
+
+  if (event.contains("mel_results")) {
+    QJsonObject mel = event.value("mel_results").toObject();
+    formation.mel_results.making_score = mel.value("making_score").toDouble();
+    formation.mel_results.efficiency_score = mel.value("efficiency_score").toDouble();
+    formation.mel_results.logical_score = mel.value("logical_score").toDouble();
+    formation.mel_results.combined_score = mel.value("combined_score").toDouble();
+    formation.mel_results.processing_timestamp = qMax<qint64>(1, formation.detection_timestamp);
+  }
+
+  return IngestFormation(formation);
+}
+
+void SportsAnalyticsEngine::Clear()
+{
+  QMutexLocker locker(&mutex_);
+
+  id_.clear();
+  video_timestamp_.clear();
+  detection_timestamp_.clear();
+  type_.clear();
+  call_.clear();
+  quarter_.clear();
+  down_.clear();
+  distance_bucket_.clear();
+  confidence_.clear();
+  has_mel_.clear();
+  mel_.clear();
+  row_by_id_.clear();
+  rows_by_time_.clear();
+  pending_mel_.clear();
+
+  for (auto& quarter : quarter_counts_) {
+    quarter.fill(0);
+  }
+  for (auto& histogram : confidence_histogram_) {
+    histogram.fill(0);
+  }
+  type_confidence_.fill(Moments());
+  call_counts_.fill(0);
+  mel_stages_.fill(Moments());
+  mel_by_type_.fill(Moments());
+  alert_type_counts_.clear();
+  alert_priority_counts_.fill(0);
+
+  for (quint64& revision : revisions_) {
+    revision++;
+  }
+}
+
+QJsonArray SportsAnalyticsEngine::FormationCountsByQuarter() const
+{
+  QMutexLocker locker(&mutex_);
+
+  QJsonArray results;
+  for (int quarter = 0; quarter < kQuarterCount; quarter++) {
+    for (int type = 0; type < kFormationTypeCount; type++) {
+      if (qint64 count = quarter_counts_[quarter][type]) {
+        QJsonObject entry;
+        entry["quarter"] = kQuarterNames[quarter];
+        entry["formation_type"] = kFormationTypeNames[type];
+        entry["count"] = count;
+        results.append(entry);
+      }
+    }
+  }
+  return results;
+}
+
+QJsonArray SportsAnalyticsEngine::FormationTypeSummary() const
+{
+  QMutexLocker locker(&mutex_);
+
+  QJsonArray results;
+  for (int type = 0; type < kFormationTypeCount; type++) {
+    const Moments& moments = type_confidence_[type];
+    if (moments.count > 0) {
+      QJsonObject entry = moments.ToJson();
+      entry["formation_type"] = kFormationTypeNames[type];
+      results.append(entry);
+    }
+  }
+  return results;
+}
+
+QJsonArray SportsAnalyticsEngine::ConfidenceHistogram(int formation_type) const
+{
+  QMutexLocker locker(&mutex_);
+
+  std::array<qint64, kConfidenceBins> bins{};
+  for (int type = 0; type < kFormationTypeCount; type++) {
+    if (formation_type < 0 || formation_type == type) {
+      for (int bin = 0; bin < kConfidenceBins; bin++) {
+        bins[bin] += confidence_histogram_[type][bin];
+      }
+    }
+  }
+
+  QJsonArray results;
+  for (int bin = 0; bin < kConfidenceBins; bin++) {
+    QJsonObject entry;
+    entry["bin_start"] = static_cast<double>(bin) / kConfidenceBins;
+    entry["bin_end"] = static_cast<double>(bin + 1) / kConfidenceBins;
+    entry["count"] = bins[bin];
+    results.append(entry);
+  }
+  return results;
+}
+
+QJsonArray SportsAnalyticsEngine::CallFrequencyByDownDistance() const
+{
+  QMutexLocker locker(&mutex_);
+
+  QJsonArray results;
+  for (int down = 0; down < kDownCount; down++) {
+    for (int bucket = 0; bucket < kDistanceBucketCount; bucket++) {
+      qint64 situation_total = 0;
+      for (int call = 0; call < kTriangleCallCount; call++) {
+        situation_total += call_counts_[CallIndex(down, bucket, call)];
+      }
+
+      for (int call = 0; call < kTriangleCallCount && situation_total > 0; call++) {
+        if (qint64 count = call_counts_[CallIndex(down, bucket, call)]) {
+          QJsonObject entry;
+          entry["down"] = down;
+          entry["distance"] = DistanceBucketName(bucket);
+          entry["call"] = kTriangleCallNames[call];
+          entry["count"] = count;
+          entry["frequency"] = static_cast<double>(count) / situation_total;
+          results.append(entry);
+        }
+      }
+    }
+  }
+  return results;
+}
+
+QJsonArray SportsAnalyticsEngine::CallTotals() const
+{
+  QMutexLocker locker(&mutex_);
+
+  std::array<qint64, kTriangleCallCount> totals{};
+  for (int i = 0; i < call_counts_.size(); i++) {
+    totals[i % kTriangleCallCount] += call_counts_[i];
+  }
+
+  QJsonArray results;
+  for (int call = 0; call < kTriangleCallCount; call++) {
+    if (totals[call] > 0) {
+      QJsonObject entry;
+      entry["call"] = kTriangleCallNames[call];
+      entry["count"] = totals[call];
+      results.append(entry);
+    }
+  }
+  return results;
+}
+
+QJsonArray SportsAnalyticsEngine::MELStageSummary() const
+{
+  QMutexLocker locker(&mutex_);
+
+  QJsonArray results;
+  for (int stage = 0; stage < kMELStageCount; stage++) {
+    QJsonObject entry = mel_stages_[stage].ToJson();
+    entry["stage"] = kMELStageNames[stage];
+    results.append(entry);
+  }
+  return results;
+}
+
+QJsonArray SportsAnalyticsEngine::MELByFormationType() const
+{
+  QMutexLocker locker(&mutex_);
+
+  QJsonArray results;
+  for (int type = 0; type < kFormationTypeCount; type++) {
+    if (mel_by_type_[type].count > 0) {
+      QJsonObject entry = mel_by_type_[type].ToJson();
+      entry["formation_type"] = kFormationTypeNames[type];
+      results.append(entry);
+    }
+  }
+  return results;
+}
+
+QJsonArray SportsAnalyticsEngine::AlertCounts() const
+{
+  QMutexLocker locker(&mutex_);
+
+  QJsonArray results;
+  for (auto it = alert_type_counts_.constBegin(); it != alert_type_counts_.constEnd(); ++it) {
+    QJsonObject entry;
+    entry["alert_type"] = it.key();
+    entry["count"] = it.value();
+    results.append(entry);
+  }
+  for (int priority = 0; priority < kAlertPriorityCount; priority++) {
+    if (alert_priority_counts_[priority] > 0) {
+      QJsonObject entry;
+      entry["priority_level"] = priority;
+      entry["count"] = alert_priority_counts_[priority];
+      results.append(entry);
+    }
+  }
+  return results;
+}
+
+QJsonArray SportsAnalyticsEngine::FormationRows(qint64 start_timestamp, qint64 end_timestamp, int limit) const
+{
+  QMutexLocker locker(&mutex_);
+
+  QJsonArray results;
+  for (auto it = rows_by_time_.lowerBound(start_timestamp);
+       it != rows_by_time_.constEnd() && it.key() <= end_timestamp; ++it) {
+    if (limit >= 0 && results.size() >= limit) {
+      break;
+    }
+    results.append(RowToJson(it.value()));
+  }
+  return results;
+}
+
+QJsonArray SportsAnalyticsEngine::FormationRowsDetectedSince(qint64 detection_timestamp, int limit) const
+{
+  QMutexLocker locker(&mutex_);
+
+  // Detection time is not indexed; check its column in video time order
+  QJsonArray results;
+  for (auto it = rows_by_time_.constBegin(); it != rows_by_time_.constEnd(); ++it) {
+    if (limit >= 0 && results.size() >= limit) {
+      break;
+    }
+    if (detection_timestamp_[it.value()] >= detection_timestamp) {
+      results.append(RowToJson(it.value()));
+    }
+  }
+  return results;
+}
+
+quint64 SportsAnalyticsEngine::Revision(Table table) const
+{
+  QMutexLocker locker(&mutex_);
+  return revisions_[table];
+}
+
+int SportsAnalyticsEngine::FormationCount() const
+{
+  QMutexLocker locker(&mutex_);
+  return id_.size();
+}
+
+QJsonObject SportsAnalyticsEngine::Statistics() const
+{
+  QMutexLocker locker(&mutex_);
+
+  QJsonObject stats;
+  stats["formation_rows"] = id_.size();
+  stats["pending_mel_results"] = pending_mel_.size();
+  stats["events_ingested"] = events_ingested_;
+  stats["rows_updated"] = rows_updated_;
+  stats["formation_revision"] = static_cast<qint64>(revisions_[kFormationTable]);
+  stats["mel_revision"] = static_cast<qint64>(revisions_[kMELTable]);
+  stats["alert_revision"] = static_cast<qint64>(revisions_[kAlertTable]);
+  return stats;
+}
+
+int SportsAnalyticsEngine::DistanceBucket(double yards_to_go)
+{
+  if (yards_to_go < 0) {
+    return 0;
+  } else if (yards_to_go <= 3) {
+    return 1;
+  } else if (yards_to_go <= 6) {
+    return 2;
+  }
+  return 3;
+}
+
+QString SportsAnalyticsEngine::DistanceBucketName(int bucket)
+{
+  switch (bucket) {
+    case 1: return "short";
+    case 2: return "medium";
+    case 3: return "long";
+    default: return "unknown";
+  }
+}
+
+int SportsAnalyticsEngine::UpsertRow(const QString& formation_id)
+{
+  // Requires mutex_
+  auto it = row_by_id_.constFind(formation_id);
+  if (it != row_by_id_.constEnd()) {
+    int row = it.value();
+    Accumulate(row, -1);
+    rows_by_time_.remove(video_timestamp_[row], row);
+
+    rows_updated_++;
+    revisions_[kFormationTable]++;
+    if (has_mel_[row]) {
+      revisions_[kMELTable]++;
+    }
+    return row;
+  }
+
+  int row = id_.size();
+  id_.append(formation_id);
+  video_timestamp_.append(0);
+  detection_timestamp_.append(0);
+  type_.append(static_cast<qint8>(FormationType::Unknown));
+  call_.append(static_cast<qint8>(TriangleCall::NoCall));
+  quarter_.append(0);
+  down_.append(0);
+  distance_bucket_.append(0);
+  confidence_.append(0.0f);
+  has_mel_.append(false);
+  mel_.append(std::array<float, kMELStageCount>{});
+  row_by_id_.insert(formation_id, row);
+  return row;
+}
+
+void SportsAnalyticsEngine::Accumulate(int row, int sign)
+{
+  // Requires mutex_
+  int type = type_[row];
+
+  quarter_counts_[quarter_[row]][type] += sign;
+  confidence_histogram_[type][ConfidenceBin(confidence_[row])] += sign;
+  type_confidence_[type].Add(confidence_[row], sign);
+  call_counts_[CallIndex(down_[row], distance_bucket_[row], call_[row])] += sign;
+
+  if (has_mel_[row]) {
+    for (int stage = 0; stage < kMELStageCount; stage++) {
+      mel_stages_[stage].Add(mel_[row][stage], sign);
+    }
+    mel_by_type_[type].Add(mel_[row][kMELStageCount - 1], sign);
+  }
+}
+
+QJsonObject SportsAnalyticsEngine::RowToJson(int row) const
+{
+  // Requires mutex_
+  QJsonObject object;
+  object["formation_id"] = id_[row];
+  object["video_timestamp"] = video_timestamp_[row];
+  object["detection_timestamp"] = detection_timestamp_[row];
+  object["formation_type"] = kFormationTypeNames[type_[row]];
+  object["recommended_call"] = kTriangleCallNames[call_[row]];
+  object["confidence"] = confidence_[row];
+  object["quarter"] = kQuarterNames[quarter_[row]];
+  object["down"] = down_[row];
+  object["distance"] = DistanceBucketName(distance_bucket_[row]);
+  if (has_mel_[row]) {
+    object["mel_combined_score"] = mel_[row][kMELStageCount - 1];
+  }
+  return object;
+}
+
+int SportsAnalyticsEngine::CallIndex(int down, int distance_bucket, int call)
+{
+  return (down * kDistanceBucketCount + distance_bucket) * kTriangleCallCount + call;
+}
+
+AnalyticsResultCache::AnalyticsResultCache(int max_entries)
+  : max_entries_(max_entries)
+  , use_clock_(0)
+  , hits_(0)
+  , misses_(0)
+  , invalidations_(0)
+  , expirations_(0)
+  , evictions_(0)
+{
+}
+
+bool AnalyticsResultCache::Lookup(const QByteArray& key, QJsonArray* results)
+{
+  QMutexLocker locker(&mutex_);
+
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    misses_++;
+    return false;
+  }
+
+  if (it->expires_at > 0 && it->expires_at <= QDateTime::currentMSecsSinceEpoch()) {
+    entries_.erase(it);
+    expirations_++;
+    misses_++;
+    return false;
+  }
+
+  it->last_used = ++use_clock_;
+  *results = it->results;
+  hits_++;
+  return true;
+}
+
+void AnalyticsResultCache::Insert(const QByteArray& key, const QJsonArray& results,
+                                  const Dependency& dependency, qint64 ttl_ms)
+{
+  QMutexLocker locker(&mutex_);
+
+  // Evict the least recently used entry; the cache is small enough to scan
+  if (!entries_.contains(key) && entries_.size() >= max_entries_) {
+    auto victim = entries_.begin();
+    for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+      if (it->last_used < victim->last_used) {
+        victim = it;
+      }
+    }
+    entries_.erase(victim);
+    evictions_++;
+  }
+
+  Entry entry;
+  entry.results = results;
+  entry.dependency = dependency;
+  entry.expires_at = ttl_ms > 0 ? QDateTime::currentMSecsSinceEpoch() + ttl_ms : 0;
+  entry.last_used = ++use_clock_;
+  entries_.insert(key, entry);
+}
+
+int AnalyticsResultCache::Invalidate(const AnalyticsChange& change)
+{
+  if (change.IsEmpty()) {
+    return 0;
+  }
+
+  QMutexLocker locker(&mutex_);
+
+  int removed = 0;
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    const Dependency& dependency = it->dependency;
+    if ((dependency.sources & change.tables) && dependency.start <= change.end && change.start <= dependency.end) {
+      it = entries_.erase(it);
+      removed++;
+    } else {
+      ++it;
+    }
+  }
+
+  invalidations_ += removed;
+  return removed;
+}
+
+int AnalyticsResultCache::InvalidateSources(quint32 sources)
+{
+  QMutexLocker locker(&mutex_);
+
+  int removed = 0;
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->dependency.sources & sources) {
+      it = entries_.erase(it);
+      removed++;
+    } else {
+      ++it;
+    }
+  }
+
+  invalidations_ += removed;
+  return removed;
+}
+
+void AnalyticsResultCache::Clear()
+{
+  QMutexLocker locker(&mutex_);
+  entries_.clear();
+}
+
+int AnalyticsResultCache::Size() const
+{
+  QMutexLocker locker(&mutex_);
+  return entries_.size();
+}
+
+QJsonObject AnalyticsResultCache::Statistics() const
+{
+  QMutexLocker locker(&mutex_);
+
+  qint64 lookups = hits_ + misses_;
+
+  QJsonObject stats;
+  stats["cached_queries"] = entries_.size();
+  stats["hits"] = hits_;
+  stats["misses"] = misses_;
+  stats["hit_ratio"] = lookups > 0 ? static_cast<double>(hits_) / lookups : 0.0;
+  stats["miss_ratio"] = lookups > 0 ? static_cast<double>(misses_) / lookups : 0.0;
+  stats["invalidations"] = invalidations_;
+  stats["expirations"] = expirations_;
+  stats["evictions"] = evictions_;
+  return stats;
+}
+
+} // namespace olive
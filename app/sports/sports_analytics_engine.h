@@ -0,0 +1,260 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Sports Analytics Engine
+  Columnar store, incremental rollups and result cache for the analytics dashboard
+***/
+
+#ifndef SPORTSANALYTICSENGINE_H
+#define SPORTSANALYTICSENGINE_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMultiMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+#include <array>
+#include <limits>
+
+#include "triangle_defense_sync.h"
+
+namespace olive {
+
+/**
+ * @brief Tables and video time span touched by one ingest
+ */
+struct AnalyticsChange {
+  quint32 tables = 0; // One bit per SportsAnalyticsEngine::Table
+  qint64 start = std::numeric_limits<qint64>::max();
+  qint64 end = std::numeric_limits<qint64>::min();
+
+  void Touch(int table, qint64 timestamp)
+  {
+    tables |= 1u << table;
+    start = qMin(start, timestamp);
+    end = qMax(end, timestamp);
+  }
+
+  // For data with no place on the video timeline
+  void TouchAll(int table)
+  {
+    Touch(table, std::numeric_limits<qint64>::min());
+    end = std::numeric_limits<qint64>::max();
+  }
+
+  bool IsEmpty() const { return tables == 0; }
+};
+
+/**
+ * @brief Local analytics over formations, Triangle Defense calls, M.E.L. results and alerts
+ *
+ * Formations are stored one column per field, and every rollup the
+ * dashboard reads is kept up to date as events arrive:
+ *  - formation counts per quarter and formation type
+ *  - confidence histograms per formation type
+ *  - call frequencies by down and distance
+ *  - M.E.L. stage and per-formation-type score moments
+ *  - alert counts by type and priority
+ *
+ * An ingest costs O(1) rollup work. Re-ingesting a formation first
+ * retracts its old contributions, so updates and late M.E.L. results
+ * keep the rollups exact. Reading a rollup is proportional to its own
+ * size and never rescans the rows. Each table has a revision counter, so
+ * callers can skip a refresh when nothing they read has changed.
+ *
+ * Quarter, down and distance are taken from the formation's field_context
+ * (or the top level of a real-time event); rows without them land in the
+ * "unknown" buckets. All methods are thread-safe.
+ */
+class SportsAnalyticsEngine
+{
+public:
+  enum Table {
+    kFormationTable,
+    kMELTable,
+    kAlertTable,
+    kTableCount
+  };
+
+  static constexpr int kQuarterCount = 6;      // Unknown, Q1-Q4, overtime
+  static constexpr int kDownCount = 5;         // Unknown, 1st-4th
+  static constexpr int kDistanceBucketCount = 4; // Unknown, short, medium, long
+  static constexpr int kConfidenceBins = 10;
+  static constexpr int kFormationTypeCount = static_cast<int>(FormationType::Unknown) + 1;
+  static constexpr int kTriangleCallCount = static_cast<int>(TriangleCall::NoCall) + 1;
+  static constexpr int kMELStageCount = 4;     // Making, efficiency, logical, combined
+  static constexpr int kAlertPriorityCount = 6;
+
+  SportsAnalyticsEngine();
+
+  SportsAnalyticsEngine(const SportsAnalyticsEngine&) = delete;
+  SportsAnalyticsEngine& operator=(const SportsAnalyticsEngine&) = delete;
+
+  /**
+   * @brief Insert a formation, or replace the row with the same formation_id
+   * @return Tables and time span whose query results may have changed
+   */
+  AnalyticsChange IngestFormation(const FormationData& formation);
+
+  /**
+   * @brief Attach M.E.L. results to a formation; held until the formation arrives
+   */
+  AnalyticsChange IngestMELResult(const QString& formation_id, const MELResult& results);
+
+  /**
+   * @brief Route a real-time event (formation detection or coaching alert)
+   * @return An empty change if the event carries nothing the engine aggregates
+   */
+  AnalyticsChange IngestEvent(const QJsonObject& event);
+
+  void Clear();
+
+  // Rollups
+  QJsonArray FormationCountsByQuarter() const;
+  QJsonArray FormationTypeSummary() const;
+  QJsonArray ConfidenceHistogram(int formation_type = -1) const;
+  QJsonArray CallFrequencyByDownDistance() const;
+  QJsonArray CallTotals() const;
+  QJsonArray MELStageSummary() const;
+  QJsonArray MELByFormationType() const;
+  QJsonArray AlertCounts() const;
+
+  /**
+   * @brief Formation rows with video_timestamp in [start, end], in time order
+   */
+  QJsonArray FormationRows(qint64 start_timestamp, qint64 end_timestamp, int limit = -1) const;
+
+  /**
+   * @brief Formation rows detected at or after a wall-clock time, in video time order
+   */
+  QJsonArray FormationRowsDetectedSince(qint64 detection_timestamp, int limit = -1) const;
+
+  quint64 Revision(Table table) const;
+  int FormationCount() const;
+  QJsonObject Statistics() const;
+
+  static int DistanceBucket(double yards_to_go);
+  static QString DistanceBucketName(int bucket);
+
+private:
+  // Running count, sum and sum of squares; unlike min/max these can be retracted
+  struct Moments {
+    qint64 count = 0;
+    double sum = 0.0;
+    double sum_squares = 0.0;
+
+    void Add(double value, int sign);
+    QJsonObject ToJson() const;
+  };
+
+  int UpsertRow(const QString& formation_id);
+  void Accumulate(int row, int sign);
+  QJsonObject RowToJson(int row) const;
+  static int CallIndex(int down, int distance_bucket, int call);
+
+  mutable QMutex mutex_;
+
+  // Formation table, one column per field
+  QVector<QString> id_;
+  QVector<qint64> video_timestamp_;
+  QVector<qint64> detection_timestamp_;
+  QVector<qint8> type_;
+  QVector<qint8> call_;
+  QVector<qint8> quarter_;
+  QVector<qint8> down_;
+  QVector<qint8> distance_bucket_;
+  QVector<float> confidence_;
+  QVector<bool> has_mel_;
+  QVector<std::array<float, kMELStageCount>> mel_;
+
+  QHash<QString, int> row_by_id_;
+  QMultiMap<qint64, int> rows_by_time_;
+  QHash<QString, MELResult> pending_mel_;
+
+  // Rollups
+  std::array<std::array<qint64, kFormationTypeCount>, kQuarterCount> quarter_counts_;
+  std::array<std::array<qint64, kConfidenceBins>, kFormationTypeCount> confidence_histogram_;
+  std::array<Moments, kFormationTypeCount> type_confidence_;
+  QVector<qint64> call_counts_;
+  std::array<Moments, kMELStageCount> mel_stages_;
+  std::array<Moments, kFormationTypeCount> mel_by_type_;
+  QHash<QString, qint64> alert_type_counts_;
+  std::array<qint64, kAlertPriorityCount> alert_priority_counts_;
+
+  std::array<quint64, kTableCount> revisions_;
+  qint64 events_ingested_;
+  qint64 rows_updated_;
+};
+
+/**
+ * @brief Analytics query results, invalidated by the data they were computed from
+ *
+ * Each entry is tagged with the tables it read and the video time span it
+ * covers. An ingest invalidates only the entries whose tables and span
+ * overlap the change, so a new formation at 12:30 leaves a cached query
+ * over the first quarter alone. Results that depend on something outside
+ * the engine (the wall clock, Superset datasets) also take an expiry.
+ *
+ * Keys are opaque; callers hash a normalized form of the query so that
+ * equivalent queries share one entry. All methods are thread-safe.
+ */
+class AnalyticsResultCache
+{
+public:
+  // Data the engine does not hold, e.g. Superset datasets
+  static constexpr quint32 kExternalSource = 1u << SportsAnalyticsEngine::kTableCount;
+
+  struct Dependency {
+    quint32 sources = 0; // Bits from AnalyticsChange::tables, or kExternalSource
+    qint64 start = std::numeric_limits<qint64>::min();
+    qint64 end = std::numeric_limits<qint64>::max();
+  };
+
+  explicit AnalyticsResultCache(int max_entries = 256);
+
+  bool Lookup(const QByteArray& key, QJsonArray* results);
+
+  /**
+   * @param ttl_ms Expiry for results that can go stale without an ingest; 0 for none
+   */
+  void Insert(const QByteArray& key, const QJsonArray& results, const Dependency& dependency, qint64 ttl_ms = 0);
+
+  /**
+   * @return Number of entries dropped
+   */
+  int Invalidate(const AnalyticsChange& change);
+  int InvalidateSources(quint32 sources);
+
+  void Clear();
+
+  int Size() const;
+  QJsonObject Statistics() const;
+
+private:
+  struct Entry {
+    QJsonArray results;
+    Dependency dependency;
+    qint64 expires_at;
+    quint64 last_used;
+  };
+
+  mutable QMutex mutex_;
+  QHash<QByteArray, Entry> entries_;
+  int max_entries_;
+  quint64 use_clock_;
+
+  qint64 hits_;
+  qint64 misses_;
+  qint64 invalidations_;
+  qint64 expirations_;
+  qint64 evictions_;
+};
+
+} // namespace olive
+
+#endif // SPORTSANALYTICSENGINE_H
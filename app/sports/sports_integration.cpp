@@ -21,8 +21,9 @@
 #include <QJsonParseError>
 #include <QMessageBox>
 #include <QProgressDialog>
-#include <QtConcurrent>
+#include <QUuid>
 
+#include "batch_analysis_scheduler.h"
 #include "video_timeline_sync.h"
 #include "formation_overlay.h"
 #include "coaching_alert_widget.h"
@@ -51,6 +52,7 @@ const QString SportsIntegrationConfig::HEALTH_CHECK_INTERVAL = "monitoring/healt
 const QString SportsIntegrationConfig::DATA_SYNC_INTERVAL = "sync/data_sync_interval";
 const QString SportsIntegrationConfig::CACHE_SIZE_LIMIT = "performance/cache_size_limit";
 const QString SportsIntegrationConfig::PROCESSING_TIMEOUT = "performance/processing_timeout";
+const QString SportsIntegrationConfig::BATCH_STAGE_CONCURRENCY = "performance/batch_stage_concurrency";
 
 SportsIntegration::SportsIntegration(QObject* parent)
   : QObject(parent)
@@ -73,6 +75,7 @@ SportsIntegration::SportsIntegration(QObject* parent)
   , stats_update_timer_(nullptr)
   , maintenance_timer_(nullptr)
   , max_concurrent_pipelines_(4)
+  , batch_scheduler_(nullptr)
   , error_recovery_timer_(nullptr)
   , consecutive_failures_(0)
   , automatic_recovery_enabled_(true)
@@ -99,6 +102,9 @@ SportsIntegration::SportsIntegration(QObject* parent)
   background_thread_->setObjectName("SportsIntegrationBackground");
   background_thread_->start();
   
+  // Setup scheduler for multi-video batch analysis
+  SetupBatchScheduler();
+  
   // Initialize network manager
   network_manager_ = new QNetworkAccessManager(this);
   
@@ -187,6 +193,11 @@ void SportsIntegration::Shutdown()
   // Stop monitoring
   StopComponentMonitoring();
 
+  // Drain batch analysis before tearing down the components its stages use
+  if (batch_scheduler_) {
+    batch_scheduler_->Clear();
+  }
+
   // Save configuration
   SaveConfiguration();
 
@@ -304,6 +315,29 @@ QString SportsIntegration::LoadVideoForAnalysis(const QString& video_path, const
     return QString();
   }
 
+  QString video_id = RegisterVideoSession(video_path);
+  if (video_id.isEmpty()) {
+    return QString();
+  }
+  active_video_id_ = video_id;
+
+  // Start video upload to MinIO
+  if (minio_client_) {
+    if (!StartVideoUpload(video_id, video_path, metadata)) {
+      qWarning() << "Failed to start video upload";
+      emit VideoLoadFailed(video_id, "Upload failed");
+      return QString();
+    }
+
+    UpdatePipelineStatus(video_id, ProcessingStage::VideoUpload, 10.0);
+  }
+
+  emit VideoLoadCompleted(video_id);
+  return video_id;
+}
+
+QString SportsIntegration::RegisterVideoSession(const QString& video_path)
+{
   QFileInfo file_info(video_path);
   if (!file_info.exists() || !file_info.isReadable()) {
     qWarning() << "Video file not accessible:" << video_path;
@@ -317,7 +351,6 @@ QString SportsIntegration::LoadVideoForAnalysis(const QString& video_path, const
   }
 
   QString video_id = SportsIntegrationUtils::GenerateVideoSessionId();
-  active_video_id_ = video_id;
 
   qInfo() << "Loading video for analysis:" << video_path << "ID:" << video_id;
   emit VideoLoadStarted(video_id);
@@ -333,25 +366,36 @@ QString SportsIntegration::LoadVideoForAnalysis(const QString& video_path, const
     active_pipelines_[video_id] = pipeline;
   }
 
-  // Start video upload to MinIO
-  if (minio_client_) {
-    QJsonObject upload_metadata = metadata;
-    upload_metadata["analysis_requested"] = true;
-    upload_metadata["video_session_id"] = video_id;
-    upload_metadata["upload_timestamp"] = QDateTime::currentMSecsSinceEpoch();
-
-    QString upload_id = minio_client_->UploadVideoFile(video_path, "videos", upload_metadata);
-    if (upload_id.isEmpty()) {
-      qWarning() << "Failed to start video upload";
-      emit VideoLoadFailed(video_id, "Upload failed");
-      return QString();
-    }
+  return video_id;
+}
 
-    UpdatePipelineStatus(video_id, ProcessingStage::VideoUpload, 10.0);
+bool SportsIntegration::StartVideoUpload(const QString& video_id, const QString& video_path, const QJsonObject& metadata)
+{
+  if (!minio_client_) {
+    return false;
   }
 
-  emit VideoLoadCompleted(video_id);
-  return video_id;
+  QJsonObject upload_metadata = metadata;
+  upload_metadata["analysis_requested"] = true;
+  upload_metadata["video_session_id"] = video_id;
+  upload_metadata["upload_timestamp"] = QDateTime::currentMSecsSinceEpoch();
+
+  // Batch uploads are mapped before they start, since starting can already
+  // report UploadFailed
+  QString upload_id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+  {
+    QMutexLocker locker(&pipeline_mutex_);
+    if (batch_video_paths_.contains(video_id)) {
+      batch_uploads_[upload_id] = video_id;
+    }
+  }
+  
+  if (minio_client_->UploadVideoFile(video_path, "videos", upload_metadata, upload_id).isEmpty()) {
+    QMutexLocker locker(&pipeline_mutex_);
+    batch_uploads_.remove(upload_id);
+    return false;
+  }
+  return true;
 }
 
 bool SportsIntegration::StartRealTimeAnalysis(const QString& video_id)
@@ -436,26 +480,24 @@ QString SportsIntegration::ProcessVideoBatch(const QString& video_path, Analysis
     return QString();
   }
 
-  QString video_id = LoadVideoForAnalysis(video_path);
+  QString video_id = RegisterVideoSession(video_path);
   if (video_id.isEmpty()) {
     return QString();
   }
 
-  qInfo() << "Starting batch processing for video:" << video_id << "mode:" << static_cast<int>(mode);
+  qInfo() << "Queueing batch processing for video:" << video_id << "mode:" << static_cast<int>(mode);
 
   current_analysis_mode_ = mode;
 
-  // Queue for batch processing
+  // The scheduler starts the upload once a network slot is free, alongside
+  // stages of every other queued video
   {
     QMutexLocker locker(&pipeline_mutex_);
-    processing_queue_.enqueue(video_id);
+    batch_video_paths_[video_id] = video_path;
   }
+  batch_scheduler_->Submit(video_id);
 
-  // Start processing pipeline in background
-  QtConcurrent::run(background_thread_, [this, video_id, mode]() {
-    ProcessVideoStage(video_id, ProcessingStage::MetadataExtraction);
-  });
-
+  emit VideoLoadCompleted(video_id);
   return video_id;
 }
 
@@ -469,11 +511,9 @@ PipelineStatus SportsIntegration::GetPipelineStatus(const QString& video_id) con
 {
   QMutexLocker locker(&pipeline_mutex_);
   
-  if (active_pipelines_.contains(video_id)) {
-    return active_pipelines_[video_id];
-  }
-  
-  return PipelineStatus();
+  PipelineStatus status = active_pipelines_.value(video_id);
+  status.stage_utilization = batch_scheduler_->Utilization();
+  return status;
 }
 
 QJsonObject SportsIntegration::GetIntegrationStatistics() const
@@ -491,6 +531,7 @@ QJsonObject SportsIntegration::GetIntegrationStatistics() const
   stats["integration_state"] = static_cast<int>(integration_state_);
   stats["real_time_analysis_active"] = real_time_analysis_active_;
   stats["active_pipelines"] = active_pipelines_.size();
+  stats["batch_scheduler"] = batch_scheduler_->Utilization();
   stats["component_status"] = QJsonObject();
   
   // Add component statistics
@@ -918,6 +959,18 @@ void SportsIntegration::ConnectComponentSignals()
   if (minio_client_) {
     connect(minio_client_, &MinIOClient::VideoUploaded,
             this, &SportsIntegration::OnVideoUploadCompleted);
+    connect(minio_client_, &MinIOClient::UploadFailed,
+            this, [this](const QString& operation_id, const QString& error) {
+              QString video_id;
+              {
+                QMutexLocker locker(&pipeline_mutex_);
+                video_id = batch_uploads_.take(operation_id);
+              }
+              if (!video_id.isEmpty()) {
+                qWarning() << "Batch video upload failed:" << video_id << error;
+                batch_scheduler_->FinishStage(video_id, ProcessingStage::VideoUpload, false);
+              }
+            });
     connect(minio_client_, &MinIOClient::Connected,
             this, [this]() { OnComponentStatusChanged("minio", true); });
     connect(minio_client_, &MinIOClient::Disconnected,
@@ -993,6 +1046,17 @@ void SportsIntegration::OnVideoUploadCompleted(const VideoMetadata& metadata)
 {
   qInfo() << "Video upload completed:" << metadata.file_id;
   
+  // Batch videos run their remaining stages through the scheduler
+  QString batch_video_id;
+  {
+    QMutexLocker locker(&pipeline_mutex_);
+    batch_video_id = batch_uploads_.take(metadata.file_id);
+  }
+  if (!batch_video_id.isEmpty()) {
+    batch_scheduler_->FinishStage(batch_video_id, ProcessingStage::VideoUpload, true);
+    return;
+  }
+  
   // Continue to next processing stage
   ProcessVideoStage(metadata.file_id, ProcessingStage::MetadataExtraction);
 }
@@ -1115,6 +1179,145 @@ void SportsIntegration::ProcessVideoStage(const QString& video_id, ProcessingSta
   }
 }
 
+void SportsIntegration::SetupBatchScheduler()
+{
+  batch_scheduler_ = new BatchAnalysisScheduler(this);
+  
+  // Concurrency overrides, e.g. {"formation_detection": 1, "network": 8}
+  QJsonObject caps = configuration_.value(SportsIntegrationConfig::BATCH_STAGE_CONCURRENCY).toObject();
+  const ProcessingStage stages[] = {
+    ProcessingStage::VideoUpload, ProcessingStage::MetadataExtraction, ProcessingStage::FormationDetection,
+    ProcessingStage::MELProcessing, ProcessingStage::DashboardSync
+  };
+  for (ProcessingStage stage : stages) {
+    QString name = BatchAnalysisScheduler::StageName(stage);
+    if (caps.contains(name)) {
+      batch_scheduler_->SetStageConcurrency(stage, caps.value(name).toInt());
+    }
+  }
+  for (int i = 0; i < BatchAnalysisScheduler::kResourceCount; i++) {
+    auto resource = static_cast<BatchAnalysisScheduler::Resource>(i);
+    QString name = BatchAnalysisScheduler::ResourceName(resource);
+    if (caps.contains(name)) {
+      batch_scheduler_->SetResourceConcurrency(resource, caps.value(name).toInt());
+    }
+  }
+  
+  batch_scheduler_->SetStageRunner([this](const QString& video_id, ProcessingStage stage) {
+    if (stage == ProcessingStage::VideoUpload) {
+      if (!minio_client_) {
+        // Storage not configured; analyze from the local file only
+        return BatchAnalysisScheduler::kStageSucceeded;
+      }
+      
+      // MinIOClient lives on this object's thread; completion arrives
+      // through OnVideoUploadCompleted or UploadFailed
+      QMetaObject::invokeMethod(this, [this, video_id]() {
+        QString video_path;
+        {
+          QMutexLocker locker(&pipeline_mutex_);
+          video_path = batch_video_paths_.value(video_id);
+        }
+        if (!StartVideoUpload(video_id, video_path, QJsonObject())) {
+          batch_scheduler_->FinishStage(video_id, ProcessingStage::VideoUpload, false);
+        }
+      }, Qt::QueuedConnection);
+      return BatchAnalysisScheduler::kStagePending;
+    }
+    
+    return RunBatchStage(video_id, stage) ? BatchAnalysisScheduler::kStageSucceeded
+                                          : BatchAnalysisScheduler::kStageFailed;
+  });
+  
+  connect(batch_scheduler_, &BatchAnalysisScheduler::StageStarted,
+          this, [this](const QString& video_id, ProcessingStage stage) {
+            {
+              QMutexLocker locker(&pipeline_mutex_);
+              if (!active_pipelines_.contains(video_id)) {
+                return;
+              }
+              PipelineStatus& pipeline = active_pipelines_[video_id];
+              pipeline.current_stage = stage;
+              pipeline.current_operation = QString("Running %1").arg(BatchAnalysisScheduler::StageName(stage));
+            }
+            emit ProcessingStageChanged(video_id, stage);
+          });
+  
+  connect(batch_scheduler_, &BatchAnalysisScheduler::StageFinished,
+          this, [this](const QString& video_id, ProcessingStage stage, bool success, const QJsonObject& metrics) {
+            QMutexLocker locker(&pipeline_mutex_);
+            if (!active_pipelines_.contains(video_id)) {
+              return;
+            }
+            PipelineStatus& pipeline = active_pipelines_[video_id];
+            QString name = BatchAnalysisScheduler::StageName(stage);
+            if (success) {
+              pipeline.completed_stages.append(name);
+            } else {
+              pipeline.failed_stages.append(name);
+            }
+            pipeline.stage_metrics[name] = metrics;
+            pipeline.completion_percentage = 100.0 * pipeline.completed_stages.size() / BatchAnalysisScheduler::kStageCount;
+          });
+  
+  connect(batch_scheduler_, &BatchAnalysisScheduler::VideoCompleted,
+          this, [this](const QString& video_id) {
+            {
+              QMutexLocker locker(&pipeline_mutex_);
+              batch_video_paths_.remove(video_id);
+            }
+            UpdatePipelineStatus(video_id, ProcessingStage::Complete, 100.0);
+            {
+              QMutexLocker locker(&stats_mutex_);
+              stats_.videos_processed++;
+            }
+            emit ProcessingCompleted(video_id);
+          });
+  
+  connect(batch_scheduler_, &BatchAnalysisScheduler::VideoFailed,
+          this, [this](const QString& video_id, ProcessingStage stage) {
+            {
+              QMutexLocker locker(&pipeline_mutex_);
+              batch_video_paths_.remove(video_id);
+            }
+            emit ProcessingFailed(video_id, QString("%1 failed").arg(BatchAnalysisScheduler::StageName(stage)));
+          });
+}
+
+bool SportsIntegration::RunBatchStage(const QString& video_id, ProcessingStage stage)
+{
+  // Runs on a scheduler pool thread
+  qDebug() << "Running batch stage:" << video_id << BatchAnalysisScheduler::StageName(stage);
+  
+  switch (stage) {
+    case ProcessingStage::MetadataExtraction: {
+      // Extract video metadata from the source file
+      QString video_path;
+      {
+        QMutexLocker locker(&pipeline_mutex_);
+        video_path = batch_video_paths_.value(video_id);
+      }
+      return QFileInfo(video_path).isReadable();
+    }
+      
+    case ProcessingStage::FormationDetection:
+      // Formation detection would be handled by Triangle Defense sync
+      return true;
+      
+    case ProcessingStage::MELProcessing:
+      // M.E.L. processing continues in background
+      return true;
+      
+    case ProcessingStage::DashboardSync:
+      // Sync with Superset dashboard
+      return true;
+      
+    default:
+      qWarning() << "Unsupported batch stage:" << static_cast<int>(stage);
+      return false;
+  }
+}
+
 void SportsIntegration::OptimizePerformance()
 {
   // Check memory usage and clean caches if necessary
@@ -1146,7 +1349,8 @@ void SportsIntegration::CleanupResources()
   {
     QMutexLocker locker(&pipeline_mutex_);
     active_pipelines_.clear();
-    processing_queue_.clear();
+    batch_video_paths_.clear();
+    batch_uploads_.clear();
   }
   
   component_status_.clear();
@@ -1184,6 +1388,7 @@ QJsonObject SportsIntegrationConfig::GetDefaultConfiguration()
   config[DATA_SYNC_INTERVAL] = 900000; // 15 minutes
   config[CACHE_SIZE_LIMIT] = 1073741824; // 1GB
   config[PROCESSING_TIMEOUT] = 300000; // 5 minutes
+  config[BATCH_STAGE_CONCURRENCY] = QJsonObject(); // Overrides keyed by stage or resource name
   
   return config;
 }
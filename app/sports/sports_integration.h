@@ -17,7 +17,6 @@
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QDateTime>
-#include <QQueue>
 #include <QMap>
 #include <QStringList>
 #include <QSettings>
@@ -31,6 +30,7 @@
 namespace olive {
 
 // Forward declarations
+class BatchAnalysisScheduler;
 class VideoTimelineSync;
 class FormationOverlay;
 class CoachingAlertWidget;
@@ -110,6 +110,7 @@ struct PipelineStatus {
   QStringList failed_stages;
   QString current_operation;
   QJsonObject stage_metrics;
+  QJsonObject stage_utilization; // Batch scheduler load per stage and resource, across all videos
   
   PipelineStatus() : current_stage(ProcessingStage::VideoUpload),
                      completion_percentage(0.0),
@@ -317,6 +318,10 @@ private:
   void UpdateSystemHealth();
   void UpdatePipelineStatus(const QString& video_id, ProcessingStage stage, double progress = 0.0);
   void ProcessVideoStage(const QString& video_id, ProcessingStage stage);
+  QString RegisterVideoSession(const QString& video_path);
+  bool StartVideoUpload(const QString& video_id, const QString& video_path, const QJsonObject& metadata);
+  void SetupBatchScheduler();
+  bool RunBatchStage(const QString& video_id, ProcessingStage stage);
   void HandleComponentError(const QString& component, const QString& error);
   void PerformAutomaticMaintenance();
   
@@ -362,9 +367,13 @@ private:
   // Pipeline tracking
   mutable QMutex pipeline_mutex_;
   QMap<QString, PipelineStatus> active_pipelines_;
-  QQueue<QString> processing_queue_;
   int max_concurrent_pipelines_;
   
+  // Batch analysis across many videos
+  BatchAnalysisScheduler* batch_scheduler_;
+  QMap<QString, QString> batch_video_paths_;
+  QMap<QString, QString> batch_uploads_; // MinIO upload id -> video id
+  
   // Statistics tracking
   mutable QMutex stats_mutex_;
   struct IntegrationStats {
@@ -443,6 +452,7 @@ public:
   static const QString DATA_SYNC_INTERVAL;
   static const QString CACHE_SIZE_LIMIT;
   static const QString PROCESSING_TIMEOUT;
+  static const QString BATCH_STAGE_CONCURRENCY;
 };
 
 /**
@@ -0,0 +1,148 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Sports Analytics Engine Tests
+***/
+
+#include "testutil.h"
+
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include "sports_analytics_engine.h"
+
+namespace olive {
+
+namespace {
+
+FormationData MakeFormation(const QString& id, FormationType type, double confidence,
+                            qint64 video_timestamp, int quarter)
+{
+  FormationData formation;
+  formation.formation_id = id;
+  formation.type = type;
+  formation.recommended_call = TriangleCall::StrongSide;
+  formation.confidence = confidence;
+  formation.video_timestamp = video_timestamp;
+  formation.detection_timestamp = 1700000000000LL + video_timestamp;
+  formation.field_context["quarter"] = quarter;
+  formation.field_context["down"] = 3;
+  formation.field_context["distance"] = 8;
+  return formation;
+}
+
+qint64 CountFor(const QJsonArray& rows, const QString& quarter, const QString& type)
+{
+  for (const QJsonValue& value : rows) {
+    QJsonObject row = value.toObject();
+    if (row["quarter"].toString() == quarter && row["formation_type"].toString() == type) {
+      return row["count"].toVariant().toLongLong();
+    }
+  }
+  return 0;
+}
+
+QJsonObject SummaryFor(const QJsonArray& rows, const QString& type)
+{
+  for (const QJsonValue& value : rows) {
+    if (value.toObject()["formation_type"].toString() == type) {
+      return value.toObject();
+    }
+  }
+  return QJsonObject();
+}
+
+} // namespace
+
+OLIVE_ADD_TEST(RollupsFollowIngests)
+{
+  SportsAnalyticsEngine engine;
+
+  engine.IngestFormation(MakeFormation("f1", FormationType::Larry, 0.8, 1000, 1));
+  engine.IngestFormation(MakeFormation("f2", FormationType::Larry, 0.6, 2000, 1));
+  engine.IngestFormation(MakeFormation("f3", FormationType::Rita, 0.9, 3000, 2));
+
+  QJsonArray quarters = engine.FormationCountsByQuarter();
+  OLIVE_ASSERT_EQUAL(CountFor(quarters, "Q1", "Larry"), 2);
+  OLIVE_ASSERT_EQUAL(CountFor(quarters, "Q2", "Rita"), 1);
+
+  QJsonObject larry = SummaryFor(engine.FormationTypeSummary(), "Larry");
+  OLIVE_ASSERT_EQUAL(larry["count"].toInt(), 2);
+  OLIVE_ASSERT(qAbs(larry["mean"].toDouble() - 0.7) < 1e-6);
+  OLIVE_ASSERT_EQUAL(engine.FormationCount(), 3);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(ReingestRetractsOldRow)
+{
+  SportsAnalyticsEngine engine;
+
+  engine.IngestFormation(MakeFormation("f1", FormationType::Larry, 0.8, 1000, 1));
+  quint64 revision = engine.Revision(SportsAnalyticsEngine::kFormationTable);
+
+  // Same formation reclassified and moved to the second quarter
+  AnalyticsChange change = engine.IngestFormation(MakeFormation("f1", FormationType::Ricky, 0.5, 5000, 2));
+  OLIVE_ASSERT(change.tables & (1u << SportsAnalyticsEngine::kFormationTable));
+  OLIVE_ASSERT_EQUAL(change.start, 1000);
+  OLIVE_ASSERT_EQUAL(change.end, 5000);
+  OLIVE_ASSERT(engine.Revision(SportsAnalyticsEngine::kFormationTable) > revision);
+
+  QJsonArray quarters = engine.FormationCountsByQuarter();
+  OLIVE_ASSERT_EQUAL(CountFor(quarters, "Q1", "Larry"), 0);
+  OLIVE_ASSERT_EQUAL(CountFor(quarters, "Q2", "Ricky"), 1);
+  OLIVE_ASSERT(SummaryFor(engine.FormationTypeSummary(), "Larry").isEmpty());
+  OLIVE_ASSERT_EQUAL(engine.FormationCount(), 1);
+
+  QJsonArray rows = engine.FormationRows(0, 10000);
+  OLIVE_ASSERT_EQUAL(rows.size(), 1);
+  OLIVE_ASSERT_EQUAL(rows[0].toObject()["video_timestamp"].toVariant().toLongLong(), 5000);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(LateMELResultsAttach)
+{
+  SportsAnalyticsEngine engine;
+
+  MELResult mel;
+  mel.making_score = 0.5;
+  mel.efficiency_score = 0.6;
+  mel.logical_score = 0.7;
+  mel.combined_score = 0.6;
+
+  // Results ahead of their formation are held until it arrives
+  AnalyticsChange held = engine.IngestMELResult("f1", mel);
+  OLIVE_ASSERT(held.IsEmpty());
+  OLIVE_ASSERT(SummaryFor(engine.MELByFormationType(), "Linda").isEmpty());
+
+  AnalyticsChange change = engine.IngestFormation(MakeFormation("f1", FormationType::Linda, 0.7, 1000, 1));
+  OLIVE_ASSERT(change.tables & (1u << SportsAnalyticsEngine::kMELTable));
+
+  QJsonObject linda = SummaryFor(engine.MELByFormationType(), "Linda");
+  OLIVE_ASSERT_EQUAL(linda["count"].toInt(), 1);
+  OLIVE_ASSERT(qAbs(linda["mean"].toDouble() - 0.6) < 1e-6);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(RowsInTimeOrder)
+{
+  SportsAnalyticsEngine engine;
+
+  engine.IngestFormation(MakeFormation("late", FormationType::Pat, 0.8, 9000, 4));
+  engine.IngestFormation(MakeFormation("early", FormationType::Pat, 0.8, 1000, 1));
+  engine.IngestFormation(MakeFormation("middle", FormationType::Pat, 0.8, 5000, 3));
+
+  QJsonArray rows = engine.FormationRows(0, 6000);
+  OLIVE_ASSERT_EQUAL(rows.size(), 2);
+  OLIVE_ASSERT(rows[0].toObject()["formation_id"].toString() == "early");
+  OLIVE_ASSERT(rows[1].toObject()["formation_id"].toString() == "middle");
+
+  OLIVE_ASSERT_EQUAL(engine.FormationRows(0, 10000, 1).size(), 1);
+
+  OLIVE_TEST_END;
+}
+
+}
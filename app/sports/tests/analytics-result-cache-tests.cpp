@@ -0,0 +1,74 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Analytics Result Cache Tests
+***/
+
+#include "testutil.h"
+
+#include <QJsonArray>
+
+#include "sports_analytics_engine.h"
+
+namespace olive {
+
+OLIVE_ADD_TEST(CacheInvalidatesOverlappingEntries)
+{
+  AnalyticsResultCache cache;
+
+  AnalyticsResultCache::Dependency first_quarter;
+  first_quarter.sources = 1u << SportsAnalyticsEngine::kFormationTable;
+  first_quarter.start = 0;
+  first_quarter.end = 900000;
+
+  AnalyticsResultCache::Dependency mel_only;
+  mel_only.sources = 1u << SportsAnalyticsEngine::kMELTable;
+
+  cache.Insert("first_quarter", QJsonArray{1}, first_quarter);
+  cache.Insert("mel", QJsonArray{2}, mel_only);
+
+  QJsonArray results;
+  OLIVE_ASSERT(cache.Lookup("first_quarter", &results));
+  OLIVE_ASSERT(results == QJsonArray{1});
+
+  // A formation late in the game leaves the first quarter alone
+  AnalyticsChange late;
+  late.Touch(SportsAnalyticsEngine::kFormationTable, 2000000);
+  OLIVE_ASSERT_EQUAL(cache.Invalidate(late), 0);
+  OLIVE_ASSERT(cache.Lookup("first_quarter", &results));
+
+  AnalyticsChange early;
+  early.Touch(SportsAnalyticsEngine::kFormationTable, 1000);
+  OLIVE_ASSERT_EQUAL(cache.Invalidate(early), 1);
+  OLIVE_ASSERT(!cache.Lookup("first_quarter", &results));
+  OLIVE_ASSERT(cache.Lookup("mel", &results));
+
+  OLIVE_ASSERT_EQUAL(cache.InvalidateSources(mel_only.sources), 1);
+  OLIVE_ASSERT_EQUAL(cache.Size(), 0);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(CacheEvictsLeastRecentlyUsed)
+{
+  AnalyticsResultCache cache(2);
+  AnalyticsResultCache::Dependency dependency;
+  dependency.sources = 1u << SportsAnalyticsEngine::kFormationTable;
+
+  cache.Insert("a", QJsonArray{1}, dependency);
+  cache.Insert("b", QJsonArray{2}, dependency);
+
+  QJsonArray results;
+  OLIVE_ASSERT(cache.Lookup("a", &results));
+  cache.Insert("c", QJsonArray{3}, dependency);
+
+  OLIVE_ASSERT_EQUAL(cache.Size(), 2);
+  OLIVE_ASSERT(cache.Lookup("a", &results));
+  OLIVE_ASSERT(!cache.Lookup("b", &results));
+  OLIVE_ASSERT(cache.Lookup("c", &results));
+
+  OLIVE_TEST_END;
+}
+
+}
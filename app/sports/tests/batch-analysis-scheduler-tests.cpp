@@ -0,0 +1,271 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Batch Analysis Scheduler Tests
+***/
+
+#include "testutil.h"
+
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QMutex>
+#include <QThread>
+#include <QTimer>
+
+#include <atomic>
+#include <functional>
+
+#include "batch_analysis_scheduler.h"
+
+namespace olive {
+
+namespace {
+
+/**
+ * @brief Thread-safe record of what the scheduler ran and reported
+ */
+class SchedulerLog
+{
+public:
+  explicit SchedulerLog(BatchAnalysisScheduler* scheduler)
+  {
+    // Signals arrive on pool threads
+    QObject::connect(scheduler, &BatchAnalysisScheduler::VideoCompleted, [this](const QString&) {
+      completed++;
+    });
+    QObject::connect(scheduler, &BatchAnalysisScheduler::VideoFailed,
+                     [this](const QString& video_id, ProcessingStage stage) {
+                       QMutexLocker locker(&mutex_);
+                       failures_.append(qMakePair(video_id, stage));
+                       failed++;
+                     });
+  }
+
+  void Ran(const QString& video_id, ProcessingStage stage)
+  {
+    QMutexLocker locker(&mutex_);
+    runs_.append(qMakePair(video_id, stage));
+  }
+
+  QList<QPair<QString, ProcessingStage>> Runs() const
+  {
+    QMutexLocker locker(&mutex_);
+    return runs_;
+  }
+
+  QList<QPair<QString, ProcessingStage>> Failures() const
+  {
+    QMutexLocker locker(&mutex_);
+    return failures_;
+  }
+
+  int IndexOf(const QString& video_id, ProcessingStage stage) const
+  {
+    return Runs().indexOf(qMakePair(video_id, stage));
+  }
+
+  std::atomic<int> completed{0};
+  std::atomic<int> failed{0};
+
+private:
+  mutable QMutex mutex_;
+  QList<QPair<QString, ProcessingStage>> runs_;
+  QList<QPair<QString, ProcessingStage>> failures_;
+};
+
+bool WaitFor(const std::function<bool()>& done, int timeout_ms)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  QEventLoop loop;
+  QTimer poll;
+  poll.setInterval(10);
+  QObject::connect(&poll, &QTimer::timeout, &loop, [&]() {
+    if (done() || timer.elapsed() > timeout_ms) {
+      loop.quit();
+    }
+  });
+  poll.start();
+  loop.exec();
+
+  return done();
+}
+
+} // namespace
+
+OLIVE_ADD_TEST(StagesRunAfterTheirDependencies)
+{
+  BatchAnalysisScheduler scheduler;
+  SchedulerLog log(&scheduler);
+  scheduler.SetStageRunner([&log](const QString& video_id, ProcessingStage stage) {
+    log.Ran(video_id, stage);
+    return BatchAnalysisScheduler::kStageSucceeded;
+  });
+
+  scheduler.Submit("game");
+  scheduler.Submit("practice");
+  scheduler.Submit("game");
+  OLIVE_ASSERT(WaitFor([&]() { return log.completed == 2; }, 5000));
+
+  for (const QString& video_id : {QString("game"), QString("practice")}) {
+    int upload = log.IndexOf(video_id, ProcessingStage::VideoUpload);
+    int metadata = log.IndexOf(video_id, ProcessingStage::MetadataExtraction);
+    int detection = log.IndexOf(video_id, ProcessingStage::FormationDetection);
+    int mel = log.IndexOf(video_id, ProcessingStage::MELProcessing);
+    int dashboard = log.IndexOf(video_id, ProcessingStage::DashboardSync);
+    OLIVE_ASSERT(upload >= 0 && metadata >= 0);
+    OLIVE_ASSERT(metadata < detection);
+    OLIVE_ASSERT(detection < mel);
+    OLIVE_ASSERT(mel < dashboard);
+    OLIVE_ASSERT(upload < dashboard);
+  }
+
+  // A duplicate submission does not run the graph twice
+  OLIVE_ASSERT_EQUAL(log.Runs().size(), 2 * BatchAnalysisScheduler::kStageCount);
+  OLIVE_ASSERT(!scheduler.Contains("game"));
+  OLIVE_ASSERT_EQUAL(scheduler.Utilization()["videos_completed"].toInt(), 2);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(FailedStageCancelsRestOfVideo)
+{
+  BatchAnalysisScheduler scheduler;
+  SchedulerLog log(&scheduler);
+  scheduler.SetStageRunner([&log](const QString& video_id, ProcessingStage stage) {
+    log.Ran(video_id, stage);
+    return stage == ProcessingStage::FormationDetection ? BatchAnalysisScheduler::kStageFailed
+                                                        : BatchAnalysisScheduler::kStageSucceeded;
+  });
+
+  scheduler.Submit("game");
+  OLIVE_ASSERT(WaitFor([&]() { return log.failed == 1 && !scheduler.Contains("game"); }, 5000));
+
+  OLIVE_ASSERT(log.Failures().first().second == ProcessingStage::FormationDetection);
+  OLIVE_ASSERT_EQUAL(log.IndexOf("game", ProcessingStage::MELProcessing), -1);
+  OLIVE_ASSERT_EQUAL(log.IndexOf("game", ProcessingStage::DashboardSync), -1);
+  OLIVE_ASSERT_EQUAL(log.completed.load(), 0);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(StageCapLimitsConcurrency)
+{
+  BatchAnalysisScheduler scheduler;
+  SchedulerLog log(&scheduler);
+  scheduler.SetStageConcurrency(ProcessingStage::FormationDetection, 1);
+
+  std::atomic<int> detecting{0};
+  std::atomic<int> most_detecting{0};
+  scheduler.SetStageRunner([&](const QString& video_id, ProcessingStage stage) {
+    log.Ran(video_id, stage);
+    if (stage == ProcessingStage::FormationDetection) {
+      int now = ++detecting;
+      int most = most_detecting;
+      while (now > most && !most_detecting.compare_exchange_weak(most, now)) {
+      }
+      QThread::msleep(20);
+      detecting--;
+    }
+    return BatchAnalysisScheduler::kStageSucceeded;
+  });
+
+  for (int i = 0; i < 4; i++) {
+    scheduler.Submit(QString("film_%1").arg(i));
+  }
+  OLIVE_ASSERT(WaitFor([&]() { return log.completed == 4; }, 10000));
+  OLIVE_ASSERT_EQUAL(most_detecting.load(), 1);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(PendingStageWaitsForFinishStage)
+{
+  BatchAnalysisScheduler scheduler;
+  SchedulerLog log(&scheduler);
+  scheduler.SetStageRunner([&log](const QString& video_id, ProcessingStage stage) {
+    log.Ran(video_id, stage);
+    return stage == ProcessingStage::VideoUpload ? BatchAnalysisScheduler::kStagePending
+                                                 : BatchAnalysisScheduler::kStageSucceeded;
+  });
+
+  scheduler.Submit("game");
+
+  // Everything but the dashboard sync can run while the upload is out
+  OLIVE_ASSERT(WaitFor([&]() { return log.IndexOf("game", ProcessingStage::MELProcessing) >= 0; }, 5000));
+  OLIVE_ASSERT(!WaitFor([&]() { return log.completed > 0; }, 100));
+  OLIVE_ASSERT_EQUAL(log.IndexOf("game", ProcessingStage::DashboardSync), -1);
+
+  scheduler.FinishStage("game", ProcessingStage::VideoUpload, true);
+  OLIVE_ASSERT(WaitFor([&]() { return log.completed == 1; }, 5000));
+  OLIVE_ASSERT(log.IndexOf("game", ProcessingStage::DashboardSync) >= 0);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(PendingStageTimesOut)
+{
+  BatchAnalysisScheduler scheduler;
+  SchedulerLog log(&scheduler);
+  scheduler.SetPendingTimeout(50);
+  scheduler.SetStageRunner([&log](const QString& video_id, ProcessingStage stage) {
+    log.Ran(video_id, stage);
+    return stage == ProcessingStage::VideoUpload ? BatchAnalysisScheduler::kStagePending
+                                                 : BatchAnalysisScheduler::kStageSucceeded;
+  });
+
+  scheduler.Submit("game");
+  OLIVE_ASSERT(WaitFor([&]() { return log.failed == 1; }, 5000));
+  OLIVE_ASSERT(log.Failures().first().second == ProcessingStage::VideoUpload);
+
+  // The upload reporting back after the timeout changes nothing
+  OLIVE_ASSERT(WaitFor([&]() { return !scheduler.Contains("game"); }, 5000));
+  scheduler.FinishStage("game", ProcessingStage::VideoUpload, true);
+  OLIVE_ASSERT(!WaitFor([&]() { return log.completed > 0; }, 100));
+  OLIVE_ASSERT_EQUAL(log.IndexOf("game", ProcessingStage::DashboardSync), -1);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(TimedOutUploadKeepsNetworkSlot)
+{
+  BatchAnalysisScheduler scheduler;
+  SchedulerLog log(&scheduler);
+  scheduler.SetResourceConcurrency(BatchAnalysisScheduler::kNetworkResource, 1);
+  scheduler.SetPendingTimeout(50);
+  scheduler.SetStageRunner([&log](const QString& video_id, ProcessingStage stage) {
+    log.Ran(video_id, stage);
+    return stage == ProcessingStage::VideoUpload ? BatchAnalysisScheduler::kStagePending
+                                                 : BatchAnalysisScheduler::kStageSucceeded;
+  });
+
+  auto network_running = [&scheduler]() {
+    return scheduler.Utilization()["resources"].toObject()["network"].toObject()["running"].toInt();
+  };
+
+  scheduler.Submit("film_0");
+  scheduler.Submit("film_1");
+  OLIVE_ASSERT(WaitFor([&]() { return log.failed == 1; }, 5000));
+  OLIVE_ASSERT(log.Failures().first() == qMakePair(QString("film_0"), ProcessingStage::VideoUpload));
+
+  // film_0's upload is still going, so film_1's cannot start beside it
+  scheduler.SetPendingTimeout(0);
+  OLIVE_ASSERT(!WaitFor([&]() { return log.IndexOf("film_1", ProcessingStage::VideoUpload) >= 0; }, 150));
+  OLIVE_ASSERT_EQUAL(network_running(), 1);
+
+  // Reporting back late frees the slot without reviving film_0
+  scheduler.FinishStage("film_0", ProcessingStage::VideoUpload, true);
+  OLIVE_ASSERT(WaitFor([&]() { return log.IndexOf("film_1", ProcessingStage::VideoUpload) >= 0; }, 5000));
+  OLIVE_ASSERT_EQUAL(network_running(), 1);
+
+  scheduler.FinishStage("film_1", ProcessingStage::VideoUpload, true);
+  OLIVE_ASSERT(WaitFor([&]() { return log.completed == 1; }, 5000));
+  OLIVE_ASSERT_EQUAL(log.IndexOf("film_0", ProcessingStage::DashboardSync), -1);
+  OLIVE_ASSERT_EQUAL(network_running(), 0);
+
+  OLIVE_TEST_END;
+}
+
+}
@@ -0,0 +1,76 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Chart Decimation Tests
+***/
+
+#include "testutil.h"
+
+#include "chart_decimation.h"
+
+namespace olive {
+
+namespace {
+
+ChartViewport MakeViewport(double x_max, double y_max, int width, int height)
+{
+  ChartViewport viewport;
+  viewport.x_min = 0.0;
+  viewport.x_max = x_max;
+  viewport.y_min = 0.0;
+  viewport.y_max = y_max;
+  viewport.pixel_width = width;
+  viewport.pixel_height = height;
+  return viewport;
+}
+
+} // namespace
+
+OLIVE_ADD_TEST(PixelGridKeepsTopEdgePoints)
+{
+  ChartViewport viewport = MakeViewport(1.0, 1.0, 2, 2);
+
+  // (1, 1) is the plot's top right corner and shares a cell with (0.75, 0.75);
+  // (1.5, 0.5) is the neighbour past x_max that is only there for lines
+  QVector<QPointF> points = {{0.0, 0.0}, {0.75, 0.75}, {1.0, 1.0}, {1.5, 0.5}};
+  QVector<QPointF> sampled = ChartDecimator::Decimate(points, viewport, ChartDecimator::kPixelGrid);
+  OLIVE_ASSERT_EQUAL(sampled.size(), 2);
+  OLIVE_ASSERT(sampled[0] == QPointF(0.0, 0.0));
+  OLIVE_ASSERT(sampled[1] == QPointF(0.75, 0.75));
+
+  // On its own the corner point is drawn rather than dropped
+  points = {{0.0, 0.0}, {1.0, 1.0}};
+  sampled = ChartDecimator::Decimate(points, viewport, ChartDecimator::kPixelGrid);
+  OLIVE_ASSERT_EQUAL(sampled.size(), 2);
+  OLIVE_ASSERT(sampled[1] == QPointF(1.0, 1.0));
+
+  // Points above y_max are off the plot
+  points = {{0.5, 1.5}};
+  OLIVE_ASSERT(ChartDecimator::Decimate(points, viewport, ChartDecimator::kPixelGrid).isEmpty());
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(MinMaxPutsXMaxInLastColumn)
+{
+  ChartViewport viewport = MakeViewport(10.0, 10.0, 4, 4);
+
+  // 100 points spread evenly up to exactly x_max, 25 per column, each
+  // column dipping and peaking away from its first and last point
+  QVector<QPointF> points;
+  for (int i = 0; i < 100; i++) {
+    double y = (i % 25 == 7) ? 0.0 : (i % 25 == 13) ? 10.0 : 5.0;
+    points.append(QPointF(i * 10.0 / 99.0, y));
+  }
+
+  // Four points per column; a column of its own for x_max would add a fifth
+  QVector<QPointF> sampled = ChartDecimator::Decimate(points, viewport, ChartDecimator::kMinMax);
+  OLIVE_ASSERT_EQUAL(sampled.size(), 16);
+  OLIVE_ASSERT(sampled.first() == points.first());
+  OLIVE_ASSERT(sampled.last() == points.last());
+
+  OLIVE_TEST_END;
+}
+
+}
@@ -0,0 +1,219 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Formation Pattern Bank Tests
+***/
+
+#include "testutil.h"
+
+#include <iostream>
+#include <random>
+#include <set>
+
+#include "formation_assignment.h"
+#include "formation_detector.h"
+#include "formation_pattern_bank.h"
+
+namespace olive {
+
+namespace {
+
+using amt::sports::AssignmentWorkspace;
+using amt::sports::FormationDescriptor;
+using amt::sports::FormationPatternBank;
+using amt::sports::PatternMatch;
+using amt::sports::PlayerPosition;
+
+constexpr int kDefenders = 11;
+
+std::vector<cv::Point2f> RandomPositions(int count, std::mt19937& rng)
+{
+  std::uniform_real_distribution<float> x(0.0f, 40.0f);
+  std::uniform_real_distribution<float> y(0.0f, 15.0f);
+  std::vector<cv::Point2f> positions;
+  for (int i = 0; i < count; i++) {
+    positions.emplace_back(x(rng), y(rng));
+  }
+  return positions;
+}
+
+std::vector<PlayerPosition> MakeDefense(const std::vector<cv::Point2f>& positions)
+{
+  std::vector<PlayerPosition> defense;
+  for (const cv::Point2f& position : positions) {
+    PlayerPosition player;
+    player.position = position;
+    player.jersey_number = 0;
+    player.team = "defense";
+    player.confidence = 1.0;
+    defense.push_back(player);
+  }
+  return defense;
+}
+
+// Jitters a pattern's slots so the defense lands near, not on, the pattern
+std::vector<cv::Point2f> Jitter(const std::vector<cv::Point2f>& positions, float amount, std::mt19937& rng)
+{
+  std::normal_distribution<float> noise(0.0f, amount);
+  std::vector<cv::Point2f> jittered;
+  for (const cv::Point2f& position : positions) {
+    jittered.emplace_back(position.x + noise(rng), position.y + noise(rng));
+  }
+  return jittered;
+}
+
+} // namespace
+
+OLIVE_ADD_TEST(ExactPatternMatchesFirst)
+{
+  std::mt19937 rng(11);
+  FormationPatternBank bank;
+
+  std::vector<std::vector<cv::Point2f>> library;
+  for (int i = 0; i < 64; i++) {
+    library.push_back(RandomPositions(kDefenders, rng));
+    bank.addPattern(amt::sports::FormationType::LARRY, library.back(), 1.0, "pattern");
+  }
+  bank.build();
+
+  for (int target : {0, 17, 63}) {
+    std::vector<PlayerPosition> defense = MakeDefense(library[target]);
+    FormationDescriptor descriptor = amt::sports::formation_utils::calculateFormationDescriptor(defense);
+    std::vector<PatternMatch> matches = bank.match(defense, descriptor, 1, 0.6);
+    OLIVE_ASSERT(!matches.empty());
+    OLIVE_ASSERT_EQUAL(matches[0].pattern_index, target);
+    OLIVE_ASSERT(matches[0].score > 0.99);
+  }
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(PruningNeverDropsAPassingAssignment)
+{
+  std::mt19937 rng(23);
+  FormationPatternBank bank;
+
+  // Mixed slot counts in the same buckets
+  std::vector<std::vector<cv::Point2f>> library;
+  for (int i = 0; i < 400; i++) {
+    int slots = (i % 4 == 0) ? 9 : kDefenders;
+    library.push_back(RandomPositions(slots, rng));
+    bank.addPattern(amt::sports::FormationType::RITA, library.back(), 0.9 + 0.1 * (i % 2));
+  }
+  bank.build();
+
+  const double min_score = 0.6;
+  AssignmentWorkspace workspace;
+  for (int trial = 0; trial < 200; trial++) {
+    const std::vector<cv::Point2f>& base = library[(trial * 7) % library.size()];
+    std::vector<cv::Point2f> positions = Jitter(base, 1.0f, rng);
+    while (static_cast<int>(positions.size()) < kDefenders) {
+      positions.push_back(RandomPositions(1, rng).front());
+    }
+    std::vector<PlayerPosition> defense = MakeDefense(positions);
+    FormationDescriptor descriptor = amt::sports::formation_utils::calculateFormationDescriptor(defense);
+
+    // Without a threshold nothing is pruned
+    OLIVE_ASSERT_EQUAL(bank.match(defense, descriptor, 0, 0.0).size(), bank.size());
+
+    std::set<int> candidates;
+    for (const PatternMatch& match : bank.match(defense, descriptor, 0, min_score)) {
+      candidates.insert(match.pattern_index);
+    }
+
+    // Every pattern whose optimal assignment passes must still be a candidate
+    for (size_t index = 0; index < bank.size(); index++) {
+      PatternMatch exact = bank.scoreAssignment(static_cast<int>(index), defense, descriptor, workspace);
+      if (exact.score >= min_score && !candidates.count(static_cast<int>(index))) {
+        std::cout << " - pattern " << index << " pruned with assignment score " << exact.score;
+        return __LINE__;
+      }
+    }
+  }
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(PruningKeepsSmallerPatternsWithExtraDefenders)
+{
+  std::mt19937 rng(31);
+  FormationPatternBank bank;
+
+  // Eight-slot patterns against nine to eleven defenders, where the defense's
+  // center of mass is not the assigned players'
+  std::vector<std::vector<cv::Point2f>> library;
+  for (int i = 0; i < 300; i++) {
+    library.push_back(RandomPositions(8, rng));
+    bank.addPattern(amt::sports::FormationType::RICKY, library.back(), 1.0);
+  }
+  bank.build();
+
+  const double min_score = 0.6;
+  AssignmentWorkspace workspace;
+  int passing = 0;
+  for (int trial = 0; trial < 300; trial++) {
+    std::vector<cv::Point2f> positions = Jitter(library[(trial * 13) % library.size()], 0.5f, rng);
+    int defenders = 9 + trial % 3;
+    while (static_cast<int>(positions.size()) < defenders) {
+      positions.push_back(RandomPositions(1, rng).front());
+    }
+    std::vector<PlayerPosition> defense = MakeDefense(positions);
+    FormationDescriptor descriptor = amt::sports::formation_utils::calculateFormationDescriptor(defense);
+
+    std::set<int> candidates;
+    for (const PatternMatch& match : bank.match(defense, descriptor, 0, min_score)) {
+      candidates.insert(match.pattern_index);
+    }
+
+    for (size_t index = 0; index < bank.size(); index++) {
+      PatternMatch exact = bank.scoreAssignment(static_cast<int>(index), defense, descriptor, workspace);
+      if (exact.score < min_score) {
+        continue;
+      }
+      passing++;
+      if (!candidates.count(static_cast<int>(index))) {
+        std::cout << " - pattern " << index << " pruned with " << defenders
+                  << " defenders and assignment score " << exact.score;
+        return __LINE__;
+      }
+    }
+  }
+
+  // The trials have to actually exercise the bound
+  OLIVE_ASSERT(passing > 0);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(PatternsWithMoreSlotsThanDefendersNeverMatch)
+{
+  std::mt19937 rng(5);
+  FormationPatternBank bank;
+  std::vector<cv::Point2f> positions = RandomPositions(kDefenders, rng);
+  bank.addPattern(amt::sports::FormationType::LARRY, positions, 1.0);
+  bank.build();
+
+  std::vector<cv::Point2f> fewer(positions.begin(), positions.begin() + 9);
+  std::vector<PlayerPosition> defense = MakeDefense(fewer);
+  FormationDescriptor descriptor = amt::sports::formation_utils::calculateFormationDescriptor(defense);
+  OLIVE_ASSERT(bank.match(defense, descriptor, 0, 0.1).empty());
+  OLIVE_ASSERT_EQUAL(bank.match(defense, descriptor, 0, 0.0).size(), bank.size());
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(NormalizedPositionsSpanUnitSquare)
+{
+  std::vector<cv::Point2f> positions = {{10.0f, 5.0f}, {30.0f, 5.0f}, {20.0f, 15.0f}};
+  std::vector<cv::Point2f> normalized = FormationPatternBank::normalizePositions(positions);
+
+  OLIVE_ASSERT_EQUAL(normalized.size(), positions.size());
+  OLIVE_ASSERT(normalized[0] == cv::Point2f(0.0f, 0.0f));
+  OLIVE_ASSERT(normalized[1] == cv::Point2f(1.0f, 0.0f));
+  OLIVE_ASSERT(normalized[2] == cv::Point2f(0.5f, 1.0f));
+
+  OLIVE_TEST_END;
+}
+
+}
@@ -0,0 +1,154 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Kafka Spill Journal Tests
+***/
+
+#include "testutil.h"
+
+#include <QTemporaryDir>
+
+#include "kafka_publisher.h"
+#include "kafka_spill_journal.h"
+
+namespace olive {
+
+namespace {
+
+KafkaEvent MakeJournalEvent(int index)
+{
+  KafkaEvent event;
+  event.topic = "formation-detections";
+  event.key = QString("formation_%1").arg(index);
+  event.data["index"] = index;
+  event.data["confidence"] = 0.75;
+  return event;
+}
+
+} // namespace
+
+OLIVE_ADD_TEST(JournalReplaysInOrder)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+
+  KafkaSpillJournal journal(dir.path());
+  OLIVE_ASSERT(journal.Open());
+
+  for (int i = 0; i < 100; i++) {
+    OLIVE_ASSERT(journal.Append(MakeJournalEvent(i)));
+  }
+  OLIVE_ASSERT_EQUAL(journal.PendingCount(), 100);
+
+  QVector<KafkaEvent> events;
+  OLIVE_ASSERT_EQUAL(journal.ReadForReplay(&events, 40, 1 << 20), 40);
+  OLIVE_ASSERT_EQUAL(journal.ReadForReplay(&events, 1000, 1 << 20), 60);
+  OLIVE_ASSERT_EQUAL(journal.PendingCount(), 0);
+  OLIVE_ASSERT_EQUAL(journal.OutstandingCount(), 100);
+
+  for (int i = 0; i < events.size(); i++) {
+    OLIVE_ASSERT(events[i].key == QString("formation_%1").arg(i));
+    OLIVE_ASSERT(events[i].data["index"].toInt() == i);
+    OLIVE_ASSERT(events[i].topic == "formation-detections");
+    OLIVE_ASSERT(events[i].journal_sequence == i);
+  }
+
+  for (const KafkaEvent& event : events) {
+    journal.Acknowledge(event.journal_sequence);
+  }
+  OLIVE_ASSERT_EQUAL(journal.OutstandingCount(), 0);
+  OLIVE_ASSERT(!journal.HasPending());
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(JournalReplaysRejectedEventsFirst)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+
+  KafkaSpillJournal journal(dir.path());
+  OLIVE_ASSERT(journal.Open());
+
+  for (int i = 0; i < 10; i++) {
+    OLIVE_ASSERT(journal.Append(MakeJournalEvent(i)));
+  }
+
+  QVector<KafkaEvent> events;
+  OLIVE_ASSERT_EQUAL(journal.ReadForReplay(&events, 5, 1 << 20), 5);
+  journal.Reject(events[3].journal_sequence);
+  OLIVE_ASSERT_EQUAL(journal.PendingCount(), 6);
+
+  QVector<KafkaEvent> replay;
+  OLIVE_ASSERT_EQUAL(journal.ReadForReplay(&replay, 2, 1 << 20), 2);
+  OLIVE_ASSERT(replay[0].key == "formation_3");
+  OLIVE_ASSERT(replay[1].key == "formation_5");
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(JournalRecoversUnacknowledgedEvents)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+
+  {
+    KafkaSpillJournal journal(dir.path());
+    OLIVE_ASSERT(journal.Open());
+    for (int i = 0; i < 20; i++) {
+      OLIVE_ASSERT(journal.Append(MakeJournalEvent(i)));
+    }
+
+    QVector<KafkaEvent> events;
+    OLIVE_ASSERT_EQUAL(journal.ReadForReplay(&events, 20, 1 << 20), 20);
+    for (int i = 0; i < 8; i++) {
+      journal.Acknowledge(events[i].journal_sequence);
+    }
+    journal.Close();
+  }
+
+  // Everything after the checkpoint comes back after a restart
+  KafkaSpillJournal journal(dir.path());
+  OLIVE_ASSERT(journal.Open());
+  OLIVE_ASSERT_EQUAL(journal.PendingCount(), 12);
+
+  QVector<KafkaEvent> events;
+  OLIVE_ASSERT_EQUAL(journal.ReadForReplay(&events, 100, 1 << 20), 12);
+  OLIVE_ASSERT(events.first().key == "formation_8");
+  OLIVE_ASSERT(events.last().key == "formation_19");
+
+  // New events continue the sequence
+  OLIVE_ASSERT(journal.Append(MakeJournalEvent(20)));
+  QVector<KafkaEvent> appended;
+  OLIVE_ASSERT_EQUAL(journal.ReadForReplay(&appended, 100, 1 << 20), 1);
+  OLIVE_ASSERT(appended.first().journal_sequence == 20);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(JournalStaysWithinBudget)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+
+  // A budget below the minimum segment still holds one 64 KiB segment
+  KafkaSpillJournal journal(dir.path(), 1, 1);
+  OLIVE_ASSERT(journal.Open());
+
+  for (int i = 0; i < 2000; i++) {
+    OLIVE_ASSERT(journal.Append(MakeJournalEvent(i)));
+    OLIVE_ASSERT(journal.DiskBytes() <= 64 * 1024);
+  }
+
+  // The oldest events gave way to the newest
+  OLIVE_ASSERT(journal.PendingCount() < 2000);
+  QVector<KafkaEvent> events;
+  journal.ReadForReplay(&events, 2000, 1LL << 30);
+  OLIVE_ASSERT(!events.isEmpty());
+  OLIVE_ASSERT(events.last().key == "formation_1999");
+
+  OLIVE_TEST_END;
+}
+
+}
@@ -0,0 +1,203 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  MinIO Chunk Store Tests
+***/
+
+#include "testutil.h"
+
+#include <QCryptographicHash>
+#include <QFile>
+#include <QSet>
+#include <QTemporaryDir>
+
+#include "minio_chunk_store.h"
+
+namespace olive {
+
+namespace {
+
+// Deterministic incompressible "footage" (splitmix64)
+QByteArray MakeFootage(qint64 size, quint64 seed)
+{
+  QByteArray data(size, Qt::Uninitialized);
+  quint64 state = seed;
+  for (qint64 i = 0; i < size; i += 8) {
+    state += 0x9E3779B97F4A7C15ULL;
+    quint64 z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    for (int b = 0; b < 8 && i + b < size; b++) {
+      data[i + b] = static_cast<char>(z >> (8 * b));
+    }
+  }
+  return data;
+}
+
+bool WriteFile(const QString& path, const QByteArray& data)
+{
+  QFile file(path);
+  return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+} // namespace
+
+OLIVE_ADD_TEST(ChunksCoverFileWithinSizeBounds)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+
+  QByteArray footage = MakeFootage(24 * 1024 * 1024, 1);
+  QString path = dir.filePath("game.mp4");
+  OLIVE_ASSERT(WriteFile(path, footage));
+
+  QVector<MinIOChunk> chunks;
+  OLIVE_ASSERT(MinIOChunker::ChunkFile(path, &chunks));
+  OLIVE_ASSERT(chunks.size() > 1);
+
+  qint64 offset = 0;
+  for (int i = 0; i < chunks.size(); i++) {
+    const MinIOChunk& chunk = chunks[i];
+    OLIVE_ASSERT_EQUAL(chunk.offset, offset);
+    OLIVE_ASSERT(chunk.size <= MinIOChunker::kMaxChunkSize);
+    if (i + 1 < chunks.size()) {
+      OLIVE_ASSERT(chunk.size > MinIOChunker::kMinChunkSize);
+    }
+
+    QByteArray digest = QCryptographicHash::hash(footage.mid(chunk.offset, chunk.size), QCryptographicHash::Sha256);
+    OLIVE_ASSERT(chunk.hash == QString::fromLatin1(digest.toHex()));
+    offset += chunk.size;
+  }
+  OLIVE_ASSERT_EQUAL(offset, footage.size());
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(InsertedBytesOnlyChangeNearbyChunks)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+
+  QByteArray footage = MakeFootage(24 * 1024 * 1024, 2);
+  QByteArray edited = footage;
+  edited.insert(5 * 1024 * 1024, MakeFootage(1000, 3));
+
+  OLIVE_ASSERT(WriteFile(dir.filePath("original.mp4"), footage));
+  OLIVE_ASSERT(WriteFile(dir.filePath("edited.mp4"), edited));
+
+  QVector<MinIOChunk> original_chunks, edited_chunks;
+  OLIVE_ASSERT(MinIOChunker::ChunkFile(dir.filePath("original.mp4"), &original_chunks));
+  OLIVE_ASSERT(MinIOChunker::ChunkFile(dir.filePath("edited.mp4"), &edited_chunks));
+
+  QSet<QString> stored;
+  for (const MinIOChunk& chunk : original_chunks) {
+    stored.insert(chunk.hash);
+  }
+
+  // Boundaries resynchronize right after the edit; a fixed-size split
+  // would change every chunk after it
+  int new_chunks = 0;
+  for (const MinIOChunk& chunk : edited_chunks) {
+    if (!stored.contains(chunk.hash)) {
+      new_chunks++;
+    }
+  }
+  OLIVE_ASSERT(new_chunks >= 1);
+  OLIVE_ASSERT(new_chunks <= 2);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(ManifestRoundTrip)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+
+  QByteArray footage = MakeFootage(12 * 1024 * 1024, 4);
+  QString path = dir.filePath("practice.mp4");
+  OLIVE_ASSERT(WriteFile(path, footage));
+
+  QVector<MinIOChunk> chunks;
+  OLIVE_ASSERT(MinIOChunker::ChunkFile(path, &chunks));
+
+  QByteArray manifest = MinIOChunker::BuildManifest(chunks, footage.size(), "practice.mp4");
+  QVector<MinIOChunk> parsed;
+  qint64 file_size = 0;
+  OLIVE_ASSERT(MinIOChunker::ParseManifest(manifest, &parsed, &file_size));
+  OLIVE_ASSERT_EQUAL(file_size, footage.size());
+  OLIVE_ASSERT_EQUAL(parsed.size(), chunks.size());
+  for (int i = 0; i < chunks.size(); i++) {
+    OLIVE_ASSERT(parsed[i].hash == chunks[i].hash);
+    OLIVE_ASSERT_EQUAL(parsed[i].offset, chunks[i].offset);
+    OLIVE_ASSERT_EQUAL(parsed[i].size, chunks[i].size);
+  }
+
+  // A manifest whose chunks do not add up to the file is rejected
+  QByteArray short_manifest = MinIOChunker::BuildManifest(chunks, footage.size() + 1, "practice.mp4");
+  OLIVE_ASSERT(!MinIOChunker::ParseManifest(short_manifest, &parsed, &file_size));
+  OLIVE_ASSERT(!MinIOChunker::ParseManifest("{\"format\":\"other\"}", &parsed, &file_size));
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(ChunkIndexPersists)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+
+  QString index_path = dir.filePath("index/bucket.idx");
+  QString first = QString::fromLatin1(QCryptographicHash::hash("first", QCryptographicHash::Sha256).toHex());
+  QString second = QString::fromLatin1(QCryptographicHash::hash("second", QCryptographicHash::Sha256).toHex());
+
+  {
+    MinIOChunkIndex index(index_path);
+    OLIVE_ASSERT(!index.Contains(first));
+    index.Insert(first);
+    index.Insert(first);
+    index.Insert("not-a-digest");
+    OLIVE_ASSERT(index.Contains(first));
+    OLIVE_ASSERT_EQUAL(index.Size(), 1);
+  }
+
+  MinIOChunkIndex reopened(index_path);
+  OLIVE_ASSERT(reopened.Contains(first));
+  OLIVE_ASSERT(!reopened.Contains(second));
+  OLIVE_ASSERT_EQUAL(reopened.Size(), 1);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(ChunkIndexRemovePersists)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+
+  QString index_path = dir.filePath("bucket.idx");
+  QString first = QString::fromLatin1(QCryptographicHash::hash("first", QCryptographicHash::Sha256).toHex());
+  QString second = QString::fromLatin1(QCryptographicHash::hash("second", QCryptographicHash::Sha256).toHex());
+
+  {
+    MinIOChunkIndex index(index_path);
+    index.Insert(first);
+    index.Insert(second);
+    index.Remove(first);
+    index.Remove(first);
+    OLIVE_ASSERT(!index.Contains(first));
+    OLIVE_ASSERT_EQUAL(index.Size(), 1);
+
+    // Still appends after the file was rewritten
+    index.Insert(first);
+    index.Remove(second);
+  }
+
+  MinIOChunkIndex reopened(index_path);
+  OLIVE_ASSERT(reopened.Contains(first));
+  OLIVE_ASSERT(!reopened.Contains(second));
+  OLIVE_ASSERT_EQUAL(reopened.Size(), 1);
+
+  OLIVE_TEST_END;
+}
+
+}
@@ -0,0 +1,928 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  MinIO Client Tests
+***/
+
+#include "testutil.h"
+
+#include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QSet>
+#include <QStandardPaths>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTimeZone>
+#include <QTimer>
+
+#include <algorithm>
+#include <functional>
+
+#include "minio_client.h"
+
+namespace olive {
+
+namespace {
+
+const QString kAccessKey = "sports-test";
+const QString kSecretKey = "sports-test-secret";
+const QString kRegion = "us-east-1";
+
+// AWS documentation example credentials
+const QString kExampleSecretKey = "wJalrXUtnFEMI/K7MDENG/bPxRfiCYEXAMPLEKEY";
+const QByteArray kEmptyPayloadHash = "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855";
+
+QDateTime ExampleTimestamp()
+{
+  return QDateTime(QDate(2013, 5, 24), QTime(0, 0), QTimeZone::utc());
+}
+
+QMap<QByteArray, QByteArray> ExampleHeaders()
+{
+  QMap<QByteArray, QByteArray> headers;
+  headers["host"] = "examplebucket.s3.amazonaws.com";
+  headers["x-amz-content-sha256"] = kEmptyPayloadHash;
+  headers["x-amz-date"] = "20130524T000000Z";
+  return headers;
+}
+
+/**
+ * @brief Local S3 endpoint for the client under test
+ *
+ * Checks every request's SigV4 signature against what actually arrived on
+ * the wire, and every Content-MD5 against the body, and serves bucket
+ * creation, paged listing, plain and multipart uploads, deletes, and
+ * ranged, If-Match conditional downloads. Plain uploads are stored and
+ * served like the objects it is given; any other object is missing (404).
+ * Parts can be made to
+ * answer without an ETag, fail, or answer late, and the completion can
+ * answer with an error document. Ranges can be held unanswered, and an
+ * object can change after some of its ranges were served.
+ */
+class S3StandIn
+{
+public:
+  S3StandIn()
+  {
+    server_.listen(QHostAddress::LocalHost);
+    QObject::connect(&server_, &QTcpServer::newConnection, [this]() {
+      while (QTcpSocket* socket = server_.nextPendingConnection()) {
+        QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() { Serve(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, [this, socket]() {
+          buffers_.remove(socket);
+          socket->deleteLater();
+        });
+      }
+    });
+  }
+
+  QString Endpoint() const { return QString("127.0.0.1:%1").arg(server_.serverPort()); }
+
+  int rejected = 0;
+  int checksummed = 0;            // Bodies that carried a matching Content-MD5
+  QList<QUrlQuery> queries;       // Every accepted request's query
+  QStringList put_paths;
+  QMap<int, int> part_attempts;
+  QMap<int, int> omit_etag;       // Part number -> responses without an ETag, -1 for all
+  QMap<int, int> fail_parts;      // Part number -> 500 responses, -1 for all
+  int part_delay_ms = 0;
+  int parts_in_flight = 0;
+  int most_parts_in_flight = 0;
+  bool completion_error = false;  // Answer the completion 200 with an <Error> body
+  QByteArray completion;
+
+  QMap<QString, QByteArray> objects;      // Path -> data, served to HEAD and GET
+  QMap<QString, QByteArray> object_etags;
+  QList<qint64> range_starts;             // Every ranged GET's first byte
+  qint64 hold_ranges_from = -1;           // Ranges starting here or later are never answered
+  int ranges_until_change = -1;           // The object changes after this many ranges
+  QStringList deletes;
+  int list_page_size = 1000;
+
+private:
+  void Serve(QTcpSocket* socket)
+  {
+    QByteArray& buffer = buffers_[socket];
+    buffer += socket->readAll();
+
+    for (;;) {
+      int header_end = buffer.indexOf("\r\n\r\n");
+      if (header_end < 0) {
+        return;
+      }
+
+      QList<QByteArray> lines = buffer.left(header_end).split('\n');
+      QMap<QByteArray, QByteArray> headers;
+      for (int i = 1; i < lines.size(); i++) {
+        int colon = lines[i].indexOf(':');
+        if (colon > 0) {
+          headers[lines[i].left(colon).trimmed().toLower()] = lines[i].mid(colon + 1).trimmed();
+        }
+      }
+
+      qint64 length = headers.value("content-length").toLongLong();
+      if (buffer.size() < header_end + 4 + length) {
+        return;
+      }
+
+      QList<QByteArray> request_line = lines[0].trimmed().split(' ');
+      QByteArray body = buffer.mid(header_end + 4, length);
+      buffer.remove(0, header_end + 4 + length);
+      Respond(socket, request_line.value(0), request_line.value(1), headers, body);
+    }
+  }
+
+  void Respond(QTcpSocket* socket, const QByteArray& method, const QByteArray& target,
+               const QMap<QByteArray, QByteArray>& headers, const QByteArray& body)
+  {
+    QUrl url(QString::fromUtf8("http://" + headers.value("host") + target));
+    if (!VerifySignature(method, url, headers)) {
+      rejected++;
+      Reply(socket, 403);
+      return;
+    }
+
+    if (headers.contains("content-md5")) {
+      if (QCryptographicHash::hash(body, QCryptographicHash::Md5).toBase64() != headers.value("content-md5")) {
+        rejected++;
+        Reply(socket, 400);
+        return;
+      }
+      checksummed++;
+    }
+
+    QUrlQuery query(url);
+    queries.append(query);
+    if (method == "PUT") {
+      put_paths.append(url.path());
+    }
+
+    if (method == "POST" && query.hasQueryItem("uploads")) {
+      Reply(socket, 200, "<InitiateMultipartUploadResult><UploadId>upload-1</UploadId></InitiateMultipartUploadResult>");
+    } else if (method == "PUT" && query.hasQueryItem("partNumber")) {
+      int number = query.queryItemValue("partNumber").toInt();
+      part_attempts[number]++;
+      most_parts_in_flight = qMax(most_parts_in_flight, ++parts_in_flight);
+      QTimer::singleShot(part_delay_ms, socket, [this, socket, number]() {
+        parts_in_flight--;
+        AnswerPart(socket, number);
+      });
+    } else if (method == "POST" && query.hasQueryItem("uploadId")) {
+      if (completion_error) {
+        Reply(socket, 200, "<Error><Code>InternalError</Code><Message>Try again</Message></Error>");
+        return;
+      }
+      completion = body;
+      Reply(socket, 200, "<CompleteMultipartUploadResult><ETag>\"object\"</ETag></CompleteMultipartUploadResult>");
+    } else if ((method == "HEAD" || method == "GET") && objects.contains(url.path())) {
+      ServeObject(socket, method, url.path(), headers);
+    } else if (method == "GET" && query.hasQueryItem("list-type")) {
+      ListObjects(socket, url.path(), query);
+    } else if ((method == "HEAD" || method == "GET") && IsObjectPath(url.path())) {
+      Reply(socket, 404);
+    } else if (method == "GET") {
+      Reply(socket, 200, "<ListBucketResult></ListBucketResult>");
+    } else if (method == "PUT") {
+      if (IsObjectPath(url.path())) {
+        objects[url.path()] = body;
+        object_etags[url.path()] = "\"object\"";
+      }
+      Reply(socket, 200, QByteArray(), "ETag: \"object\"\r\n");
+    } else if (method == "DELETE") {
+      objects.remove(url.path());
+      object_etags.remove(url.path());
+      deletes.append(url.path());
+      Reply(socket, 204);
+    } else {
+      Reply(socket, 200);
+    }
+  }
+
+  void AnswerPart(QTcpSocket* socket, int number)
+  {
+    int& fail = fail_parts[number];
+    if (fail != 0) {
+      if (fail > 0) {
+        fail--;
+      }
+      Reply(socket, 500);
+      return;
+    }
+
+    int& omit = omit_etag[number];
+    if (omit != 0) {
+      if (omit > 0) {
+        omit--;
+      }
+      Reply(socket, 200);
+    } else {
+      Reply(socket, 200, QByteArray(), "ETag: \"part-" + QByteArray::number(number) + "\"\r\n");
+    }
+  }
+
+  static bool IsObjectPath(const QString& path)
+  {
+    return path.indexOf('/', 1) > 0;
+  }
+
+  // ListObjectsV2, list_page_size keys a page; the continuation token is the next offset
+  void ListObjects(QTcpSocket* socket, const QString& bucket_path, const QUrlQuery& query)
+  {
+    QString prefix = bucket_path + "/";
+    QStringList keys;
+    for (auto it = objects.constBegin(); it != objects.constEnd(); ++it) {
+      if (it.key().startsWith(prefix)) {
+        keys.append(it.key().mid(prefix.size()));
+      }
+    }
+
+    int first = query.queryItemValue("continuation-token").toInt();
+    int last = qMin(first + list_page_size, static_cast<int>(keys.size()));
+    QByteArray body = "<ListBucketResult>";
+    for (int i = first; i < last; i++) {
+      body += "<Contents><Key>" + keys[i].toUtf8() + "</Key></Contents>";
+    }
+    if (last < keys.size()) {
+      body += "<IsTruncated>true</IsTruncated><NextContinuationToken>" + QByteArray::number(last)
+              + "</NextContinuationToken>";
+    } else {
+      body += "<IsTruncated>false</IsTruncated>";
+    }
+    Reply(socket, 200, body + "</ListBucketResult>");
+  }
+
+  void ServeObject(QTcpSocket* socket, const QByteArray& method, const QString& path,
+                   const QMap<QByteArray, QByteArray>& headers)
+  {
+    const QByteArray& data = objects[path];
+    const QByteArray& etag = object_etags[path];
+    if (method == "HEAD") {
+      socket->write("HTTP/1.1 200 OK\r\nContent-Length: " + QByteArray::number(data.size())
+                    + "\r\nETag: " + etag + "\r\n\r\n");
+      return;
+    }
+
+    if (headers.contains("if-match") && headers.value("if-match") != etag) {
+      Reply(socket, 412);
+      return;
+    }
+
+    static const QRegularExpression pattern("^bytes=(\\d+)-(\\d+)$");
+    QRegularExpressionMatch range = pattern.match(QString::fromUtf8(headers.value("range")));
+    if (!range.hasMatch()) {
+      Reply(socket, 200, data, "ETag: " + etag + "\r\n");
+      return;
+    }
+
+    qint64 first = range.captured(1).toLongLong();
+    qint64 last = qMin(range.captured(2).toLongLong(), static_cast<qint64>(data.size()) - 1);
+    range_starts.append(first);
+    if (hold_ranges_from >= 0 && first >= hold_ranges_from) {
+      return;
+    }
+
+    socket->write("HTTP/1.1 206 Partial Content\r\nContent-Length: " + QByteArray::number(last - first + 1)
+                  + "\r\nContent-Range: bytes " + QByteArray::number(first) + "-" + QByteArray::number(last)
+                  + "/" + QByteArray::number(data.size()) + "\r\nETag: " + etag + "\r\n\r\n"
+                  + data.mid(first, last - first + 1));
+
+    if (ranges_until_change > 0 && --ranges_until_change == 0) {
+      objects[path].fill('x');
+      object_etags[path] = "\"changed\"";
+    }
+  }
+
+  bool VerifySignature(const QByteArray& method, const QUrl& url, const QMap<QByteArray, QByteArray>& headers) const
+  {
+    static const QRegularExpression pattern(
+      "^AWS4-HMAC-SHA256 Credential=([^/]+)/([^,]+), SignedHeaders=([^,]+), Signature=([0-9a-f]{64})$");
+    QRegularExpressionMatch match = pattern.match(QString::fromUtf8(headers.value("authorization")));
+    if (!match.hasMatch() || match.captured(1) != kAccessKey) {
+      return false;
+    }
+
+    QMap<QByteArray, QByteArray> signed_headers;
+    for (const QByteArray& name : match.captured(3).toUtf8().split(';')) {
+      signed_headers[name] = headers.value(name);
+    }
+    if (!signed_headers.contains("host") || !signed_headers.contains("x-amz-date")) {
+      return false;
+    }
+
+    QString date = QString::fromUtf8(headers.value("x-amz-date"));
+    QDateTime timestamp(QDate::fromString(date.left(8), "yyyyMMdd"),
+                        QTime::fromString(date.mid(9, 6), "HHmmss"), QTimeZone::utc());
+    if (match.captured(2) != MinIOUtils::SignatureV4Scope(kRegion, timestamp)) {
+      return false;
+    }
+
+    return match.captured(4) == MinIOUtils::SignatureV4(QString::fromUtf8(method), url, signed_headers,
+                                                        headers.value("x-amz-content-sha256"),
+                                                        kSecretKey, kRegion, timestamp);
+  }
+
+  static void Reply(QTcpSocket* socket, int status, const QByteArray& body = QByteArray(),
+                    const QByteArray& extra_headers = QByteArray())
+  {
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + (status == 200 ? " OK" : " Rejected") + "\r\n"
+                          + "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          + extra_headers + "\r\n" + body;
+    socket->write(response);
+  }
+
+  QTcpServer server_;
+  QHash<QTcpSocket*, QByteArray> buffers_;
+};
+
+bool WaitFor(const std::function<bool()>& done, int timeout_ms)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  QEventLoop loop;
+  QTimer poll;
+  poll.setInterval(10);
+  QObject::connect(&poll, &QTimer::timeout, &loop, [&]() {
+    if (done() || timer.elapsed() > timeout_ms) {
+      loop.quit();
+    }
+  });
+  poll.start();
+  loop.exec();
+
+  return done();
+}
+
+QByteArray Footage(qint64 size)
+{
+  QByteArray data(size, Qt::Uninitialized);
+  for (qint64 i = 0; i < size; i++) {
+    data[i] = static_cast<char>((i * 131) >> 7);
+  }
+  return data;
+}
+
+bool WriteFootage(const QString& path, qint64 size)
+{
+  QFile file(path);
+  return file.open(QIODevice::WriteOnly) && file.write(Footage(size)) == size;
+}
+
+// Incompressible bytes that never repeat a chunk, different for every seed (splitmix64)
+QByteArray Noise(qint64 size, quint64 seed)
+{
+  QByteArray data(size, Qt::Uninitialized);
+  quint64 state = seed;
+  for (qint64 i = 0; i < size; i += 8) {
+    state += 0x9E3779B97F4A7C15ULL;
+    quint64 z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    for (int b = 0; b < 8 && i + b < size; b++) {
+      data[i + b] = static_cast<char>(z >> (8 * b));
+    }
+  }
+  return data;
+}
+
+bool WriteFile(const QString& path, const QByteArray& data)
+{
+  QFile file(path);
+  return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+QSet<QString> ChunkPaths(const QString& path)
+{
+  QVector<MinIOChunk> chunks;
+  MinIOChunker::ChunkFile(path, &chunks);
+  QSet<QString> paths;
+  for (const MinIOChunk& chunk : chunks) {
+    paths.insert("/videos/" + MinIOChunker::ChunkObjectKey(chunk.hash));
+  }
+  return paths;
+}
+
+// Uploads with deduplication and waits; the object key, empty on failure
+QString UploadDeduplicated(MinIOClient* client, const QString& path)
+{
+  QString object_key;
+  bool failed = false;
+  QMetaObject::Connection uploaded = QObject::connect(client, &MinIOClient::VideoUploaded,
+                                                      [&](const VideoMetadata& metadata) { object_key = metadata.object_key; });
+  QMetaObject::Connection failure = QObject::connect(client, &MinIOClient::UploadFailed,
+                                                     [&](const QString&, const QString&) { failed = true; });
+  if (!client->UploadVideoFile(path).isEmpty()) {
+    WaitFor([&]() { return !object_key.isEmpty() || failed; }, 30000);
+  }
+  QObject::disconnect(uploaded);
+  QObject::disconnect(failure);
+  return object_key;
+}
+
+QByteArray ReadFile(const QString& path)
+{
+  QFile file(path);
+  return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+// Ranges a partial download's manifest records as stored
+QList<int> StoredRanges(const QString& local_path)
+{
+  QList<int> stored;
+  for (const QJsonValue& value : QJsonDocument::fromJson(ReadFile(local_path + ".part.json"))["done"].toArray()) {
+    stored.append(value.toInt());
+  }
+  return stored;
+}
+
+} // namespace
+
+OLIVE_ADD_TEST(SignatureV4MatchesAwsExamples)
+{
+  // GET Object
+  QMap<QByteArray, QByteArray> headers = ExampleHeaders();
+  headers["range"] = "bytes=0-9";
+  OLIVE_ASSERT(MinIOUtils::SignatureV4("GET", QUrl("https://examplebucket.s3.amazonaws.com/test.txt"), headers,
+                                       kEmptyPayloadHash, kExampleSecretKey, kRegion, ExampleTimestamp())
+               == "f0e8bdb87c964420e857bd35b5d6ed310bd44f0170aba48dd91039c6036bdb41");
+
+  // GET Bucket: the query is signed sorted, whatever order it was built in
+  OLIVE_ASSERT(MinIOUtils::SignatureV4("GET", QUrl("https://examplebucket.s3.amazonaws.com/?prefix=J&max-keys=2"),
+                                       ExampleHeaders(), kEmptyPayloadHash, kExampleSecretKey, kRegion,
+                                       ExampleTimestamp())
+               == "34b48302e7b5fa45bde8084f4b7868a86f0a534bc59db6670ed5711ef69dc6f7");
+
+  // GET Bucket lifecycle: a bare query name signs as "name="
+  OLIVE_ASSERT(MinIOUtils::SignatureV4("GET", QUrl("https://examplebucket.s3.amazonaws.com/?lifecycle"),
+                                       ExampleHeaders(), kEmptyPayloadHash, kExampleSecretKey, kRegion,
+                                       ExampleTimestamp())
+               == "fea454ca298b7da1c68078a5d1bdbfbbe0d65c699e0f91ac7a200a0136783543");
+
+  OLIVE_ASSERT(MinIOUtils::SignatureV4Scope(kRegion, ExampleTimestamp()) == "20130524/us-east-1/s3/aws4_request");
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(ListQueryIsSigned)
+{
+  S3StandIn s3;
+  MinIOClient client;
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+  client.ListVideos("videos", "2024/");
+  OLIVE_ASSERT_EQUAL(s3.rejected, 0);
+  OLIVE_ASSERT(s3.queries.last().queryItemValue("prefix") == "2024/");
+  OLIVE_ASSERT(s3.queries.last().queryItemValue("max-keys") == "1000");
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(MultipartUploadRetriesPartWithoutETag)
+{
+  QStandardPaths::setTestModeEnabled(true);
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+  QString path = dir.filePath("game.mp4");
+  OLIVE_ASSERT(WriteFootage(path, 11 * 1024 * 1024));
+
+  S3StandIn s3;
+  s3.omit_etag[2] = 1;
+
+  MinIOClient client;
+  client.SetMultipartUpload(true, 5 * 1024 * 1024, 2);
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+  bool uploaded = false;
+  QString failure;
+  QObject::connect(&client, &MinIOClient::VideoUploaded, [&](const VideoMetadata&) { uploaded = true; });
+  QObject::connect(&client, &MinIOClient::UploadFailed, [&](const QString&, const QString& error) { failure = error; });
+
+  OLIVE_ASSERT(!client.UploadVideoFile(path).isEmpty());
+  OLIVE_ASSERT(WaitFor([&]() { return uploaded || !failure.isEmpty(); }, 30000));
+  OLIVE_ASSERT(uploaded);
+
+  // Initiate, parts and completion all carried uploads/uploadId/partNumber in the signature
+  OLIVE_ASSERT_EQUAL(s3.rejected, 0);
+  OLIVE_ASSERT_EQUAL(s3.part_attempts.size(), 3);
+  OLIVE_ASSERT_EQUAL(s3.part_attempts[1], 1);
+  OLIVE_ASSERT_EQUAL(s3.part_attempts[2], 2);
+  OLIVE_ASSERT_EQUAL(s3.checksummed, 4);
+  OLIVE_ASSERT(s3.completion.contains("part-2"));
+  OLIVE_ASSERT(!s3.completion.contains("<ETag></ETag>"));
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(MissingETagFailsUpload)
+{
+  QStandardPaths::setTestModeEnabled(true);
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+  QString path = dir.filePath("practice.mp4");
+  OLIVE_ASSERT(WriteFootage(path, 11 * 1024 * 1024));
+
+  S3StandIn s3;
+  s3.omit_etag[3] = -1;
+
+  MinIOClient client;
+  client.SetMultipartUpload(true, 5 * 1024 * 1024, 2);
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+  bool uploaded = false;
+  QString failure;
+  QObject::connect(&client, &MinIOClient::VideoUploaded, [&](const VideoMetadata&) { uploaded = true; });
+  QObject::connect(&client, &MinIOClient::UploadFailed, [&](const QString&, const QString& error) { failure = error; });
+
+  // The upload gives up after the retries instead of waiting on the part forever
+  OLIVE_ASSERT(!client.UploadVideoFile(path).isEmpty());
+  OLIVE_ASSERT(WaitFor([&]() { return uploaded || !failure.isEmpty(); }, 30000));
+  OLIVE_ASSERT(!uploaded);
+  OLIVE_ASSERT(failure.contains("ETag"));
+  OLIVE_ASSERT(s3.completion.isEmpty());
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(InterruptedUploadResumesMissingParts)
+{
+  QStandardPaths::setTestModeEnabled(true);
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+  QString path = dir.filePath("film.mp4");
+  OLIVE_ASSERT(WriteFootage(path, 11 * 1024 * 1024));
+
+  S3StandIn s3;
+  s3.fail_parts[3] = -1;
+
+  // The first session stores parts 1 and 2, then gives up on part 3
+  {
+    MinIOClient client;
+    client.SetMultipartUpload(true, 5 * 1024 * 1024, 2);
+    OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+    QString failure;
+    QObject::connect(&client, &MinIOClient::UploadFailed, [&](const QString&, const QString& error) { failure = error; });
+    OLIVE_ASSERT(!client.UploadVideoFile(path).isEmpty());
+    OLIVE_ASSERT(WaitFor([&]() { return !failure.isEmpty(); }, 30000));
+    OLIVE_ASSERT(s3.completion.isEmpty());
+  }
+  OLIVE_ASSERT_EQUAL(s3.part_attempts[1], 1);
+  OLIVE_ASSERT_EQUAL(s3.part_attempts[2], 1);
+  int failed_attempts = s3.part_attempts[3];
+
+  // A new client picks the upload up from the manifest on disk
+  s3.fail_parts.clear();
+  MinIOClient client;
+  client.SetMultipartUpload(true, 5 * 1024 * 1024, 2);
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+  bool uploaded = false;
+  QString failure;
+  QObject::connect(&client, &MinIOClient::VideoUploaded, [&](const VideoMetadata&) { uploaded = true; });
+  QObject::connect(&client, &MinIOClient::UploadFailed, [&](const QString&, const QString& error) { failure = error; });
+  OLIVE_ASSERT(!client.UploadVideoFile(path).isEmpty());
+  OLIVE_ASSERT(WaitFor([&]() { return uploaded || !failure.isEmpty(); }, 30000));
+  OLIVE_ASSERT(uploaded);
+
+  OLIVE_ASSERT_EQUAL(s3.rejected, 0);
+  OLIVE_ASSERT_EQUAL(s3.part_attempts[1], 1);
+  OLIVE_ASSERT_EQUAL(s3.part_attempts[2], 1);
+  OLIVE_ASSERT_EQUAL(s3.part_attempts[3], failed_attempts + 1);
+  OLIVE_ASSERT(s3.completion.contains("part-1") && s3.completion.contains("part-2") && s3.completion.contains("part-3"));
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(CompletionErrorBodyFailsUpload)
+{
+  QStandardPaths::setTestModeEnabled(true);
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+  QString path = dir.filePath("walkthrough.mp4");
+  OLIVE_ASSERT(WriteFootage(path, 11 * 1024 * 1024));
+
+  S3StandIn s3;
+  s3.completion_error = true;
+
+  MinIOClient client;
+  client.SetMultipartUpload(true, 5 * 1024 * 1024, 2);
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+  bool uploaded = false;
+  QString failure;
+  QObject::connect(&client, &MinIOClient::VideoUploaded, [&](const VideoMetadata&) { uploaded = true; });
+  QObject::connect(&client, &MinIOClient::UploadFailed, [&](const QString&, const QString& error) { failure = error; });
+
+  // A 200 carrying an <Error> document is not a completed upload
+  OLIVE_ASSERT(!client.UploadVideoFile(path).isEmpty());
+  OLIVE_ASSERT(WaitFor([&]() { return uploaded || !failure.isEmpty(); }, 30000));
+  OLIVE_ASSERT(!uploaded);
+  OLIVE_ASSERT(failure.contains("InternalError"));
+
+  // Every part is stored, so uploading again only completes
+  s3.completion_error = false;
+  failure.clear();
+  OLIVE_ASSERT(!client.UploadVideoFile(path).isEmpty());
+  OLIVE_ASSERT(WaitFor([&]() { return uploaded || !failure.isEmpty(); }, 30000));
+  OLIVE_ASSERT(uploaded);
+  OLIVE_ASSERT_EQUAL(s3.part_attempts[1], 1);
+  OLIVE_ASSERT_EQUAL(s3.part_attempts[2], 1);
+  OLIVE_ASSERT_EQUAL(s3.part_attempts[3], 1);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(RetriedPartsWaitForAFreeSlot)
+{
+  QStandardPaths::setTestModeEnabled(true);
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+  QString path = dir.filePath("special-teams.mp4");
+  OLIVE_ASSERT(WriteFootage(path, 16 * 1024 * 1024));
+
+  // Part 1 comes back without an ETag while the next part is still out when
+  // its backoff ends
+  S3StandIn s3;
+  s3.omit_etag[1] = 1;
+  s3.part_delay_ms = 400;
+
+  MinIOClient client;
+  client.SetMultipartUpload(true, 5 * 1024 * 1024, 1);
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+  bool uploaded = false;
+  QString failure;
+  QObject::connect(&client, &MinIOClient::VideoUploaded, [&](const VideoMetadata&) { uploaded = true; });
+  QObject::connect(&client, &MinIOClient::UploadFailed, [&](const QString&, const QString& error) { failure = error; });
+
+  OLIVE_ASSERT(!client.UploadVideoFile(path).isEmpty());
+  OLIVE_ASSERT(WaitFor([&]() { return uploaded || !failure.isEmpty(); }, 30000));
+  OLIVE_ASSERT(uploaded);
+  OLIVE_ASSERT_EQUAL(s3.part_attempts[1], 2);
+  OLIVE_ASSERT_EQUAL(s3.most_parts_in_flight, 1);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(DeduplicatedUploadKeepsManifestOffVideoKey)
+{
+  QStandardPaths::setTestModeEnabled(true);
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+  QString path = dir.filePath("scrimmage.mp4");
+  OLIVE_ASSERT(WriteFootage(path, 6 * 1024 * 1024));
+
+  S3StandIn s3;
+  MinIOClient client;
+  client.SetDeduplication(true);
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+  VideoMetadata video;
+  QString failure;
+  QObject::connect(&client, &MinIOClient::VideoUploaded, [&](const VideoMetadata& metadata) { video = metadata; });
+  QObject::connect(&client, &MinIOClient::UploadFailed, [&](const QString&, const QString& error) { failure = error; });
+
+  OLIVE_ASSERT(!client.UploadVideoFile(path).isEmpty());
+  OLIVE_ASSERT(WaitFor([&]() { return !video.object_key.isEmpty() || !failure.isEmpty(); }, 30000));
+  OLIVE_ASSERT(failure.isEmpty());
+  OLIVE_ASSERT_EQUAL(s3.rejected, 0);
+
+  // Chunks and the manifest are stored, nothing at the video's own key
+  QString video_path = "/videos/" + video.object_key;
+  QString manifest_path = "/videos/" + MinIOChunker::ManifestObjectKey(video.object_key);
+  OLIVE_ASSERT(s3.put_paths.contains(manifest_path));
+  OLIVE_ASSERT(!s3.put_paths.contains(video_path));
+  int chunk_puts = 0;
+  for (const QString& put : s3.put_paths) {
+    if (put.startsWith("/videos/chunks/")) {
+      chunk_puts++;
+    }
+  }
+  OLIVE_ASSERT(chunk_puts > 0);
+  OLIVE_ASSERT_EQUAL(s3.checksummed, chunk_puts);
+
+  // The video key has no streamable object behind it
+  OLIVE_ASSERT(client.GetPresignedUrl("videos", video.object_key).isEmpty());
+
+  // Another client only has the bucket to go by
+  MinIOClient fresh;
+  OLIVE_ASSERT(fresh.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+  OLIVE_ASSERT(fresh.FileExists("videos", video.object_key));
+  OLIVE_ASSERT_EQUAL(fresh.GetFileSize("videos", video.object_key), 6 * 1024 * 1024);
+  OLIVE_ASSERT(fresh.GetPresignedUrl("videos", video.object_key).isEmpty());
+  OLIVE_ASSERT(!fresh.FileExists("videos", "missing.mp4"));
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(DeleteFileKeepsChunksOtherManifestsUse)
+{
+  QStandardPaths::setTestModeEnabled(true);
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+
+  // Two cuts of one game, the same up to their last few megabytes
+  QByteArray game = Noise(9 * 1024 * 1024, 11);
+  QString first_path = dir.filePath("first_half.mp4");
+  QString second_path = dir.filePath("second_half.mp4");
+  OLIVE_ASSERT(WriteFile(first_path, game + Noise(3 * 1024 * 1024, 12)));
+  OLIVE_ASSERT(WriteFile(second_path, game + Noise(3 * 1024 * 1024, 13)));
+
+  S3StandIn s3;
+  s3.list_page_size = 1;
+  MinIOClient client;
+  client.SetDeduplication(true);
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+  QString first_key = UploadDeduplicated(&client, first_path);
+  QString second_key = UploadDeduplicated(&client, second_path);
+  OLIVE_ASSERT(!first_key.isEmpty() && !second_key.isEmpty());
+
+  QSet<QString> first_chunks = ChunkPaths(first_path);
+  QSet<QString> second_chunks = ChunkPaths(second_path);
+  QSet<QString> only_first = first_chunks - second_chunks;
+  OLIVE_ASSERT(!only_first.isEmpty());
+  OLIVE_ASSERT(first_chunks.intersects(second_chunks));
+
+  OLIVE_ASSERT(client.DeleteFile("videos", first_key));
+  OLIVE_ASSERT(!client.FileExists("videos", first_key));
+  OLIVE_ASSERT(!s3.objects.contains("/videos/" + MinIOChunker::ManifestObjectKey(first_key)));
+
+  // Only the chunks no other manifest lists are gone
+  for (const QString& chunk : first_chunks) {
+    OLIVE_ASSERT(s3.objects.contains(chunk) == second_chunks.contains(chunk));
+  }
+  OLIVE_ASSERT(client.FileExists("videos", second_key));
+  OLIVE_ASSERT_EQUAL(s3.rejected, 0);
+
+  // Uploading the deleted cut again stores its chunks again
+  s3.put_paths.clear();
+  OLIVE_ASSERT(!UploadDeduplicated(&client, first_path).isEmpty());
+  for (const QString& chunk : only_first) {
+    OLIVE_ASSERT(s3.put_paths.contains(chunk));
+  }
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(ChunkMissingFromBucketIsUploadedAgain)
+{
+  QStandardPaths::setTestModeEnabled(true);
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+  QString path = dir.filePath("film_room.mp4");
+  OLIVE_ASSERT(WriteFile(path, Noise(8 * 1024 * 1024, 21)));
+
+  S3StandIn s3;
+  MinIOClient client;
+  client.SetDeduplication(true);
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+  OLIVE_ASSERT(!UploadDeduplicated(&client, path).isEmpty());
+
+  // A lifecycle rule expires one chunk behind the index's back
+  QSet<QString> chunks = ChunkPaths(path);
+  OLIVE_ASSERT(chunks.size() > 1);
+  QString expired = *chunks.constBegin();
+  s3.objects.remove(expired);
+
+  s3.put_paths.clear();
+  OLIVE_ASSERT(!UploadDeduplicated(&client, path).isEmpty());
+
+  // Listed chunks are checked; only the missing one is sent
+  QStringList chunk_puts;
+  for (const QString& put : s3.put_paths) {
+    if (put.startsWith("/videos/chunks/")) {
+      chunk_puts.append(put);
+    }
+  }
+  OLIVE_ASSERT(chunk_puts == QStringList({expired}));
+  OLIVE_ASSERT(s3.objects.contains(expired));
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(RangedDownloadAssemblesObject)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+  QString local_path = dir.filePath("game.mp4");
+
+  S3StandIn s3;
+  QByteArray footage = Footage(3 * 1024 * 1024 + 512 * 1024);
+  s3.objects["/videos/game.mp4"] = footage;
+  s3.object_etags["/videos/game.mp4"] = "\"v1\"";
+
+  MinIOClient client;
+  client.SetRangedDownload(1024 * 1024, 2);
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+  QString downloaded;
+  QString failure;
+  QObject::connect(&client, &MinIOClient::FileDownloaded, [&](const QString&, const QString& path) { downloaded = path; });
+  QObject::connect(&client, &MinIOClient::DownloadFailed, [&](const QString&, const QString& error) { failure = error; });
+
+  OLIVE_ASSERT(!client.DownloadFile("videos", "game.mp4", local_path).isEmpty());
+  OLIVE_ASSERT(WaitFor([&]() { return !downloaded.isEmpty() || !failure.isEmpty(); }, 30000));
+  OLIVE_ASSERT(downloaded == local_path);
+  OLIVE_ASSERT_EQUAL(s3.rejected, 0);
+
+  OLIVE_ASSERT_EQUAL(s3.range_starts.size(), 4);
+  OLIVE_ASSERT(ReadFile(local_path) == footage);
+  OLIVE_ASSERT(!QFile::exists(local_path + ".part"));
+  OLIVE_ASSERT(!QFile::exists(local_path + ".part.json"));
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(InterruptedDownloadResumesMissingRanges)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+  QString local_path = dir.filePath("practice.mp4");
+
+  S3StandIn s3;
+  QByteArray footage = Footage(3 * 1024 * 1024 + 512 * 1024);
+  s3.objects["/videos/practice.mp4"] = footage;
+  s3.object_etags["/videos/practice.mp4"] = "\"v1\"";
+  s3.hold_ranges_from = 2 * 1024 * 1024;
+
+  // The first session stores the first two ranges and stalls on the rest
+  {
+    MinIOClient client;
+    client.SetRangedDownload(1024 * 1024, 2);
+    OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+    OLIVE_ASSERT(!client.DownloadFile("videos", "practice.mp4", local_path).isEmpty());
+    OLIVE_ASSERT(WaitFor([&]() { return StoredRanges(local_path).size() == 2; }, 30000));
+    client.CancelAllTransfers();
+  }
+  OLIVE_ASSERT(QFile::exists(local_path + ".part"));
+  OLIVE_ASSERT(!QFile::exists(local_path));
+
+  s3.hold_ranges_from = -1;
+  s3.range_starts.clear();
+
+  MinIOClient client;
+  client.SetRangedDownload(1024 * 1024, 2);
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+  QString downloaded;
+  QString failure;
+  QObject::connect(&client, &MinIOClient::FileDownloaded, [&](const QString&, const QString& path) { downloaded = path; });
+  QObject::connect(&client, &MinIOClient::DownloadFailed, [&](const QString&, const QString& error) { failure = error; });
+  OLIVE_ASSERT(!client.DownloadFile("videos", "practice.mp4", local_path).isEmpty());
+  OLIVE_ASSERT(WaitFor([&]() { return !downloaded.isEmpty() || !failure.isEmpty(); }, 30000));
+  OLIVE_ASSERT(downloaded == local_path);
+
+  // Only the ranges the manifest did not list were fetched again
+  std::sort(s3.range_starts.begin(), s3.range_starts.end());
+  OLIVE_ASSERT(s3.range_starts == QList<qint64>({2 * 1024 * 1024, 3 * 1024 * 1024}));
+  OLIVE_ASSERT(ReadFile(local_path) == footage);
+  OLIVE_ASSERT(!QFile::exists(local_path + ".part.json"));
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(ObjectChangeDiscardsPartialDownload)
+{
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+  QString local_path = dir.filePath("scout.mp4");
+
+  S3StandIn s3;
+  s3.objects["/videos/scout.mp4"] = Footage(3 * 1024 * 1024);
+  s3.object_etags["/videos/scout.mp4"] = "\"v1\"";
+  s3.ranges_until_change = 1;
+
+  MinIOClient client;
+  client.SetRangedDownload(1024 * 1024, 1);
+  OLIVE_ASSERT(client.Initialize(s3.Endpoint(), kAccessKey, kSecretKey, false));
+
+  QString downloaded;
+  QString failure;
+  QObject::connect(&client, &MinIOClient::FileDownloaded, [&](const QString&, const QString& path) { downloaded = path; });
+  QObject::connect(&client, &MinIOClient::DownloadFailed, [&](const QString&, const QString& error) { failure = error; });
+
+  // The second range's If-Match no longer holds, so the server answers 412
+  OLIVE_ASSERT(!client.DownloadFile("videos", "scout.mp4", local_path).isEmpty());
+  OLIVE_ASSERT(WaitFor([&]() { return !downloaded.isEmpty() || !failure.isEmpty(); }, 30000));
+  OLIVE_ASSERT(downloaded.isEmpty());
+  OLIVE_ASSERT(failure.contains("changed"));
+
+  // Nothing of the old version is kept to be mixed with the new one
+  OLIVE_ASSERT(!QFile::exists(local_path));
+  OLIVE_ASSERT(!QFile::exists(local_path + ".part"));
+  OLIVE_ASSERT(!QFile::exists(local_path + ".part.json"));
+
+  OLIVE_TEST_END;
+}
+
+}
@@ -0,0 +1,294 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Triangle Defense Sync Tests
+***/
+
+#include "testutil.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QStandardPaths>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTimer>
+#include <QUrlQuery>
+
+#include <functional>
+
+#include "triangle_defense_sync.h"
+
+namespace olive {
+
+namespace {
+
+/**
+ * @brief Local Supabase endpoint for the sync under test
+ *
+ * Answers /rest/v1/formations the way PostgREST does: rows filtered by the
+ * gte/lte video_timestamp bounds, in timestamp order, then offset and limit
+ * applied. Every request's query is recorded, and the page at one offset
+ * can be made to fail.
+ */
+class SupabaseStandIn
+{
+public:
+  SupabaseStandIn()
+  {
+    server_.listen(QHostAddress::LocalHost);
+    QObject::connect(&server_, &QTcpServer::newConnection, [this]() {
+      while (QTcpSocket* socket = server_.nextPendingConnection()) {
+        QObject::connect(socket, &QTcpSocket::readyRead, socket, [this, socket]() { Serve(socket); });
+        QObject::connect(socket, &QTcpSocket::disconnected, socket, [this, socket]() {
+          buffers_.remove(socket);
+          socket->deleteLater();
+        });
+      }
+    });
+  }
+
+  QString Url() const { return QString("http://127.0.0.1:%1").arg(server_.serverPort()); }
+
+  void AddRows(qint64 video_timestamp, int count)
+  {
+    for (int i = 0; i < count; i++) {
+      rows_.append(qMakePair(video_timestamp, QString("row_%1").arg(rows_.size())));
+    }
+    std::stable_sort(rows_.begin(), rows_.end(),
+                     [](const Row& a, const Row& b) { return a.first < b.first; });
+  }
+
+  QList<QUrlQuery> queries;
+  int fail_offset = -1;  // Answer 500 to the page at this offset
+
+private:
+  using Row = QPair<qint64, QString>;
+
+  void Serve(QTcpSocket* socket)
+  {
+    QByteArray& buffer = buffers_[socket];
+    buffer += socket->readAll();
+
+    for (;;) {
+      int header_end = buffer.indexOf("\r\n\r\n");
+      if (header_end < 0) {
+        return;
+      }
+
+      QByteArray request_line = buffer.left(buffer.indexOf("\r\n"));
+      buffer.remove(0, header_end + 4);
+      Respond(socket, QUrl(QString::fromUtf8(request_line.split(' ').value(1))));
+    }
+  }
+
+  void Respond(QTcpSocket* socket, const QUrl& target)
+  {
+    QUrlQuery query(target);
+    queries.append(query);
+
+    qint64 start = 0;
+    qint64 end = 0;
+    for (const QString& bound : query.allQueryItemValues("video_timestamp")) {
+      if (bound.startsWith("gte.")) {
+        start = bound.mid(4).toLongLong();
+      } else if (bound.startsWith("lte.")) {
+        end = bound.mid(4).toLongLong();
+      }
+    }
+    int offset = query.queryItemValue("offset").toInt();
+    int limit = query.queryItemValue("limit").toInt();
+    if (offset == fail_offset) {
+      socket->write("HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n");
+      return;
+    }
+
+    QJsonArray page;
+    int skipped = 0;
+    for (const Row& row : rows_) {
+      if (row.first < start || row.first > end) {
+        continue;
+      }
+      if (skipped++ < offset) {
+        continue;
+      }
+      if (page.size() >= limit) {
+        break;
+      }
+
+      QJsonObject formation;
+      formation["id"] = row.second;
+      formation["formation_type"] = "LARRY";
+      formation["confidence"] = 0.9;
+      formation["video_timestamp"] = row.first;
+      formation["detection_timestamp"] = row.first;
+      page.append(formation);
+    }
+
+    QByteArray body = QJsonDocument(page).toJson(QJsonDocument::Compact);
+    socket->write("HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: "
+                  + QByteArray::number(body.size()) + "\r\n\r\n" + body);
+  }
+
+  QTcpServer server_;
+  QHash<QTcpSocket*, QByteArray> buffers_;
+  QList<Row> rows_;
+};
+
+bool WaitFor(const std::function<bool()>& done, int timeout_ms)
+{
+  QElapsedTimer timer;
+  timer.start();
+
+  QEventLoop loop;
+  QTimer poll;
+  poll.setInterval(10);
+  QObject::connect(&poll, &QTimer::timeout, &loop, [&]() {
+    if (done() || timer.elapsed() > timeout_ms) {
+      loop.quit();
+    }
+  });
+  poll.start();
+  loop.exec();
+
+  return done();
+}
+
+// Starts each test from an empty formation cache
+void ResetCache()
+{
+  QStandardPaths::setTestModeEnabled(true);
+  QString app_data_path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+  QFile::remove(QDir(app_data_path).filePath("triangle_defense_cache.db"));
+}
+
+bool Idle(const TriangleDefenseSync& sync)
+{
+  return sync.GetSyncStatistics()["fetches_in_flight"].toInt() == 0;
+}
+
+} // namespace
+
+OLIVE_ADD_TEST(FullPageOnOneTimestampPagesPastIt)
+{
+  ResetCache();
+
+  // More rows on the window's first timestamp than one page holds
+  SupabaseStandIn supabase;
+  supabase.AddRows(1000, 1500);
+  for (qint64 timestamp = 2000; timestamp < 7000; timestamp += 100) {
+    supabase.AddRows(timestamp, 1);
+  }
+
+  TriangleDefenseSync sync;
+  QSet<QString> received;
+  QObject::connect(&sync, &TriangleDefenseSync::FormationDetected,
+                   [&received](const FormationData& formation) { received.insert(formation.formation_id); });
+
+  sync.SetPrefetchWindow(10000, 0);
+  OLIVE_ASSERT(sync.Initialize(supabase.Url(), "anon-key"));
+  sync.SetVideoTimestamp(1000);
+
+  OLIVE_ASSERT(WaitFor([&]() { return received.size() >= 1550 && Idle(sync); }, 30000));
+
+  // The second page resumes by offset instead of asking for the first again
+  OLIVE_ASSERT_EQUAL(supabase.queries.size(), 2);
+  OLIVE_ASSERT(!supabase.queries[0].hasQueryItem("offset"));
+  OLIVE_ASSERT(supabase.queries[1].queryItemValue("offset") == "1000");
+  OLIVE_ASSERT(supabase.queries[1].allQueryItemValues("video_timestamp").contains("gte.1000"));
+  OLIVE_ASSERT_EQUAL(received.size(), 1550);
+
+  // Nothing left to fetch for the same window
+  sync.SetVideoTimestamp(1000);
+  OLIVE_ASSERT(Idle(sync));
+  OLIVE_ASSERT_EQUAL(supabase.queries.size(), 2);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(TruncatedPageResumesAtLastRow)
+{
+  ResetCache();
+
+  SupabaseStandIn supabase;
+  for (qint64 timestamp = 1000; timestamp < 2200; timestamp++) {
+    supabase.AddRows(timestamp, 1);
+  }
+
+  TriangleDefenseSync sync;
+  QSet<QString> received;
+  QObject::connect(&sync, &TriangleDefenseSync::FormationDetected,
+                   [&received](const FormationData& formation) { received.insert(formation.formation_id); });
+
+  sync.SetPrefetchWindow(10000, 0);
+  OLIVE_ASSERT(sync.Initialize(supabase.Url(), "anon-key"));
+  sync.SetVideoTimestamp(1000);
+
+  OLIVE_ASSERT(WaitFor([&]() { return received.size() >= 1200 && Idle(sync); }, 30000));
+
+  // The first page ends at 1999, so the rest of the window starts there
+  OLIVE_ASSERT_EQUAL(supabase.queries.size(), 2);
+  OLIVE_ASSERT(supabase.queries[1].allQueryItemValues("video_timestamp").contains("gte.1999"));
+  OLIVE_ASSERT(!supabase.queries[1].hasQueryItem("offset"));
+  OLIVE_ASSERT_EQUAL(received.size(), 1200);
+
+  OLIVE_TEST_END;
+}
+
+OLIVE_ADD_TEST(ExportFetchesRangeLargerThanCache)
+{
+  ResetCache();
+
+  SupabaseStandIn supabase;
+  for (qint64 timestamp = 0; timestamp < 250000; timestamp += 100) {
+    supabase.AddRows(timestamp, 1);
+  }
+
+  // The prefetch window only ever loads the first second
+  TriangleDefenseSync sync;
+  sync.SetPrefetchWindow(1000, 0);
+  OLIVE_ASSERT(sync.Initialize(supabase.Url(), "anon-key"));
+  sync.SetVideoTimestamp(0);
+  OLIVE_ASSERT(WaitFor([&]() { return !sync.GetFormationsInRange(0, 1000).isEmpty() && Idle(sync); }, 5000));
+  OLIVE_ASSERT(sync.GetFormationsInRange(50000, 249900).isEmpty());
+
+  QJsonArray track;
+  OLIVE_ASSERT(sync.ExportFormationTrack(50000, 249900, &track));
+  OLIVE_ASSERT_EQUAL(track.size(), 2000);
+  for (int i = 0; i < track.size(); i++) {
+    OLIVE_ASSERT_EQUAL(track[i].toObject()["video_timestamp"].toVariant().toLongLong(), i * 100LL);
+  }
+
+  // Paged by offset over the one range
+  int pages = 0;
+  for (const QUrlQuery& query : supabase.queries) {
+    if (query.allQueryItemValues("video_timestamp").contains("gte.50000")) {
+      pages++;
+    }
+  }
+  OLIVE_ASSERT_EQUAL(pages, 3);
+
+  // A failed page fails the export instead of writing a short track
+  supabase.fail_offset = 1000;
+  QJsonArray partial;
+  OLIVE_ASSERT(!sync.ExportFormationTrack(50000, 249900, &partial));
+  OLIVE_ASSERT(partial.isEmpty());
+
+  QTemporaryDir dir;
+  OLIVE_ASSERT(dir.isValid());
+  QString track_path = dir.filePath("track.json");
+  OLIVE_ASSERT(!sync.SaveFormationTrack(track_path, 50000, 249900));
+  OLIVE_ASSERT(!QFile::exists(track_path));
+
+  OLIVE_TEST_END;
+}
+
+}
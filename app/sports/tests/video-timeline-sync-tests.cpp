@@ -0,0 +1,58 @@
+/***
+  Apache-Cleats Sports Editor
+  Copyright (C) 2024 AnalyzeMyTeam
+
+  Video Timeline Sync Tests
+***/
+
+#include "testutil.h"
+
+#include "video_timeline_sync.h"
+
+namespace olive {
+
+namespace {
+
+TimelineMarker MakeMarker(qint64 timestamp)
+{
+  TimelineMarker marker;
+  marker.type = TimelineMarkerType::ManualAnnotation;
+  marker.timestamp = timestamp;
+  marker.label = "Blitz";
+  return marker;
+}
+
+} // namespace
+
+OLIVE_ADD_TEST(DirectWritesAreReadBackOnSameThread)
+{
+  VideoTimelineSync sync;
+
+  // No event loop pass between a write and the query that follows it
+  QString marker_id = sync.AddTimelineMarker(MakeMarker(5000));
+  OLIVE_ASSERT(!marker_id.isEmpty());
+  QList<TimelineMarker> markers = sync.GetMarkersInRange(4000, 6000);
+  OLIVE_ASSERT_EQUAL(markers.size(), 1);
+  OLIVE_ASSERT(markers.first().marker_id == marker_id);
+  OLIVE_ASSERT(sync.GetMarkerAt(5200, TimelineMarkerType::ManualAnnotation).marker_id == marker_id);
+
+  OLIVE_ASSERT(sync.UpdateTimelineMarker(marker_id, MakeMarker(9000)));
+  OLIVE_ASSERT(sync.GetMarkersInRange(4000, 6000).isEmpty());
+  OLIVE_ASSERT_EQUAL(sync.GetMarkersInRange(8000, 10000).size(), 1);
+
+  OLIVE_ASSERT(sync.RemoveTimelineMarker(marker_id));
+  OLIVE_ASSERT(sync.GetMarkersInRange(0, 20000).isEmpty());
+
+  // Several writes before one read
+  for (qint64 timestamp = 1000; timestamp <= 3000; timestamp += 1000) {
+    OLIVE_ASSERT(!sync.AddTimelineMarker(MakeMarker(timestamp)).isEmpty());
+  }
+  markers = sync.GetMarkersInRange(0, 20000);
+  OLIVE_ASSERT_EQUAL(markers.size(), 3);
+  OLIVE_ASSERT_EQUAL(markers.first().timestamp, 1000);
+  OLIVE_ASSERT_EQUAL(markers.last().timestamp, 3000);
+
+  OLIVE_TEST_END;
+}
+
+}
@@ -9,18 +9,80 @@
 #include "triangle_defense_sync.h"
 
 #include <QDebug>
+#include <QEventLoop>
 #include <QSqlError>
 #include <QSqlRecord>
 #include <QNetworkRequest>
 #include <QUrlQuery>
 #include <QStandardPaths>
 #include <QDir>
+#include <QFile>
 #include <QCoreApplication>
 #include <QRegularExpression>
 #include <QtMath>
 
+#include <algorithm>
+
 namespace olive {
 
+namespace {
+
+constexpr int kFormationFetchLimit = 1000;
+constexpr qint64 kPrefetchMergeGapMs = 5000;     // Refetching this much beats another round trip
+constexpr qint64 kMaxPrefetchSpanMs = 120000;
+constexpr double kMaxPrefetchRateScale = 8.0;
+constexpr qint64 kMaxPrefetchBackoffMs = 30000;
+
+using TimeRange = QPair<qint64, qint64>;
+
+// Merge [start, end] into a map of disjoint start -> end ranges
+void AddRange(QMap<qint64, qint64>& ranges, qint64 start, qint64 end)
+{
+  auto it = ranges.upperBound(start);
+  if (it != ranges.begin()) {
+    auto previous = it;
+    --previous;
+    if (previous.value() >= start - 1) {
+      start = previous.key();
+      end = qMax(end, previous.value());
+      it = ranges.erase(previous);
+    }
+  }
+  while (it != ranges.end() && it.key() <= end + 1) {
+    end = qMax(end, it.value());
+    it = ranges.erase(it);
+  }
+  ranges.insert(start, end);
+}
+
+// Parts of [start, end] that no range covers, in order
+QVector<TimeRange> UncoveredRanges(const QMap<qint64, qint64>& ranges, qint64 start, qint64 end)
+{
+  QVector<TimeRange> gaps;
+  qint64 cursor = start;
+  
+  auto it = ranges.upperBound(start);
+  if (it != ranges.constBegin()) {
+    --it;
+  }
+  for (; it != ranges.constEnd() && it.key() <= end && cursor <= end; ++it) {
+    if (it.value() < cursor) {
+      continue;
+    }
+    if (it.key() > cursor) {
+      gaps.append(TimeRange(cursor, it.key() - 1));
+    }
+    cursor = it.value() + 1;
+  }
+  if (cursor <= end) {
+    gaps.append(TimeRange(cursor, end));
+  }
+  
+  return gaps;
+}
+
+} // namespace
+
 TriangleDefenseSync::TriangleDefenseSync(QObject* parent)
   : QObject(parent)
   , supabase_url_("https://your-project.supabase.co")
@@ -32,7 +94,6 @@ TriangleDefenseSync::TriangleDefenseSync(QObject* parent)
   , max_cached_formations_(10000)
   , network_manager_(nullptr)
   , websocket_(nullptr)
-  , current_reply_(nullptr)
   , sync_timer_(nullptr)
   , cache_cleanup_timer_(nullptr)
   , heartbeat_timer_(nullptr)
@@ -43,6 +104,11 @@ TriangleDefenseSync::TriangleDefenseSync(QObject* parent)
   , last_data_fetch_(0)
   , video_playing_(false)
   , video_rate_(1.0)
+  , prefetch_lookahead_ms_(30000)
+  , prefetch_lookbehind_ms_(5000)
+  , max_prefetch_requests_(2)
+  , prefetch_failures_(0)
+  , prefetch_retry_at_(0)
   , reconnection_attempts_(0)
   , reconnect_timer_(nullptr)
   , last_heartbeat_(0)
@@ -136,9 +202,10 @@ void TriangleDefenseSync::Shutdown()
   }
 
   // Cancel network requests
-  if (current_reply_) {
-    current_reply_->abort();
-    current_reply_ = nullptr;
+  QList<QNetworkReply*> replies = formation_fetches_.keys();
+  formation_fetches_.clear();
+  for (QNetworkReply* reply : replies) {
+    reply->abort();
   }
 
   // Close database
@@ -159,47 +226,34 @@ FormationData TriangleDefenseSync::GetFormationAt(qint64 video_timestamp) const
   QMutexLocker locker(&cache_mutex_);
   
   // Check exact timestamp match first
-  if (formation_cache_.contains(video_timestamp)) {
+  if (const FormationData* exact = formation_cache_.find(video_timestamp)) {
     stats_.cache_hits++;
-    return formation_cache_[video_timestamp];
+    return *exact;
   }
 
   // Find closest formations for interpolation
-  FormationData closest_before, closest_after;
-  qint64 min_before_diff = LLONG_MAX;
-  qint64 min_after_diff = LLONG_MAX;
-  bool found_before = false, found_after = false;
-
-  for (auto it = formation_cache_.constBegin(); it != formation_cache_.constEnd(); ++it) {
-    qint64 timestamp_diff = it.key() - video_timestamp;
-    
-    if (timestamp_diff <= 0 && qAbs(timestamp_diff) < min_before_diff) {
-      min_before_diff = qAbs(timestamp_diff);
-      closest_before = it.value();
-      found_before = true;
-    } else if (timestamp_diff > 0 && timestamp_diff < min_after_diff) {
-      min_after_diff = timestamp_diff;
-      closest_after = it.value();
-      found_after = true;
-    }
-  }
+  auto neighbours = formation_cache_.neighbours(video_timestamp);
+  bool found_before = neighbours.before != nullptr;
+  bool found_after = neighbours.after != nullptr;
+  qint64 min_before_diff = found_before ? video_timestamp - neighbours.before_time : LLONG_MAX;
+  qint64 min_after_diff = found_after ? neighbours.after_time - video_timestamp : LLONG_MAX;
 
   // Return interpolated formation if we have both before and after
   if (found_before && found_after && min_before_diff < 5000 && min_after_diff < 5000) {
     // Only interpolate if formations are within 5 seconds
     stats_.cache_hits++;
-    return TriangleDefenseUtils::InterpolateFormation(closest_before, closest_after, video_timestamp);
+    return TriangleDefenseUtils::InterpolateFormation(*neighbours.before, *neighbours.after, video_timestamp);
   }
 
   // Return closest formation if within reasonable range
   if (found_before && min_before_diff < 10000) { // 10 seconds
     stats_.cache_hits++;
-    return closest_before;
+    return *neighbours.before;
   }
   
   if (found_after && min_after_diff < 10000) { // 10 seconds
     stats_.cache_hits++;
-    return closest_after;
+    return *neighbours.after;
   }
 
   // No formation found
@@ -213,19 +267,60 @@ QList<FormationData> TriangleDefenseSync::GetFormationsInRange(qint64 start_time
   
   QList<FormationData> formations;
   
-  for (auto it = formation_cache_.constBegin(); it != formation_cache_.constEnd(); ++it) {
-    if (it.key() >= start_timestamp && it.key() <= end_timestamp) {
-      formations.append(it.value());
-    }
+  // Store is already time-sorted, so the range comes back in order
+  formation_cache_.forEachInRange(start_timestamp, end_timestamp,
+                                  [&formations](qint64, const FormationData& formation) {
+                                    formations.append(formation);
+                                  });
+  
+  return formations;
+}
+
+bool TriangleDefenseSync::ExportFormationTrack(qint64 start_timestamp, qint64 end_timestamp,
+                                               QJsonArray* track) const
+{
+  QList<FormationData> formations;
+  if (!FetchFormationRange(start_timestamp, end_timestamp, &formations)) {
+    qWarning() << "Formation track" << start_timestamp << "to" << end_timestamp << "could not be fetched completely";
+    return false;
   }
   
-  // Sort by timestamp
-  std::sort(formations.begin(), formations.end(), 
-           [](const FormationData& a, const FormationData& b) {
-             return a.video_timestamp < b.video_timestamp;
-           });
+  *track = QJsonArray();
+  for (const FormationData& formation : formations) {
+    QJsonObject row;
+    row["id"] = formation.formation_id;
+    row["formation_type"] = FormationTypeToString(formation.type);
+    row["recommended_call"] = TriangleCallToString(formation.recommended_call);
+    row["confidence"] = formation.confidence;
+    row["video_timestamp"] = formation.video_timestamp - start_timestamp;
+    row["player_positions"] = formation.player_positions;
+    track->append(row);
+  }
   
-  return formations;
+  return true;
+}
+
+bool TriangleDefenseSync::SaveFormationTrack(const QString& filename, qint64 start_timestamp,
+                                             qint64 end_timestamp) const
+{
+  QJsonArray track;
+  if (!ExportFormationTrack(start_timestamp, end_timestamp, &track)) {
+    return false;
+  }
+  
+  QFile file(filename);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+    qWarning() << "Failed to write formation track:" << filename << file.errorString();
+    return false;
+  }
+  
+  QByteArray data = QJsonDocument(track).toJson(QJsonDocument::Compact);
+  if (file.write(data) != data.size()) {
+    qWarning() << "Failed to write formation track:" << filename << file.errorString();
+    return false;
+  }
+  
+  return true;
 }
 
 QList<CoachingAlert> TriangleDefenseSync::GetActiveAlerts() const
@@ -303,12 +398,8 @@ void TriangleDefenseSync::SetVideoTimestamp(qint64 timestamp)
 {
   current_video_timestamp_ = timestamp;
   
-  // Check if we need to fetch more data
-  qint64 current_time = QDateTime::currentMSecsSinceEpoch();
-  if (current_time - last_data_fetch_ > 30000) { // Fetch every 30 seconds
-    RefreshFormationData();
-    last_data_fetch_ = current_time;
-  }
+  // Fetch whatever the window around the new position is missing
+  SchedulePrefetch();
 }
 
 void TriangleDefenseSync::SetRealTimeMode(bool enabled)
@@ -324,6 +415,13 @@ void TriangleDefenseSync::SetRealTimeMode(bool enabled)
   qInfo() << "Real-time mode" << (enabled ? "enabled" : "disabled");
 }
 
+void TriangleDefenseSync::SetPrefetchWindow(qint64 lookahead_ms, qint64 lookbehind_ms)
+{
+  prefetch_lookahead_ms_ = qMax(0LL, lookahead_ms);
+  prefetch_lookbehind_ms_ = qMax(0LL, lookbehind_ms);
+  SchedulePrefetch();
+}
+
 QJsonObject TriangleDefenseSync::GetSyncStatistics() const
 {
   QJsonObject stats;
@@ -335,9 +433,14 @@ QJsonObject TriangleDefenseSync::GetSyncStatistics() const
   stats["cache_misses"] = static_cast<qint64>(stats_.cache_misses);
   stats["cache_hit_ratio"] = static_cast<double>(stats_.cache_hits) / 
                             qMax(1LL, stats_.cache_hits + stats_.cache_misses);
+  stats["prefetch_requests"] = static_cast<qint64>(stats_.prefetch_requests);
+  stats["prefetch_cancelled"] = static_cast<qint64>(stats_.prefetch_cancelled);
+  stats["prefetch_coalesced"] = static_cast<qint64>(stats_.prefetch_coalesced);
+  stats["fetches_in_flight"] = formation_fetches_.size();
+  stats["prefetched_ranges"] = fetched_ranges_.size();
   stats["uptime_seconds"] = stats_.start_time.secsTo(QDateTime::currentDateTime());
   stats["is_connected"] = is_connected_;
-  stats["cached_formations"] = formation_cache_.size();
+  stats["cached_formations"] = static_cast<qint64>(formation_cache_.size());
   stats["cached_alerts"] = alert_cache_.size();
   
   return stats;
@@ -357,12 +460,21 @@ void TriangleDefenseSync::OnVideoPlaybackChanged(bool playing, qint64 position)
       sync_timer_->stop();
     }
   }
+  
+  SchedulePrefetch();
 }
 
 void TriangleDefenseSync::OnVideoSeekPerformed(qint64 new_position)
 {
   current_video_timestamp_ = new_position;
   
+  // Prefetches for where the playhead was are no use any more
+  qint64 window_start = 0;
+  qint64 window_end = 0;
+  PrefetchWindow(&window_start, &window_end);
+  CancelStalePrefetches(window_start, window_end);
+  SchedulePrefetch();
+  
   // Force immediate sync after seek
   OnSyncTimer();
 }
@@ -376,6 +488,9 @@ void TriangleDefenseSync::OnVideoRateChanged(double rate)
     int adjusted_interval = static_cast<int>(sync_interval_ms_ / qMax(0.1, rate));
     sync_timer_->setInterval(adjusted_interval);
   }
+  
+  // Faster playback reaches further ahead
+  SchedulePrefetch();
 }
 
 void TriangleDefenseSync::OnManualFormationMarked(qint64 timestamp, FormationType type, double confidence)
@@ -419,17 +534,16 @@ void TriangleDefenseSync::OnTriangleCallOverride(qint64 timestamp, TriangleCall
           << "at" << timestamp << "reason:" << reason;
 }
 
-void TriangleDefenseSync::OnSupabaseDataReceived()
+void TriangleDefenseSync::ProcessFormationReply(QNetworkReply* reply, const FormationFetch& fetch)
 {
-  QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-  if (!reply) {
-    return;
-  }
-  
   if (reply->error() != QNetworkReply::NoError) {
     qWarning() << "Supabase request failed:" << reply->errorString();
+    
+    // Back off so a dead server is not asked again on every tick
+    prefetch_failures_++;
+    prefetch_retry_at_ = QDateTime::currentMSecsSinceEpoch()
+                         + qMin(kMaxPrefetchBackoffMs, 500LL * (1LL << qMin(prefetch_failures_ - 1, 6)));
     HandleConnectionError(reply->errorString());
-    reply->deleteLater();
     return;
   }
   
@@ -439,51 +553,43 @@ void TriangleDefenseSync::OnSupabaseDataReceived()
   
   if (error.error != QJsonParseError::NoError) {
     qWarning() << "Failed to parse Supabase response:" << error.errorString();
-    reply->deleteLater();
     return;
   }
   
+  prefetch_failures_ = 0;
+  prefetch_retry_at_ = 0;
+  
   QJsonArray formations_array = doc.array();
   int formations_processed = 0;
+  qint64 last_timestamp = fetch.start;
   
   for (const QJsonValue& value : formations_array) {
-    QJsonObject obj = value.toObject();
-    
-    FormationData formation;
-    formation.formation_id = obj["id"].toString();
-    formation.type = ParseFormationType(obj["formation_type"].toString());
-    formation.confidence = obj["confidence"].toDouble();
-    formation.video_timestamp = obj["video_timestamp"].toVariant().toLongLong();
-    formation.detection_timestamp = obj["detection_timestamp"].toVariant().toLongLong();
-    formation.hash_position = obj["hash_position"].toString();
-    formation.field_zone = obj["field_zone"].toString();
-    formation.player_positions = obj["player_positions"].toObject();
-    formation.field_context = obj["field_context"].toObject();
-    
-    // Process M.E.L. results if available
-    if (obj.contains("mel_results")) {
-      QJsonObject mel_obj = obj["mel_results"].toObject();
-      formation.mel_results.making_score = mel_obj["making_score"].toDouble();
-      formation.mel_results.efficiency_score = mel_obj["efficiency_score"].toDouble();
-      formation.mel_results.logical_score = mel_obj["logical_score"].toDouble();
-      formation.mel_results.combined_score = mel_obj["combined_score"].toDouble();
-      formation.mel_results.stage_status = mel_obj["stage_status"].toString();
-      formation.mel_results.detailed_metrics = mel_obj["detailed_metrics"].toObject();
-    }
-    
-    formation.recommended_call = DetermineTriangleCall(formation);
+    FormationData formation = ParseFormationRow(value.toObject());
     
     UpdateFormationCache(formation);
     formations_processed++;
+    last_timestamp = qMax(last_timestamp, formation.video_timestamp);
     
     emit FormationDetected(formation);
   }
   
+  // A truncated page only covers up to its last row; the rest stays a gap.
+  // Rows at that timestamp are fetched again, which the cache absorbs.
+  qint64 covered_end = fetch.end;
+  if (formations_array.size() >= kFormationFetchLimit) {
+    covered_end = last_timestamp - 1;
+  }
+  if (covered_end >= fetch.start) {
+    AddRange(fetched_ranges_, fetch.start, covered_end);
+  } else {
+    // Every row sat on fetch.start, so restarting there would return the
+    // same page forever; page past them instead
+    FetchFormationsFromSupabase(fetch.start, fetch.end, fetch.prefetch,
+                                fetch.offset + formations_array.size());
+  }
+  
   qInfo() << "Processed" << formations_processed << "formations from Supabase";
   emit DataRefreshed(formations_processed, 0);
-  
-  reply->deleteLater();
-  current_reply_ = nullptr;
 }
 
 void TriangleDefenseSync::OnWebSocketConnected()
@@ -541,9 +647,23 @@ void TriangleDefenseSync::OnWebSocketMessageReceived(const QString& message)
   }
 }
 
-void TriangleDefenseSync::OnNetworkReplyFinished()
+void TriangleDefenseSync::OnFormationReplyFinished(QNetworkReply* reply)
 {
-  OnSupabaseDataReceived();
+  auto it = formation_fetches_.find(reply);
+  if (it == formation_fetches_.end()) {
+    // Cancelled as stale
+    reply->deleteLater();
+    return;
+  }
+  
+  FormationFetch fetch = it.value();
+  formation_fetches_.erase(it);
+  
+  ProcessFormationReply(reply, fetch);
+  reply->deleteLater();
+  
+  // Keep filling the window
+  SchedulePrefetch();
 }
 
 void TriangleDefenseSync::OnSyncTimer()
@@ -555,6 +675,9 @@ void TriangleDefenseSync::OnSyncTimer()
   stats_.sync_operations++;
   last_sync_timestamp_ = QDateTime::currentMSecsSinceEpoch();
   
+  // Move the prefetch window along with the playhead
+  SchedulePrefetch();
+  
   // Get current formation
   FormationData current_formation = GetFormationAt(current_video_timestamp_);
   
@@ -672,8 +795,6 @@ void TriangleDefenseSync::SetupDatabase()
 void TriangleDefenseSync::SetupNetworking()
 {
   network_manager_ = new QNetworkAccessManager(this);
-  connect(network_manager_, &QNetworkAccessManager::finished,
-          this, &TriangleDefenseSync::OnNetworkReplyFinished);
 }
 
 void TriangleDefenseSync::SetupWebSocket()
@@ -756,7 +877,7 @@ void TriangleDefenseSync::LoadFormationData()
     formation.mel_results.detailed_metrics = QJsonDocument::fromJson(
       query.value("mel_detailed_metrics").toString().toUtf8()).object();
     
-    formation_cache_[formation.video_timestamp] = formation;
+    formation_cache_.insert(formation.video_timestamp, formation);
   }
   
   qInfo() << "Loaded" << formation_cache_.size() << "formations from cache";
@@ -856,7 +977,7 @@ QString TriangleDefenseSync::TriangleCallToString(TriangleCall call) const
 void TriangleDefenseSync::UpdateFormationCache(const FormationData& formation)
 {
   QMutexLocker locker(&cache_mutex_);
-  formation_cache_[formation.video_timestamp] = formation;
+  formation_cache_.insert(formation.video_timestamp, formation);
   stats_.formations_processed++;
   
   // Store in database
@@ -963,37 +1084,222 @@ TriangleCall TriangleDefenseSync::DetermineTriangleCall(const FormationData& for
   }
 }
 
-bool TriangleDefenseSync::FetchFormationsFromSupabase(qint64 start_time, qint64 end_time)
+bool TriangleDefenseSync::FetchFormationsFromSupabase(qint64 start_time, qint64 end_time, bool prefetch,
+                                                      int offset)
 {
   if (supabase_url_.isEmpty() || api_key_.isEmpty()) {
     qWarning() << "Supabase credentials not configured";
     return false;
   }
   
+  QNetworkReply* reply = network_manager_->get(CreateFormationRequest(start_time, end_time, offset));
+  formation_fetches_.insert(reply, FormationFetch{start_time, end_time, prefetch, offset});
+  connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+    OnFormationReplyFinished(reply);
+  });
+  stats_.network_requests++;
+  last_data_fetch_ = QDateTime::currentMSecsSinceEpoch();
+  
+  qDebug() << "Fetching formations from Supabase:" << start_time << "to" << end_time
+           << (prefetch ? "(prefetch)" : "");
+  return true;
+}
+
+QNetworkRequest TriangleDefenseSync::CreateFormationRequest(qint64 start_time, qint64 end_time, int offset) const
+{
   QUrl url(supabase_url_ + "/rest/v1/formations");
   QUrlQuery query;
   query.addQueryItem("video_timestamp", QString("gte.%1").arg(start_time));
   query.addQueryItem("video_timestamp", QString("lte.%1").arg(end_time));
-  query.addQueryItem("order", "video_timestamp.asc");
-  query.addQueryItem("limit", "1000");
+  query.addQueryItem("order", "video_timestamp.asc,id.asc"); // Stable pages for offset paging
+  query.addQueryItem("limit", QString::number(kFormationFetchLimit));
+  if (offset > 0) {
+    query.addQueryItem("offset", QString::number(offset));
+  }
   url.setQuery(query);
   
   QNetworkRequest request(url);
   request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
   request.setRawHeader("Authorization", QString("Bearer %1").arg(api_key_).toUtf8());
   request.setRawHeader("apikey", api_key_.toUtf8());
+  return request;
+}
+
+FormationData TriangleDefenseSync::ParseFormationRow(const QJsonObject& row) const
+{
+  FormationData formation;
+  formation.formation_id = row["id"].toString();
+  formation.type = ParseFormationType(row["formation_type"].toString());
+  formation.confidence = row["confidence"].toDouble();
+  formation.video_timestamp = row["video_timestamp"].toVariant().toLongLong();
+  formation.detection_timestamp = row["detection_timestamp"].toVariant().toLongLong();
+  formation.hash_position = row["hash_position"].toString();
+  formation.field_zone = row["field_zone"].toString();
+  formation.player_positions = row["player_positions"].toObject();
+  formation.field_context = row["field_context"].toObject();
+  
+  // Process M.E.L. results if available
+  if (row.contains("mel_results")) {
+    QJsonObject mel_obj = row["mel_results"].toObject();
+    formation.mel_results.making_score = mel_obj["making_score"].toDouble();
+    formation.mel_results.efficiency_score = mel_obj["efficiency_score"].toDouble();
+    formation.mel_results.logical_score = mel_obj["logical_score"].toDouble();
+    formation.mel_results.combined_score = mel_obj["combined_score"].toDouble();
+    formation.mel_results.stage_status = mel_obj["stage_status"].toString();
+    formation.mel_results.detailed_metrics = mel_obj["detailed_metrics"].toObject();
+  }
   
-  if (current_reply_) {
-    current_reply_->abort();
+  formation.recommended_call = DetermineTriangleCall(formation);
+  return formation;
+}
+
+bool TriangleDefenseSync::FetchFormationRange(qint64 start_time, qint64 end_time,
+                                              QList<FormationData>* formations) const
+{
+  if (supabase_url_.isEmpty() || api_key_.isEmpty() || !network_manager_) {
+    qWarning() << "Supabase credentials not configured";
+    return false;
   }
   
-  current_reply_ = network_manager_->get(request);
-  stats_.network_requests++;
+  // One fixed range, paged by offset until a page comes back short
+  QList<FormationData> fetched;
+  for (int offset = 0;; offset += kFormationFetchLimit) {
+    QNetworkReply* reply = network_manager_->get(CreateFormationRequest(start_time, end_time, offset));
+    
+    QEventLoop loop;
+    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+    loop.exec();
+    
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(reply->readAll(), &error);
+    bool ok = reply->error() == QNetworkReply::NoError && error.error == QJsonParseError::NoError && doc.isArray();
+    if (!ok) {
+      qWarning() << "Formation page at offset" << offset << "failed:"
+                 << (reply->error() != QNetworkReply::NoError ? reply->errorString() : error.errorString());
+    }
+    reply->deleteLater();
+    if (!ok) {
+      return false;
+    }
+    
+    QJsonArray rows = doc.array();
+    for (const QJsonValue& value : rows) {
+      fetched.append(ParseFormationRow(value.toObject()));
+    }
+    if (rows.size() < kFormationFetchLimit) {
+      break;
+    }
+  }
   
-  qDebug() << "Fetching formations from Supabase:" << start_time << "to" << end_time;
+  *formations = fetched;
   return true;
 }
 
+void TriangleDefenseSync::PrefetchWindow(qint64* window_start, qint64* window_end) const
+{
+  // Reach further ahead the faster the video plays; reverse playback looks back
+  double scale = qBound(1.0, qAbs(video_rate_), kMaxPrefetchRateScale);
+  qint64 ahead = static_cast<qint64>(prefetch_lookahead_ms_ * scale);
+  qint64 behind = prefetch_lookbehind_ms_;
+  if (video_rate_ < 0.0) {
+    std::swap(ahead, behind);
+  }
+  
+  *window_start = qMax(0LL, current_video_timestamp_ - behind);
+  *window_end = current_video_timestamp_ + ahead;
+}
+
+void TriangleDefenseSync::SchedulePrefetch()
+{
+  if (!is_initialized_ || supabase_url_.isEmpty() || api_key_.isEmpty()) {
+    return;
+  }
+  if (QDateTime::currentMSecsSinceEpoch() < prefetch_retry_at_) {
+    return;
+  }
+  
+  qint64 window_start = 0;
+  qint64 window_end = 0;
+  PrefetchWindow(&window_start, &window_end);
+  
+  // Loaded and in-flight spans are both covered
+  QMap<qint64, qint64> covered = fetched_ranges_;
+  int prefetches_in_flight = 0;
+  for (auto it = formation_fetches_.constBegin(); it != formation_fetches_.constEnd(); ++it) {
+    AddRange(covered, it->start, it->end);
+    if (it->prefetch) {
+      prefetches_in_flight++;
+    }
+  }
+  
+  if (prefetches_in_flight >= max_prefetch_requests_) {
+    return;
+  }
+  
+  // Slivers away from the playhead wait until they are worth a request,
+  // so steady playback refills in strides instead of every tick
+  const qint64 min_span = qMax(1LL, prefetch_lookahead_ms_ / 4);
+  const qint64 position = current_video_timestamp_;
+  auto distance = [position](const TimeRange& range) {
+    if (range.second < position) {
+      return position - range.second;
+    }
+    return qMax(0LL, range.first - position);
+  };
+  
+  // Merge gaps separated by little loaded data, capping the span per request
+  QVector<TimeRange> requests;
+  for (const TimeRange& gap : UncoveredRanges(covered, window_start, window_end)) {
+    if (gap.second - gap.first + 1 < min_span && distance(gap) > min_span) {
+      continue;
+    }
+    
+    if (!requests.isEmpty() && gap.first - requests.last().second <= kPrefetchMergeGapMs
+        && gap.second - requests.last().first < kMaxPrefetchSpanMs) {
+      requests.last().second = gap.second;
+      stats_.prefetch_coalesced++;
+      continue;
+    }
+    
+    for (qint64 start = gap.first; start <= gap.second; start += kMaxPrefetchSpanMs) {
+      requests.append(TimeRange(start, qMin(gap.second, start + kMaxPrefetchSpanMs - 1)));
+    }
+  }
+  
+  // Nearest the playhead first
+  std::stable_sort(requests.begin(), requests.end(),
+                   [&distance](const TimeRange& a, const TimeRange& b) {
+                     return distance(a) < distance(b);
+                   });
+  
+  for (const TimeRange& range : requests) {
+    if (prefetches_in_flight >= max_prefetch_requests_) {
+      break;
+    }
+    if (FetchFormationsFromSupabase(range.first, range.second, true)) {
+      stats_.prefetch_requests++;
+      prefetches_in_flight++;
+    }
+  }
+}
+
+void TriangleDefenseSync::CancelStalePrefetches(qint64 window_start, qint64 window_end)
+{
+  QList<QNetworkReply*> stale;
+  for (auto it = formation_fetches_.constBegin(); it != formation_fetches_.constEnd(); ++it) {
+    if (it->prefetch && (it->end < window_start || it->start > window_end)) {
+      stale.append(it.key());
+    }
+  }
+  
+  // Forget them first; their finished() then falls through to deleteLater()
+  for (QNetworkReply* reply : stale) {
+    formation_fetches_.remove(reply);
+    reply->abort();
+    stats_.prefetch_cancelled++;
+  }
+}
+
 void TriangleDefenseSync::ProcessFormationDetection(const QJsonObject& detection)
 {
   FormationData formation;
@@ -1025,16 +1331,14 @@ void TriangleDefenseSync::CleanupOldData()
   // Clean formations cache
   {
     QMutexLocker locker(&cache_mutex_);
-    auto it = formation_cache_.begin();
-    while (it != formation_cache_.end()) {
-      if (it.value().detection_timestamp < cutoff_time) {
-        it = formation_cache_.erase(it);
-      } else {
-        ++it;
-      }
-    }
+    formation_cache_.removeIf([cutoff_time](const FormationData& formation) {
+      return formation.detection_timestamp < cutoff_time;
+    });
   }
   
+  // Evicted rows can sit anywhere on the timeline, so nothing counts as loaded
+  fetched_ranges_.clear();
+  
   // Clean database
   QSqlQuery query(cache_db_);
   query.prepare("DELETE FROM formations WHERE detection_timestamp < ?");
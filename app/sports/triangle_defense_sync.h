@@ -18,12 +18,16 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QDateTime>
+#include <QHash>
+#include <QMap>
 #include <QQueue>
 #include <QMutex>
 #include <QThread>
 #include <QSqlDatabase>
 #include <QSqlQuery>
 
+#include "formation_history_store.h"
+
 namespace olive {
 
 /**
@@ -110,6 +114,14 @@ struct CoachingAlert {
 
 /**
  * @brief Triangle Defense synchronization service
+ *
+ * Formations are prefetched from Supabase ahead of the playhead: playback,
+ * rate and seek events move a window that reaches further ahead the faster
+ * the video plays, and only the parts of it not already loaded or in
+ * flight are requested, with nearby gaps merged into one request. A seek
+ * aborts prefetches that no longer overlap the window. Requests go to the
+ * URL given to Initialize(), so a plain local HTTP server answering
+ * /rest/v1/formations can stand in for Supabase.
  */
 class TriangleDefenseSync : public QObject
 {
@@ -140,6 +152,24 @@ public:
    */
   QList<FormationData> GetFormationsInRange(qint64 start_timestamp, qint64 end_timestamp) const;
 
+  /**
+   * @brief Export formations in a time range as rows for the Formation Overlay node
+   *
+   * The cache may only hold part of a long range, so the whole range is
+   * fetched from Supabase, a page at a time; this blocks until every page
+   * has arrived. Returns false, leaving track untouched, if any page fails.
+   * Timestamps are shifted by -start_timestamp so they line up with the
+   * start of the exported clip.
+   */
+  bool ExportFormationTrack(qint64 start_timestamp, qint64 end_timestamp, QJsonArray* track) const;
+
+  /**
+   * @brief Write ExportFormationTrack() to a JSON file for the node's Formation Track input
+   *
+   * Nothing is written when the export fails.
+   */
+  bool SaveFormationTrack(const QString& filename, qint64 start_timestamp, qint64 end_timestamp) const;
+
   /**
    * @brief Get active coaching alerts
    */
@@ -170,6 +200,13 @@ public:
    */
   void SetRealTimeMode(bool enabled);
 
+  /**
+   * @brief Set how far formations are prefetched around the playhead
+   *
+   * The lookahead is for 1x playback and grows with the playback rate.
+   */
+  void SetPrefetchWindow(qint64 lookahead_ms, qint64 lookbehind_ms);
+
   /**
    * @brief Get synchronization statistics
    */
@@ -224,16 +261,27 @@ signals:
   void DataRefreshed(int formation_count, int alert_count);
 
 private slots:
-  void OnSupabaseDataReceived();
   void OnWebSocketConnected();
   void OnWebSocketDisconnected();
   void OnWebSocketMessageReceived(const QString& message);
-  void OnNetworkReplyFinished();
+  void OnFormationReplyFinished(QNetworkReply* reply);
   void OnSyncTimer();
   void OnCacheCleanupTimer();
   void OnHeartbeatTimer();
 
 private:
+  /**
+   * @brief Formation request in flight, covering [start, end] of video time
+   *
+   * offset skips rows already read when a full page shared one timestamp.
+   */
+  struct FormationFetch {
+    qint64 start;
+    qint64 end;
+    bool prefetch;
+    int offset;
+  };
+
   void SetupDatabase();
   void SetupNetworking();
   void SetupWebSocket();
@@ -244,7 +292,16 @@ private:
   void UpdateFormationCache(const FormationData& formation);
   void UpdateAlertCache(const CoachingAlert& alert);
   
-  bool FetchFormationsFromSupabase(qint64 start_time, qint64 end_time);
+  bool FetchFormationsFromSupabase(qint64 start_time, qint64 end_time, bool prefetch = false,
+                                   int offset = 0);
+  void ProcessFormationReply(QNetworkReply* reply, const FormationFetch& fetch);
+  QNetworkRequest CreateFormationRequest(qint64 start_time, qint64 end_time, int offset) const;
+  FormationData ParseFormationRow(const QJsonObject& row) const;
+  bool FetchFormationRange(qint64 start_time, qint64 end_time, QList<FormationData>* formations) const;
+  
+  void SchedulePrefetch();
+  void CancelStalePrefetches(qint64 window_start, qint64 window_end);
+  void PrefetchWindow(qint64* window_start, qint64* window_end) const;
   bool FetchAlertsFromSupabase();
   bool UpdateSupabaseFormation(const FormationData& formation);
   
@@ -278,7 +335,7 @@ private:
   // Network components
   QNetworkAccessManager* network_manager_;
   QWebSocket* websocket_;
-  QNetworkReply* current_reply_;
+  QHash<QNetworkReply*, FormationFetch> formation_fetches_; // In flight
   
   // Database
   QSqlDatabase cache_db_;
@@ -291,7 +348,7 @@ private:
   
   // Data caches
   mutable QMutex cache_mutex_;
-  QMap<qint64, FormationData> formation_cache_; // timestamp -> formation
+  amt::sports::TimeIndexedStore<qint64, FormationData> formation_cache_; // sorted by video timestamp
   QMap<QString, CoachingAlert> alert_cache_;    // alert_id -> alert
   MELResult latest_mel_results_;
   QJsonObject pipeline_status_;
@@ -305,6 +362,14 @@ private:
   bool video_playing_;
   double video_rate_;
   
+  // Predictive prefetch
+  QMap<qint64, qint64> fetched_ranges_; // Disjoint start -> end spans already loaded
+  qint64 prefetch_lookahead_ms_;
+  qint64 prefetch_lookbehind_ms_;
+  int max_prefetch_requests_;
+  int prefetch_failures_;
+  qint64 prefetch_retry_at_;
+  
   // Statistics
   struct SyncStats {
     qint64 formations_processed;
@@ -313,10 +378,14 @@ private:
     qint64 network_requests;
     qint64 cache_hits;
     qint64 cache_misses;
+    qint64 prefetch_requests;
+    qint64 prefetch_cancelled;
+    qint64 prefetch_coalesced;   // Gaps merged into another request
     QDateTime start_time;
     
     SyncStats() : formations_processed(0), alerts_processed(0), sync_operations(0),
                   network_requests(0), cache_hits(0), cache_misses(0),
+                  prefetch_requests(0), prefetch_cancelled(0), prefetch_coalesced(0),
                   start_time(QDateTime::currentDateTime()) {}
   } stats_;
   
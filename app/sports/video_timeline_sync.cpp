@@ -20,11 +20,25 @@
 #include <QtMath>
 #include <QJsonDocument>
 #include <QJsonParseError>
+#include <QHash>
+#include <QThread>
+
+#include <algorithm>
 
 #include "panel/timeline/timeline.h"
 
 namespace olive {
 
+namespace {
+
+// Marker events queued by the analysis slots; the event id is the marker id
+const QString kMarkerUpsertEvent = QStringLiteral("marker_upsert");
+const QString kMarkerPatchEvent = QStringLiteral("marker_patch");   // Description and metadata only
+const QString kMarkerRemoveEvent = QStringLiteral("marker_remove");
+const QString kPositionUpdateEvent = QStringLiteral("position_update");
+
+} // namespace
+
 VideoTimelineSync::VideoTimelineSync(QObject* parent)
   : QObject(parent)
   , triangle_defense_sync_(nullptr)
@@ -42,10 +56,18 @@ VideoTimelineSync::VideoTimelineSync(QObject* parent)
   , sync_precision_ms_(100)
   , marker_animations_enabled_(true)
   , max_queue_size_(1000)
+  , queue_high_water_mark_(0)
+  , events_dropped_(0)
   , event_processing_active_(false)
   , max_markers_(10000)
+  , marker_snapshot_(std::make_shared<TimelineMarkerSnapshot>())
+  , marker_snapshot_dirty_(false)
+  , marker_snapshot_scheduled_(false)
+  , marker_snapshot_stale_(false)
   , timeline_view_(nullptr)
   , timeline_scene_(nullptr)
+  , marker_layer_(nullptr)
+  , pulse_phase_(0.0)
   , scroll_animation_(nullptr)
   , marker_animation_group_(nullptr)
   , auto_cleanup_enabled_(true)
@@ -82,6 +104,19 @@ VideoTimelineSync::VideoTimelineSync(QObject* parent)
   timeline_view_->setOptimizationFlag(QGraphicsView::DontAdjustForAntialiasing);
   timeline_view_->setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
   
+  // One layer paints all markers straight from the time index
+  marker_layer_ = new TimelineMarkerLayer([this]() { return AcquireMarkerSnapshot(); });
+  marker_layer_->setClickCallback([this](const QString& marker_id) {
+    QMutexLocker locker(&marker_mutex_);
+    auto it = timeline_markers_.constFind(marker_id);
+    if (it != timeline_markers_.constEnd()) {
+      TimelineMarker marker = it.value();
+      locker.unlock();
+      emit MarkerClicked(marker);
+    }
+  });
+  timeline_scene_->addItem(marker_layer_);
+  
   // Setup animation groups
   marker_animation_group_ = new QParallelAnimationGroup(this);
   scroll_animation_ = new QPropertyAnimation(this);
@@ -179,9 +214,11 @@ void VideoTimelineSync::Shutdown()
     event_queue_.clear();
   }
 
-  // Clean up graphics
+  // Clean up graphics, keeping the marker layer
   if (timeline_scene_) {
+    timeline_scene_->removeItem(marker_layer_);
     timeline_scene_->clear();
+    timeline_scene_->addItem(marker_layer_);
   }
 
   is_initialized_ = false;
@@ -231,6 +268,11 @@ void VideoTimelineSync::StartRealTimeSync()
   real_time_sync_active_ = true;
   event_processing_active_ = true;
 
+  {
+    QMutexLocker locker(&event_mutex_);
+    queue_high_water_mark_ = event_queue_.size();
+  }
+
   // Start sync timer
   if (sync_timer_) {
     sync_timer_->start();
@@ -260,6 +302,9 @@ void VideoTimelineSync::StopRealTimeSync()
 
   qInfo() << "Stopping real-time timeline synchronization";
 
+  // Apply whatever analysis results are still queued
+  ProcessEventQueue();
+
   real_time_sync_active_ = false;
   event_processing_active_ = false;
 
@@ -291,18 +336,13 @@ void VideoTimelineSync::UpdateVideoPosition(qint64 timestamp)
     // Create sync event for position update
     SyncEvent event;
     event.event_id = QString("pos_update_%1").arg(timestamp);
-    event.event_type = "position_update";
+    event.event_type = kPositionUpdateEvent;
     event.video_timestamp = timestamp;
     event.system_timestamp = QDateTime::currentMSecsSinceEpoch();
     event.source_component = "video_timeline_sync";
     event.requires_ui_update = true;
 
-    {
-      QMutexLocker locker(&event_mutex_);
-      if (event_queue_.size() < max_queue_size_) {
-        event_queue_.enqueue(event);
-      }
-    }
+    EnqueueSyncEvent(event);
 
     emit SyncPositionChanged(timestamp);
   }
@@ -326,19 +366,19 @@ QString VideoTimelineSync::AddTimelineMarker(const TimelineMarker& marker)
       return QString();
     }
     
+    auto existing = timeline_markers_.constFind(validated_marker.marker_id);
+    if (existing != timeline_markers_.constEnd()) {
+      UnindexMarker(existing.value());
+    }
     timeline_markers_[validated_marker.marker_id] = validated_marker;
+    IndexMarker(validated_marker);
+    ScheduleMarkerSnapshot();
   }
 
-  // Create graphics item for marker
-  if (IsMarkerVisible(validated_marker)) {
-    TimelineMarkerItem* marker_item = new TimelineMarkerItem(validated_marker);
-    timeline_scene_->addItem(marker_item);
-    marker_graphics_[validated_marker.marker_id] = marker_item;
-    
-    // Animate marker if enabled
-    if (marker_animations_enabled_ && validated_marker.animated) {
-      AnimateMarker(validated_marker.marker_id);
-    }
+  // Repaint the marker layer
+  marker_layer_->markersChanged(validated_marker.timestamp);
+  if (IsMarkerVisible(validated_marker) && marker_animations_enabled_ && validated_marker.animated) {
+    AnimateMarker(validated_marker.marker_id);
   }
 
   // Update statistics
@@ -365,18 +405,15 @@ bool VideoTimelineSync::RemoveTimelineMarker(const QString& marker_id)
     if (!timeline_markers_.contains(marker_id)) {
       return false;
     }
-    timeline_markers_.remove(marker_id);
-  }
-
-  // Remove graphics item
-  if (marker_graphics_.contains(marker_id)) {
-    QGraphicsItem* item = marker_graphics_.take(marker_id);
-    timeline_scene_->removeItem(item);
-    delete item;
+    UnindexMarker(timeline_markers_.take(marker_id));
+    ScheduleMarkerSnapshot();
   }
 
   // Remove from animated markers list
-  animated_markers_.removeAll(marker_id);
+  if (animated_markers_.removeAll(marker_id) > 0) {
+    marker_layer_->setAnimatedMarkers(animated_markers_);
+  }
+  marker_layer_->markersChanged();
 
   // Update statistics
   {
@@ -403,16 +440,13 @@ bool VideoTimelineSync::UpdateTimelineMarker(const QString& marker_id, const Tim
     ValidateMarkerData(validated_marker);
     validated_marker.marker_id = marker_id; // Preserve original ID
     
+    UnindexMarker(timeline_markers_[marker_id]);
     timeline_markers_[marker_id] = validated_marker;
+    IndexMarker(validated_marker);
+    ScheduleMarkerSnapshot();
   }
 
-  // Update graphics item
-  if (marker_graphics_.contains(marker_id)) {
-    TimelineMarkerItem* marker_item = static_cast<TimelineMarkerItem*>(marker_graphics_[marker_id]);
-    if (marker_item) {
-      marker_item->setMarker(updated_marker);
-    }
-  }
+  marker_layer_->markersChanged(updated_marker.timestamp);
 
   emit MarkerUpdated(updated_marker);
   emit TimelineDataChanged();
@@ -423,51 +457,51 @@ bool VideoTimelineSync::UpdateTimelineMarker(const QString& marker_id, const Tim
 
 QList<TimelineMarker> VideoTimelineSync::GetMarkersInRange(qint64 start_timestamp, qint64 end_timestamp) const
 {
-  QMutexLocker locker(&marker_mutex_);
+  std::shared_ptr<const TimelineMarkerSnapshot> snapshot = AcquireMarkerSnapshot();
   
   QList<TimelineMarker> markers_in_range;
-  
-  for (auto it = timeline_markers_.constBegin(); it != timeline_markers_.constEnd(); ++it) {
-    const TimelineMarker& marker = it.value();
-    if (marker.timestamp >= start_timestamp && marker.timestamp <= end_timestamp) {
-      markers_in_range.append(marker);
-    }
+  if (end_timestamp < start_timestamp) {
+    return markers_in_range;
   }
   
-  // Sort by timestamp
-  std::sort(markers_in_range.begin(), markers_in_range.end(),
-           [](const TimelineMarker& a, const TimelineMarker& b) {
-             return a.timestamp < b.timestamp;
-           });
+  // Already in timestamp order
+  auto first = std::lower_bound(snapshot->timestamps.begin(), snapshot->timestamps.end(), start_timestamp);
+  auto last = std::upper_bound(first, snapshot->timestamps.end(), end_timestamp);
+  
+  markers_in_range.reserve(static_cast<int>(last - first));
+  for (auto it = first; it != last; ++it) {
+    markers_in_range.append(*snapshot->markers[it - snapshot->timestamps.begin()]);
+  }
   
   return markers_in_range;
 }
 
 TimelineMarker VideoTimelineSync::GetMarkerAt(qint64 timestamp, TimelineMarkerType type) const
 {
-  QMutexLocker locker(&marker_mutex_);
+  std::shared_ptr<const TimelineMarkerSnapshot> snapshot = AcquireMarkerSnapshot();
   
-  TimelineMarker closest_marker;
+  // Only markers within a reasonable range (1 second) qualify
+  const qint64 max_distance = 1000;
+  auto first = std::lower_bound(snapshot->timestamps.begin(), snapshot->timestamps.end(),
+                                timestamp - max_distance);
+  auto last = std::upper_bound(first, snapshot->timestamps.end(), timestamp + max_distance);
+  
+  const TimelineMarker* closest_marker = nullptr;
   qint64 min_distance = LLONG_MAX;
   
-  for (auto it = timeline_markers_.constBegin(); it != timeline_markers_.constEnd(); ++it) {
-    const TimelineMarker& marker = it.value();
+  for (auto it = first; it != last; ++it) {
+    const TimelineMarker& marker = *snapshot->markers[it - snapshot->timestamps.begin()];
     
     if (marker.type == type || type == TimelineMarkerType::Formation) { // Formation as wildcard
       qint64 distance = qAbs(marker.timestamp - timestamp);
       if (distance < min_distance) {
         min_distance = distance;
-        closest_marker = marker;
+        closest_marker = &marker;
       }
     }
   }
   
-  // Only return if within reasonable range (1 second)
-  if (min_distance <= 1000) {
-    return closest_marker;
-  }
-  
-  return TimelineMarker();
+  return closest_marker ? *closest_marker : TimelineMarker();
 }
 
 void VideoTimelineSync::ClearMarkers()
@@ -475,16 +509,14 @@ void VideoTimelineSync::ClearMarkers()
   {
     QMutexLocker locker(&marker_mutex_);
     timeline_markers_.clear();
+    marker_time_index_.clear();
+    marker_snapshot_dirty_ = true;
+    PublishMarkerSnapshot();
   }
   
-  // Clear graphics items
-  for (QGraphicsItem* item : marker_graphics_) {
-    timeline_scene_->removeItem(item);
-    delete item;
-  }
-  marker_graphics_.clear();
-  
   animated_markers_.clear();
+  marker_layer_->setAnimatedMarkers(animated_markers_);
+  marker_layer_->markersChanged();
   
   // Update statistics
   {
@@ -498,19 +530,14 @@ void VideoTimelineSync::ClearMarkers()
 
 void VideoTimelineSync::SetMarkerTypeVisible(TimelineMarkerType type, bool visible)
 {
-  marker_visibility_[type] = visible;
-  
-  // Update existing marker visibility
-  QMutexLocker locker(&marker_mutex_);
-  for (auto it = timeline_markers_.begin(); it != timeline_markers_.end(); ++it) {
-    const TimelineMarker& marker = it.value();
-    if (marker.type == type) {
-      if (marker_graphics_.contains(marker.marker_id)) {
-        QGraphicsItem* item = marker_graphics_[marker.marker_id];
-        item->setVisible(visible);
-      }
-    }
+  // The density pyramid only counts visible types, so it is republished
+  {
+    QMutexLocker locker(&marker_mutex_);
+    marker_visibility_[type] = visible;
+    marker_snapshot_dirty_ = true;
+    PublishMarkerSnapshot();
   }
+  marker_layer_->update();
   
   qDebug() << "Marker type visibility changed:" << static_cast<int>(type) << "visible:" << visible;
 }
@@ -543,6 +570,8 @@ void VideoTimelineSync::SetMarkerAnimations(bool enabled)
     if (marker_animation_group_) {
       marker_animation_group_->stop();
     }
+    pulse_phase_ = 0.0;
+    marker_layer_->setPulsePhase(pulse_phase_);
   } else if (enabled && real_time_sync_active_ && marker_animation_timer_) {
     marker_animation_timer_->start();
   }
@@ -550,6 +579,16 @@ void VideoTimelineSync::SetMarkerAnimations(bool enabled)
   qInfo() << "Marker animations" << (enabled ? "enabled" : "disabled");
 }
 
+void VideoTimelineSync::SetTimelineScale(double pixels_per_second)
+{
+  marker_layer_->setTimeScale(pixels_per_second);
+}
+
+void VideoTimelineSync::SetMarkerClusterThreshold(double pixels)
+{
+  marker_layer_->setClusterThreshold(pixels);
+}
+
 QJsonObject VideoTimelineSync::ExportTimelineData() const
 {
   QMutexLocker locker(&marker_mutex_);
@@ -636,14 +675,9 @@ void VideoTimelineSync::OnFormationDetected(const FormationData& formation)
     return;
   }
   
+  // Counted in events_processed when the queue drains its marker event
   qDebug() << "Processing formation detection for timeline:" << formation.formation_id;
   CreateFormationMarker(formation);
-  
-  // Update statistics
-  {
-    QMutexLocker locker(&stats_mutex_);
-    sync_statistics_.events_processed++;
-  }
 }
 
 void VideoTimelineSync::OnFormationUpdated(const FormationData& formation)
@@ -652,30 +686,27 @@ void VideoTimelineSync::OnFormationUpdated(const FormationData& formation)
     return;
   }
   
-  // Find existing marker and update it
-  QString marker_id = QString("formation_%1").arg(formation.formation_id);
+  // Patch the existing marker, or the one still queued for this formation
+  TimelineMarker patch;
+  patch.marker_id = QString("formation_%1").arg(formation.formation_id);
+  patch.description = QString("Formation: %1 (Confidence: %2%)")
+                     .arg(static_cast<int>(formation.type))
+                     .arg(formation.confidence * 100, 0, 'f', 1);
+  patch.metadata["confidence"] = formation.confidence;
+  patch.metadata["mel_score"] = formation.mel_results.combined_score;
   
-  QMutexLocker locker(&marker_mutex_);
-  if (timeline_markers_.contains(marker_id)) {
-    TimelineMarker& marker = timeline_markers_[marker_id];
-    
-    // Update marker with new formation data
-    marker.description = QString("Formation: %1 (Confidence: %2%)")
-                        .arg(static_cast<int>(formation.type))
-                        .arg(formation.confidence * 100, 0, 'f', 1);
-    marker.metadata["confidence"] = formation.confidence;
-    marker.metadata["mel_score"] = formation.mel_results.combined_score;
-    
-    // Update graphics if visible
-    if (marker_graphics_.contains(marker_id)) {
-      TimelineMarkerItem* marker_item = static_cast<TimelineMarkerItem*>(marker_graphics_[marker_id]);
-      if (marker_item) {
-        marker_item->setMarker(marker);
-      }
-    }
-    
-    emit MarkerUpdated(marker);
+  QueueMarkerEvent(kMarkerPatchEvent, patch);
+}
+
+void VideoTimelineSync::OnFormationDeleted(const QString& formation_id)
+{
+  if (!real_time_sync_active_) {
+    return;
   }
+  
+  TimelineMarker marker;
+  marker.marker_id = QString("formation_%1").arg(formation_id);
+  QueueMarkerEvent(kMarkerRemoveEvent, marker);
 }
 
 void VideoTimelineSync::OnTriangleCallRecommended(TriangleCall call, const FormationData& formation)
@@ -821,20 +852,15 @@ void VideoTimelineSync::OnMarkerAnimationTimer()
     return;
   }
   
-  // Update animated markers
-  for (const QString& marker_id : animated_markers_) {
-    if (marker_graphics_.contains(marker_id)) {
-      TimelineMarkerItem* marker_item = static_cast<TimelineMarkerItem*>(marker_graphics_[marker_id]);
-      if (marker_item) {
-        // Update animation frame
-        marker_item->startPulseAnimation();
-      }
-    }
-  }
+  // Advance the shared pulse; one full cycle per second
+  pulse_phase_ += marker_animation_timer_->interval() / 1000.0;
+  pulse_phase_ -= qFloor(pulse_phase_);
+  marker_layer_->setPulsePhase(pulse_phase_);
 }
 
 void VideoTimelineSync::OnStatisticsTimer()
 {
+  OptimizeMarkerRendering();
   UpdateSyncStatistics();
   emit StatisticsUpdated(sync_statistics_);
 }
@@ -845,28 +871,222 @@ void VideoTimelineSync::ProcessEventQueue()
     return;
   }
   
-  QMutexLocker locker(&event_mutex_);
+  // Take the whole backlog in one swap; producers never wait on processing
+  QQueue<SyncEvent> events;
+  {
+    QMutexLocker locker(&event_mutex_);
+    events.swap(event_queue_);
+  }
   
-  int processed_count = 0;
-  const int max_events_per_cycle = 50; // Process up to 50 events per cycle
+  if (events.isEmpty()) {
+    return;
+  }
   
-  while (!event_queue_.isEmpty() && processed_count < max_events_per_cycle) {
-    SyncEvent event = event_queue_.dequeue();
-    locker.unlock();
-    
-    ProcessSyncEvent(event);
-    processed_count++;
+  // Merge marker events per marker id, keeping first-arrival order, and
+  // keep only the newest position update
+  QVector<SyncEvent> marker_events;
+  QHash<QString, int> marker_event_slots;
+  int latest_position = -1;
+  qint64 coalesced_count = 0;
+  
+  for (int i = 0; i < events.size(); i++) {
+    const SyncEvent& event = events.at(i);
     
-    locker.relock();
+    if (event.event_type == kMarkerUpsertEvent || event.event_type == kMarkerPatchEvent
+        || event.event_type == kMarkerRemoveEvent) {
+      auto slot = marker_event_slots.constFind(event.event_id);
+      if (slot == marker_event_slots.constEnd()) {
+        marker_event_slots.insert(event.event_id, marker_events.size());
+        marker_events.append(event);
+      } else {
+        MergeMarkerEvent(marker_events[slot.value()], event);
+        coalesced_count++;
+      }
+    } else if (event.event_type == kPositionUpdateEvent) {
+      if (latest_position >= 0) {
+        coalesced_count++;
+      }
+      latest_position = i;
+    } else {
+      ProcessSyncEvent(event);
+    }
+  }
+  
+  if (latest_position >= 0) {
+    ProcessSyncEvent(events.at(latest_position));
+  }
+  
+  TimelineMarkerChangeSet changes;
+  if (!marker_events.isEmpty()) {
+    changes = ApplyMarkerEvents(marker_events);
   }
   
-  if (processed_count > 0) {
+  {
     QMutexLocker stats_locker(&stats_mutex_);
-    sync_statistics_.events_processed += processed_count;
-    sync_statistics_.queued_events = event_queue_.size();
+    sync_statistics_.events_processed += events.size();
+    sync_statistics_.events_coalesced += coalesced_count;
+    sync_statistics_.markers_created += changes.added.size();
+    sync_statistics_.active_markers = timeline_markers_.size();
+    if (!changes.IsEmpty()) {
+      sync_statistics_.change_batches++;
+    }
+  }
+  
+  if (!changes.IsEmpty()) {
+    emit MarkersChanged(changes);
+    emit TimelineDataChanged();
+  }
+  
+  if (debug_mode_enabled_ && coalesced_count > 0) {
+    qDebug() << "Timeline sync applied" << events.size() << "events as"
+             << changes.added.size() << "added," << changes.updated.size() << "updated,"
+             << changes.removed.size() << "removed";
+  }
+}
+
+void VideoTimelineSync::EnqueueSyncEvent(const SyncEvent& event)
+{
+  bool drain_now = false;
+  {
+    QMutexLocker locker(&event_mutex_);
+    
+    // Position updates are superseded by the next one, so a full queue
+    // sheds them; marker events carry analysis results and are never lost
+    if (event_queue_.size() >= max_queue_size_ && event.event_type == kPositionUpdateEvent) {
+      events_dropped_++;
+      return;
+    }
+    
+    event_queue_.enqueue(event);
+    queue_high_water_mark_ = qMax(queue_high_water_mark_, static_cast<int>(event_queue_.size()));
+    drain_now = event_queue_.size() >= max_queue_size_;
+  }
+  
+  // A burst filled the queue before the next tick; apply it now, which
+  // also throttles the producer when it runs on this thread
+  if (drain_now && QThread::currentThread() == thread()) {
+    ProcessEventQueue();
+  }
+}
+
+void VideoTimelineSync::QueueMarkerEvent(const QString& event_type, const TimelineMarker& marker)
+{
+  SyncEvent event;
+  event.event_type = event_type;
+  event.system_timestamp = QDateTime::currentMSecsSinceEpoch();
+  event.source_component = "triangle_defense_sync";
+  event.marker = marker;
+  
+  if (event_type == kMarkerUpsertEvent) {
+    ValidateMarkerData(event.marker);
+    if (event.marker.marker_id.isEmpty()) {
+      event.marker.marker_id = GenerateMarkerId(event.marker.type, event.marker.timestamp);
+    }
+  }
+  
+  event.event_id = event.marker.marker_id;
+  event.video_timestamp = event.marker.timestamp;
+  
+  EnqueueSyncEvent(event);
+}
+
+void VideoTimelineSync::MergeMarkerEvent(SyncEvent& pending, const SyncEvent& next)
+{
+  if (next.event_type != kMarkerPatchEvent) {
+    // Upserts and removals replace whatever came before
+    pending = next;
+  } else if (pending.event_type != kMarkerRemoveEvent) {
+    // Fold the patch into the queued upsert or patch; a removed marker stays removed
+    ApplyMarkerPatch(pending.marker, next.marker);
+    pending.system_timestamp = next.system_timestamp;
+  }
+}
+
+void VideoTimelineSync::ApplyMarkerPatch(TimelineMarker& marker, const TimelineMarker& patch)
+{
+  if (!patch.description.isEmpty()) {
+    marker.description = patch.description;
+  }
+  for (auto it = patch.metadata.constBegin(); it != patch.metadata.constEnd(); ++it) {
+    marker.metadata[it.key()] = it.value();
   }
 }
 
+TimelineMarkerChangeSet VideoTimelineSync::ApplyMarkerEvents(const QVector<SyncEvent>& marker_events)
+{
+  TimelineMarkerChangeSet changes;
+  qint64 latest_timestamp = -1;
+  int rejected_count = 0;
+  
+  // One transaction: readers see the previous snapshot until the whole
+  // batch is in, then it is republished once here, not by a reader
+  {
+    QMutexLocker locker(&marker_mutex_);
+    
+    for (const SyncEvent& event : marker_events) {
+      auto existing = timeline_markers_.find(event.event_id);
+      
+      if (event.event_type == kMarkerRemoveEvent) {
+        if (existing != timeline_markers_.end()) {
+          UnindexMarker(existing.value());
+          timeline_markers_.erase(existing);
+          changes.removed.append(event.event_id);
+        }
+      } else if (event.event_type == kMarkerPatchEvent) {
+        if (existing != timeline_markers_.end()) {
+          ApplyMarkerPatch(existing.value(), event.marker);
+          IndexMarker(existing.value());
+          changes.updated.append(existing.value());
+        }
+      } else if (existing != timeline_markers_.end()) {
+        UnindexMarker(existing.value());
+        existing.value() = event.marker;
+        IndexMarker(event.marker);
+        changes.updated.append(event.marker);
+        latest_timestamp = qMax(latest_timestamp, event.marker.timestamp);
+      } else if (timeline_markers_.size() >= max_markers_) {
+        rejected_count++;
+      } else {
+        timeline_markers_.insert(event.event_id, event.marker);
+        IndexMarker(event.marker);
+        changes.added.append(event.marker);
+        latest_timestamp = qMax(latest_timestamp, event.marker.timestamp);
+      }
+    }
+    
+    PublishMarkerSnapshot();
+  }
+  
+  if (rejected_count > 0) {
+    qWarning() << "Maximum marker limit reached, dropped" << rejected_count << "queued markers";
+  }
+  
+  if (changes.IsEmpty()) {
+    return changes;
+  }
+  
+  // Animation list and layer are touched once for the whole batch
+  bool animations_changed = false;
+  for (const QString& marker_id : changes.removed) {
+    animations_changed |= animated_markers_.removeAll(marker_id) > 0;
+  }
+  if (marker_animations_enabled_) {
+    for (const TimelineMarker& marker : changes.added) {
+      if (marker.animated && IsMarkerVisible(marker) && !animated_markers_.contains(marker.marker_id)) {
+        animated_markers_.append(marker.marker_id);
+        animations_changed = true;
+      }
+    }
+  }
+  if (animations_changed) {
+    marker_layer_->setAnimatedMarkers(animated_markers_);
+  }
+  
+  marker_layer_->markersChanged(latest_timestamp);
+  
+  return changes;
+}
+
 void VideoTimelineSync::CleanupOldMarkers()
 {
   if (!auto_cleanup_enabled_) {
@@ -902,7 +1122,7 @@ void VideoTimelineSync::CleanupOldMarkers()
 
 void VideoTimelineSync::ProcessSyncEvent(const SyncEvent& event)
 {
-  if (event.event_type == "position_update") {
+  if (event.event_type == kPositionUpdateEvent) {
     // Update timeline view position if needed
     if (event.requires_ui_update) {
       UpdateTimelineView();
@@ -936,7 +1156,7 @@ void VideoTimelineSync::CreateFormationMarker(const FormationData& formation)
   marker.metadata["field_zone"] = formation.field_zone;
   marker.metadata["mel_score"] = formation.mel_results.combined_score;
   
-  AddTimelineMarker(marker);
+  QueueMarkerEvent(kMarkerUpsertEvent, marker);
 }
 
 void VideoTimelineSync::CreateTriangleCallMarker(TriangleCall call, const FormationData& formation)
@@ -958,7 +1178,7 @@ void VideoTimelineSync::CreateTriangleCallMarker(TriangleCall call, const Format
   marker.metadata["triangle_call"] = static_cast<int>(call);
   marker.metadata["confidence"] = formation.confidence;
   
-  AddTimelineMarker(marker);
+  QueueMarkerEvent(kMarkerUpsertEvent, marker);
 }
 
 void VideoTimelineSync::CreateCoachingAlertMarker(const CoachingAlert& alert)
@@ -984,7 +1204,7 @@ void VideoTimelineSync::CreateCoachingAlertMarker(const CoachingAlert& alert)
   marker.metadata["target_staff"] = alert.target_staff;
   marker.metadata["message"] = alert.message;
   
-  AddTimelineMarker(marker);
+  QueueMarkerEvent(kMarkerUpsertEvent, marker);
 }
 
 void VideoTimelineSync::CreateMELScoreMarker(const QString& formation_id, const MELResult& results)
@@ -1013,7 +1233,7 @@ void VideoTimelineSync::CreateMELScoreMarker(const QString& formation_id, const
   marker.metadata["combined_score"] = results.combined_score;
   marker.metadata["stage_status"] = results.stage_status;
   
-  AddTimelineMarker(marker);
+  QueueMarkerEvent(kMarkerUpsertEvent, marker);
 }
 
 QColor VideoTimelineSync::GetMarkerColor(TimelineMarkerType type, double confidence) const
@@ -1109,10 +1329,16 @@ void VideoTimelineSync::UpdateSyncStatistics()
   {
     QMutexLocker event_locker(&event_mutex_);
     sync_statistics_.queued_events = event_queue_.size();
+    sync_statistics_.queue_high_water_mark = queue_high_water_mark_;
+    sync_statistics_.events_dropped = events_dropped_;
   }
   
   sync_statistics_.sync_operations++;
   
+  sync_statistics_.paint_time_ms = marker_layer_->lastPaintTimeMs();
+  sync_statistics_.average_paint_time_ms = marker_layer_->averagePaintTimeMs();
+  sync_statistics_.rendered_marker_bins = marker_layer_->lastPaintedBins();
+  
   // Calculate timeline accuracy score based on sync performance
   if (sync_statistics_.average_latency_ms > 100.0) {
     sync_statistics_.timeline_accuracy_score = qMax(50.0, 100.0 - sync_statistics_.average_latency_ms / 10.0);
@@ -1150,21 +1376,82 @@ bool VideoTimelineSync::IsMarkerVisible(const TimelineMarker& marker) const
   return marker_visibility_.value(marker.type, true);
 }
 
-void VideoTimelineSync::AnimateMarker(const QString& marker_id)
+void VideoTimelineSync::IndexMarker(const TimelineMarker& marker)
 {
-  if (!marker_animations_enabled_ || !marker_graphics_.contains(marker_id)) {
+  marker_time_index_[std::make_pair(marker.timestamp, marker.marker_id)] =
+    std::make_shared<const TimelineMarker>(marker);
+  marker_snapshot_dirty_ = true;
+}
+
+void VideoTimelineSync::UnindexMarker(const TimelineMarker& marker)
+{
+  marker_time_index_.erase(std::make_pair(marker.timestamp, marker.marker_id));
+  marker_snapshot_dirty_ = true;
+}
+
+void VideoTimelineSync::PublishMarkerSnapshot() const
+{
+  marker_snapshot_stale_ = false;
+  if (!marker_snapshot_dirty_) {
     return;
   }
+  marker_snapshot_dirty_ = false;
   
-  TimelineMarkerItem* marker_item = static_cast<TimelineMarkerItem*>(marker_graphics_[marker_id]);
-  if (marker_item) {
-    marker_item->setAnimated(true);
-    marker_item->startPulseAnimation();
-    
-    if (!animated_markers_.contains(marker_id)) {
-      animated_markers_.append(marker_id);
+  auto snapshot = std::make_shared<TimelineMarkerSnapshot>();
+  snapshot->timestamps.reserve(marker_time_index_.size());
+  snapshot->markers.reserve(marker_time_index_.size());
+  for (const auto& entry : marker_time_index_) {
+    snapshot->timestamps.push_back(entry.first.first);
+    snapshot->markers.push_back(entry.second);
+  }
+  for (auto it = marker_visibility_.constBegin(); it != marker_visibility_.constEnd(); ++it) {
+    if (!it.value()) {
+      snapshot->visible_types &= ~(1u << static_cast<int>(it.key()));
+    }
+  }
+  snapshot->BuildDensityLevels();
+  std::atomic_store(&marker_snapshot_, std::shared_ptr<const TimelineMarkerSnapshot>(std::move(snapshot)));
+}
+
+void VideoTimelineSync::ScheduleMarkerSnapshot()
+{
+  // Direct writes in one event loop pass share a single rebuild, unless a
+  // read comes first
+  marker_snapshot_stale_ = true;
+  if (marker_snapshot_scheduled_) {
+    return;
+  }
+  marker_snapshot_scheduled_ = true;
+  
+  QTimer::singleShot(0, this, [this]() {
+    {
+      QMutexLocker locker(&marker_mutex_);
+      marker_snapshot_scheduled_ = false;
+      PublishMarkerSnapshot();
     }
+    marker_layer_->update();
+  });
+}
+
+std::shared_ptr<const TimelineMarkerSnapshot> VideoTimelineSync::AcquireMarkerSnapshot() const
+{
+  // Writers publish; readers (usually the UI) only rebuild to see a direct
+  // write that is still waiting for its scheduled publish
+  if (marker_snapshot_stale_) {
+    QMutexLocker locker(&marker_mutex_);
+    PublishMarkerSnapshot();
   }
+  return std::atomic_load(&marker_snapshot_);
+}
+
+void VideoTimelineSync::AnimateMarker(const QString& marker_id)
+{
+  if (!marker_animations_enabled_ || animated_markers_.contains(marker_id)) {
+    return;
+  }
+  
+  animated_markers_.append(marker_id);
+  marker_layer_->setAnimatedMarkers(animated_markers_);
 }
 
 void VideoTimelineSync::UpdateTimelineView()
@@ -1177,6 +1464,24 @@ void VideoTimelineSync::UpdateTimelineView()
   }
 }
 
+void VideoTimelineSync::OptimizeMarkerRendering()
+{
+  if (!rendering_optimizations_enabled_) {
+    return;
+  }
+  
+  // Coarser clusters if frames blow the budget, finer again once they are cheap
+  const double frame_budget_ms = 4.0;
+  double average_paint_ms = marker_layer_->averagePaintTimeMs();
+  double threshold = marker_layer_->clusterThreshold();
+  
+  if (average_paint_ms > frame_budget_ms && threshold < 32.0) {
+    marker_layer_->setClusterThreshold(threshold * 2.0);
+  } else if (average_paint_ms < frame_budget_ms / 4.0 && threshold > 4.0) {
+    marker_layer_->setClusterThreshold(threshold / 2.0);
+  }
+}
+
 void VideoTimelineSync::CalculateSyncLatency()
 {
   if (sync_latency_timer_.isValid()) {
@@ -1204,140 +1509,379 @@ void VideoTimelineSync::CalculateSyncLatency()
   }
 }
 
-// TimelineMarkerItem Implementation
-TimelineMarkerItem::TimelineMarkerItem(const TimelineMarker& marker, QGraphicsItem* parent)
+// TimelineMarkerLayer Implementation
+namespace {
+
+// Narrowest pyramid bucket; when a bin is narrower than this, frames walk
+// the visible markers themselves
+constexpr qint64 kBaseBucketMs = 100;
+constexpr int kMaxDensityLevels = 40;
+constexpr double kMarkerHalfWidth = 6.0;
+constexpr qint64 kNoCell = LLONG_MIN;
+
+qint64 FloorDiv(qint64 value, qint64 divisor)
+{
+  qint64 quotient = value / divisor;
+  return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+} // namespace
+
+void TimelineMarkerSnapshot::BuildDensityLevels()
+{
+  levels.clear();
+  
+  auto keep_top = [this](DensityBucket& bucket, int candidate) {
+    if (markers[candidate]->priority > markers[bucket.representative]->priority) {
+      bucket.representative = candidate;
+    }
+  };
+  
+  // Finest level straight from the sorted markers
+  std::vector<DensityBucket> finest;
+  for (size_t i = 0; i < markers.size(); i++) {
+    if (!IsTypeVisible(markers[i]->type)) {
+      continue;
+    }
+    qint64 index = FloorDiv(timestamps[i], kBaseBucketMs);
+    if (!finest.empty() && finest.back().index == index) {
+      finest.back().count++;
+      keep_top(finest.back(), static_cast<int>(i));
+    } else {
+      finest.push_back({index, 1, static_cast<int>(i)});
+    }
+  }
+  levels.push_back(std::move(finest));
+  
+  // Each level doubles the bucket width until one bucket is left
+  while (levels.size() < kMaxDensityLevels && levels.back().size() > 1) {
+    std::vector<DensityBucket> coarser;
+    coarser.reserve(levels.back().size() / 2 + 1);
+    for (const DensityBucket& bucket : levels.back()) {
+      qint64 index = bucket.index >> 1; // Arithmetic shift floors negatives too
+      if (!coarser.empty() && coarser.back().index == index) {
+        coarser.back().count += bucket.count;
+        keep_top(coarser.back(), bucket.representative);
+      } else {
+        coarser.push_back({index, bucket.count, bucket.representative});
+      }
+    }
+    levels.push_back(std::move(coarser));
+  }
+}
+
+TimelineMarkerLayer::TimelineMarkerLayer(SnapshotSource source, QGraphicsItem* parent)
   : QGraphicsItem(parent)
-  , marker_(marker)
-  , is_animated_(false)
-  , is_hovered_(false)
-  , pulse_animation_(nullptr)
-  , icon_item_(nullptr)
-  , label_item_(nullptr)
+  , source_(std::move(source))
+  , time_scale_(10.0)
+  , height_(40.0)
+  , extent_ms_(0)
+  , cluster_threshold_px_(4.0)
+  , pulse_phase_(0.0)
+  , bins_left_(0.0)
+  , bins_right_(0.0)
+  , bins_valid_(false)
+  , hovered_cell_(kNoCell)
+  , last_paint_ms_(0.0)
+  , average_paint_ms_(0.0)
 {
   setAcceptHoverEvents(true);
-  setFlag(QGraphicsItem::ItemIsSelectable, true);
-  updateVisuals();
+  setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true); // exposedRect drives culling
 }
 
-QRectF TimelineMarkerItem::boundingRect() const
+QRectF TimelineMarkerLayer::boundingRect() const
 {
-  return QRectF(-10, -20, 20, 40);
+  return QRectF(-kMarkerHalfWidth, 0, timestampToX(extent_ms_) + 2 * kMarkerHalfWidth, height_);
 }
 
-void TimelineMarkerItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
+void TimelineMarkerLayer::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget)
 {
-  Q_UNUSED(option)
-  Q_UNUSED(widget)
-  
-  painter->setRenderHint(QPainter::Antialiasing);
+  QElapsedTimer paint_timer;
+  paint_timer.start();
   
-  // Draw marker shape based on type
-  QColor color = marker_.color;
-  if (is_hovered_) {
-    color = color.lighter(120);
+  // Bins cover the whole visible range on a grid fixed at x = 0, so they do
+  // not shift as the view scrolls or differ between partial repaints, and
+  // hit testing works anywhere in view. They are only rebuilt when the
+  // markers, the scale or the visible cells change.
+  std::shared_ptr<const TimelineMarkerSnapshot> snapshot = source_();
+  QRectF visible = visibleRect(widget);
+  double cell_width = cluster_threshold_px_;
+  double left = std::floor((visible.left() - kMarkerHalfWidth) / cell_width) * cell_width;
+  double right = (std::floor((visible.right() + kMarkerHalfWidth) / cell_width) + 1) * cell_width;
+  if (!bins_valid_ || snapshot != snapshot_ || left != bins_left_ || right != bins_right_) {
+    snapshot_ = snapshot;
+    collectBins(*snapshot_, left, right);
+    bins_left_ = left;
+    bins_right_ = right;
+    bins_valid_ = true;
   }
   
-  painter->setBrush(color);
-  painter->setPen(QPen(color.darker(150), 1));
-  
-  QRectF rect = boundingRect();
-  rect.setHeight(rect.height() * marker_.height_scale);
+  // The exposed strip only decides which bins are drawn
+  double exposed_left = option->exposedRect.left() - kMarkerHalfWidth;
+  double exposed_right = option->exposedRect.right() + kMarkerHalfWidth;
   
-  switch (marker_.type) {
-    case TimelineMarkerType::Formation:
-      painter->drawEllipse(rect);
-      break;
-    case TimelineMarkerType::TriangleCall:
-      painter->drawPolygon(QPolygonF() << QPointF(0, rect.top()) 
-                                      << QPointF(rect.right(), rect.bottom())
-                                      << QPointF(rect.left(), rect.bottom()));
-      break;
-    case TimelineMarkerType::CoachingAlert:
-      painter->drawRect(rect);
-      break;
-    default:
-      painter->drawEllipse(rect);
-      break;
+  painter->setRenderHint(QPainter::Antialiasing);
+  for (const Bin& bin : painted_bins_) {
+    if (bin.right < exposed_left || bin.left > exposed_right) {
+      continue;
+    }
+    
+    const TimelineMarker& representative = *snapshot_->markers[bin.representative];
+    bool hovered = bin.cell == hovered_cell_;
+    
+    if (bin.count == 1) {
+      paintMarker(painter, representative, bin.left, hovered);
+    } else {
+      paintCluster(painter, bin, representative, hovered);
+    }
   }
   
-  // Draw label if visible
-  if (!marker_.label.isEmpty() && rect.width() > 15) {
-    painter->setPen(QPen(Qt::white));
-    painter->drawText(rect, Qt::AlignCenter, marker_.label);
+  last_paint_ms_ = paint_timer.nsecsElapsed() / 1000000.0;
+  average_paint_ms_ = average_paint_ms_ > 0.0 ? average_paint_ms_ * 0.9 + last_paint_ms_ * 0.1 : last_paint_ms_;
+}
+
+void TimelineMarkerLayer::setTimeScale(double pixels_per_second)
+{
+  prepareGeometryChange();
+  time_scale_ = qMax(0.001, pixels_per_second);
+  bins_valid_ = false;
+  hovered_cell_ = kNoCell;
+  update();
+}
+
+void TimelineMarkerLayer::setHeight(double height)
+{
+  prepareGeometryChange();
+  height_ = height;
+  update();
+}
+
+void TimelineMarkerLayer::setClusterThreshold(double pixels)
+{
+  cluster_threshold_px_ = qMax(1.0, pixels);
+  bins_valid_ = false;
+  hovered_cell_ = kNoCell;
+  update();
+}
+
+void TimelineMarkerLayer::setAnimatedMarkers(const QList<QString>& marker_ids)
+{
+  animated_markers_ = QSet<QString>(marker_ids.begin(), marker_ids.end());
+  update();
+}
+
+void TimelineMarkerLayer::setPulsePhase(double phase)
+{
+  pulse_phase_ = phase;
+  if (!animated_markers_.isEmpty()) {
+    update();
   }
 }
 
-void TimelineMarkerItem::setMarker(const TimelineMarker& marker)
+void TimelineMarkerLayer::markersChanged(qint64 timestamp)
 {
-  marker_ = marker;
-  updateVisuals();
+  if (timestamp > extent_ms_) {
+    prepareGeometryChange();
+    extent_ms_ = timestamp;
+  }
   update();
 }
 
-void TimelineMarkerItem::setAnimated(bool animated)
+void TimelineMarkerLayer::mousePressEvent(QGraphicsSceneMouseEvent* event)
 {
-  is_animated_ = animated;
-  
-  if (animated && !pulse_animation_) {
-    pulse_animation_ = new QPropertyAnimation(this, "opacity");
-    pulse_animation_->setDuration(1000);
-    pulse_animation_->setLoopCount(-1);
-    pulse_animation_->setKeyValueAt(0.0, 1.0);
-    pulse_animation_->setKeyValueAt(0.5, 0.5);
-    pulse_animation_->setKeyValueAt(1.0, 1.0);
+  // Accepting the press is what delivers the release to this item
+  if (binAt(event->pos()) >= 0) {
+    event->accept();
+  } else {
+    event->ignore();
   }
 }
 
-void TimelineMarkerItem::startPulseAnimation()
+void TimelineMarkerLayer::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
 {
-  if (pulse_animation_ && is_animated_) {
-    pulse_animation_->start();
+  int bin = binAt(event->pos());
+  if (bin >= 0 && click_callback_) {
+    click_callback_(snapshot_->markers[painted_bins_[bin].representative]->marker_id);
   }
 }
 
-void TimelineMarkerItem::stopPulseAnimation()
+void TimelineMarkerLayer::hoverMoveEvent(QGraphicsSceneHoverEvent* event)
 {
-  if (pulse_animation_) {
-    pulse_animation_->stop();
-    setOpacity(1.0);
+  // Repaint only when the pointer crosses into another bin
+  int bin = binAt(event->pos());
+  qint64 cell = bin < 0 ? kNoCell : painted_bins_[bin].cell;
+  if (cell == hovered_cell_) {
+    return;
+  }
+  hovered_cell_ = cell;
+  
+  if (bin < 0) {
+    setToolTip(QString());
+  } else if (painted_bins_[bin].count == 1) {
+    setToolTip(VideoTimelineSyncUtils::CreateMarkerTooltip(*snapshot_->markers[painted_bins_[bin].representative]));
+  } else {
+    const Bin& cluster = painted_bins_[bin];
+    setToolTip(QString("<b>%1 markers</b><br>Time: %2ms - %3ms<br>Top: %4")
+               .arg(cluster.count)
+               .arg(qRound64(xToTimestamp(cluster.left)))
+               .arg(qRound64(xToTimestamp(cluster.right)))
+               .arg(snapshot_->markers[cluster.representative]->label));
   }
+  update();
 }
 
-void TimelineMarkerItem::mousePressEvent(QGraphicsSceneMouseEvent* event)
+void TimelineMarkerLayer::hoverLeaveEvent(QGraphicsSceneHoverEvent* event)
 {
   Q_UNUSED(event)
-  // Handle marker click
+  if (hovered_cell_ != kNoCell) {
+    hovered_cell_ = kNoCell;
+    setToolTip(QString());
+    update();
+  }
 }
 
-void TimelineMarkerItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* event)
+void TimelineMarkerLayer::collectBins(const TimelineMarkerSnapshot& snapshot, double left, double right)
 {
-  Q_UNUSED(event)
-  // Emit marker clicked signal through parent VideoTimelineSync
+  painted_bins_.clear();
+  
+  qint64 start_ms = qFloor(xToTimestamp(left));
+  qint64 end_ms = qCeil(xToTimestamp(right));
+  double bin_ms = xToTimestamp(cluster_threshold_px_);
+  
+  if (bin_ms < kBaseBucketMs) {
+    // Zoomed in: few markers fit in the visible range, walk them directly
+    auto first = std::lower_bound(snapshot.timestamps.begin(), snapshot.timestamps.end(), start_ms);
+    auto last = std::upper_bound(first, snapshot.timestamps.end(), end_ms);
+    for (auto it = first; it != last; ++it) {
+      int index = static_cast<int>(it - snapshot.timestamps.begin());
+      if (snapshot.IsTypeVisible(snapshot.markers[index]->type)) {
+        addToBin(snapshot, TimelineMarkerSnapshot::DensityBucket{0, 1, index}, timestampToX(*it));
+      }
+    }
+    return;
+  }
+  
+  if (snapshot.levels.empty()) {
+    return;
+  }
+  
+  // Zoomed out: the widest level whose buckets are no wider than one bin,
+  // so the visible range holds a bounded number of buckets
+  int level = qBound(0, static_cast<int>(std::floor(std::log2(bin_ms / kBaseBucketMs))),
+                     static_cast<int>(snapshot.levels.size()) - 1);
+  qint64 bucket_ms = kBaseBucketMs << level;
+  const std::vector<TimelineMarkerSnapshot::DensityBucket>& buckets = snapshot.levels[level];
+  
+  qint64 first_index = FloorDiv(start_ms, bucket_ms);
+  qint64 last_index = FloorDiv(end_ms, bucket_ms);
+  auto it = std::lower_bound(buckets.begin(), buckets.end(), first_index,
+                             [](const TimelineMarkerSnapshot::DensityBucket& bucket, qint64 index) {
+                               return bucket.index < index;
+                             });
+  for (; it != buckets.end() && it->index <= last_index; ++it) {
+    double x = it->count == 1
+      ? timestampToX(snapshot.timestamps[it->representative])
+      : timestampToX(it->index * bucket_ms + bucket_ms / 2);
+    addToBin(snapshot, *it, x);
+  }
+}
+
+void TimelineMarkerLayer::addToBin(const TimelineMarkerSnapshot& snapshot,
+                                   const TimelineMarkerSnapshot::DensityBucket& bucket, double x)
+{
+  // Buckets arrive left to right; everything in one grid cell shares a bin
+  qint64 cell = static_cast<qint64>(std::floor(x / cluster_threshold_px_));
+  if (!painted_bins_.isEmpty() && painted_bins_.last().cell == cell) {
+    Bin& bin = painted_bins_.last();
+    bin.right = qMax(bin.right, x);
+    bin.count += bucket.count;
+    if (snapshot.markers[bucket.representative]->priority > snapshot.markers[bin.representative]->priority) {
+      bin.representative = bucket.representative;
+    }
+    return;
+  }
+  
+  painted_bins_.append(Bin{cell, x, x, bucket.count, bucket.representative});
 }
 
-void TimelineMarkerItem::hoverEnterEvent(QGraphicsSceneHoverEvent* event)
+void TimelineMarkerLayer::paintMarker(QPainter* painter, const TimelineMarker& marker, double x, bool hovered) const
 {
-  Q_UNUSED(event)
-  is_hovered_ = true;
-  update();
+  QColor color = hovered ? marker.color.lighter(120) : marker.color;
+  painter->setBrush(color);
+  painter->setPen(QPen(color.darker(150), 1));
+  
+  bool pulsing = animated_markers_.contains(marker.marker_id);
+  if (pulsing) {
+    painter->setOpacity(0.75 + 0.25 * std::cos(2.0 * M_PI * pulse_phase_));
+  }
   
-  // Show tooltip
-  QString tooltip = VideoTimelineSyncUtils::CreateMarkerTooltip(marker_);
-  setToolTip(tooltip);
+  double marker_height = height_ * marker.height_scale;
+  QRectF rect(x - kMarkerHalfWidth, height_ - marker_height, 2 * kMarkerHalfWidth, marker_height);
+  
+  switch (marker.type) {
+    case TimelineMarkerType::TriangleCall:
+      painter->drawPolygon(QPolygonF() << QPointF(x, rect.top())
+                                      << QPointF(rect.right(), rect.bottom())
+                                      << QPointF(rect.left(), rect.bottom()));
+      break;
+    case TimelineMarkerType::CoachingAlert:
+      painter->drawRect(rect);
+      break;
+    default:
+      painter->drawEllipse(rect);
+      break;
+  }
+  
+  if (pulsing) {
+    painter->setOpacity(1.0);
+  }
 }
 
-void TimelineMarkerItem::hoverLeaveEvent(QGraphicsSceneHoverEvent* event)
+void TimelineMarkerLayer::paintCluster(QPainter* painter, const Bin& bin, const TimelineMarker& representative,
+                                       bool hovered) const
 {
-  Q_UNUSED(event)
-  is_hovered_ = false;
-  update();
+  // Taller with density, colored by the highest priority marker inside
+  double bar_height = height_ * qMin(1.0, 0.35 + 0.1 * std::log2(static_cast<double>(bin.count)));
+  QRectF rect(bin.left - kMarkerHalfWidth, height_ - bar_height,
+              bin.right - bin.left + 2 * kMarkerHalfWidth, bar_height);
+  
+  QColor color = hovered ? representative.color.lighter(120) : representative.color;
+  color.setAlpha(200);
+  painter->setBrush(color);
+  painter->setPen(QPen(representative.color.darker(150), 1));
+  painter->drawRoundedRect(rect, 2, 2);
+  
+  QString count = QString::number(bin.count);
+  if (painter->fontMetrics().horizontalAdvance(count) + 4 <= rect.width()) {
+    painter->setPen(QPen(Qt::white));
+    painter->drawText(rect, Qt::AlignCenter, count);
+  }
+}
+
+QRectF TimelineMarkerLayer::visibleRect(QWidget* widget) const
+{
+  // The whole view rather than the strip being repainted; without a view
+  // (rendering to an image) everything is visible
+  QGraphicsView* view = widget ? qobject_cast<QGraphicsView*>(widget->parentWidget()) : nullptr;
+  if (!view) {
+    return boundingRect();
+  }
+  return mapFromScene(view->mapToScene(view->viewport()->rect()).boundingRect()).boundingRect();
 }
 
-void TimelineMarkerItem::updateVisuals()
+int TimelineMarkerLayer::binAt(const QPointF& pos) const
 {
-  // Update visual properties based on marker data
-  setVisible(true);
-  setZValue(marker_.priority);
+  if (!snapshot_) {
+    return -1;
+  }
+  
+  for (int i = 0; i < painted_bins_.size(); i++) {
+    const Bin& bin = painted_bins_[i];
+    if (pos.x() >= bin.left - kMarkerHalfWidth && pos.x() <= bin.right + kMarkerHalfWidth) {
+      return i;
+    }
+  }
+  return -1;
 }
 
 // VideoTimelineSyncUtils namespace implementation
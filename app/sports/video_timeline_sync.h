@@ -24,6 +24,13 @@
 #include <QPropertyAnimation>
 #include <QParallelAnimationGroup>
 #include <QSequentialAnimationGroup>
+#include <QSet>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
 
 #include "triangle_defense_sync.h"
 
@@ -78,6 +85,7 @@ struct SyncEvent {
   double confidence;
   QString source_component;
   bool requires_ui_update;
+  TimelineMarker marker; // Payload of marker_* events; event_id is the marker id
   
   SyncEvent() : video_timestamp(0), system_timestamp(0), confidence(1.0),
                 requires_ui_update(true) {}
@@ -95,15 +103,70 @@ struct SyncStatistics {
   QDateTime last_sync_time;
   int active_markers;
   int queued_events;
+  double paint_time_ms;          // Last marker layer frame
+  double average_paint_time_ms;
+  int rendered_marker_bins;      // Markers and clusters drawn in the last frame
+  int queue_high_water_mark;     // Deepest event backlog since sync started
+  qint64 events_coalesced;       // Events merged into another before being applied
+  qint64 events_dropped;         // Position updates dropped on a full queue
+  qint64 change_batches;         // MarkersChanged emissions
   
   SyncStatistics() : events_processed(0), markers_created(0), sync_operations(0),
                      average_latency_ms(0.0), timeline_accuracy_score(100.0),
                      last_sync_time(QDateTime::currentDateTime()),
-                     active_markers(0), queued_events(0) {}
+                     active_markers(0), queued_events(0), paint_time_ms(0.0),
+                     average_paint_time_ms(0.0), rendered_marker_bins(0),
+                     queue_high_water_mark(0), events_coalesced(0), events_dropped(0),
+                     change_batches(0) {}
+};
+
+/**
+ * @brief Net marker changes applied by one event queue pass
+ */
+struct TimelineMarkerChangeSet {
+  QList<TimelineMarker> added;
+  QList<TimelineMarker> updated;
+  QStringList removed;
+
+  bool IsEmpty() const { return added.isEmpty() && updated.isEmpty() && removed.isEmpty(); }
 };
 
+/**
+ * @brief Immutable, time-ordered view of all timeline markers
+ *
+ * Carries the density pyramid the marker layer draws zoomed-out frames
+ * from: sparse time buckets of visible markers, doubling in width per
+ * level. The publishing writer builds it, so painting never does.
+ */
+struct TimelineMarkerSnapshot {
+  struct DensityBucket {
+    qint64 index;        // Bucket start / bucket width
+    int count;
+    int representative;  // Index of the highest priority marker
+  };
+
+  std::vector<qint64> timestamps; // Sorted, parallel to markers
+  std::vector<std::shared_ptr<const TimelineMarker>> markers;
+
+  quint32 visible_types = ~0u;    // Bit per TimelineMarkerType
+  std::vector<std::vector<DensityBucket>> levels;
+
+  bool IsTypeVisible(TimelineMarkerType type) const { return visible_types & (1u << static_cast<int>(type)); }
+  void BuildDensityLevels();
+};
+
+class TimelineMarkerLayer;
+
 /**
  * @brief Video timeline synchronization coordinator
+ *
+ * Markers coming from Triangle Defense analysis are not applied as they
+ * arrive. They are queued as marker events with position updates, and each
+ * sync tick drains the queue at once, merges events for the same marker,
+ * applies the result to the marker store in one locked pass and emits a
+ * single MarkersChanged. A burst of re-analysis results therefore costs one
+ * repaint per tick rather than one per marker. The Add/Remove/Update API
+ * still applies immediately and emits the per-marker signals.
  */
 class VideoTimelineSync : public QObject
 {
@@ -159,12 +222,19 @@ public:
   bool UpdateTimelineMarker(const QString& marker_id, const TimelineMarker& updated_marker);
 
   /**
-   * @brief Get markers in time range
+   * @brief Get markers in time range, ordered by timestamp
+   *
+   * Served from the time-ordered index in O(log n + k) without taking
+   * marker_mutex_; a query racing another thread's write may see the
+   * markers as they were just before it. Writes made before the call on
+   * the same thread are always seen.
    */
   QList<TimelineMarker> GetMarkersInRange(qint64 start_timestamp, qint64 end_timestamp) const;
 
   /**
-   * @brief Get marker at specific timestamp
+   * @brief Get the marker of a type closest to a timestamp, within one second
+   *
+   * Formation acts as a wildcard type. Lock-free like GetMarkersInRange().
    */
   TimelineMarker GetMarkerAt(qint64 timestamp, TimelineMarkerType type = TimelineMarkerType::Formation) const;
 
@@ -193,6 +263,16 @@ public:
    */
   void SetMarkerAnimations(bool enabled);
 
+  /**
+   * @brief Set the timeline zoom level
+   */
+  void SetTimelineScale(double pixels_per_second);
+
+  /**
+   * @brief Markers closer than this many pixels are drawn as one cluster
+   */
+  void SetMarkerClusterThreshold(double pixels);
+
   /**
    * @brief Export timeline data
    */
@@ -272,6 +352,11 @@ signals:
   void MarkerRemoved(const QString& marker_id);
   void MarkerClicked(const TimelineMarker& marker);
 
+  /**
+   * @brief Queued marker events applied in one sync tick
+   */
+  void MarkersChanged(const TimelineMarkerChangeSet& changes);
+
   /**
    * @brief Event signals
    */
@@ -289,6 +374,11 @@ private slots:
 private:
   void SetupTimers();
   void ProcessSyncEvent(const SyncEvent& event);
+  void EnqueueSyncEvent(const SyncEvent& event);
+  void QueueMarkerEvent(const QString& event_type, const TimelineMarker& marker);
+  TimelineMarkerChangeSet ApplyMarkerEvents(const QVector<SyncEvent>& marker_events);
+  static void MergeMarkerEvent(SyncEvent& pending, const SyncEvent& next);
+  static void ApplyMarkerPatch(TimelineMarker& marker, const TimelineMarker& patch);
   void CreateFormationMarker(const FormationData& formation);
   void CreateTriangleCallMarker(TriangleCall call, const FormationData& formation);
   void CreateCoachingAlertMarker(const CoachingAlert& alert);
@@ -309,6 +399,13 @@ private:
   bool IsMarkerVisible(const TimelineMarker& marker) const;
   void SortMarkersByPriority();
 
+  // All require marker_mutex_
+  void IndexMarker(const TimelineMarker& marker);
+  void UnindexMarker(const TimelineMarker& marker);
+  void PublishMarkerSnapshot() const;
+  void ScheduleMarkerSnapshot();
+
+  std::shared_ptr<const TimelineMarkerSnapshot> AcquireMarkerSnapshot() const;
   // Core components
   TriangleDefenseSync* triangle_defense_sync_;
   TimelinePanel* timeline_panel_;
@@ -334,6 +431,8 @@ private:
   mutable QMutex event_mutex_;
   QQueue<SyncEvent> event_queue_;
   int max_queue_size_;
+  int queue_high_water_mark_;
+  qint64 events_dropped_;
   bool event_processing_active_;
   
   // Marker management
@@ -343,11 +442,25 @@ private:
   QMap<TimelineMarkerType, QColor> marker_colors_;
   QList<QString> animated_markers_;
   int max_markers_;
+
+  // Time-ordered index, kept current by every write under marker_mutex_.
+  // Writers republish the immutable snapshot once per batch: at the end of
+  // an event queue pass, or on the next event loop pass after direct
+  // Add/Remove/Update calls. Readers load the published pointer without
+  // the lock (RCU-style); only after a direct write that is not published
+  // yet does a reader take the lock and publish it first, so a caller
+  // always reads its own writes.
+  std::map<std::pair<qint64, QString>, std::shared_ptr<const TimelineMarker>> marker_time_index_;
+  mutable std::shared_ptr<const TimelineMarkerSnapshot> marker_snapshot_; // std::atomic_load/store only
+  mutable bool marker_snapshot_dirty_;            // Guarded by marker_mutex_
+  bool marker_snapshot_scheduled_;                // Guarded by marker_mutex_
+  mutable std::atomic<bool> marker_snapshot_stale_; // A direct write awaits publishing
   
   // Visual rendering
   QGraphicsView* timeline_view_;
   QGraphicsScene* timeline_scene_;
-  QMap<QString, QGraphicsItem*> marker_graphics_;
+  TimelineMarkerLayer* marker_layer_;
+  double pulse_phase_;
   QPropertyAnimation* scroll_animation_;
   QParallelAnimationGroup* marker_animation_group_;
   
@@ -370,40 +483,88 @@ private:
 };
 
 /**
- * @brief Timeline marker graphics item
+ * @brief Single graphics item that paints every timeline marker
+ *
+ * Only the visible time range is visited (viewport culling). Markers are
+ * merged into density bins one cluster threshold wide, on a grid fixed at
+ * the start of the timeline, and each bin is drawn with its count; within
+ * a frame only bins in the exposed rect are drawn. Zoomed out, bins are read from a sparse pyramid of
+ * time buckets that doubles in width per level, so a frame costs
+ * O(visible bins) however many markers the timeline holds. The pyramid and
+ * type visibility come with the snapshot, so a frame never rebuilds them.
  */
-class TimelineMarkerItem : public QGraphicsItem
+class TimelineMarkerLayer : public QGraphicsItem
 {
 public:
-  explicit TimelineMarkerItem(const TimelineMarker& marker, QGraphicsItem* parent = nullptr);
+  using SnapshotSource = std::function<std::shared_ptr<const TimelineMarkerSnapshot>()>;
+  using MarkerCallback = std::function<void(const QString& marker_id)>;
+
+  explicit TimelineMarkerLayer(SnapshotSource source, QGraphicsItem* parent = nullptr);
 
   // QGraphicsItem interface
   QRectF boundingRect() const override;
   void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
 
-  void setMarker(const TimelineMarker& marker);
-  TimelineMarker getMarker() const { return marker_; }
+  void setTimeScale(double pixels_per_second);
+  void setHeight(double height);
+  void setClusterThreshold(double pixels);
+  double clusterThreshold() const { return cluster_threshold_px_; }
+  void setAnimatedMarkers(const QList<QString>& marker_ids);
+  void setPulsePhase(double phase);
+  void setClickCallback(MarkerCallback callback) { click_callback_ = std::move(callback); }
+
+  /**
+   * @brief Markers were added, changed or removed; timestamp grows the extent
+   */
+  void markersChanged(qint64 timestamp = -1);
 
-  void setAnimated(bool animated);
-  void startPulseAnimation();
-  void stopPulseAnimation();
+  double lastPaintTimeMs() const { return last_paint_ms_; }
+  double averagePaintTimeMs() const { return average_paint_ms_; }
+  int lastPaintedBins() const { return painted_bins_.size(); }
 
 protected:
   void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
   void mouseReleaseEvent(QGraphicsSceneMouseEvent* event) override;
-  void hoverEnterEvent(QGraphicsSceneHoverEvent* event) override;
+  void hoverMoveEvent(QGraphicsSceneHoverEvent* event) override;
   void hoverLeaveEvent(QGraphicsSceneHoverEvent* event) override;
 
 private:
-  void updateVisuals();
-  void createTooltip();
-
-  TimelineMarker marker_;
-  bool is_animated_;
-  bool is_hovered_;
-  QPropertyAnimation* pulse_animation_;
-  QGraphicsPixmapItem* icon_item_;
-  QGraphicsTextItem* label_item_;
+  struct Bin {
+    qint64 cell;         // x / cluster threshold; the grid starts at x = 0
+    double left;         // Marker x range
+    double right;
+    int count;
+    int representative;
+  };
+
+  void collectBins(const TimelineMarkerSnapshot& snapshot, double left, double right);
+  void addToBin(const TimelineMarkerSnapshot& snapshot, const TimelineMarkerSnapshot::DensityBucket& bucket,
+                double x);
+  void paintMarker(QPainter* painter, const TimelineMarker& marker, double x, bool hovered) const;
+  void paintCluster(QPainter* painter, const Bin& bin, const TimelineMarker& representative, bool hovered) const;
+  int binAt(const QPointF& pos) const;
+  QRectF visibleRect(QWidget* widget) const;
+  double timestampToX(qint64 timestamp) const { return timestamp * time_scale_ / 1000.0; }
+  double xToTimestamp(double x) const { return x * 1000.0 / time_scale_; }
+
+  SnapshotSource source_;
+  std::shared_ptr<const TimelineMarkerSnapshot> snapshot_;  // Last painted
+
+  double time_scale_;          // Pixels per second
+  double height_;
+  qint64 extent_ms_;           // Latest marker timestamp seen
+  double cluster_threshold_px_;
+  QSet<QString> animated_markers_;
+  double pulse_phase_;
+  MarkerCallback click_callback_;
+
+  QVector<Bin> painted_bins_;  // Whole visible range as of the last frame, for hit testing
+  double bins_left_;           // Range painted_bins_ was built over
+  double bins_right_;
+  bool bins_valid_;            // False after a scale or threshold change
+  qint64 hovered_cell_;
+  double last_paint_ms_;
+  double average_paint_ms_;
 };
 
 /**
@@ -488,5 +649,6 @@ Q_DECLARE_METATYPE(olive::TimelineMarkerType)
 Q_DECLARE_METATYPE(olive::TimelineMarker)
 Q_DECLARE_METATYPE(olive::SyncEvent)
 Q_DECLARE_METATYPE(olive::SyncStatistics)
+Q_DECLARE_METATYPE(olive::TimelineMarkerChangeSet)
 
 #endif // VIDEOTIMELINEYNC_H